@@ -203,8 +203,8 @@ if (NOT WAMR_BUILD_SANITIZER STREQUAL "")
 endif ()
 
 if (WAMR_BUILD_LINUX_PERF EQUAL 1)
-  if (NOT WAMR_BUILD_JIT AND NOT WAMR_BUILD_AOT)
-    message(WARNING "only support perf in aot and llvm-jit")
+  if (NOT WAMR_BUILD_JIT AND NOT WAMR_BUILD_AOT AND NOT WAMR_BUILD_FAST_JIT)
+    message(WARNING "only support perf in aot, llvm-jit and fast-jit")
     set(WAMR_BUILD_LINUX_PERF 0)
   endif ()
 endif ()
@@ -241,6 +241,10 @@ if (NOT DEFINED WAMR_BUILD_MEMORY64)
   set (WAMR_BUILD_MEMORY64 0)
 endif ()
 
+if (NOT DEFINED WAMR_BUILD_MEMORY_DISCARD)
+  set (WAMR_BUILD_MEMORY_DISCARD 0)
+endif ()
+
 if (NOT DEFINED WAMR_BUILD_MULTI_MEMORY)
   set (WAMR_BUILD_MULTI_MEMORY 0)
 endif ()
@@ -361,6 +365,10 @@ else ()
 endif ()
 if (WAMR_BUILD_THREAD_MGR EQUAL 1)
   message ("     Thread manager enabled")
+  if (WAMR_BUILD_THREAD_POOL_SIZE GREATER 0)
+    add_definitions (-DCLUSTER_THREAD_POOL_SIZE=${WAMR_BUILD_THREAD_POOL_SIZE})
+    message ("     Thread pool enabled with ${WAMR_BUILD_THREAD_POOL_SIZE} parked threads per cluster")
+  endif ()
 endif ()
 if (WAMR_BUILD_LIB_PTHREAD EQUAL 1)
   message ("     Lib pthread enabled")
@@ -398,6 +406,11 @@ if (WAMR_BUILD_BULK_MEMORY_OPT EQUAL 1)
 else()
   add_definitions (-DWASM_ENABLE_BULK_MEMORY_OPT=0)
 endif ()
+if (WAMR_BUILD_MEMORY_DISCARD EQUAL 1)
+  add_definitions (-DWASM_ENABLE_MEMORY_DISCARD=1)
+else ()
+  add_definitions (-DWASM_ENABLE_MEMORY_DISCARD=0)
+endif ()
 if (WAMR_BUILD_SHARED_MEMORY EQUAL 1)
   add_definitions (-DWASM_ENABLE_SHARED_MEMORY=1)
   message ("     Shared memory enabled")
@@ -408,6 +421,27 @@ if (WAMR_BUILD_SHARED_HEAP EQUAL 1)
   add_definitions (-DWASM_ENABLE_SHARED_HEAP=1)
   message ("     Shared heap enabled")
 endif()
+if (WAMR_BUILD_TASK_SCHEDULER EQUAL 1)
+  message ("     Task scheduler enabled")
+endif ()
+if (WAMR_BUILD_SAMPLING_PROFILING EQUAL 1)
+  add_definitions (-DWASM_ENABLE_SAMPLING_PROFILING=1)
+  message ("     Sampling profiling enabled")
+  # The samples are taken with the copy call stack APIs
+  set (WAMR_BUILD_COPY_CALL_STACK 1)
+endif ()
+if (WAMR_BUILD_INTERP_PROFILING EQUAL 1)
+  add_definitions (-DWASM_ENABLE_INTERP_PROFILING=1)
+  message ("     Interpreter profiling enabled")
+endif ()
+if (WAMR_BUILD_PREPARED_MODULE EQUAL 1)
+  if (NOT WAMR_BUILD_FAST_INTERP EQUAL 1 OR NOT WAMR_BUILD_INTERP EQUAL 1
+      OR WAMR_BUILD_GC EQUAL 1 OR WAMR_BUILD_MINI_LOADER EQUAL 1)
+    message (FATAL_ERROR "Prepared module requires the fast interpreter, and doesn't support GC and the mini loader")
+  endif ()
+  add_definitions (-DWASM_ENABLE_PREPARED_MODULE=1)
+  message ("     Prepared module enabled")
+endif ()
 if (WAMR_BUILD_COPY_CALL_STACK EQUAL 1)
   add_definitions (-DWASM_ENABLE_COPY_CALL_STACK=1)
   message("     Copy callstack enabled")
@@ -418,7 +452,9 @@ if (WAMR_BUILD_MEMORY64 EQUAL 1)
     message (FATAL_ERROR "-- Memory64 is only available on the 64-bit platform/target")
   endif()
   add_definitions (-DWASM_ENABLE_MEMORY64=1)
-  set (WAMR_DISABLE_HW_BOUND_CHECK 1)
+  if (DEFINED WAMR_BUILD_MEMORY64_HW_BOUND_CHECK_MAX_GB)
+    add_definitions (-DWASM_MEMORY64_HW_BOUND_CHECK_MAX_GB=${WAMR_BUILD_MEMORY64_HW_BOUND_CHECK_MAX_GB})
+  endif ()
 endif ()
 if (WAMR_BUILD_MULTI_MEMORY EQUAL 1)
   add_definitions (-DWASM_ENABLE_MULTI_MEMORY=1)
@@ -513,10 +549,11 @@ if (WAMR_BUILD_STRINGREF EQUAL 1)
   endif()
 endif ()
 if (WAMR_BUILD_PERF_PROFILING EQUAL 1 OR
+    WAMR_BUILD_SAMPLING_PROFILING EQUAL 1 OR
     WAMR_BUILD_DUMP_CALL_STACK EQUAL 1 OR
     WAMR_BUILD_GC EQUAL 1)
-  # Enable AOT/JIT stack frame when perf-profiling, dump-call-stack
-  # or GC is enabled
+  # Enable AOT/JIT stack frame when perf-profiling, sampling-profiling,
+  # dump-call-stack or GC is enabled
   if (WAMR_BUILD_AOT EQUAL 1 OR WAMR_BUILD_JIT EQUAL 1)
     add_definitions (-DWASM_ENABLE_AOT_STACK_FRAME=1)
   endif ()
@@ -641,6 +678,10 @@ if (WAMR_BUILD_GC_HEAP_VERIFY EQUAL 1)
   add_definitions (-DBH_ENABLE_GC_VERIFY=1)
   message ("     GC heap verification enabled")
 endif ()
+if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_MARK_THREAD_NUM GREATER 1)
+  add_definitions (-DGC_MARK_THREAD_NUM=${WAMR_BUILD_GC_MARK_THREAD_NUM})
+  message ("     GC parallel marking enabled with ${WAMR_BUILD_GC_MARK_THREAD_NUM} threads")
+endif ()
 if ("$ENV{COLLECT_CODE_COVERAGE}" STREQUAL "1" OR COLLECT_CODE_COVERAGE EQUAL 1)
   include(${CMAKE_CURRENT_LIST_DIR}/code_coverage.cmake)
   message ("     Collect code coverage enabled")
@@ -747,6 +788,14 @@ else ()
   add_definitions (-DWASM_ENABLE_SHRUNK_MEMORY=0)
   message ("     Shrunk memory disabled")
 endif()
+if (WAMR_BUILD_HEAP_TRIM EQUAL 1)
+  add_definitions (-DWASM_ENABLE_HEAP_TRIM=1)
+  message ("     Heap trim enabled")
+endif ()
+if (WAMR_BUILD_NUMA EQUAL 1)
+  add_definitions (-DWASM_ENABLE_NUMA=1)
+  message ("     NUMA-aware placement enabled")
+endif ()
 if (WAMR_BUILD_AOT_VALIDATOR EQUAL 1)
   message ("     AOT validator enabled")
   add_definitions (-DWASM_ENABLE_AOT_VALIDATOR=1)
@@ -755,6 +804,10 @@ if (WAMR_BUILD_INSTRUCTION_METERING EQUAL 1)
   message ("     Instruction metering enabled")
   add_definitions (-DWASM_ENABLE_INSTRUCTION_METERING=1)
 endif ()
+if (WAMR_BUILD_EPOCH_INTERRUPTION EQUAL 1)
+  message ("     Epoch interruption enabled")
+  add_definitions (-DWASM_ENABLE_EPOCH_INTERRUPTION=1)
+endif ()
 if (WAMR_BUILD_EXTENDED_CONST_EXPR EQUAL 1)
   message ("     Extended constant expression enabled")
   add_definitions(-DWASM_ENABLE_EXTENDED_CONST_EXPR=1)
@@ -787,6 +840,7 @@ message (
 "       \"Garbage Collection\" via WAMR_BUILD_GC: ${WAMR_BUILD_GC}\n"
 "       \"Legacy Exception Handling\" via WAMR_BUILD_EXCE_HANDLING: ${WAMR_BUILD_EXCE_HANDLING}\n"
 "       \"Memory64\" via WAMR_BUILD_MEMORY64: ${WAMR_BUILD_MEMORY64}\n"
+"       \"Memory Control (memory.discard)\" via WAMR_BUILD_MEMORY_DISCARD: ${WAMR_BUILD_MEMORY_DISCARD}\n"
 "       \"Multiple Memories\" via WAMR_BUILD_MULTI_MEMORY: ${WAMR_BUILD_MULTI_MEMORY}\n"
 "       \"Reference Types\" via WAMR_BUILD_REF_TYPES: ${WAMR_BUILD_REF_TYPES}\n"
 "       \"Reference-Typed Strings\" via WAMR_BUILD_STRINGREF: ${WAMR_BUILD_STRINGREF}\n"
@@ -148,6 +148,18 @@ if (WAMR_BUILD_THREAD_MGR EQUAL 1)
     include (${IWASM_DIR}/libraries/thread-mgr/thread_mgr.cmake)
 endif ()
 
+if (WAMR_BUILD_TASK_SCHEDULER EQUAL 1)
+    if (NOT (WAMR_BUILD_PLATFORM STREQUAL "linux"
+             OR WAMR_BUILD_PLATFORM STREQUAL "darwin"
+             OR WAMR_BUILD_PLATFORM STREQUAL "freebsd"))
+        message (FATAL_ERROR "Task scheduler requires ucontext, which isn't supported on platform " ${WAMR_BUILD_PLATFORM})
+    endif ()
+    include (${IWASM_DIR}/libraries/task-scheduler/task_scheduler.cmake)
+    # The task stacks have no guard pages, let the AOT code check the
+    # native stack overflow by itself
+    set (WAMR_DISABLE_STACK_HW_BOUND_CHECK 1)
+endif ()
+
 if (WAMR_BUILD_LIBC_EMCC EQUAL 1)
     include (${IWASM_DIR}/libraries/libc-emcc/libc_emcc.cmake)
 endif ()
@@ -222,6 +234,7 @@ set (source_all
     ${LIB_WASI_THREADS_SOURCE}
     ${LIB_PTHREAD_SOURCE}
     ${THREAD_MGR_SOURCE}
+    ${TASK_SCHEDULER_SOURCE}
     ${LIBC_EMCC_SOURCE}
     ${LIB_RATS_SOURCE}
     ${DEBUG_ENGINE_SOURCE}
@@ -74,6 +74,10 @@ if(WAMR_BUILD_GC EQUAL 1)
   check_fast_jit_error("Unsupported build configuration: GC + FAST_JIT")
 endif()
 
+if(WAMR_BUILD_INSTRUCTION_METERING EQUAL 1)
+  check_fast_jit_error("Unsupported build configuration: INSTRUCTION_METERING + FAST_JIT")
+endif()
+
 if(WAMR_BUILD_MEMORY64 EQUAL 1)
   check_fast_interp_error("Unsupported build configuration: MEMORY64 + FAST_INTERP")
   check_fast_jit_error("Unsupported build configuration: MEMORY64 + FAST_JIT")
@@ -218,6 +218,11 @@
 #define WASM_ENABLE_BULK_MEMORY_OPT 0
 #endif
 
+/* The memory.discard instruction of the memory control proposal */
+#ifndef WASM_ENABLE_MEMORY_DISCARD
+#define WASM_ENABLE_MEMORY_DISCARD 0
+#endif
+
 /* Shared memory */
 #ifndef WASM_ENABLE_SHARED_MEMORY
 #define WASM_ENABLE_SHARED_MEMORY 0
@@ -315,6 +320,13 @@
 #define WASM_DISABLE_HW_BOUND_CHECK 0
 #endif
 
+/* The max memory size in GB of a memory64 linear memory, which can be
+ * bound checked with hardware trap, a memory64 linear memory with larger
+ * max memory size is bound checked by software */
+#ifndef WASM_MEMORY64_HW_BOUND_CHECK_MAX_GB
+#define WASM_MEMORY64_HW_BOUND_CHECK_MAX_GB 64
+#endif
+
 /* Disable native stack access boundary check with hardware
  * trap or not, enable it by default if it is supported */
 #ifndef WASM_DISABLE_STACK_HW_BOUND_CHECK
@@ -352,6 +364,37 @@ unless used elsewhere */
 #define WASM_ENABLE_PERF_PROFILING 0
 #endif
 
+/* Sampling profiler: a SIGPROF timer walks the call stack of the thread
+   running wasm, and the samples are aggregated per call path */
+#ifndef WASM_ENABLE_SAMPLING_PROFILING
+#define WASM_ENABLE_SAMPLING_PROFILING 0
+#endif
+
+/* The max number of frames recorded in a sample, the frames of the callers
+   beyond it are dropped */
+#ifndef WASM_SAMPLING_PROF_MAX_DEPTH
+#define WASM_SAMPLING_PROF_MAX_DEPTH 64
+#endif
+
+/* The default max number of distinct call paths recorded */
+#ifndef WASM_SAMPLING_PROF_DEFAULT_CALL_PATHS
+#define WASM_SAMPLING_PROF_DEFAULT_CALL_PATHS 4096
+#endif
+
+/* Interpreter profiling: count the executions of each function and the
+   taken/not-taken edges of each conditional branch, and the frequencies of
+   the opcode pairs, the profile can be consumed by wamrc */
+#ifndef WASM_ENABLE_INTERP_PROFILING
+#define WASM_ENABLE_INTERP_PROFILING 0
+#endif
+
+/* Prepared module: keep the code prepared by the fast interpreter loader in
+   a custom section of the wasm binary, so that the loader can skip validating
+   and preparing the function bodies when loading the binary again */
+#ifndef WASM_ENABLE_PREPARED_MODULE
+#define WASM_ENABLE_PREPARED_MODULE 0
+#endif
+
 /* Dump call stack */
 #ifndef WASM_ENABLE_DUMP_CALL_STACK
 #define WASM_ENABLE_DUMP_CALL_STACK 0
@@ -414,6 +457,26 @@ unless used elsewhere */
    see ems_gc_internal.h */
 #define APP_HEAP_SIZE_MAX (1024 * 1024 * 1024)
 
+/* Give the pages of the free chunks of the app heap back to the OS, see
+   doc/memory_tune.md */
+#ifndef WASM_ENABLE_HEAP_TRIM
+#define WASM_ENABLE_HEAP_TRIM 0
+#endif
+
+/* Default min size of the pages given back to the OS when a chunk of the
+   app heap is freed, the smaller ones are given back by trimming the heap.
+   The other ems heaps, e.g. the runtime's global pool and the gc heaps,
+   don't give back the pages of the freed chunks */
+#ifndef HEAP_TRIM_THRESHOLD_DEFAULT
+#define HEAP_TRIM_THRESHOLD_DEFAULT (128 * 1024)
+#endif
+
+/* Bind the linear memory and the exec env stacks of an instance to a NUMA
+   node and optionally pin its threads to the node, see doc/perf_tune.md */
+#ifndef WASM_ENABLE_NUMA
+#define WASM_ENABLE_NUMA 0
+#endif
+
 /* Default min/max gc heap size of each app */
 #ifndef GC_HEAP_SIZE_DEFAULT
 #define GC_HEAP_SIZE_DEFAULT (128 * 1024)
@@ -571,6 +634,13 @@ unless used elsewhere */
     wasm_runtime_set_max_thread_num */
 #define CLUSTER_MAX_THREAD_NUM 4
 
+/* Max number of native threads parked per cluster after their thread
+    routines exit, which are reused to run the routines of the threads
+    spawned later. 0 means to create a native thread for each spawn */
+#ifndef CLUSTER_THREAD_POOL_SIZE
+#define CLUSTER_THREAD_POOL_SIZE 0
+#endif
+
 #ifndef WASM_ENABLE_TAIL_CALL
 #define WASM_ENABLE_TAIL_CALL 0
 #endif
@@ -732,8 +802,20 @@ unless used elsewhere */
 #define WASM_ENABLE_INSTRUCTION_METERING 0
 #endif
 
+/* Epoch-based interruption: AOT/JIT code compares the global epoch with
+   the deadline of the exec_env at function entries and loop headers */
+#ifndef WASM_ENABLE_EPOCH_INTERRUPTION
+#define WASM_ENABLE_EPOCH_INTERRUPTION 0
+#endif
+
 #ifndef WASM_ENABLE_EXTENDED_CONST_EXPR
 #define WASM_ENABLE_EXTENDED_CONST_EXPR 0
 #endif
 
+/* Enable the M:N task scheduler, which runs wasm calls as tasks on a
+   fixed number of worker threads */
+#ifndef WASM_ENABLE_TASK_SCHEDULER
+#define WASM_ENABLE_TASK_SCHEDULER 0
+#endif
+
 #endif /* end of _CONFIG_H_ */
@@ -337,6 +337,20 @@ loader_mmap(uint32 size, bool prot_exec, char *error_buf, uint32 error_buf_size)
     return mem;
 }
 
+/* Size of the huge pages which back the text section */
+#define TEXT_HUGE_PAGE_SIZE (2 * (uint64)BH_MB)
+
+static void
+advise_text_huge_page(void *text, uint64 size)
+{
+    /* The text keeps the regular pages if it fails, which isn't fatal */
+    if (os_madvise(text, (size_t)size, MMAP_ADVICE_HUGEPAGE) != 0) {
+        LOG_VERBOSE("Advise AOT text %p of %" PRIu64
+                    " bytes with huge page failed",
+                    text, size);
+    }
+}
+
 static char *
 load_string(uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
             bool is_load_from_file_buf,
@@ -513,6 +527,39 @@ check_feature_flags(char *error_buf, uint32 error_buf_size,
     }
 #endif
 
+#if WASM_ENABLE_INSTRUCTION_METERING == 0
+    if (feature_flags & WASM_FEATURE_INSTRUCTION_METERING) {
+        set_error_buf(error_buf, error_buf_size,
+                      "instruction metering is not enabled in this build");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION == 0
+    if (feature_flags & WASM_FEATURE_EPOCH_INTERRUPTION) {
+        set_error_buf(error_buf, error_buf_size,
+                      "epoch interruption is not enabled in this build");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_MEMORY_DISCARD == 0
+    if (feature_flags & WASM_FEATURE_MEMORY_DISCARD) {
+        set_error_buf(error_buf, error_buf_size,
+                      "memory discard is not enabled in this build");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_MEMORY64 == 0 || !defined(OS_ENABLE_HW_BOUND_CHECK)
+    if (feature_flags & WASM_FEATURE_MEMORY64_HW_BOUND_CHECK) {
+        set_error_buf(error_buf, error_buf_size,
+                      "memory64 hardware bound check is not enabled "
+                      "in this build");
+        return false;
+    }
+#endif
+
     return true;
 }
 
@@ -604,7 +651,8 @@ load_target_info_section(const uint8 *buf, const uint8 *buf_end,
         return false;
     }
 
-#if WASM_ENABLE_DUMP_CALL_STACK != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_GC != 0 \
+    || WASM_ENABLE_MEMORY64 != 0
     module->feature_flags = target_info.feature_flags;
 #endif
 
@@ -1916,11 +1964,9 @@ load_types(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
             }
         }
         else if (type_flag == WASM_TYPE_STRUCT) {
-            AOTStructType *struct_type;
+            AOTStructType *struct_type, *parent_struct_type = NULL;
             const uint8 *buf_org;
-            uint16 *reference_table;
             uint16 field_count, ref_field_count = 0;
-            uint32 offset;
 
             read_uint16(buf, buf_end, field_count);
             read_uint16(buf, buf_end, ref_type_map_count);
@@ -1948,7 +1994,6 @@ load_types(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
                 goto fail;
             }
 
-            offset = (uint32)offsetof(WASMStructObject, field_data);
             types[i] = (AOTType *)struct_type;
 
             init_base_type((AOTType *)struct_type, i, type_flag, is_sub_final,
@@ -1956,11 +2001,11 @@ load_types(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
             struct_type->field_count = field_count;
             struct_type->ref_type_map_count = ref_type_map_count;
 
-            struct_type->reference_table = reference_table =
+            struct_type->reference_table =
                 (uint16 *)((uint8 *)struct_type
                            + offsetof(AOTStructType, fields)
                            + sizeof(WASMStructFieldType) * field_count);
-            *reference_table++ = ref_field_count;
+            struct_type->reference_table[0] = ref_field_count;
 
             LOG_VERBOSE(
                 "type %u: struct, field count: %d, ref type map count: %d", i,
@@ -1970,7 +2015,7 @@ load_types(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
 
             /* Traverse again to read each field */
             for (j = 0; j < field_count; j++) {
-                uint8 field_type, field_size;
+                uint8 field_type;
 
                 read_uint8(buf, buf_end, struct_type->fields[j].field_flags);
                 read_uint8(buf, buf_end, field_type);
@@ -1982,25 +2027,22 @@ load_types(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
                 }
 #endif
                 struct_type->fields[j].field_type = field_type;
-                struct_type->fields[j].field_size = field_size =
+                struct_type->fields[j].field_size =
                     (uint8)wasm_reftype_size(field_type);
-#if !(defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
-      || defined(BUILD_TARGET_X86_32))
-                if (field_size == 2)
-                    offset = align_uint(offset, 2);
-                else if (field_size >= 4) /* field size is 4 or 8 */
-                    offset = align_uint(offset, 4);
-#endif
-                struct_type->fields[j].field_offset = offset;
-                if (wasm_is_type_reftype(field_type))
-                    *reference_table++ = offset;
-                offset += field_size;
                 LOG_VERBOSE("                field: %d, flags: %d, type: %d", j,
                             struct_type->fields[j].field_flags,
                             struct_type->fields[j].field_type);
             }
 
-            struct_type->total_size = offset;
+            if (parent_type_idx < i
+                && types[parent_type_idx]->type_flag == WASM_TYPE_STRUCT)
+                parent_struct_type = (AOTStructType *)types[parent_type_idx];
+            /* the fields are sorted by size if the compiler packs them */
+            wasm_struct_type_set_layout(
+                struct_type, parent_struct_type,
+                module->feature_flags & WASM_FEATURE_PACKED_STRUCT_FIELDS
+                    ? true
+                    : false);
             buf = align_ptr(buf, 4);
 
             /* If ref_type_map is not empty, read ref_type_map */
@@ -2652,7 +2694,7 @@ try_merge_data_and_text(const uint8 **buf, const uint8 **buf_end,
     uint8 *old_end = (uint8 *)*buf_end;
     size_t code_size = (size_t)(old_end - old_buf);
     uint32 page_size = os_getpagesize();
-    uint64 total_size = 0;
+    uint64 total_size = 0, text_size;
     uint32 i;
     uint8 *sections;
 
@@ -2660,8 +2702,12 @@ try_merge_data_and_text(const uint8 **buf, const uint8 **buf_end,
         return true;
     }
 
-    /* calculate the total memory needed */
-    total_size += align_uint64((uint64)code_size, page_size);
+    /* calculate the total memory needed, the text is padded to the end
+       of its last huge page so that the page can be backed too */
+    text_size = align_uint64((uint64)code_size, module->huge_page_text
+                                                    ? TEXT_HUGE_PAGE_SIZE
+                                                    : page_size);
+    total_size += text_size;
     for (i = 0; i < module->data_section_count; ++i) {
         total_size +=
             align_uint64((uint64)module->data_sections[i].size, page_size);
@@ -2680,8 +2726,12 @@ try_merge_data_and_text(const uint8 **buf, const uint8 **buf_end,
         return false;
     }
 
+    if (!module->huge_page_text) {
+        text_size = code_size;
+    }
+
 #ifdef BH_PLATFORM_WINDOWS
-    if (!os_mem_commit(sections, code_size,
+    if (!os_mem_commit(sections, text_size,
                        MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC)) {
         os_munmap(sections, (uint32)total_size);
         return false;
@@ -2689,13 +2739,17 @@ try_merge_data_and_text(const uint8 **buf, const uint8 **buf_end,
 #endif
 
     /* change the code part to be executable */
-    if (os_mprotect(sections, code_size,
+    if (os_mprotect(sections, text_size,
                     MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC)
         != 0) {
         os_munmap(sections, (uint32)total_size);
         return false;
     }
 
+    if (module->huge_page_text) {
+        advise_text_huge_page(sections, text_size);
+    }
+
     module->merged_data_text_sections = sections;
     module->merged_data_text_sections_size = (uint32)total_size;
 
@@ -2704,7 +2758,7 @@ try_merge_data_and_text(const uint8 **buf, const uint8 **buf_end,
     *buf_end = sections + code_size;
     bh_memcpy_s(sections, (uint32)code_size, old_buf, (uint32)code_size);
     os_munmap(old_buf, code_size);
-    sections += align_uint((uint32)code_size, page_size);
+    sections += align_uint64(text_size, page_size);
 
     /* then migrate .data sections */
     for (i = 0; i < module->data_section_count; ++i) {
@@ -4359,6 +4413,11 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
                     total_size =
                         (uint64)section_size + aot_get_plt_table_size();
                     total_size = (total_size + 3) & ~((uint64)3);
+                    if (module->huge_page_text) {
+                        /* the plt table is put at the end of the padding */
+                        total_size =
+                            align_uint64(total_size, TEXT_HUGE_PAGE_SIZE);
+                    }
                     if (total_size >= UINT32_MAX
                         || !(aot_text =
                                  loader_mmap((uint32)total_size, true,
@@ -4367,6 +4426,10 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
                         goto fail;
                     }
 
+                    if (module->huge_page_text) {
+                        advise_text_huge_page(aot_text, total_size);
+                    }
+
 #if (WASM_MEM_DUAL_BUS_MIRROR != 0)
                     mirrored_text = os_get_dbus_mirror(aot_text);
                     bh_assert(mirrored_text != NULL);
@@ -4485,7 +4548,8 @@ load(const uint8 *buf, uint32 size, AOTModule *module,
 
 #if WASM_ENABLE_LINUX_PERF != 0
     if (wasm_runtime_get_linux_perf())
-        if (!aot_create_perf_map(module, error_buf, error_buf_size))
+        if (!aot_create_perf_map(module, error_buf, error_buf_size)
+            || !aot_create_perf_jitdump(module, error_buf, error_buf_size))
             goto fail;
 #endif
 
@@ -4503,6 +4567,8 @@ aot_load_from_aot_file(const uint8 *buf, uint32 size, const LoadArgs *args,
     if (!module)
         return NULL;
 
+    module->huge_page_text = args->huge_page_text;
+
     os_thread_jit_write_protect_np(false); /* Make memory writable */
     if (!load(buf, size, module, args->wasm_binary_freeable, args->no_resolve,
               error_buf, error_buf_size)) {
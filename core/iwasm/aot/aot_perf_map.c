@@ -68,6 +68,17 @@ sort_func_ptrs(const AOTModule *module, char *error_buf, uint32 error_buf_size)
     return sorted_func_ptrs;
 }
 
+static void
+get_func_name(const char *module_name, uint32 func_idx, char *buf,
+              uint32 buf_size)
+{
+    if (strlen(module_name) > 0)
+        (void)snprintf(buf, buf_size, "[%s]#aot_func#%u", module_name,
+                       func_idx);
+    else
+        (void)snprintf(buf, buf_size, "aot_func#%u", func_idx);
+}
+
 bool
 aot_create_perf_map(const AOTModule *module, char *error_buf,
                     uint32 error_buf_size)
@@ -75,6 +86,7 @@ aot_create_perf_map(const AOTModule *module, char *error_buf,
     struct func_info *sorted_func_ptrs = NULL;
     char perf_map_path[64] = { 0 };
     char perf_map_info[128] = { 0 };
+    char func_name[96];
     FILE *perf_map = NULL;
     uint32 i;
     pid_t pid = getpid();
@@ -96,20 +108,11 @@ aot_create_perf_map(const AOTModule *module, char *error_buf,
     const char *module_name = aot_get_module_name((AOTModule *)module);
     for (i = 0; i < module->func_count; i++) {
         memset(perf_map_info, 0, 128);
-        if (strlen(module_name) > 0) {
-            (void)snprintf(perf_map_info, 128,
-                           "%" PRIxPTR "  %x  [%s]#aot_func#%u\n",
-                           (uintptr_t)sorted_func_ptrs[i].ptr,
-                           get_func_size(module, sorted_func_ptrs, i),
-                           module_name, sorted_func_ptrs[i].idx);
-        }
-        else {
-            (void)snprintf(perf_map_info, 128,
-                           "%" PRIxPTR "  %x  aot_func#%u\n",
-                           (uintptr_t)sorted_func_ptrs[i].ptr,
-                           get_func_size(module, sorted_func_ptrs, i),
-                           sorted_func_ptrs[i].idx);
-        }
+        get_func_name(module_name, sorted_func_ptrs[i].idx, func_name,
+                      sizeof(func_name));
+        (void)snprintf(perf_map_info, 128, "%" PRIxPTR "  %x  %s\n",
+                       (uintptr_t)sorted_func_ptrs[i].ptr,
+                       get_func_size(module, sorted_func_ptrs, i), func_name);
 
         /* fwrite() is thread safe */
         (void)fwrite(perf_map_info, 1, strlen(perf_map_info), perf_map);
@@ -128,3 +131,30 @@ quit:
 
     return ret;
 }
+
+bool
+aot_create_perf_jitdump(const AOTModule *module, char *error_buf,
+                        uint32 error_buf_size)
+{
+    struct func_info *sorted_func_ptrs;
+    const char *module_name = aot_get_module_name((AOTModule *)module);
+    char func_name[96];
+    uint32 i;
+
+    sorted_func_ptrs = sort_func_ptrs(module, error_buf, error_buf_size);
+    if (!sorted_func_ptrs)
+        return false;
+
+    /* The AOT file has no map from the native code to the bytecode, so
+       only the symbols are reported */
+    for (i = 0; i < module->func_count; i++) {
+        get_func_name(module_name, sorted_func_ptrs[i].idx, func_name,
+                      sizeof(func_name));
+        wasm_jitdump_code_load(func_name, sorted_func_ptrs[i].ptr,
+                               get_func_size(module, sorted_func_ptrs, i),
+                               NULL, 0);
+    }
+
+    wasm_runtime_free(sorted_func_ptrs);
+    return true;
+}
@@ -12,4 +12,9 @@ bool
 aot_create_perf_map(const AOTModule *module, char *error_buf,
                     uint32 error_buf_size);
 
+/* Write the code load records of the AOT functions into the jitdump */
+bool
+aot_create_perf_jitdump(const AOTModule *module, char *error_buf,
+                        uint32 error_buf_size);
+
 #endif /* _AOT_PERF_MAP_H_ */
\ No newline at end of file
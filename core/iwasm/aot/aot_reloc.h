@@ -33,6 +33,13 @@ typedef struct {
 #define REG_BULK_MEMORY_SYM()
 #endif
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+#define REG_MEMORY_DISCARD_SYM()          \
+    REG_SYM(aot_memory_discard),
+#else
+#define REG_MEMORY_DISCARD_SYM()
+#endif
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #include "wasm_shared_memory.h"
 #define REG_ATOMIC_WAIT_SYM()             \
@@ -192,6 +199,13 @@ typedef struct {
 #define REG_SHARED_HEAP_SYM()
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+#define REG_EPOCH_INTERRUPTION_SYM()          \
+    REG_SYM(wasm_runtime_epoch_deadline_reached),
+#else
+#define REG_EPOCH_INTERRUPTION_SYM()
+#endif
+
 #define REG_COMMON_SYMBOLS                \
     REG_SYM(aot_set_exception_with_id),   \
     REG_SYM(aot_invoke_native),           \
@@ -218,6 +232,7 @@ typedef struct {
     REG_SYM(rint),                        \
     REG_SYM(rintf),                       \
     REG_BULK_MEMORY_SYM()                 \
+    REG_MEMORY_DISCARD_SYM()              \
     REG_ATOMIC_WAIT_SYM()                 \
     REG_REF_TYPES_SYM()                   \
     REG_AOT_TRACE_SYM()                   \
@@ -226,6 +241,7 @@ typedef struct {
     REG_GC_SYM()                          \
     REG_STRINGREF_SYM()                   \
     REG_SHARED_HEAP_SYM()                 \
+    REG_EPOCH_INTERRUPTION_SYM()          \
 
 #define CHECK_RELOC_OFFSET(data_size) do {              \
     if (!check_reloc_offset(target_section_size,        \
@@ -41,6 +41,17 @@ bh_static_assert(offsetof(WASMExecEnv, wasm_stack.top)
                  == 11 * sizeof(uintptr_t));
 bh_static_assert(offsetof(WASMExecEnv, wasm_stack.bottom)
                  == 12 * sizeof(uintptr_t));
+#if WASM_ENABLE_INSTRUCTION_METERING != 0 \
+    || WASM_ENABLE_EPOCH_INTERRUPTION != 0
+bh_static_assert(offsetof(WASMExecEnv, instructions_to_execute)
+                 == 13 * sizeof(uintptr_t));
+#endif
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+bh_static_assert(offsetof(WASMExecEnv, epoch_deadline)
+                 == 14 * sizeof(uintptr_t));
+bh_static_assert(offsetof(WASMExecEnv, epoch_ptr)
+                 == 14 * sizeof(uintptr_t) + sizeof(uint64));
+#endif
 
 bh_static_assert(offsetof(AOTModuleInstance, memories) == 1 * sizeof(uint64));
 bh_static_assert(offsetof(AOTModuleInstance, func_ptrs) == 5 * sizeof(uint64));
@@ -972,7 +983,8 @@ static AOTMemoryInstance *
 memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
                    AOTModule *module, AOTMemoryInstance *memory_inst,
                    AOTMemory *memory, uint32 memory_idx, uint32 heap_size,
-                   uint32 max_memory_pages, char *error_buf,
+                   uint32 max_memory_pages, uint8 huge_page_policy,
+                   int8 numa_node, uint8 prefault_policy, char *error_buf,
                    uint32 error_buf_size)
 {
     void *heap_handle;
@@ -987,6 +999,7 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
         heap_offset = (uint64)num_bytes_per_page * init_page_count;
     uint64 memory_data_size, max_memory_data_size;
     uint8 *p = NULL, *global_addr;
+    uint8 mem64_clamp_log2 = 0;
     bool is_memory64 = memory->flags & MEMORY64_FLAG;
 
     bool is_shared_memory = false;
@@ -1103,6 +1116,35 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
             max_page_count = default_max_pages;
     }
 
+#if WASM_ENABLE_MEMORY64 != 0 && defined(OS_ENABLE_HW_BOUND_CHECK)
+    if (is_memory64
+        && (module->feature_flags & WASM_FEATURE_MEMORY64_HW_BOUND_CHECK)) {
+        /* The AOT code clamps the load/store addresses to the size got
+           from the declared max memory size, see aot_check_memory_overflow,
+           the memory can't grow beyond it */
+        mem64_clamp_log2 = wasm_get_mem64_clamp_log2(
+            (uint64)memory->num_bytes_per_page * memory->max_page_count);
+        if (mem64_clamp_log2 == 0) {
+            set_error_buf(error_buf, error_buf_size,
+                          "max memory size exceeds the limit of hardware "
+                          "bound check, try recompiling with "
+                          "`--bounds-checks=1` option");
+            return NULL;
+        }
+        if ((uint64)num_bytes_per_page * max_page_count
+            > ((uint64)1 << mem64_clamp_log2)) {
+            max_page_count = (uint32)(((uint64)1 << mem64_clamp_log2)
+                                      / num_bytes_per_page);
+            if (init_page_count > max_page_count) {
+                set_error_buf(error_buf, error_buf_size,
+                              "failed to insert app heap into linear memory, "
+                              "try using `--heap-size=0` option");
+                return NULL;
+            }
+        }
+    }
+#endif
+
     LOG_VERBOSE("Memory instantiate:");
     LOG_VERBOSE("  page bytes: %u, init pages: %u, max pages: %u",
                 num_bytes_per_page, init_page_count, max_page_count);
@@ -1117,8 +1159,10 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
 
     /* TODO: memory64 uses is_memory64 flag */
     if (wasm_allocate_linear_memory(&p, is_shared_memory, is_memory64,
-                                    num_bytes_per_page, init_page_count,
-                                    max_page_count, &memory_data_size)
+                                    mem64_clamp_log2, num_bytes_per_page,
+                                    init_page_count, max_page_count,
+                                    huge_page_policy, numa_node,
+                                    prefault_policy, &memory_data_size)
         != BHT_OK) {
         set_error_buf(error_buf, error_buf_size,
                       "allocate linear memory failed");
@@ -1126,6 +1170,9 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     }
 
     memory_inst->module_type = Wasm_Module_AoT;
+    memory_inst->huge_page_policy = huge_page_policy;
+    memory_inst->numa_node = numa_node;
+    memory_inst->prefault_policy = prefault_policy;
     memory_inst->num_bytes_per_page = num_bytes_per_page;
     memory_inst->cur_page_count = init_page_count;
     memory_inst->max_page_count = max_page_count;
@@ -1133,6 +1180,7 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
 #if WASM_ENABLE_MEMORY64 != 0
     if (is_memory64) {
         memory_inst->is_memory64 = 1;
+        memory_inst->mem64_clamp_log2 = mem64_clamp_log2;
     }
 #endif
 
@@ -1159,6 +1207,10 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
             set_error_buf(error_buf, error_buf_size, "init app heap failed");
             goto fail2;
         }
+#if WASM_ENABLE_HEAP_TRIM != 0
+        mem_allocator_set_trim_threshold(heap_handle,
+                                         HEAP_TRIM_THRESHOLD_DEFAULT);
+#endif
     }
 
     if (memory_data_size > 0) {
@@ -1220,7 +1272,8 @@ aot_get_memory_with_idx(AOTModuleInstance *module_inst, uint32 mem_idx)
 static bool
 memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
                      AOTModule *module, uint32 heap_size,
-                     uint32 max_memory_pages, char *error_buf,
+                     uint32 max_memory_pages, uint8 huge_page_policy,
+                     int8 numa_node, uint8 prefault_policy, char *error_buf,
                      uint32 error_buf_size)
 {
     uint32 global_index, global_data_offset, length;
@@ -1242,7 +1295,8 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     for (i = 0; i < memory_count; i++, memories++) {
         memory_inst = memory_instantiate(
             module_inst, parent, module, memories, &module->memories[i], i,
-            heap_size, max_memory_pages, error_buf, error_buf_size);
+            heap_size, max_memory_pages, huge_page_policy, numa_node,
+            prefault_policy, error_buf, error_buf_size);
         if (!memory_inst) {
             return false;
         }
@@ -1920,6 +1974,7 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     uint32 stack_size = args->v1.default_stack_size;
     uint32 heap_size = args->v1.host_managed_heap_size;
     uint32 max_memory_pages = args->v1.max_memory_pages;
+    int8 numa_node = -1;
 
     /* Align and validate heap size */
     heap_size = align_uint(heap_size, 8);
@@ -1964,6 +2019,22 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
         (WASMModuleInstanceExtra *)((uint8 *)module_inst + extra_info_offset);
     extra = (AOTModuleInstanceExtra *)module_inst->e;
 
+#if WASM_ENABLE_NUMA != 0
+    /* The sub instance of a spawned thread inherits the NUMA placement of
+       its parent */
+    if (is_sub_inst) {
+        AOTModuleInstanceExtra *parent_extra =
+            (AOTModuleInstanceExtra *)parent->e;
+        extra->common.numa_node = parent_extra->common.numa_node;
+        extra->common.numa_pin_threads = parent_extra->common.numa_pin_threads;
+    }
+    else {
+        extra->common.numa_node = args->numa_node >= 0 ? args->numa_node : -1;
+        extra->common.numa_pin_threads = args->numa_pin_threads;
+    }
+    numa_node = (int8)extra->common.numa_node;
+#endif
+
 #if WASM_ENABLE_GC != 0
     /* Initialize gc heap first since it may be used when initializing
        globals and others */
@@ -2066,7 +2137,9 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
 
     /* Initialize memory space */
     if (!memories_instantiate(module_inst, parent, module, heap_size,
-                              max_memory_pages, error_buf, error_buf_size))
+                              max_memory_pages, (uint8)args->huge_page_policy,
+                              numa_node, (uint8)args->memory_prefault_policy,
+                              error_buf, error_buf_size))
         goto fail;
 
     /* Initialize function pointers */
@@ -2097,6 +2170,7 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
                 wasi_args->map_dir_count, wasi_args->env, wasi_args->env_count,
                 wasi_args->addr_pool, wasi_args->addr_count,
                 wasi_args->ns_lookup_pool, wasi_args->ns_lookup_count,
+                wasi_args->mmap_dir_list, wasi_args->mmap_dir_count,
                 wasi_args->argv, wasi_args->argc, wasi_args->stdio[0],
                 wasi_args->stdio[1], wasi_args->stdio[2], error_buf,
                 error_buf_size))
@@ -3628,6 +3702,25 @@ aot_data_drop(AOTModuleInstance *module_inst, uint32 seg_index)
 }
 #endif /* WASM_ENABLE_BULK_MEMORY */
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+bool
+aot_memory_discard(AOTModuleInstance *module_inst, uint64 addr, uint64 len)
+{
+    AOTMemoryInstance *memory_inst = aot_get_default_memory(module_inst);
+
+    if ((addr | len) % DEFAULT_NUM_BYTES_PER_PAGE != 0) {
+        aot_set_exception(module_inst, "unaligned memory discard");
+        return false;
+    }
+
+    if (!memory_inst || !wasm_discard_memory(memory_inst, addr, len)) {
+        aot_set_exception(module_inst, "out of bounds memory access");
+        return false;
+    }
+    return true;
+}
+#endif /* WASM_ENABLE_MEMORY_DISCARD */
+
 #if WASM_ENABLE_THREAD_MGR != 0
 bool
 aot_set_aux_stack(WASMExecEnv *exec_env, uint64 start_offset, uint32 size)
@@ -4002,7 +4095,8 @@ aot_table_grow(AOTModuleInstance *module_inst, uint32 tbl_idx, uint32 inc_size,
 #endif /* WASM_ENABLE_REF_TYPES != 0 || WASM_ENABLE_GC != 0 */
 
 #if WASM_ENABLE_AOT_STACK_FRAME != 0
-#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0 \
+    || WASM_ENABLE_SAMPLING_PROFILING != 0
 #if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
 static const char *
 lookup_func_name(const char **func_names, uint32 *func_indexes,
@@ -4061,8 +4155,22 @@ get_func_name_from_index(const AOTModuleInstance *module_inst,
 
     return func_name;
 }
+
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+const char *
+aot_get_func_name_by_index(const AOTModuleInstance *module_inst,
+                           uint32 func_index)
+{
+    AOTModule *module = (AOTModule *)module_inst->module;
+
+    if (func_index >= module->import_func_count + module->func_count)
+        return NULL;
+    return get_func_name_from_index(module_inst, func_index);
+}
+#endif
 #endif /* end of WASM_ENABLE_DUMP_CALL_STACK != 0 || \
-          WASM_ENABLE_PERF_PROFILING != 0 */
+          WASM_ENABLE_PERF_PROFILING != 0 || \
+          WASM_ENABLE_SAMPLING_PROFILING != 0 */
 
 #if WASM_ENABLE_GC == 0
 static bool
@@ -35,6 +35,18 @@ extern "C" {
  * and not at the beginning of each function call */
 #define WASM_FEATURE_FRAME_PER_FUNCTION (1 << 12)
 #define WASM_FEATURE_FRAME_NO_FUNC_IDX (1 << 13)
+/* The fields of a struct type which aren't inherited from the parent
+ * type are laid out in descending order of field size */
+#define WASM_FEATURE_PACKED_STRUCT_FIELDS (1 << 14)
+/* The code decreases exec_env->instructions_to_execute */
+#define WASM_FEATURE_INSTRUCTION_METERING (1 << 15)
+/* The code checks exec_env->epoch_deadline */
+#define WASM_FEATURE_EPOCH_INTERRUPTION (1 << 16)
+/* The code clamps the memory64 load/store addresses and relies on the
+   guard regions to catch the out of bounds accesses */
+#define WASM_FEATURE_MEMORY64_HW_BOUND_CHECK (1 << 17)
+/* The code calls aot_memory_discard for the memory.discard opcode */
+#define WASM_FEATURE_MEMORY_DISCARD (1 << 18)
 
 typedef enum AOTSectionType {
     AOT_SECTION_TYPE_TARGET_INFO = 0,
@@ -300,6 +312,10 @@ typedef struct AOTModule {
     /* is indirect mode or not */
     bool is_indirect_mode;
 
+    /* whether the text section is mapped in huge page granularity and
+       advised to be backed with transparent huge pages */
+    bool huge_page_text;
+
 #if WASM_ENABLE_LIBC_WASI != 0
     WASIArguments wasi_args;
     bool import_wasi_api;
@@ -356,7 +372,8 @@ typedef struct AOTModule {
     uint8 *merged_data_text_sections;
     uint32 merged_data_text_sections_size;
 
-#if WASM_ENABLE_AOT_STACK_FRAME != 0
+#if WASM_ENABLE_AOT_STACK_FRAME != 0 || WASM_ENABLE_GC != 0 \
+    || WASM_ENABLE_MEMORY64 != 0
     uint32 feature_flags;
 #endif
 } AOTModule;
@@ -732,6 +749,11 @@ bool
 aot_data_drop(AOTModuleInstance *module_inst, uint32 seg_index);
 #endif
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+bool
+aot_memory_discard(AOTModuleInstance *module_inst, uint64 addr, uint64 len);
+#endif
+
 #if WASM_ENABLE_THREAD_MGR != 0
 bool
 aot_set_aux_stack(WASMExecEnv *exec_env, uint64 start_offset, uint32 size);
@@ -788,8 +810,21 @@ uint32
 aot_copy_callstack(WASMExecEnv *exec_env, WASMCApiFrame *buffer,
                    const uint32 length, const uint32 skip_n, char *error_buf,
                    uint32_t error_buf_size);
+
+/* Also used for the frames of LLVM JIT code */
+uint32
+aot_copy_callstack_standard_frame(WASMExecEnv *exec_env, WASMCApiFrame *buffer,
+                                  const uint32 length, const uint32 skip_n,
+                                  char *error_buf, uint32_t error_buf_size);
 #endif // WASM_ENABLE_COPY_CALL_STACK
 
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+/* Get the function name, NULL if it isn't found or the index is invalid */
+const char *
+aot_get_func_name_by_index(const AOTModuleInstance *module_inst,
+                           uint32 func_index);
+#endif
+
 /**
  * @brief Dump wasm call stack or get the size
  *
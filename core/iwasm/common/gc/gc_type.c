@@ -4,6 +4,7 @@
  */
 
 #include "gc_type.h"
+#include "gc_object.h"
 
 void
 wasm_dump_value_type(uint8 type, const WASMRefType *ref_type)
@@ -377,6 +378,58 @@ wasm_struct_type_equal(const WASMStructType *type1, const WASMStructType *type2,
     return true;
 }
 
+void
+wasm_struct_type_set_layout(WASMStructType *type,
+                            const WASMStructType *parent_type,
+                            bool sort_by_size)
+{
+    static const uint8 field_sizes[] = { 16, 8, 4, 2, 1 };
+    uint16 *reference_table = type->reference_table + 1;
+    uint32 offset = (uint32)offsetof(WASMStructObject, field_data);
+    uint32 inherited_count = 0, pass_count, field_size, i, j;
+
+    if (parent_type && parent_type->field_count <= type->field_count) {
+        for (i = 0; i < parent_type->field_count; i++) {
+            if (type->fields[i].field_size != parent_type->fields[i].field_size)
+                break;
+        }
+        /* otherwise type isn't a valid subtype, which is rejected later */
+        if (i == parent_type->field_count) {
+            for (i = 0; i < parent_type->field_count; i++)
+                type->fields[i].field_offset =
+                    parent_type->fields[i].field_offset;
+            inherited_count = parent_type->field_count;
+            offset = parent_type->total_size;
+        }
+    }
+
+    pass_count = sort_by_size ? sizeof(field_sizes) : 1;
+    for (i = 0; i < pass_count; i++) {
+        for (j = inherited_count; j < type->field_count; j++) {
+            field_size = type->fields[j].field_size;
+            if (sort_by_size && field_size != field_sizes[i])
+                continue;
+#if !(defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
+      || defined(BUILD_TARGET_X86_32))
+            if (field_size == 2)
+                offset = align_uint(offset, 2);
+            else if (field_size >= 4) /* field size is 4, 8 or 16 */
+                offset = align_uint(offset, 4);
+#endif
+            type->fields[j].field_offset = offset;
+            offset += field_size;
+        }
+    }
+    type->total_size = offset;
+
+    for (i = 0; i < type->field_count; i++) {
+        if (wasm_is_type_reftype(type->fields[i].field_type))
+            *reference_table++ = (uint16)type->fields[i].field_offset;
+    }
+    bh_assert(reference_table
+              == type->reference_table + 1 + type->reference_table[0]);
+}
+
 bool
 wasm_array_type_equal(const WASMArrayType *type1, const WASMArrayType *type2,
                       const WASMTypePtr *types, uint32 type_count)
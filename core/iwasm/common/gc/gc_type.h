@@ -74,6 +74,19 @@ wasm_struct_type_is_subtype_of(const WASMStructType *type1,
                                const WASMStructType *type2,
                                const WASMTypePtr *types, uint32 type_count);
 
+/**
+ * Set the field offsets, the reference table and the total size of a
+ * struct type whose field sizes have been set. The fields inherited from
+ * the parent type keep their offsets in the parent type, so an object
+ * can be accessed as the parent type. The other fields are placed after
+ * them in descending order of field size if sort_by_size is true, which
+ * leaves no padding between fields, or in declaration order otherwise.
+ */
+void
+wasm_struct_type_set_layout(WASMStructType *type,
+                            const WASMStructType *parent_type,
+                            bool sort_by_size);
+
 /* Operations of array type */
 
 /* Whether two array types are equal */
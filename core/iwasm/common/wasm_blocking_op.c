@@ -8,6 +8,9 @@
 #include "bh_platform.h"
 #include "bh_common.h"
 #include "bh_assert.h"
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+#include "../libraries/task-scheduler/task_scheduler.h"
+#endif
 
 #if WASM_ENABLE_THREAD_MGR != 0 && defined(OS_ENABLE_WAKEUP_BLOCKING_OP)
 
@@ -25,6 +28,10 @@
 bool
 wasm_runtime_begin_blocking_op(wasm_exec_env_t env)
 {
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    WASMTask *task;
+#endif
+
     LOCK(env);
     bh_assert(!ISSET(env, BLOCKING));
     SET(env, BLOCKING);
@@ -35,6 +42,10 @@ wasm_runtime_begin_blocking_op(wasm_exec_env_t env)
     }
     UNLOCK(env);
     os_begin_blocking_op();
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    if ((task = wasm_task_get_current()))
+        wasm_task_begin_blocking(task);
+#endif
     return true;
 }
 
@@ -42,11 +53,19 @@ void
 wasm_runtime_end_blocking_op(wasm_exec_env_t env)
 {
     int saved_errno = errno;
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    WASMTask *task;
+#endif
+
     LOCK(env);
     bh_assert(ISSET(env, BLOCKING));
     CLR(env, BLOCKING);
     UNLOCK(env);
     os_end_blocking_op();
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    if ((task = wasm_task_get_current()))
+        wasm_task_end_blocking(task);
+#endif
     errno = saved_errno;
 }
 
@@ -82,11 +101,27 @@ wasm_runtime_interrupt_blocking_op(wasm_exec_env_t env)
 bool
 wasm_runtime_begin_blocking_op(wasm_exec_env_t env)
 {
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    WASMTask *task;
+
+    if ((task = wasm_task_get_current()))
+        wasm_task_begin_blocking(task);
+#endif
     return true;
 }
 
 void
 wasm_runtime_end_blocking_op(wasm_exec_env_t env)
-{}
+{
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    WASMTask *task;
+    int saved_errno = errno;
+
+    if ((task = wasm_task_get_current())) {
+        wasm_task_end_blocking(task);
+        errno = saved_errno;
+    }
+#endif
+}
 
 #endif /* WASM_ENABLE_THREAD_MGR && OS_ENABLE_WAKEUP_BLOCKING_OP */
@@ -48,6 +48,13 @@ typedef struct wasm_module_ex_t {
     uint32 ref_count;
 #if WASM_ENABLE_WASM_CACHE != 0
     char hash[SHA256_DIGEST_LENGTH];
+    /* whether it is indexed by the module cache of the engine */
+    bool cached;
+    /* the binary size accounted by the module cache */
+    uint64 cache_size;
+    /* the list of the idle modules in the module cache */
+    struct wasm_module_ex_t *idle_prev;
+    struct wasm_module_ex_t *idle_next;
 #endif
 } wasm_module_ex_t;
 
@@ -64,6 +71,11 @@ wasm_module_delete_internal(wasm_module_t *);
 static void
 wasm_instance_delete_internal(wasm_instance_t *);
 
+#if WASM_ENABLE_WASM_CACHE != 0
+static void
+module_cache_destroy(wasm_engine_t *engine);
+#endif
+
 /* temporarily put stubs here */
 static wasm_store_t *
 wasm_store_copy(const wasm_store_t *src)
@@ -347,6 +359,37 @@ wasm_config_set_segue_flags(wasm_config_t *config, uint32 segue_flags)
     return config;
 }
 
+wasm_config_t *
+wasm_config_set_module_cache_budget(wasm_config_t *config, uint64_t budget)
+{
+    if (!config)
+        return NULL;
+
+    config->module_cache_budget = budget;
+    return config;
+}
+
+#if WASM_ENABLE_WASM_CACHE != 0
+/* The bucket count of the module cache, which doesn't grow */
+#define MODULE_CACHE_HASH_MAP_SIZE 1024
+
+static uint32
+module_cache_hash(const void *key)
+{
+    uint32 hash;
+
+    /* the digest is uniformly distributed, any part of it will do */
+    bh_memcpy_s(&hash, sizeof(hash), key, sizeof(hash));
+    return hash;
+}
+
+static bool
+module_cache_key_equal(void *key1, void *key2)
+{
+    return memcmp(key1, key2, SHA256_DIGEST_LENGTH) == 0;
+}
+#endif /* WASM_ENABLE_WASM_CACHE != 0 */
+
 static void
 wasm_engine_delete_internal(wasm_engine_t *engine)
 {
@@ -354,6 +397,13 @@ wasm_engine_delete_internal(wasm_engine_t *engine)
         /* clean all created wasm_module_t and their locks */
         unsigned i;
 
+#if WASM_ENABLE_WASM_CACHE != 0
+        /* unload the modules kept in the cache */
+        if (engine->module_cache)
+            module_cache_destroy(engine);
+#endif
+
+        /* the modules which are still used by a store */
         for (i = 0; i < engine->modules.num_elems; i++) {
             wasm_module_ex_t *module;
             if (bh_vector_get(&engine->modules, i, &module)) {
@@ -363,6 +413,7 @@ wasm_engine_delete_internal(wasm_engine_t *engine)
         }
 
         bh_vector_destroy(&engine->modules);
+        os_mutex_destroy(&engine->modules_lock);
 
 #ifndef os_thread_local_attribute
         bh_vector_destroy(&engine->stores_by_tid);
@@ -413,6 +464,12 @@ wasm_engine_new_internal(wasm_config_t *config)
         goto failed;
     }
 
+    if (os_mutex_init(&engine->modules_lock) != BHT_OK) {
+        wasm_runtime_free(engine);
+        engine = NULL;
+        goto failed;
+    }
+
     if (!bh_vector_init(&engine->modules, DEFAULT_VECTOR_INIT_SIZE,
                         sizeof(wasm_module_ex_t *), true))
         goto failed;
@@ -423,6 +480,20 @@ wasm_engine_new_internal(wasm_config_t *config)
         goto failed;
 #endif
 
+#if WASM_ENABLE_WASM_CACHE != 0
+    if (os_mutex_init(&engine->module_cache_lock) != BHT_OK)
+        goto failed;
+
+    if (!(engine->module_cache = bh_hash_map_create(
+              MODULE_CACHE_HASH_MAP_SIZE, false, module_cache_hash,
+              module_cache_key_equal, NULL, NULL))) {
+        os_mutex_destroy(&engine->module_cache_lock);
+        goto failed;
+    }
+
+    engine->module_cache_budget = config->module_cache_budget;
+#endif
+
     engine->ref_count = 1;
 
     WASM_C_DUMP_PROC_MEM();
@@ -475,6 +546,29 @@ wasm_engine_new_with_config(wasm_config_t *config)
     return singleton_engine;
 }
 
+bool
+wasm_engine_get_module_cache_stats(wasm_engine_t *engine,
+                                   wasm_module_cache_stats_t *stats)
+{
+#if WASM_ENABLE_WASM_CACHE != 0
+    if (!engine || !stats)
+        return false;
+
+    os_mutex_lock(&engine->module_cache_lock);
+    stats->hits = engine->module_cache_hits;
+    stats->misses = engine->module_cache_misses;
+    stats->evictions = engine->module_cache_evictions;
+    stats->module_count = engine->module_cache_count;
+    stats->size = engine->module_cache_size;
+    os_mutex_unlock(&engine->module_cache_lock);
+    return true;
+#else
+    (void)engine;
+    (void)stats;
+    return false;
+#endif
+}
+
 own wasm_engine_t *
 wasm_engine_new_with_args(mem_alloc_type_t type, const MemAllocOption *opts)
 {
@@ -2192,53 +2286,179 @@ module_to_module_ext(wasm_module_t *module)
 #define MODULE_AOT(module_comm) ((AOTModule *)(*module_comm))
 #endif
 
+/* Unload the module once it isn't used, the caller holds its lock */
+static void
+module_ext_release(wasm_module_ex_t *module_ex)
+{
+    if (module_ex->is_binary_cloned)
+        DEINIT_VEC(module_ex->binary, wasm_byte_vec_delete);
+
+    if (module_ex->module_comm_rt) {
+        wasm_runtime_unload(module_ex->module_comm_rt);
+        module_ex->module_comm_rt = NULL;
+    }
+
 #if WASM_ENABLE_WASM_CACHE != 0
-static wasm_module_ex_t *
-check_loaded_module(Vector *modules, char *binary_hash)
+    memset(module_ex->hash, 0, sizeof(module_ex->hash));
+#endif
+}
+
+/* Remove a released module from the engine and free it, the caller must
+   not hold its lock */
+static void
+module_ext_free(wasm_engine_t *engine, wasm_module_ex_t *module_ex)
 {
-    unsigned i;
-    wasm_module_ex_t *module = NULL;
+    wasm_module_ex_t *module;
+    uint32 i;
 
-    for (i = 0; i < modules->num_elems; i++) {
-        bh_vector_get(modules, i, &module);
-        if (!module) {
-            LOG_ERROR("Unexpected failure at %d\n", __LINE__);
-            return NULL;
+    os_mutex_lock(&engine->modules_lock);
+    for (i = 0; i < engine->modules.num_elems; i++) {
+        if (bh_vector_get(&engine->modules, i, &module)
+            && module == module_ex) {
+            bh_vector_remove(&engine->modules, i, NULL);
+            break;
         }
+    }
+    os_mutex_unlock(&engine->modules_lock);
 
-        if (!module->ref_count)
-            /* deleted */
-            continue;
+    os_mutex_destroy(&module_ex->lock);
+    wasm_runtime_free(module_ex);
+}
 
-        if (memcmp(module->hash, binary_hash, SHA256_DIGEST_LENGTH) == 0)
-            return module;
+#if WASM_ENABLE_WASM_CACHE != 0
+/*
+ * The module cache of the engine indexes the loaded modules by the digest
+ * of their binaries. A cached module which isn't used by any store is idle,
+ * it is kept loaded if its binary is cloned, and the idle modules are
+ * unloaded from the least recently used one whenever the total binary size
+ * of the cached modules exceeds the budget. The cache lock must be taken
+ * before the lock of a module.
+ */
+
+static void
+module_cache_idle_append(wasm_engine_t *engine, wasm_module_ex_t *module_ex)
+{
+    module_ex->idle_prev = engine->idle_modules_tail;
+    module_ex->idle_next = NULL;
+    if (engine->idle_modules_tail)
+        engine->idle_modules_tail->idle_next = module_ex;
+    else
+        engine->idle_modules_head = module_ex;
+    engine->idle_modules_tail = module_ex;
+}
+
+static void
+module_cache_idle_remove(wasm_engine_t *engine, wasm_module_ex_t *module_ex)
+{
+    if (module_ex->idle_prev)
+        module_ex->idle_prev->idle_next = module_ex->idle_next;
+    else
+        engine->idle_modules_head = module_ex->idle_next;
+    if (module_ex->idle_next)
+        module_ex->idle_next->idle_prev = module_ex->idle_prev;
+    else
+        engine->idle_modules_tail = module_ex->idle_prev;
+    module_ex->idle_prev = module_ex->idle_next = NULL;
+}
+
+static void
+module_cache_remove(wasm_engine_t *engine, wasm_module_ex_t *module_ex)
+{
+    bh_hash_map_remove(engine->module_cache, module_ex->hash, NULL, NULL);
+    engine->module_cache_size -= module_ex->cache_size;
+    engine->module_cache_count--;
+    module_ex->cached = false;
+}
+
+static void
+module_cache_evict(wasm_engine_t *engine)
+{
+    wasm_module_ex_t *module_ex;
+
+    while (engine->module_cache_size > engine->module_cache_budget
+           && (module_ex = engine->idle_modules_head)) {
+        module_cache_idle_remove(engine, module_ex);
+        module_cache_remove(engine, module_ex);
+
+        os_mutex_lock(&module_ex->lock);
+        module_ext_release(module_ex);
+        os_mutex_unlock(&module_ex->lock);
+        module_ext_free(engine, module_ex);
+
+        engine->module_cache_evictions++;
     }
-    return NULL;
+}
+
+static void
+module_cache_insert(wasm_engine_t *engine, wasm_module_ex_t *module_ex,
+                    uint64 binary_size)
+{
+    os_mutex_lock(&engine->module_cache_lock);
+
+    /* the same binary may have been loaded by another thread meanwhile,
+       then this module isn't cached */
+    if (!bh_hash_map_find(engine->module_cache, module_ex->hash)
+        && bh_hash_map_insert(engine->module_cache, module_ex->hash,
+                              module_ex)) {
+        module_ex->cached = true;
+        module_ex->cache_size = binary_size;
+        engine->module_cache_size += binary_size;
+        engine->module_cache_count++;
+        module_cache_evict(engine);
+    }
+
+    os_mutex_unlock(&engine->module_cache_lock);
+}
+
+static void
+module_cache_destroy(wasm_engine_t *engine)
+{
+    wasm_module_ex_t *module_ex;
+
+    while ((module_ex = engine->idle_modules_head)) {
+        module_cache_idle_remove(engine, module_ex);
+        module_cache_remove(engine, module_ex);
+        module_ext_release(module_ex);
+        module_ext_free(engine, module_ex);
+    }
+
+    bh_hash_map_destroy(engine->module_cache);
+    engine->module_cache = NULL;
+    os_mutex_destroy(&engine->module_cache_lock);
 }
 
 static wasm_module_ex_t *
 try_reuse_loaded_module(wasm_store_t *store, char *binary_hash)
 {
+    wasm_engine_t *engine = singleton_engine;
     wasm_module_ex_t *cached = NULL;
     wasm_module_ex_t *ret = NULL;
 
-    cached = check_loaded_module(&singleton_engine->modules, binary_hash);
-    if (!cached)
+    os_mutex_lock(&engine->module_cache_lock);
+
+    cached = bh_hash_map_find(engine->module_cache, binary_hash);
+    if (!cached) {
+        engine->module_cache_misses++;
         goto quit;
+    }
 
     os_mutex_lock(&cached->lock);
-    if (!cached->ref_count)
-        goto unlock;
 
     if (!bh_vector_append((Vector *)store->modules, &cached))
         goto unlock;
 
+    if (cached->ref_count == 0)
+        /* idle */
+        module_cache_idle_remove(engine, cached);
+
     cached->ref_count += 1;
+    engine->module_cache_hits++;
     ret = cached;
 
 unlock:
     os_mutex_unlock(&cached->lock);
 quit:
+    os_mutex_unlock(&engine->module_cache_lock);
     return ret;
 }
 #endif /* WASM_ENABLE_WASM_CACHE != 0 */
@@ -2325,13 +2545,14 @@ wasm_module_new_ex(wasm_store_t *store, wasm_byte_vec_t *binary, LoadArgs *args)
     if (!bh_vector_append(&singleton_engine->modules, &module_ex))
         goto destroy_lock;
 
+    module_ex->ref_count = 1;
+
 #if WASM_ENABLE_WASM_CACHE != 0
     bh_memcpy_s(module_ex->hash, sizeof(module_ex->hash), binary_hash,
                 sizeof(binary_hash));
+    module_cache_insert(singleton_engine, module_ex, binary->size);
 #endif
 
-    module_ex->ref_count = 1;
-
     WASM_C_DUMP_PROC_MEM();
 
     return module_ext_to_module(module_ex);
@@ -2405,6 +2626,9 @@ static void
 wasm_module_delete_internal(wasm_module_t *module)
 {
     wasm_module_ex_t *module_ex;
+#if WASM_ENABLE_WASM_CACHE != 0
+    wasm_engine_t *engine;
+#endif
 
     if (!module) {
         return;
@@ -2412,28 +2636,46 @@ wasm_module_delete_internal(wasm_module_t *module)
 
     module_ex = module_to_module_ext(module);
 
+#if WASM_ENABLE_WASM_CACHE != 0
+    engine = singleton_engine;
+    os_mutex_lock(&engine->module_cache_lock);
+#endif
     os_mutex_lock(&module_ex->lock);
 
     /* N -> N-1 -> 0 -> UINT32_MAX */
     module_ex->ref_count--;
-    if (module_ex->ref_count > 0) {
-        os_mutex_unlock(&module_ex->lock);
-        return;
-    }
+    if (module_ex->ref_count > 0)
+        goto unlock;
 
-    if (module_ex->is_binary_cloned)
-        DEINIT_VEC(module_ex->binary, wasm_byte_vec_delete);
+#if WASM_ENABLE_WASM_CACHE != 0
+    if (module_ex->cached) {
+        if (module_ex->is_binary_cloned) {
+            /* keep it loaded for the modules created later with the same
+               binary, unless the cache is out of budget */
+            module_cache_idle_append(engine, module_ex);
+            os_mutex_unlock(&module_ex->lock);
+            module_cache_evict(engine);
+            os_mutex_unlock(&engine->module_cache_lock);
+            return;
+        }
 
-    if (module_ex->module_comm_rt) {
-        wasm_runtime_unload(module_ex->module_comm_rt);
-        module_ex->module_comm_rt = NULL;
+        module_cache_remove(engine, module_ex);
     }
+#endif
 
+    module_ext_release(module_ex);
+    os_mutex_unlock(&module_ex->lock);
 #if WASM_ENABLE_WASM_CACHE != 0
-    memset(module_ex->hash, 0, sizeof(module_ex->hash));
+    os_mutex_unlock(&engine->module_cache_lock);
 #endif
+    module_ext_free(singleton_engine, module_ex);
+    return;
 
+unlock:
     os_mutex_unlock(&module_ex->lock);
+#if WASM_ENABLE_WASM_CACHE != 0
+    os_mutex_unlock(&engine->module_cache_lock);
+#endif
 }
 
 void
@@ -2857,7 +3099,47 @@ failed_exporttype_new:
     wasm_exporttype_vec_delete(out);
 }
 
-#if WASM_ENABLE_JIT == 0 || WASM_ENABLE_LAZY_JIT != 0
+#if WASM_ENABLE_PREPARED_MODULE != 0
+void
+wasm_module_serialize(wasm_module_t *module, own wasm_byte_vec_t *out)
+{
+    wasm_module_ex_t *module_ex;
+    char error_buf[128] = { 0 };
+    uint8 *prepared;
+    uint32 prepared_size;
+
+    if (!module || !out)
+        return;
+
+    if (((const wasm_module_ex_t *)(module))->ref_count == 0)
+        return;
+
+    /* the binary is loaded again to generate the prepared module */
+    module_ex = module_to_module_ext(module);
+    if (!module_ex->binary || !module_ex->binary->data) {
+        LOG_ERROR("the binary of the module isn't available");
+        return;
+    }
+
+    if (!(prepared = wasm_runtime_prepare_module(
+              (uint8 *)module_ex->binary->data,
+              (uint32)module_ex->binary->size, &prepared_size, error_buf,
+              (uint32)sizeof(error_buf)))) {
+        LOG_ERROR("%s", error_buf);
+        return;
+    }
+
+    wasm_byte_vec_new(out, prepared_size, (wasm_byte_t *)prepared);
+    wasm_runtime_free(prepared);
+}
+
+own wasm_module_t *
+wasm_module_deserialize(wasm_store_t *store, const wasm_byte_vec_t *binary)
+{
+    /* the prepared code isn't validated, so it isn't used by default */
+    return wasm_module_new(store, binary);
+}
+#elif WASM_ENABLE_JIT == 0 || WASM_ENABLE_LAZY_JIT != 0
 void
 wasm_module_serialize(wasm_module_t *module, own wasm_byte_vec_t *out)
 {
@@ -8,6 +8,9 @@
 
 #include "../include/wasm_c_api.h"
 #include "wasm_runtime_common.h"
+#if WASM_ENABLE_WASM_CACHE != 0
+#include "bh_hashmap.h"
+#endif
 
 #ifndef own
 #define own
@@ -28,8 +31,27 @@ struct wasm_engine_t {
     uint32 ref_count;
     /* list of wasm_module_ex_t */
     Vector modules;
+    /* protects the lookup and removal of a module in the list */
+    korp_mutex modules_lock;
     /* list of stores which are classified according to tids */
     Vector stores_by_tid;
+#if WASM_ENABLE_WASM_CACHE != 0
+    /* the cached wasm_module_ex_t, indexed by the SHA-256 digest of
+       their binaries */
+    HashMap *module_cache;
+    /* the cached modules which aren't used by any store, from the least
+       recently used to the most recently used */
+    struct wasm_module_ex_t *idle_modules_head;
+    struct wasm_module_ex_t *idle_modules_tail;
+    /* the total binary size of the cached modules and its limit */
+    uint64 module_cache_size;
+    uint64 module_cache_budget;
+    uint32 module_cache_count;
+    uint64 module_cache_hits;
+    uint64 module_cache_misses;
+    uint64 module_cache_evictions;
+    korp_mutex module_cache_lock;
+#endif
 };
 
 struct wasm_store_t {
@@ -26,6 +26,28 @@
 #endif
 #endif
 
+#if WASM_ENABLE_NUMA != 0
+/* Bind the wasm stack to the NUMA node of the instance, only the pages
+   fully covered by the stack are bound as the others are shared with the
+   neighbouring allocations */
+static void
+bind_wasm_stack_numa_node(WASMExecEnv *exec_env)
+{
+    int32 numa_node = wasm_runtime_get_numa_node(exec_env->module_inst);
+    uintptr_t page_size = (uintptr_t)os_getpagesize();
+    uintptr_t start = ((uintptr_t)exec_env->wasm_stack.bottom + page_size - 1)
+                      & ~(page_size - 1);
+    uintptr_t end =
+        (uintptr_t)exec_env->wasm_stack.top_boundary & ~(page_size - 1);
+
+    if (numa_node >= 0 && start < end
+        && os_mbind((void *)start, end - start, (int)numa_node) != 0) {
+        LOG_WARNING("Bind wasm stack %p to NUMA node %" PRId32 " failed",
+                    (void *)start, numa_node);
+    }
+}
+#endif
+
 WASMExecEnv *
 wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
                               uint32 stack_size)
@@ -73,6 +95,10 @@ wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
         exec_env->wasm_stack.bottom + stack_size;
     exec_env->wasm_stack.top = exec_env->wasm_stack.bottom;
 
+#if WASM_ENABLE_NUMA != 0
+    bind_wasm_stack_numa_node(exec_env);
+#endif
+
 #if WASM_ENABLE_AOT != 0
     if (module_inst->module_type == Wasm_Module_AoT) {
         AOTModuleInstance *i = (AOTModuleInstance *)module_inst;
@@ -89,6 +115,11 @@ wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
     exec_env->instructions_to_execute = -1;
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    exec_env->epoch_deadline = UINT64_MAX;
+    exec_env->epoch_ptr = wasm_runtime_get_epoch_ptr();
+#endif
+
     return exec_env;
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
@@ -87,11 +87,25 @@ typedef struct WASMExecEnv {
         uint8 *bottom;
     } wasm_stack;
 
-#if WASM_ENABLE_INSTRUCTION_METERING != 0
-    /* instructions to execute */
+#if WASM_ENABLE_INSTRUCTION_METERING != 0 \
+    || WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* instructions to execute, also used by AOT/JIT code which decreases
+       it by the instruction count of each basic block, don't change its
+       place */
     int instructions_to_execute;
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* The epoch deadline and the address of the global epoch counter,
+       also used by AOT/JIT code, don't change their places */
+    uint64 epoch_deadline;
+    uint64 *epoch_ptr;
+    /* Called when the deadline is reached */
+    bool (*epoch_deadline_callback)(struct WASMExecEnv *exec_env,
+                                    void *user_data);
+    void *epoch_deadline_user_data;
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0
     /**
      * Cache for
@@ -125,6 +139,11 @@ typedef struct WASMExecEnv {
 
     /* whether the aux stack is allocated */
     bool is_aux_stack_allocated;
+
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    /* the native thread of the cluster's thread pool running the thread */
+    struct WASMClusterWorker *worker;
+#endif
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_runtime_common.h"
+#include "bh_platform.h"
+
+#if WASM_ENABLE_LINUX_PERF != 0
+
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * The jitdump file read by `perf inject --jit`, see
+ * tools/perf/Documentation/jitdump-specification.txt of the linux kernel.
+ * perf finds the file by the executable mapping of it recorded in
+ * perf.data, and injects an ELF image with the symbol and the line table
+ * for each code load record. The timestamps must be taken from the clock
+ * used by `perf record -k mono`.
+ */
+
+#define JITDUMP_MAGIC 0x4A695444
+#define JITDUMP_VERSION 1
+
+/* perf prepends an ELF header to the code of the injected image, the
+   addresses of the line table entries must be adjusted for it */
+#define JITDUMP_ELF_HEADER_SIZE 0x40
+
+#if defined(__x86_64__)
+#define JITDUMP_ELF_MACH EM_X86_64
+#elif defined(__i386__)
+#define JITDUMP_ELF_MACH EM_386
+#elif defined(__aarch64__)
+#define JITDUMP_ELF_MACH EM_AARCH64
+#elif defined(__arm__)
+#define JITDUMP_ELF_MACH EM_ARM
+#elif defined(__riscv)
+#define JITDUMP_ELF_MACH EM_RISCV
+#elif defined(__mips__)
+#define JITDUMP_ELF_MACH EM_MIPS
+#else
+#define JITDUMP_ELF_MACH EM_NONE
+#endif
+
+enum {
+    JIT_CODE_LOAD = 0,
+    JIT_CODE_MOVE = 1,
+    JIT_CODE_DEBUG_INFO = 2,
+    JIT_CODE_CLOSE = 3,
+};
+
+typedef struct JitDumpHeader {
+    uint32 magic;
+    uint32 version;
+    uint32 total_size;
+    uint32 elf_mach;
+    uint32 pad1;
+    uint32 pid;
+    uint64 timestamp;
+    uint64 flags;
+} JitDumpHeader;
+
+typedef struct JitDumpRecordHeader {
+    uint32 id;
+    uint32 total_size;
+    uint64 timestamp;
+} JitDumpRecordHeader;
+
+typedef struct JitDumpCodeLoad {
+    JitDumpRecordHeader header;
+    uint32 pid;
+    uint32 tid;
+    uint64 vma;
+    uint64 code_addr;
+    uint64 code_size;
+    uint64 code_index;
+    /* Followed by the NUL terminated name and the native code */
+} JitDumpCodeLoad;
+
+typedef struct JitDumpDebugInfo {
+    JitDumpRecordHeader header;
+    uint64 code_addr;
+    uint64 nr_entry;
+    /* Followed by the entries */
+} JitDumpDebugInfo;
+
+typedef struct JitDumpDebugEntry {
+    uint64 code_addr;
+    uint32 line;
+    uint32 discrim;
+    /* Followed by the NUL terminated file name */
+} JitDumpDebugEntry;
+
+typedef struct JitDump {
+    FILE *file;
+    /* The executable mapping of the file which perf looks for */
+    void *marker;
+    uint32 marker_size;
+    uint32 pid;
+    uint64 code_index;
+    korp_mutex lock;
+} JitDump;
+
+static JitDump jitdump;
+
+static uint64
+jitdump_timestamp(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64)ts.tv_sec * 1000000000ULL + (uint64)ts.tv_nsec;
+}
+
+bool
+wasm_jitdump_init(void)
+{
+    char path[256];
+    const char *dir = getenv("JITDUMPDIR");
+    JitDumpHeader header = { 0 };
+    int fd;
+
+    bh_assert(!jitdump.file);
+
+    jitdump.pid = (uint32)getpid();
+    (void)snprintf(path, sizeof(path), "%s/jit-%" PRIu32 ".dump",
+                   dir ? dir : "/tmp", jitdump.pid);
+    if ((fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0666)) < 0) {
+        LOG_WARNING("warning: can't create %s, because %s", path,
+                    strerror(errno));
+        return false;
+    }
+
+    jitdump.marker_size = (uint32)sysconf(_SC_PAGESIZE);
+    jitdump.marker = mmap(NULL, jitdump.marker_size, PROT_READ | PROT_EXEC,
+                          MAP_PRIVATE, fd, 0);
+    if (jitdump.marker == MAP_FAILED) {
+        LOG_WARNING("warning: can't map %s, because %s", path,
+                    strerror(errno));
+        goto fail1;
+    }
+
+    if (!(jitdump.file = fdopen(fd, "w+"))) {
+        LOG_WARNING("warning: can't open %s, because %s", path,
+                    strerror(errno));
+        goto fail2;
+    }
+
+    if (os_mutex_init(&jitdump.lock) != 0)
+        goto fail3;
+
+    header.magic = JITDUMP_MAGIC;
+    header.version = JITDUMP_VERSION;
+    header.total_size = sizeof(JitDumpHeader);
+    header.elf_mach = JITDUMP_ELF_MACH;
+    header.pid = jitdump.pid;
+    header.timestamp = jitdump_timestamp();
+    (void)fwrite(&header, sizeof(header), 1, jitdump.file);
+    (void)fflush(jitdump.file);
+
+    LOG_VERBOSE("write jitdump records into %s", path);
+    return true;
+
+fail3:
+    (void)fclose(jitdump.file);
+    jitdump.file = NULL;
+    fd = -1;
+fail2:
+    (void)munmap(jitdump.marker, jitdump.marker_size);
+fail1:
+    if (fd >= 0)
+        (void)close(fd);
+    return false;
+}
+
+void
+wasm_jitdump_destroy(void)
+{
+    JitDumpRecordHeader close_record;
+
+    if (!jitdump.file)
+        return;
+
+    close_record.id = JIT_CODE_CLOSE;
+    close_record.total_size = sizeof(close_record);
+    close_record.timestamp = jitdump_timestamp();
+    (void)fwrite(&close_record, sizeof(close_record), 1, jitdump.file);
+
+    (void)fclose(jitdump.file);
+    (void)munmap(jitdump.marker, jitdump.marker_size);
+    os_mutex_destroy(&jitdump.lock);
+    memset(&jitdump, 0, sizeof(jitdump));
+}
+
+static void
+write_debug_info(const void *code, const WASMJitDumpLine *lines,
+                 uint32 line_count, uint64 timestamp)
+{
+    JitDumpDebugInfo debug_info;
+    JitDumpDebugEntry entry;
+    const char *file_name = WASM_JITDUMP_LINE_FILE_NAME;
+    uint32 entry_size = (uint32)(sizeof(entry) + strlen(file_name) + 1), i;
+
+    debug_info.header.id = JIT_CODE_DEBUG_INFO;
+    debug_info.header.total_size =
+        (uint32)sizeof(debug_info) + entry_size * line_count;
+    debug_info.header.timestamp = timestamp;
+    debug_info.code_addr = (uint64)(uintptr_t)code;
+    debug_info.nr_entry = line_count;
+    (void)fwrite(&debug_info, sizeof(debug_info), 1, jitdump.file);
+
+    for (i = 0; i < line_count; i++) {
+        entry.code_addr =
+            (uint64)(uintptr_t)lines[i].code_addr + JITDUMP_ELF_HEADER_SIZE;
+        entry.line = lines[i].bytecode_offset;
+        entry.discrim = 0;
+        (void)fwrite(&entry, sizeof(entry), 1, jitdump.file);
+        (void)fwrite(file_name, strlen(file_name) + 1, 1, jitdump.file);
+    }
+}
+
+void
+wasm_jitdump_code_load(const char *name, const void *code, uint32 code_size,
+                       const WASMJitDumpLine *lines, uint32 line_count)
+{
+    JitDumpCodeLoad code_load;
+    uint32 name_size = (uint32)strlen(name) + 1;
+
+    if (!jitdump.file)
+        return;
+
+    os_mutex_lock(&jitdump.lock);
+
+    code_load.header.id = JIT_CODE_LOAD;
+    code_load.header.total_size =
+        (uint32)sizeof(code_load) + name_size + code_size;
+    code_load.header.timestamp = jitdump_timestamp();
+    code_load.pid = jitdump.pid;
+    code_load.tid = (uint32)syscall(SYS_gettid);
+    code_load.vma = code_load.code_addr = (uint64)(uintptr_t)code;
+    code_load.code_size = code_size;
+    /* Code reusing the memory of the freed code is reported by a new load
+       record, perf resolves the samples with the latest record before them,
+       so the index must be unique */
+    code_load.code_index = jitdump.code_index++;
+
+    /* The debug info is applied to the next code load record */
+    if (line_count > 0)
+        write_debug_info(code, lines, line_count,
+                         code_load.header.timestamp);
+
+    (void)fwrite(&code_load, sizeof(code_load), 1, jitdump.file);
+    (void)fwrite(name, name_size, 1, jitdump.file);
+    (void)fwrite(code, code_size, 1, jitdump.file);
+    (void)fflush(jitdump.file);
+
+    os_mutex_unlock(&jitdump.lock);
+}
+
+#endif /* end of WASM_ENABLE_LINUX_PERF != 0 */
@@ -33,6 +33,33 @@ static WASMSharedHeap *shared_heap_list = NULL;
 static korp_mutex shared_heap_list_lock;
 #endif
 
+#if WASM_ENABLE_THREAD_MGR != 0 && WASM_MEM_ALLOC_WITH_USAGE == 0
+/* A range of the linear memory to fault in with the prefault thread */
+typedef struct PrefaultRange {
+    struct PrefaultRange *next;
+    /* The mapping of the linear memory which the range belongs to */
+    uint8 *owner;
+    uint8 *addr;
+    uint64 size;
+} PrefaultRange;
+
+/* The background thread which faults in the linear memories with the
+   MEMORY_PREFAULT_POLICY_BACKGROUND policy, it is created when the first
+   range is queued */
+static korp_mutex prefault_lock;
+static korp_cond prefault_cond;
+/* Signaled when the prefault thread finishes the running range */
+static korp_cond prefault_done_cond;
+static korp_tid prefault_tid;
+static bool prefault_thread_created = false;
+static bool prefault_thread_exiting = false;
+static PrefaultRange *prefault_ranges = NULL;
+static PrefaultRange *prefault_ranges_tail = NULL;
+/* The range which the prefault thread is faulting in, the mapping it
+   belongs to isn't unmapped or moved until it is finished */
+static PrefaultRange *prefault_range_running = NULL;
+#endif
+
 static enlarge_memory_error_callback_t enlarge_memory_error_cb;
 static void *enlarge_memory_error_user_data;
 
@@ -771,6 +798,176 @@ wasm_runtime_shared_heap_free(WASMModuleInstanceCommon *module_inst, uint64 ptr)
 }
 #endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
 
+#if WASM_ENABLE_THREAD_MGR != 0 && WASM_MEM_ALLOC_WITH_USAGE == 0
+static void *
+prefault_thread_routine(void *arg)
+{
+    PrefaultRange *range;
+
+    (void)arg;
+
+    os_mutex_lock(&prefault_lock);
+    while (!prefault_thread_exiting) {
+        if (!(range = prefault_ranges)) {
+            os_cond_wait(&prefault_cond, &prefault_lock);
+            continue;
+        }
+        if (!(prefault_ranges = range->next))
+            prefault_ranges_tail = NULL;
+        prefault_range_running = range;
+        os_mutex_unlock(&prefault_lock);
+
+        /* The mapping of the range stays in place while it is running,
+           see cancel_prefault_in_background, otherwise the address may
+           be reused by another mapping, e.g. of a file, which the advice
+           would write fault */
+        if (os_madvise(range->addr, (size_t)range->size,
+                       MMAP_ADVICE_POPULATE_WRITE)
+            != 0) {
+            LOG_VERBOSE("Prefault linear memory %p of %" PRIu64
+                        " bytes failed",
+                        range->addr, range->size);
+        }
+
+        os_mutex_lock(&prefault_lock);
+        prefault_range_running = NULL;
+        os_cond_broadcast(&prefault_done_cond);
+        wasm_runtime_free(range);
+    }
+    os_mutex_unlock(&prefault_lock);
+
+    return NULL;
+}
+
+/* Queue a range of the linear memory to the prefault thread, return false
+   if it can't be queued */
+static bool
+prefault_in_background(uint8 *owner, uint8 *addr, uint64 size)
+{
+    PrefaultRange *range;
+    bool ret = false;
+
+    os_mutex_lock(&prefault_lock);
+
+    if (prefault_thread_exiting)
+        goto unlock;
+
+    if (prefault_ranges_tail && prefault_ranges_tail->owner == owner
+        && prefault_ranges_tail->addr + prefault_ranges_tail->size == addr) {
+        /* Merge it with the last range, e.g. when the memory grows page by
+           page faster than the pages are faulted in */
+        prefault_ranges_tail->size += size;
+        ret = true;
+        goto unlock;
+    }
+
+    if (!(range = wasm_runtime_malloc(sizeof(PrefaultRange))))
+        goto unlock;
+
+    if (!prefault_thread_created) {
+        if (os_thread_create(&prefault_tid, prefault_thread_routine, NULL,
+                             APP_THREAD_STACK_SIZE_DEFAULT)
+            != 0) {
+            LOG_WARNING("Create the prefault thread failed");
+            wasm_runtime_free(range);
+            goto unlock;
+        }
+        prefault_thread_created = true;
+    }
+
+    range->next = NULL;
+    range->owner = owner;
+    range->addr = addr;
+    range->size = size;
+    if (prefault_ranges_tail)
+        prefault_ranges_tail->next = range;
+    else
+        prefault_ranges = range;
+    prefault_ranges_tail = range;
+    os_cond_signal(&prefault_cond);
+    ret = true;
+
+unlock:
+    os_mutex_unlock(&prefault_lock);
+    return ret;
+}
+
+/* Remove the queued ranges of the mapping of a linear memory and wait for
+   the running one, must be called before the mapping is unmapped or moved */
+static void
+cancel_prefault_in_background(uint8 *owner)
+{
+    PrefaultRange *range, **p_range;
+
+    os_mutex_lock(&prefault_lock);
+
+    prefault_ranges_tail = NULL;
+    p_range = &prefault_ranges;
+    while ((range = *p_range)) {
+        if (range->owner == owner) {
+            *p_range = range->next;
+            wasm_runtime_free(range);
+        }
+        else {
+            prefault_ranges_tail = range;
+            p_range = &range->next;
+        }
+    }
+
+    while (prefault_range_running && prefault_range_running->owner == owner)
+        os_cond_wait(&prefault_done_cond, &prefault_lock);
+
+    os_mutex_unlock(&prefault_lock);
+}
+
+static bool
+init_prefault_thread(void)
+{
+    if (os_mutex_init(&prefault_lock) != 0)
+        return false;
+
+    if (os_cond_init(&prefault_cond) != 0) {
+        os_mutex_destroy(&prefault_lock);
+        return false;
+    }
+
+    if (os_cond_init(&prefault_done_cond) != 0) {
+        os_cond_destroy(&prefault_cond);
+        os_mutex_destroy(&prefault_lock);
+        return false;
+    }
+
+    return true;
+}
+
+static void
+destroy_prefault_thread(void)
+{
+    PrefaultRange *range;
+
+    os_mutex_lock(&prefault_lock);
+    prefault_thread_exiting = true;
+    os_cond_signal(&prefault_cond);
+    os_mutex_unlock(&prefault_lock);
+
+    if (prefault_thread_created) {
+        os_thread_join(prefault_tid, NULL);
+        prefault_thread_created = false;
+    }
+
+    while ((range = prefault_ranges)) {
+        prefault_ranges = range->next;
+        wasm_runtime_free(range);
+    }
+    prefault_ranges_tail = NULL;
+    prefault_thread_exiting = false;
+
+    os_cond_destroy(&prefault_done_cond);
+    os_cond_destroy(&prefault_cond);
+    os_mutex_destroy(&prefault_lock);
+}
+#endif /* end of WASM_ENABLE_THREAD_MGR != 0 && WASM_MEM_ALLOC_WITH_USAGE == 0 */
+
 bool
 wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
                          const MemAllocOption *alloc_option)
@@ -783,6 +980,27 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
     }
 #endif
 
+#if WASM_ENABLE_THREAD_MGR != 0 && WASM_MEM_ALLOC_WITH_USAGE == 0
+    if (!init_prefault_thread()) {
+#if WASM_ENABLE_SHARED_HEAP != 0
+        os_mutex_destroy(&shared_heap_list_lock);
+#endif
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_GC != 0
+    if (!mem_allocator_init_gc_markers()) {
+#if WASM_ENABLE_THREAD_MGR != 0 && WASM_MEM_ALLOC_WITH_USAGE == 0
+        destroy_prefault_thread();
+#endif
+#if WASM_ENABLE_SHARED_HEAP != 0
+        os_mutex_destroy(&shared_heap_list_lock);
+#endif
+        return false;
+    }
+#endif
+
     if (mem_alloc_type == Alloc_With_Pool) {
         ret = wasm_memory_init_with_pool(alloc_option->pool.heap_buf,
                                          alloc_option->pool.heap_size);
@@ -809,6 +1027,16 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
         os_mutex_destroy(&shared_heap_list_lock);
     }
 #endif
+#if WASM_ENABLE_THREAD_MGR != 0 && WASM_MEM_ALLOC_WITH_USAGE == 0
+    if (!ret) {
+        destroy_prefault_thread();
+    }
+#endif
+#if WASM_ENABLE_GC != 0
+    if (!ret) {
+        mem_allocator_destroy_gc_markers();
+    }
+#endif
 
     return ret;
 }
@@ -851,6 +1079,13 @@ wasm_runtime_memory_destroy(void)
 #if WASM_ENABLE_SHARED_HEAP != 0
     destroy_shared_heaps();
 #endif
+#if WASM_ENABLE_THREAD_MGR != 0 && WASM_MEM_ALLOC_WITH_USAGE == 0
+    destroy_prefault_thread();
+#endif
+#if WASM_ENABLE_GC != 0
+    /* The markers are allocated from the runtime's memory */
+    mem_allocator_destroy_gc_markers();
+#endif
 
     if (memory_mode == MEMORY_MODE_POOL) {
 #if BH_ENABLE_GC_VERIFY == 0
@@ -1398,8 +1633,13 @@ wasm_check_app_addr_and_convert(WASMModuleInstance *module_inst, bool is_str,
     }
 
     /* No need to check the app_offset and buf_size if memory access
-       boundary check with hardware trap is enabled */
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+       boundary check with hardware trap is enabled, except for memory64,
+       whose app_offset may be beyond the guard regions */
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    if (!memory_inst->is_memory64)
+        goto success;
+#endif
+
     SHARED_MEMORY_LOCK(memory_inst);
 
     if (app_buf_addr >= memory_inst->memory_data_size) {
@@ -1424,18 +1664,15 @@ wasm_check_app_addr_and_convert(WASMModuleInstance *module_inst, bool is_str,
     }
 
     SHARED_MEMORY_UNLOCK(memory_inst);
-#endif
 
 success:
     *p_native_addr = (void *)native_addr;
     return true;
 
-#ifndef OS_ENABLE_HW_BOUND_CHECK
 fail:
     SHARED_MEMORY_UNLOCK(memory_inst);
     wasm_set_exception(module_inst, "out of bounds memory access");
     return false;
-#endif
 }
 
 WASMMemoryInstance *
@@ -1455,6 +1692,50 @@ wasm_get_memory_with_idx(WASMModuleInstance *module_inst, uint32 index)
     return module_inst->memories[index];
 }
 
+uint64
+wasm_runtime_trim_app_heap(WASMModuleInstanceCommon *module_inst_comm)
+{
+    uint64 size = 0;
+#if WASM_ENABLE_HEAP_TRIM != 0
+    WASMMemoryInstance *memory_inst;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    memory_inst =
+        wasm_get_default_memory((WASMModuleInstance *)module_inst_comm);
+    if (memory_inst && memory_inst->heap_handle) {
+        /* the heap is moved if the memory is grown */
+        SHARED_MEMORY_LOCK(memory_inst);
+        size = mem_allocator_trim(memory_inst->heap_handle);
+        SHARED_MEMORY_UNLOCK(memory_inst);
+    }
+#else
+    (void)module_inst_comm;
+#endif
+    return size;
+}
+
+void
+wasm_runtime_set_app_heap_trim_threshold(
+    WASMModuleInstanceCommon *module_inst_comm, uint32 threshold)
+{
+#if WASM_ENABLE_HEAP_TRIM != 0
+    WASMMemoryInstance *memory_inst;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    memory_inst =
+        wasm_get_default_memory((WASMModuleInstance *)module_inst_comm);
+    if (memory_inst && memory_inst->heap_handle)
+        mem_allocator_set_trim_threshold(memory_inst->heap_handle, threshold);
+#else
+    (void)module_inst_comm;
+    (void)threshold;
+#endif
+}
+
 void
 wasm_runtime_set_mem_bound_check_bytes(WASMMemoryInstance *memory,
                                        uint64 memory_data_size)
@@ -1476,6 +1757,156 @@ wasm_runtime_set_mem_bound_check_bytes(WASMMemoryInstance *memory,
 #endif
 }
 
+#if WASM_MEM_ALLOC_WITH_USAGE == 0
+/* Size of the huge pages which back the linear memory */
+#define LINEAR_MEMORY_HUGE_PAGE_SIZE (2 * (uint64)BH_MB)
+
+/**
+ * Get the size to map for the linear memory which is bound checked by
+ * software, it is mapped in the granularity of huge pages when it should
+ * be backed with huge pages, so that the last huge page can be backed
+ * too and the growth within it doesn't remap the memory
+ */
+static uint64
+wasm_get_linear_memory_map_size(uint64 memory_data_size,
+                                uint8 huge_page_policy)
+{
+    if (huge_page_policy == HUGE_PAGE_POLICY_THP
+        || huge_page_policy == HUGE_PAGE_POLICY_HUGETLB)
+        return align_as_and_cast(memory_data_size,
+                                 LINEAR_MEMORY_HUGE_PAGE_SIZE);
+    return memory_data_size;
+}
+
+static void
+wasm_advise_linear_memory_huge_page(uint8 *mapped_mem, uint64 map_size,
+                                    uint8 huge_page_policy)
+{
+    int advice;
+
+    if (huge_page_policy == HUGE_PAGE_POLICY_DEFAULT || map_size == 0)
+        return;
+
+    advice = huge_page_policy == HUGE_PAGE_POLICY_NONE
+                 ? MMAP_ADVICE_NOHUGEPAGE
+                 : MMAP_ADVICE_HUGEPAGE;
+    if (os_madvise(mapped_mem, (size_t)map_size, advice) != 0) {
+        LOG_VERBOSE("Advise linear memory %p of %" PRIu64
+                    " bytes with huge page policy %u failed",
+                    mapped_mem, map_size, huge_page_policy);
+    }
+}
+
+#if WASM_ENABLE_NUMA != 0
+static bool
+wasm_bind_linear_memory_numa_node(uint8 *mapped_mem, uint64 size,
+                                  int8 numa_node)
+{
+    if (numa_node < 0 || size == 0)
+        return true;
+
+    if (os_mbind(mapped_mem, (size_t)size, numa_node) != 0) {
+        LOG_WARNING("Bind linear memory %p of %" PRIu64
+                    " bytes to NUMA node %d failed",
+                    mapped_mem, size, numa_node);
+        return false;
+    }
+    return true;
+}
+#endif
+
+/**
+ * Fault in the pages of the range [addr, addr + size) of the linear memory
+ * mapped at mapped_mem which is newly committed, the wasm app can't access
+ * the range until the instantiation or memory.grow returns
+ */
+static void
+wasm_prefault_linear_memory(uint8 *mapped_mem, uint8 *addr, uint64 size,
+                            uint8 prefault_policy)
+{
+    uint64 page_size = os_getpagesize();
+    /* The page which the range starts in may have been faulted in and hold
+       the content of the memory */
+    uint8 *start = (uint8 *)(((uintptr_t)addr + page_size - 1)
+                             & ~(uintptr_t)(page_size - 1));
+    uint8 *end = addr + size, *p;
+
+    if (prefault_policy == MEMORY_PREFAULT_POLICY_LAZY || start >= end)
+        return;
+
+#if WASM_ENABLE_THREAD_MGR != 0
+    if (prefault_policy == MEMORY_PREFAULT_POLICY_BACKGROUND
+        && prefault_in_background(mapped_mem, start, (uint64)(end - start)))
+        return;
+#else
+    (void)mapped_mem;
+#endif
+
+    if (os_madvise(start, (size_t)(end - start), MMAP_ADVICE_POPULATE_WRITE)
+        == 0)
+        return;
+
+    /* Fault in the pages by writing them, which is only safe before the
+       wasm app can access the range */
+    for (p = start; p < end; p += page_size)
+        *(volatile uint8 *)p = 0;
+}
+
+#ifndef BH_PLATFORM_WINDOWS
+/**
+ * Back the huge page chunks of the reserved linear memory which are
+ * newly committed in the range [old_size, new_size) with the pages of
+ * the huge page pool, the chunk partly committed before keeps its
+ * regular pages as the content can't be moved to the huge page.
+ *
+ * @return false if the range can't be restored after the failure, in
+ * which case the range is unmapped and acts like the guard region
+ */
+static bool
+wasm_map_linear_memory_hugetlb(uint8 *mapped_mem, uint64 old_size,
+                               uint64 new_size)
+{
+    uint64 start = align_as_and_cast(old_size, LINEAR_MEMORY_HUGE_PAGE_SIZE);
+    uint64 end = new_size & ~(LINEAR_MEMORY_HUGE_PAGE_SIZE - 1);
+    uint8 *addr;
+
+    if ((uintptr_t)mapped_mem % LINEAR_MEMORY_HUGE_PAGE_SIZE != 0
+        || start >= end)
+        return true;
+
+    addr = os_mmap(mapped_mem + start, (size_t)(end - start),
+                   MMAP_PROT_READ | MMAP_PROT_WRITE,
+                   MMAP_MAP_FIXED | MMAP_MAP_HUGETLB, os_get_invalid_handle());
+    if (addr == mapped_mem + start)
+        return true;
+
+    LOG_VERBOSE("Map linear memory %p of %" PRIu64
+                " bytes with huge page pool failed",
+                mapped_mem + start, end - start);
+
+    if (addr) {
+        /* The platform doesn't honor the fixed address, the range is
+           untouched */
+        os_munmap(addr, (size_t)(end - start));
+        return true;
+    }
+
+    /* The range may have been unmapped by the failed mapping, map it
+       with the regular pages again and fall back to transparent huge
+       pages */
+    addr = os_mmap(mapped_mem + start, (size_t)(end - start),
+                   MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_FIXED,
+                   os_get_invalid_handle());
+    if (addr != mapped_mem + start)
+        return false;
+
+    wasm_advise_linear_memory_huge_page(addr, end - start,
+                                        HUGE_PAGE_POLICY_THP);
+    return true;
+}
+#endif /* end of BH_PLATFORM_WINDOWS */
+#endif /* end of WASM_MEM_ALLOC_WITH_USAGE == 0 */
+
 static void
 wasm_munmap_linear_memory(void *mapped_mem, uint64 commit_size, uint64 map_size)
 {
@@ -1558,13 +1989,16 @@ wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
         goto return_func;
     }
 
-#ifdef OS_ENABLE_HW_BOUND_CHECK
-    full_size_mmaped = true;
-#elif WASM_ENABLE_SHARED_MEMORY != 0
+#if WASM_ENABLE_SHARED_MEMORY != 0
     full_size_mmaped = shared_memory_is_shared(memory);
 #else
     full_size_mmaped = false;
 #endif
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    if (wasm_is_hw_bound_checked(memory->is_memory64,
+                                 memory->mem64_clamp_log2))
+        full_size_mmaped = true;
+#endif
 
     memory_data_old = memory->memory_data;
     total_size_old = memory->memory_data_size;
@@ -1658,8 +2092,35 @@ wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
             ret = false;
             goto return_func;
         }
+
+#ifndef BH_PLATFORM_WINDOWS
+        if (memory->huge_page_policy == HUGE_PAGE_POLICY_HUGETLB
+            && !wasm_map_linear_memory_hugetlb(memory->memory_data,
+                                               total_size_old,
+                                               total_size_new)) {
+            ret = false;
+            goto return_func;
+        }
+#endif
+
+#if WASM_ENABLE_NUMA != 0
+        /* The huge page chunks are new mappings which don't inherit the
+           memory policy, bind the committed range again */
+        (void)wasm_bind_linear_memory_numa_node(
+            memory->memory_data + total_size_old,
+            total_size_new - total_size_old, memory->numa_node);
+#endif
+
+        wasm_prefault_linear_memory(
+            memory->memory_data, memory->memory_data + total_size_old,
+            total_size_new - total_size_old, memory->prefault_policy);
     }
     else {
+        uint64 map_size_old = wasm_get_linear_memory_map_size(
+            total_size_old, memory->huge_page_policy);
+        uint64 map_size_new = wasm_get_linear_memory_map_size(
+            total_size_new, memory->huge_page_policy);
+
         if (heap_size > 0) {
             if (mem_allocator_is_heap_corrupted(memory->heap_handle)) {
                 wasm_runtime_show_app_heap_corrupted_prompt();
@@ -1668,11 +2129,33 @@ wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
             }
         }
 
-        if (!(memory_data_new =
-                  wasm_mremap_linear_memory(memory_data_old, total_size_old,
-                                            total_size_new, total_size_new))) {
-            ret = false;
-            goto return_func;
+        if (map_size_new == map_size_old) {
+            /* The new pages were mapped in the last huge page, and they
+               have been kept zero as they were out of bounds */
+            memory_data_new = memory_data_old;
+        }
+        else {
+#if WASM_ENABLE_THREAD_MGR != 0
+            /* mremap may move the mapping, drop the pages not faulted in
+               yet, they are faulted in on the first access instead */
+            if (memory->prefault_policy == MEMORY_PREFAULT_POLICY_BACKGROUND)
+                cancel_prefault_in_background(memory_data_old);
+#endif
+            if (!(memory_data_new = wasm_mremap_linear_memory(
+                      memory_data_old, map_size_old, map_size_new,
+                      map_size_new))) {
+                ret = false;
+                goto return_func;
+            }
+            wasm_advise_linear_memory_huge_page(memory_data_new, map_size_new,
+                                                memory->huge_page_policy);
+#if WASM_ENABLE_NUMA != 0
+            /* mremap keeps the memory policy of the old range, bind the
+               extended range */
+            (void)wasm_bind_linear_memory_numa_node(
+                memory_data_new + map_size_old, map_size_new - map_size_old,
+                memory->numa_node);
+#endif
         }
 
         if (heap_size > 0) {
@@ -1690,6 +2173,11 @@ wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
         memory->heap_data = memory_data_new + (heap_data_old - memory_data_old);
         memory->heap_data_end = memory->heap_data + heap_size;
         memory->memory_data = memory_data_new;
+
+        wasm_prefault_linear_memory(memory_data_new,
+                                    memory_data_new + total_size_old,
+                                    total_size_new - total_size_old,
+                                    memory->prefault_policy);
 #if defined(os_writegsbase)
         /* write base addr of linear memory to GS segment register */
         os_writegsbase(memory_data_new);
@@ -1756,6 +2244,71 @@ wasm_runtime_enlarge_memory(WASMModuleInstanceCommon *module_inst,
     return false;
 }
 
+bool
+wasm_discard_memory(WASMMemoryInstance *memory, uint64 offset, uint64 len)
+{
+    uint8 *start;
+#if WASM_MEM_ALLOC_WITH_USAGE == 0
+    uint8 *end, *page_start, *page_end;
+    uintptr_t page_size;
+#endif
+
+    if (offset > memory->memory_data_size
+        || len > memory->memory_data_size - offset) {
+        return false;
+    }
+
+    if (len == 0) {
+        return true;
+    }
+
+    start = memory->memory_data + offset;
+
+#if WASM_MEM_ALLOC_WITH_USAGE == 0
+    /* The linear memory is anonymous memory mapped by the runtime, the
+       whole pages in the range are replaced with zero-filled pages which
+       don't occupy physical memory until they are written again */
+    end = start + len;
+    page_size = (uintptr_t)os_getpagesize();
+    page_start =
+        (uint8 *)(((uintptr_t)start + page_size - 1) & ~(page_size - 1));
+    page_end = (uint8 *)((uintptr_t)end & ~(page_size - 1));
+
+    if (page_start < page_end
+        && os_madvise(page_start, (size_t)(page_end - page_start),
+                      MMAP_ADVICE_DONTNEED)
+               == 0) {
+        memset(start, 0, (size_t)(page_start - start));
+        memset(page_end, 0, (size_t)(end - page_end));
+        return true;
+    }
+#endif
+
+    memset(start, 0, (size_t)len);
+    return true;
+}
+
+bool
+wasm_runtime_discard_memory(WASMModuleInstanceCommon *module_inst,
+                            uint64 offset, uint64 len)
+{
+    WASMMemoryInstance *memory_inst;
+    bool ret;
+
+    bh_assert(module_inst->module_type == Wasm_Module_Bytecode
+              || module_inst->module_type == Wasm_Module_AoT);
+
+    memory_inst = wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    if (!memory_inst) {
+        return false;
+    }
+
+    SHARED_MEMORY_LOCK(memory_inst);
+    ret = wasm_discard_memory(memory_inst, offset, len);
+    SHARED_MEMORY_UNLOCK(memory_inst);
+    return ret;
+}
+
 void
 wasm_runtime_set_enlarge_mem_error_callback(
     const enlarge_memory_error_callback_t callback, void *user_data)
@@ -1911,21 +2464,31 @@ wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
     bh_assert(memory_inst);
     bh_assert(memory_inst->memory_data);
 
-#ifndef OS_ENABLE_HW_BOUND_CHECK
-#if WASM_ENABLE_SHARED_MEMORY != 0
-    if (shared_memory_is_shared(memory_inst)) {
-        map_size = (uint64)memory_inst->num_bytes_per_page
-                   * memory_inst->max_page_count;
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    if (wasm_is_hw_bound_checked(memory_inst->is_memory64,
+                                 memory_inst->mem64_clamp_log2)) {
+        map_size = wasm_get_hw_bound_check_map_size(
+            memory_inst->is_memory64, memory_inst->mem64_clamp_log2);
     }
     else
 #endif
     {
-        map_size = (uint64)memory_inst->num_bytes_per_page
-                   * memory_inst->cur_page_count;
-    }
-#else
-    map_size = 8 * (uint64)BH_GB;
+#if WASM_ENABLE_SHARED_MEMORY != 0
+        if (shared_memory_is_shared(memory_inst)) {
+            map_size = (uint64)memory_inst->num_bytes_per_page
+                       * memory_inst->max_page_count;
+        }
+        else
 #endif
+        {
+            map_size = (uint64)memory_inst->num_bytes_per_page
+                       * memory_inst->cur_page_count;
+#if WASM_MEM_ALLOC_WITH_USAGE == 0
+            map_size = wasm_get_linear_memory_map_size(
+                map_size, memory_inst->huge_page_policy);
+#endif
+        }
+    }
 
 #if WASM_MEM_ALLOC_WITH_USAGE != 0
     (void)map_size;
@@ -1935,6 +2498,10 @@ wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
 #endif
               memory_inst->memory_data);
 #else
+#if WASM_ENABLE_THREAD_MGR != 0
+    if (memory_inst->prefault_policy == MEMORY_PREFAULT_POLICY_BACKGROUND)
+        cancel_prefault_in_background(memory_inst->memory_data);
+#endif
     wasm_munmap_linear_memory(memory_inst->memory_data,
                               memory_inst->memory_data_size, map_size);
 #endif
@@ -1944,44 +2511,62 @@ wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
 
 int
 wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
-                            bool is_memory64, uint64 num_bytes_per_page,
-                            uint64 init_page_count, uint64 max_page_count,
+                            bool is_memory64, uint8 mem64_clamp_log2,
+                            uint64 num_bytes_per_page, uint64 init_page_count,
+                            uint64 max_page_count, uint8 huge_page_policy,
+                            int8 numa_node, uint8 prefault_policy,
                             uint64 *memory_data_size)
 {
-    uint64 map_size, page_size;
+    uint64 map_size, commit_size, page_size;
+    bool is_reserved = true;
 
     bh_assert(data);
     bh_assert(memory_data_size);
 
-#ifndef OS_ENABLE_HW_BOUND_CHECK
-#if WASM_ENABLE_SHARED_MEMORY != 0
-    if (is_shared_memory) {
-        /* Allocate maximum memory size when memory is shared */
-        map_size = max_page_count * num_bytes_per_page;
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    if (wasm_is_hw_bound_checked(is_memory64, mem64_clamp_log2)) {
+        /* Map the whole address range that the opcode load/store can
+           access, see wasm_get_hw_bound_check_map_size */
+        bh_assert(!is_memory64
+                  || max_page_count * num_bytes_per_page
+                         <= ((uint64)1 << mem64_clamp_log2));
+        map_size =
+            wasm_get_hw_bound_check_map_size(is_memory64, mem64_clamp_log2);
     }
     else
+#else
+    bh_assert(mem64_clamp_log2 == 0);
+    (void)mem64_clamp_log2;
 #endif
     {
-        map_size = init_page_count * num_bytes_per_page;
+#if WASM_ENABLE_SHARED_MEMORY != 0
+        if (is_shared_memory) {
+            /* Allocate maximum memory size when memory is shared */
+            map_size = max_page_count * num_bytes_per_page;
+        }
+        else
+#endif
+        {
+            map_size = init_page_count * num_bytes_per_page;
+            is_reserved = false;
+        }
     }
-#else  /* else of OS_ENABLE_HW_BOUND_CHECK */
-    /* Totally 8G is mapped, the opcode load/store address range is 0 to 8G:
-     *   ea = i + memarg.offset
-     * both i and memarg.offset are u32 in range 0 to 4G
-     * so the range of ea is 0 to 8G
-     */
-    map_size = 8 * (uint64)BH_GB;
-#endif /* end of OS_ENABLE_HW_BOUND_CHECK */
 
     page_size = os_getpagesize();
     *memory_data_size = init_page_count * num_bytes_per_page;
 
     bh_assert(*memory_data_size <= GET_MAX_LINEAR_MEMORY_SIZE(is_memory64));
     *memory_data_size = align_as_and_cast(*memory_data_size, page_size);
+    commit_size = *memory_data_size;
 
     if (map_size > 0) {
 #if WASM_MEM_ALLOC_WITH_USAGE != 0
         (void)wasm_mmap_linear_memory;
+        (void)commit_size;
+        (void)is_reserved;
+        (void)huge_page_policy;
+        (void)numa_node;
+        (void)prefault_policy;
         if (!(*data = malloc_func(Alloc_For_LinearMemory,
 #if WASM_MEM_ALLOC_WITH_USER_DATA != 0
                                   allocator_user_data,
@@ -1990,9 +2575,42 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
             return BHT_ERROR;
         }
 #else
-        if (!(*data = wasm_mmap_linear_memory(map_size, *memory_data_size))) {
+        if (!is_reserved) {
+            /* The memory is bound checked by software, the pages mapped
+               beyond the memory data size are never accessed */
+            map_size =
+                wasm_get_linear_memory_map_size(map_size, huge_page_policy);
+            commit_size = map_size;
+        }
+
+        if (!(*data = wasm_mmap_linear_memory(map_size, commit_size))) {
+            return BHT_ERROR;
+        }
+
+        wasm_advise_linear_memory_huge_page(*data, map_size, huge_page_policy);
+
+#ifndef BH_PLATFORM_WINDOWS
+        if (is_reserved && huge_page_policy == HUGE_PAGE_POLICY_HUGETLB
+            && !wasm_map_linear_memory_hugetlb(*data, 0, commit_size)) {
+            wasm_munmap_linear_memory(*data, commit_size, map_size);
+            return BHT_ERROR;
+        }
+#endif
+
+#if WASM_ENABLE_NUMA != 0
+        /* Bind the whole mapping including the reserved range, so that
+           the pages committed by memory.grow are faulted in from the node
+           too */
+        if (!wasm_bind_linear_memory_numa_node(*data, map_size, numa_node)) {
+            wasm_munmap_linear_memory(*data, commit_size, map_size);
             return BHT_ERROR;
         }
+#else
+        (void)numa_node;
+#endif
+
+        wasm_prefault_linear_memory(*data, *data, *memory_data_size,
+                                    prefault_policy);
 #endif
     }
 
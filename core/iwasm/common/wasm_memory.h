@@ -138,13 +138,48 @@ void
 wasm_runtime_set_enlarge_mem_error_callback(
     const enlarge_memory_error_callback_t callback, void *user_data);
 
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+/* Whether the linear memory is bound checked with hardware trap, a
+   memory64 linear memory is only if its max memory size is small enough,
+   see wasm_get_mem64_clamp_log2 */
+static inline bool
+wasm_is_hw_bound_checked(bool is_memory64, uint8 mem64_clamp_log2)
+{
+    return !is_memory64 || mem64_clamp_log2 > 0;
+}
+
+/* Get the size of the virtual address space mapped for the linear memory
+   bound checked with hardware trap, including the guard regions */
+static inline uint64
+wasm_get_hw_bound_check_map_size(bool is_memory64, uint8 mem64_clamp_log2)
+{
+    /* For memory32, the opcode load/store address range is 0 to 8G:
+     *   ea = i + memarg.offset
+     * both i and memarg.offset are u32 in range 0 to 4G.
+     * For memory64, i is clamped to 2^mem64_clamp_log2 by the AOT code,
+     * which only does so when memarg.offset is in range 0 to 4G, so
+     * 8G guard regions are mapped after that.
+     */
+    if (is_memory64)
+        return ((uint64)1 << mem64_clamp_log2) + 8 * (uint64)BH_GB;
+    return 8 * (uint64)BH_GB;
+}
+#endif
+
+/* Fill the range of the linear memory with zeros and give the whole pages
+   inside it back to the OS, return false if it is out of bounds */
+bool
+wasm_discard_memory(WASMMemoryInstance *memory, uint64 offset, uint64 len);
+
 void
 wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst);
 
 int
 wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
-                            bool is_memory64, uint64 num_bytes_per_page,
-                            uint64 init_page_count, uint64 max_page_count,
+                            bool is_memory64, uint8 mem64_clamp_log2,
+                            uint64 num_bytes_per_page, uint64 init_page_count,
+                            uint64 max_page_count, uint8 huge_page_policy,
+                            int8 numa_node, uint8 prefault_policy,
                             uint64 *memory_data_size);
 
 #ifdef __cplusplus
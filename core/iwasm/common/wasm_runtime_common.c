@@ -31,6 +31,9 @@
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #include "wasm_shared_memory.h"
 #endif
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+#include "../libraries/task-scheduler/task_scheduler.h"
+#endif
 #if WASM_ENABLE_FAST_JIT != 0
 #include "../fast-jit/jit_compiler.h"
 #endif
@@ -195,8 +198,14 @@ is_sig_addr_in_guard_pages(void *sig_addr, WASMModuleInstance *module_inst)
     for (i = 0; i < module_inst->memory_count; ++i) {
         /* To be compatible with multi memory, get the ith memory instance */
         memory_inst = wasm_get_memory_with_idx(module_inst, i);
+        if (!wasm_is_hw_bound_checked(memory_inst->is_memory64,
+                                      memory_inst->mem64_clamp_log2))
+            continue;
         mapped_mem_start_addr = memory_inst->memory_data;
-        mapped_mem_end_addr = memory_inst->memory_data + 8 * (uint64)BH_GB;
+        mapped_mem_end_addr =
+            memory_inst->memory_data
+            + wasm_get_hw_bound_check_map_size(memory_inst->is_memory64,
+                                               memory_inst->mem64_clamp_log2);
         if (mapped_mem_start_addr <= (uint8 *)sig_addr
             && (uint8 *)sig_addr < mapped_mem_end_addr) {
             /* The address which causes segmentation fault is inside
@@ -655,6 +664,10 @@ wasm_runtime_destroy_internal(void)
     runtime_signal_destroy();
 #endif
 
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    wasm_sampling_prof_destroy();
+#endif
+
     /* runtime env destroy */
 #if WASM_ENABLE_MULTI_MODULE
     wasm_runtime_destroy_loading_module_list();
@@ -683,6 +696,10 @@ wasm_runtime_destroy_internal(void)
     jit_compiler_destroy();
 #endif
 
+#if WASM_ENABLE_LINUX_PERF != 0
+    wasm_jitdump_destroy();
+#endif
+
 #if WASM_ENABLE_SHARED_MEMORY
     wasm_shared_memory_destroy();
 #endif
@@ -771,6 +788,12 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
 
 #if WASM_ENABLE_LINUX_PERF != 0
     wasm_runtime_set_linux_perf(init_args->enable_linux_perf);
+#if WASM_ENABLE_WAMR_COMPILER == 0
+    /* Create the jitdump before the JIT compilers generate any code, the
+       perf map is still created for AOT if it fails */
+    if (init_args->enable_linux_perf)
+        (void)wasm_jitdump_init();
+#endif
 #else
     if (init_args->enable_linux_perf)
         LOG_WARNING("warning: to enable linux perf support, please recompile "
@@ -778,6 +801,9 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
 #endif
 
     if (!wasm_runtime_env_init()) {
+#if WASM_ENABLE_LINUX_PERF != 0
+        wasm_jitdump_destroy();
+#endif
         wasm_runtime_memory_destroy();
         return false;
     }
@@ -1504,6 +1530,26 @@ wasm_runtime_load_ex(uint8 *buf, uint32 size, const LoadArgs *args,
                                           error_buf_size);
 }
 
+uint8 *
+wasm_runtime_prepare_module(const uint8 *buf, uint32 size, uint32 *p_size,
+                            char *error_buf, uint32 error_buf_size)
+{
+    if (!buf || !p_size || size < 4
+        || get_package_type(buf, size) != Wasm_Module_Bytecode) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module prepare failed: invalid wasm binary");
+        return NULL;
+    }
+
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    return wasm_prepare_module(buf, size, p_size, error_buf, error_buf_size);
+#else
+    set_error_buf(error_buf, error_buf_size,
+                  "WASM module prepare failed: prepared module isn't enabled");
+    return NULL;
+#endif
+}
+
 bool
 wasm_runtime_resolve_symbols(WASMModuleCommon *module)
 {
@@ -1627,6 +1673,13 @@ wasm_runtime_instantiate_internal(WASMModuleCommon *module,
                                   const struct InstantiationArgs2 *args,
                                   char *error_buf, uint32 error_buf_size)
 {
+#if WASM_ENABLE_NUMA != 0
+    if (args->numa_node >= OS_NUMA_NODE_MAX) {
+        set_error_buf(error_buf, error_buf_size,
+                      "Instantiate module failed, invalid NUMA node");
+        return NULL;
+    }
+#endif
 #if WASM_ENABLE_INTERP != 0
     if (module->module_type == Wasm_Module_Bytecode)
         return (WASMModuleInstanceCommon *)wasm_instantiate(
@@ -1648,6 +1701,7 @@ void
 wasm_runtime_instantiation_args_set_defaults(struct InstantiationArgs2 *args)
 {
     memset(args, 0, sizeof(*args));
+    args->numa_node = -1;
 #if WASM_ENABLE_LIBC_WASI != 0
     wasi_args_set_defaults(&args->wasi);
 #endif
@@ -1717,6 +1771,41 @@ wasm_runtime_instantiation_args_set_max_memory_pages(
     p->v1.max_memory_pages = v;
 }
 
+void
+wasm_runtime_instantiation_args_set_huge_page_policy(
+    struct InstantiationArgs2 *p, huge_page_policy_t v)
+{
+    p->huge_page_policy = v;
+}
+
+void
+wasm_runtime_instantiation_args_set_memory_prefault_policy(
+    struct InstantiationArgs2 *p, memory_prefault_policy_t v)
+{
+    p->memory_prefault_policy = v;
+}
+
+void
+wasm_runtime_instantiation_args_set_numa_node(struct InstantiationArgs2 *p,
+                                              int32 v)
+{
+#if WASM_ENABLE_NUMA != 0
+    p->numa_node = v;
+#else
+    if (v >= 0)
+        LOG_WARNING("NUMA node %" PRId32 " is ignored as NUMA-aware "
+                    "placement isn't enabled",
+                    v);
+#endif
+}
+
+void
+wasm_runtime_instantiation_args_set_numa_pin_threads(
+    struct InstantiationArgs2 *p, bool v)
+{
+    p->numa_pin_threads = v;
+}
+
 #if WASM_ENABLE_LIBC_WASI != 0
 void
 wasm_runtime_instantiation_args_set_wasi_arg(struct InstantiationArgs2 *p,
@@ -1793,6 +1882,18 @@ wasm_runtime_instantiation_args_set_wasi_ns_lookup_pool(
     wasi_args->ns_lookup_count = ns_lookup_pool_size;
     wasi_args->set_by_user = true;
 }
+
+void
+wasm_runtime_instantiation_args_set_wasi_mmap_dir(struct InstantiationArgs2 *p,
+                                                  const char *mmap_dir_list[],
+                                                  uint32 mmap_dir_count)
+{
+    WASIArguments *wasi_args = &p->wasi;
+
+    wasi_args->mmap_dir_list = mmap_dir_list;
+    wasi_args->mmap_dir_count = mmap_dir_count;
+    wasi_args->set_by_user = true;
+}
 #endif /* WASM_ENABLE_LIBC_WASI != 0 */
 
 WASMModuleInstanceCommon *
@@ -2433,6 +2534,64 @@ wasm_runtime_set_instruction_count_limit(WASMExecEnv *exec_env,
 }
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* Only incremented by wasm_runtime_increment_epoch, AOT/JIT code reads it
+   with plain loads */
+static bh_atomic_64_t epoch_counter;
+
+uint64 *
+wasm_runtime_get_epoch_ptr(void)
+{
+    return (uint64 *)&epoch_counter;
+}
+
+void
+wasm_runtime_increment_epoch(void)
+{
+    BH_ATOMIC_64_FETCH_ADD(epoch_counter, 1);
+}
+
+uint64
+wasm_runtime_get_epoch(void)
+{
+    return BH_ATOMIC_64_LOAD(epoch_counter);
+}
+
+void
+wasm_runtime_set_epoch_deadline(WASMExecEnv *exec_env,
+                                uint64 ticks_beyond_current)
+{
+    uint64 epoch = BH_ATOMIC_64_LOAD(epoch_counter);
+
+    exec_env->epoch_deadline = ticks_beyond_current > UINT64_MAX - epoch
+                                   ? UINT64_MAX
+                                   : epoch + ticks_beyond_current;
+}
+
+void
+wasm_runtime_set_epoch_deadline_callback(
+    WASMExecEnv *exec_env,
+    bool (*callback)(WASMExecEnv *exec_env, void *user_data), void *user_data)
+{
+    exec_env->epoch_deadline_callback = callback;
+    exec_env->epoch_deadline_user_data = user_data;
+}
+
+bool
+wasm_runtime_epoch_deadline_reached(WASMExecEnv *exec_env)
+{
+    if (exec_env->epoch_deadline_callback
+        && exec_env->epoch_deadline_callback(
+            exec_env, exec_env->epoch_deadline_user_data)) {
+        return true;
+    }
+
+    wasm_runtime_set_exception(exec_env->module_inst,
+                               "epoch deadline reached");
+    return false;
+}
+#endif
+
 WASMFuncType *
 wasm_runtime_get_function_type(const WASMFunctionInstanceCommon *function,
                                uint32 module_type)
@@ -2725,12 +2884,25 @@ wasm_runtime_call_wasm(WASMExecEnv *exec_env,
 #if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
     uint32 result_argc = 0;
 #endif
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    int instructions_to_execute;
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    WASMExecEnv *prev_sampled_exec_env;
+#endif
 
     if (!wasm_runtime_exec_env_check(exec_env)) {
         LOG_ERROR("Invalid exec env stack info.");
         return false;
     }
 
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    /* AOT/JIT code decreases exec_env->instructions_to_execute, restore it
+       after the call so that the limit applies to each call like in the
+       interpreter */
+    instructions_to_execute = exec_env->instructions_to_execute;
+#endif
+
 #if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
     if (!wasm_runtime_prepare_call_function(exec_env, function, argv, argc,
                                             &new_argv, &param_argc,
@@ -2744,6 +2916,10 @@ wasm_runtime_call_wasm(WASMExecEnv *exec_env,
     param_argc = argc;
 #endif
 
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    /* Let the sampling profiler walk the call stack of the exec_env */
+    prev_sampled_exec_env = wasm_runtime_set_sampled_exec_env(exec_env);
+#endif
 #if WASM_ENABLE_INTERP != 0
     if (exec_env->module_inst->module_type == Wasm_Module_Bytecode)
         ret = wasm_call_function(exec_env, (WASMFunctionInstance *)function,
@@ -2753,6 +2929,12 @@ wasm_runtime_call_wasm(WASMExecEnv *exec_env,
     if (exec_env->module_inst->module_type == Wasm_Module_AoT)
         ret = aot_call_function(exec_env, (AOTFunctionInstance *)function,
                                 param_argc, new_argv);
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    wasm_runtime_set_sampled_exec_env(prev_sampled_exec_env);
+#endif
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    exec_env->instructions_to_execute = instructions_to_execute;
 #endif
     if (!ret) {
         if (new_argv != argv) {
@@ -3220,6 +3402,7 @@ static const char *exception_msgs[] = {
     "create stringref failed",        /* EXCE_FAILED_TO_CREATE_STRINGREF */
     "create stringview failed",       /* EXCE_FAILED_TO_CREATE_STRINGVIEW */
     "encode failed",                  /* EXCE_FAILED_TO_ENCODE_STRING */
+    "instruction limit exceeded",     /* EXCE_INSTRUCTION_LIMIT_EXCEEDED */
     "",                               /* EXCE_ALREADY_THROWN */
 };
 /* clang-format on */
@@ -3394,6 +3577,52 @@ wasm_runtime_is_bounds_checks_enabled(WASMModuleInstanceCommon *module_inst)
 }
 #endif
 
+#if WASM_ENABLE_NUMA != 0
+#ifndef OS_ENABLE_NUMA
+#error "NUMA-aware placement isn't supported on this platform"
+#endif
+
+int32
+wasm_runtime_get_numa_node(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        return ((WASMModuleInstance *)module_inst)->e->common.numa_node;
+    }
+#endif
+
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        return ((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                    ->e)
+            ->common.numa_node;
+    }
+#endif
+
+    return -1;
+}
+
+bool
+wasm_runtime_is_numa_pin_threads_enabled(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        return ((WASMModuleInstance *)module_inst)->e->common.numa_pin_threads;
+    }
+#endif
+
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        return ((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                    ->e)
+            ->common.numa_pin_threads;
+    }
+#endif
+
+    return false;
+}
+#endif /* end of WASM_ENABLE_NUMA != 0 */
+
 uint64
 wasm_runtime_module_malloc_internal(WASMModuleInstanceCommon *module_inst,
                                     WASMExecEnv *exec_env, uint64 size,
@@ -3624,6 +3853,20 @@ wasm_runtime_set_wasi_ns_lookup_pool(wasm_module_t module,
     }
 }
 
+void
+wasm_runtime_set_wasi_mmap_dir(wasm_module_t module,
+                               const char *mmap_dir_list[],
+                               uint32 mmap_dir_count)
+{
+    WASIArguments *wasi_args = get_wasi_args_from_module(module);
+
+    if (wasi_args) {
+        wasi_args->mmap_dir_list = mmap_dir_list;
+        wasi_args->mmap_dir_count = mmap_dir_count;
+        wasi_args->set_by_user = true;
+    }
+}
+
 #if WASM_ENABLE_UVWASI == 0
 static bool
 copy_string_array(const char *array[], uint32 array_size, char **buf_ptr,
@@ -3673,6 +3916,7 @@ wasm_runtime_init_wasi(WASMModuleInstanceCommon *module_inst,
                        const char *env[], uint32 env_count,
                        const char *addr_pool[], uint32 addr_pool_size,
                        const char *ns_lookup_pool[], uint32 ns_lookup_pool_size,
+                       const char *mmap_dir_list[], uint32 mmap_dir_count,
                        char *argv[], uint32 argc, os_raw_file_handle stdinfd,
                        os_raw_file_handle stdoutfd, os_raw_file_handle stderrfd,
                        char *error_buf, uint32 error_buf_size)
@@ -3896,6 +4140,17 @@ wasm_runtime_init_wasi(WASMModuleInstanceCommon *module_inst,
             wasm_runtime_free(mapping_copy);
     }
 
+    for (i = 0; i < mmap_dir_count; i++) {
+        if (!fd_table_enable_mmap_files(curfds, prestats, mmap_dir_list[i])) {
+            if (error_buf)
+                snprintf(error_buf, error_buf_size,
+                         "error while enabling mmap mode of directory %s: "
+                         "not pre-opened\n",
+                         mmap_dir_list[i]);
+            goto fail;
+        }
+    }
+
     /* addr_pool(textual) -> apool */
     for (i = 0; i < addr_pool_size; i++) {
         char *cp, *address, *mask;
@@ -4029,6 +4284,7 @@ wasm_runtime_init_wasi(WASMModuleInstanceCommon *module_inst,
                        const char *env[], uint32 env_count,
                        const char *addr_pool[], uint32 addr_pool_size,
                        const char *ns_lookup_pool[], uint32 ns_lookup_pool_size,
+                       const char *mmap_dir_list[], uint32 mmap_dir_count,
                        char *argv[], uint32 argc, os_raw_file_handle stdinfd,
                        os_raw_file_handle stdoutfd, os_raw_file_handle stderrfd,
                        char *error_buf, uint32 error_buf_size)
@@ -6480,6 +6736,64 @@ wasm_runtime_join_thread(wasm_thread_t tid, void **retval)
 
 #endif /* end of WASM_ENABLE_THREAD_MGR */
 
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+bool
+wasm_runtime_init_task_scheduler(uint32 worker_num, uint32 task_stack_size)
+{
+    return wasm_task_scheduler_init(worker_num, task_stack_size);
+}
+
+void
+wasm_runtime_destroy_task_scheduler(void)
+{
+    wasm_task_scheduler_destroy();
+}
+
+wasm_task_t
+wasm_runtime_spawn_task(WASMExecEnv *exec_env,
+                        WASMFunctionInstanceCommon *function, uint32 argc,
+                        uint32 argv[])
+{
+    return wasm_task_spawn(exec_env, function, argc, argv);
+}
+
+bool
+wasm_runtime_join_task(wasm_task_t task)
+{
+    return wasm_task_join(task);
+}
+
+void
+wasm_runtime_yield_task(WASMExecEnv *exec_env)
+{
+    WASMTask *task = wasm_task_get_current();
+
+    (void)exec_env;
+    if (task)
+        wasm_task_yield(task);
+}
+
+wasm_async_op_t
+wasm_runtime_create_async_op(WASMExecEnv *exec_env)
+{
+    (void)exec_env;
+    return wasm_task_create_async_op();
+}
+
+uint64
+wasm_runtime_await_async_op(WASMExecEnv *exec_env, wasm_async_op_t op)
+{
+    (void)exec_env;
+    return wasm_task_await_async_op(op);
+}
+
+void
+wasm_runtime_complete_async_op(wasm_async_op_t op, uint64 result)
+{
+    wasm_task_complete_async_op(op, result);
+}
+#endif /* end of WASM_ENABLE_TASK_SCHEDULER */
+
 #if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
 
 static korp_mutex externref_lock;
@@ -6997,6 +7311,33 @@ wasm_runtime_dump_pgo_prof_data_to_buf(WASMModuleInstanceCommon *module_inst,
 }
 #endif /* end of WASM_ENABLE_STATIC_PGO != 0 */
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+uint32
+wasm_runtime_get_interp_prof_data_size(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        WASMModuleInstance *wasm_inst = (WASMModuleInstance *)module_inst;
+        return wasm_get_interp_prof_data_size(wasm_inst);
+    }
+#endif
+    return 0;
+}
+
+uint32
+wasm_runtime_dump_interp_prof_data_to_buf(
+    WASMModuleInstanceCommon *module_inst, char *buf, uint32 len)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        WASMModuleInstance *wasm_inst = (WASMModuleInstance *)module_inst;
+        return wasm_dump_interp_prof_data_to_buf(wasm_inst, buf, len);
+    }
+#endif
+    return 0;
+}
+#endif /* end of WASM_ENABLE_INTERP_PROFILING != 0 */
+
 bool
 wasm_runtime_get_table_elem_type(const WASMModuleCommon *module_comm,
                                  uint32 table_idx, uint8 *out_elem_type,
@@ -614,6 +614,10 @@ wasm_runtime_get_exec_env_tls(void);
 
 struct InstantiationArgs2 {
     InstantiationArgs v1;
+    huge_page_policy_t huge_page_policy;
+    memory_prefault_policy_t memory_prefault_policy;
+    int32 numa_node;
+    bool numa_pin_threads;
 #if WASM_ENABLE_LIBC_WASI != 0
     WASIArguments wasi;
 #endif
@@ -738,6 +742,24 @@ void
 wasm_runtime_instantiation_args_set_max_memory_pages(
     struct InstantiationArgs2 *p, uint32 v);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN
+void
+wasm_runtime_instantiation_args_set_memory_prefault_policy(
+    struct InstantiationArgs2 *p, memory_prefault_policy_t v);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN
+void
+wasm_runtime_instantiation_args_set_numa_node(struct InstantiationArgs2 *p,
+                                              int32 v);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN
+void
+wasm_runtime_instantiation_args_set_numa_pin_threads(
+    struct InstantiationArgs2 *p, bool v);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_instantiation_args_set_wasi_arg(struct InstantiationArgs2 *p,
@@ -775,6 +797,12 @@ wasm_runtime_instantiation_args_set_wasi_ns_lookup_pool(
     struct InstantiationArgs2 *p, const char *ns_lookup_pool[],
     uint32 ns_lookup_pool_size);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_instantiation_args_set_wasi_mmap_dir(struct InstantiationArgs2 *p,
+                                                  const char *mmap_dir_list[],
+                                                  uint32 mmap_dir_count);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN WASMModuleInstanceCommon *
 wasm_runtime_instantiate_ex2(WASMModuleCommon *module,
@@ -879,6 +907,66 @@ wasm_runtime_set_instruction_count_limit(WASMExecEnv *exec_env,
                                          int instructions_to_execute);
 #endif
 
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_increment_epoch(void);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint64
+wasm_runtime_get_epoch(void);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline(WASMExecEnv *exec_env,
+                                uint64 ticks_beyond_current);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline_callback(
+    WASMExecEnv *exec_env,
+    bool (*callback)(WASMExecEnv *exec_env, void *user_data),
+    void *user_data);
+
+/* Address of the global epoch counter read by AOT/JIT code */
+uint64 *
+wasm_runtime_get_epoch_ptr(void);
+
+/* Called by AOT/JIT code when the epoch deadline is reached, return false
+   and set the exception if the execution should be interrupted */
+bool
+wasm_runtime_epoch_deadline_reached(WASMExecEnv *exec_env);
+#endif
+
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_start_sampling_profiler(uint32 interval_us,
+                                     uint32 max_call_paths);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_stop_sampling_profiler(void);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint32
+wasm_runtime_get_sampling_profile_size(wasm_sampling_profile_format_t format);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint32
+wasm_runtime_dump_sampling_profile_to_buf(
+    wasm_sampling_profile_format_t format, char *buf, uint32 len);
+
+/* Set the exec_env whose call stack is sampled when the current thread is
+   interrupted by the profiling timer, return the previous one */
+WASMExecEnv *
+wasm_runtime_set_sampled_exec_env(WASMExecEnv *exec_env);
+
+/* Stop the profiler and free the samples */
+void
+wasm_sampling_prof_destroy(void);
+#endif
+
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN
@@ -891,6 +979,16 @@ WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_is_bounds_checks_enabled(WASMModuleInstanceCommon *module_inst);
 #endif
 
+#if WASM_ENABLE_NUMA != 0
+/* Get the NUMA node the instance is bound to, -1 if it isn't bound */
+int32
+wasm_runtime_get_numa_node(WASMModuleInstanceCommon *module_inst);
+
+/* Whether the threads spawned by the instance are pinned to its node */
+bool
+wasm_runtime_is_numa_pin_threads_enabled(WASMModuleInstanceCommon *module_inst);
+#endif
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
 /* Access exception check guard page to trigger the signal handler */
 void
@@ -1010,6 +1108,15 @@ WASM_RUNTIME_API_EXTERN uint64
 wasm_runtime_module_dup_data(WASMModuleInstanceCommon *module_inst,
                              const char *src, uint64 size);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint64
+wasm_runtime_trim_app_heap(WASMModuleInstanceCommon *module_inst);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_app_heap_trim_threshold(WASMModuleInstanceCommon *module_inst,
+                                         uint32 threshold);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_validate_app_addr(WASMModuleInstanceCommon *module_inst,
@@ -1170,6 +1277,7 @@ wasm_runtime_init_wasi(WASMModuleInstanceCommon *module_inst,
                        const char *env[], uint32 env_count,
                        const char *addr_pool[], uint32 addr_pool_size,
                        const char *ns_lookup_pool[], uint32 ns_lookup_pool_size,
+                       const char *mmap_dir_list[], uint32 mmap_dir_count,
                        char *argv[], uint32 argc, os_raw_file_handle stdinfd,
                        os_raw_file_handle stdoutfd, os_raw_file_handle stderrfd,
                        char *error_buf, uint32 error_buf_size);
@@ -1192,6 +1300,12 @@ WASM_RUNTIME_API_EXTERN void
 wasm_runtime_set_wasi_ns_lookup_pool(wasm_module_t module,
                                      const char *ns_lookup_pool[],
                                      uint32 ns_lookup_pool_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_wasi_mmap_dir(wasm_module_t module,
+                               const char *mmap_dir_list[],
+                               uint32 mmap_dir_count);
 #endif /* end of WASM_ENABLE_LIBC_WASI */
 
 #if WASM_ENABLE_GC != 0
@@ -1417,6 +1531,29 @@ wasm_runtime_get_linux_perf(void);
 
 void
 wasm_runtime_set_linux_perf(bool flag);
+
+/* The file name of the line table entries of the jitdump, whose line
+   numbers are the offsets of the opcodes in the wasm binary */
+#define WASM_JITDUMP_LINE_FILE_NAME "wasm"
+
+typedef struct WASMJitDumpLine {
+    /* The native address of the first instruction of the line */
+    const void *code_addr;
+    uint32 bytecode_offset;
+} WASMJitDumpLine;
+
+/* Create the jit-<pid>.dump file for `perf inject --jit` */
+bool
+wasm_jitdump_init(void);
+
+void
+wasm_jitdump_destroy(void);
+
+/* Write the code load record of the generated or loaded code, and the line
+   table sorted by the native address if there is one */
+void
+wasm_jitdump_code_load(const char *name, const void *code, uint32 code_size,
+                       const WASMJitDumpLine *lines, uint32 line_count);
 #endif
 
 #if WASM_ENABLE_SHARED_HEAP != 0
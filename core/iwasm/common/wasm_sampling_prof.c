@@ -0,0 +1,671 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_runtime_common.h"
+#include "bh_platform.h"
+#include "bh_atomic.h"
+#if WASM_ENABLE_INTERP != 0
+#include "../interpreter/wasm_runtime.h"
+#endif
+#if WASM_ENABLE_AOT != 0
+#include "../aot/aot_runtime.h"
+#endif
+
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+
+#ifndef OS_ENABLE_SAMPLING_TIMER
+#error "Sampling profiling isn't supported on this platform"
+#endif
+
+/*
+ * The sampling profiler: the profiling timer interrupts the thread which
+ * consumes the CPU time, and the signal handler walks the call stack of
+ * the exec_env running on the thread with the async-signal-safe copy call
+ * stack functions. The call paths are aggregated in a preallocated open
+ * addressing hash table, whose slots are claimed with compare-and-swap,
+ * since the handler can't allocate memory or take locks.
+ */
+
+/* The frames copied by a copy call stack call, which are on the stack of
+   the signal handler, so don't copy all the frames at once */
+#define COPY_FRAME_NUM 16
+
+/* The max number of slots probed before a sample is lost */
+#define MAX_PROBE_NUM 64
+
+typedef struct SampledCallPath {
+    /* Hash of the call path, 0 if the slot is free */
+    bh_atomic_64_t hash;
+    bh_atomic_32_t count;
+    uint32 frame_count;
+    WASMModuleInstanceCommon *module_inst;
+    /* Function indexes, from the callee to the caller */
+    uint32 func_indexes[WASM_SAMPLING_PROF_MAX_DEPTH];
+} SampledCallPath;
+
+typedef struct SamplingProfiler {
+    SampledCallPath *call_paths;
+    /* Power of 2 */
+    uint32 call_path_count;
+    uint32 interval_us;
+    bh_atomic_32_t running;
+    /* The number of signal handlers running */
+    bh_atomic_32_t handler_count;
+    /* The samples taken when the thread isn't running wasm */
+    bh_atomic_32_t native_count;
+    /* The samples lost since the hash table is full */
+    bh_atomic_32_t lost_count;
+} SamplingProfiler;
+
+static SamplingProfiler profiler;
+
+/* The exec_env of thread local storage, read in the signal handler, as
+   we cannot get it from the argument of signal handler */
+static os_thread_local_attribute WASMExecEnv *sampled_exec_env = NULL;
+
+WASMExecEnv *
+wasm_runtime_set_sampled_exec_env(WASMExecEnv *exec_env)
+{
+    WASMExecEnv *prev_exec_env = sampled_exec_env;
+
+    sampled_exec_env = exec_env;
+    return prev_exec_env;
+}
+
+static uint32
+copy_frames(WASMExecEnv *exec_env, WASMCApiFrame *frames, uint32 length,
+            uint32 skip_n)
+{
+    WASMModuleInstanceCommon *module_inst = exec_env->module_inst;
+    char error_buf[32];
+
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_AOT_STACK_FRAME != 0
+        /* LLVM JIT code pushes the AOT frames */
+        if (wasm_runtime_get_running_mode(module_inst) == Mode_LLVM_JIT)
+            return aot_copy_callstack_standard_frame(
+                exec_env, frames, length, skip_n, error_buf,
+                sizeof(error_buf));
+#endif
+        return wasm_interp_copy_callstack(exec_env, frames, length, skip_n,
+                                          error_buf, sizeof(error_buf));
+    }
+#endif
+#if WASM_ENABLE_AOT != 0 && WASM_ENABLE_AOT_STACK_FRAME != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return aot_copy_callstack(exec_env, frames, length, skip_n, error_buf,
+                                  sizeof(error_buf));
+#endif
+    (void)module_inst;
+    (void)error_buf;
+    return 0;
+}
+
+static uint64
+hash_call_path(WASMModuleInstanceCommon *module_inst,
+               const uint32 *func_indexes, uint32 frame_count)
+{
+    /* FNV-1a */
+    uint64 hash = 14695981039346656037ULL;
+    uint32 i;
+
+    hash = (hash ^ (uint64)(uintptr_t)module_inst) * 1099511628211ULL;
+    for (i = 0; i < frame_count; i++)
+        hash = (hash ^ func_indexes[i]) * 1099511628211ULL;
+    /* 0 means a free slot */
+    return hash ? hash : 1;
+}
+
+static void
+record_call_path(WASMModuleInstanceCommon *module_inst,
+                 const uint32 *func_indexes, uint32 frame_count)
+{
+    uint64 hash = hash_call_path(module_inst, func_indexes, frame_count);
+    uint32 mask = profiler.call_path_count - 1;
+    uint32 idx = (uint32)hash & mask, i, j;
+
+    for (i = 0; i < MAX_PROBE_NUM && i <= mask; i++, idx = (idx + 1) & mask) {
+        SampledCallPath *call_path = profiler.call_paths + idx;
+        uint64 expected = 0;
+
+        /* Regard the call paths with the same 64-bit hash as the same one */
+        if (__atomic_compare_exchange_n(&call_path->hash, &expected, hash,
+                                        false, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_SEQ_CST)) {
+            /* The slot is claimed, it is only read after the profiler
+               is stopped */
+            call_path->module_inst = module_inst;
+            call_path->frame_count = frame_count;
+            for (j = 0; j < frame_count; j++)
+                call_path->func_indexes[j] = func_indexes[j];
+            BH_ATOMIC_32_FETCH_ADD(call_path->count, 1);
+            return;
+        }
+        if (expected == hash) {
+            BH_ATOMIC_32_FETCH_ADD(call_path->count, 1);
+            return;
+        }
+    }
+
+    BH_ATOMIC_32_FETCH_ADD(profiler.lost_count, 1);
+}
+
+static void
+sampling_handler(void)
+{
+    WASMExecEnv *exec_env = sampled_exec_env;
+    WASMCApiFrame frames[COPY_FRAME_NUM];
+    uint32 func_indexes[WASM_SAMPLING_PROF_MAX_DEPTH];
+    uint32 frame_count = 0, length, n, i;
+
+    /* Count the handler before checking whether the profiler is running,
+       so that the profiler can wait until the handlers finish */
+    BH_ATOMIC_32_FETCH_ADD(profiler.handler_count, 1);
+    if (!BH_ATOMIC_32_LOAD(profiler.running))
+        goto done;
+
+    if (!exec_env) {
+        BH_ATOMIC_32_FETCH_ADD(profiler.native_count, 1);
+        goto done;
+    }
+
+    while (frame_count < WASM_SAMPLING_PROF_MAX_DEPTH) {
+        length = WASM_SAMPLING_PROF_MAX_DEPTH - frame_count;
+        if (length > COPY_FRAME_NUM)
+            length = COPY_FRAME_NUM;
+        n = copy_frames(exec_env, frames, length, frame_count);
+        for (i = 0; i < n; i++)
+            func_indexes[frame_count++] = frames[i].func_index;
+        if (n < length)
+            break;
+    }
+
+    if (frame_count > 0)
+        record_call_path(exec_env->module_inst, func_indexes, frame_count);
+    else
+        BH_ATOMIC_32_FETCH_ADD(profiler.native_count, 1);
+
+done:
+    BH_ATOMIC_32_FETCH_SUB(profiler.handler_count, 1);
+}
+
+bool
+wasm_runtime_start_sampling_profiler(uint32 interval_us, uint32 max_call_paths)
+{
+    uint32 call_path_count = 1;
+    uint64 total_size;
+
+    if (BH_ATOMIC_32_LOAD(profiler.running)) {
+        LOG_ERROR("sampling profiler is already running");
+        return false;
+    }
+    if (interval_us == 0) {
+        LOG_ERROR("invalid sampling interval");
+        return false;
+    }
+
+    if (max_call_paths == 0)
+        max_call_paths = WASM_SAMPLING_PROF_DEFAULT_CALL_PATHS;
+    while (call_path_count < max_call_paths && call_path_count < (1U << 30))
+        call_path_count <<= 1;
+
+    /* Discard the previous samples */
+    if (profiler.call_paths) {
+        wasm_runtime_free(profiler.call_paths);
+        profiler.call_paths = NULL;
+    }
+
+    total_size = sizeof(SampledCallPath) * (uint64)call_path_count;
+    if (total_size >= UINT32_MAX
+        || !(profiler.call_paths = wasm_runtime_malloc((uint32)total_size))) {
+        LOG_ERROR("allocate memory for sampling profiler failed");
+        return false;
+    }
+    memset(profiler.call_paths, 0, (uint32)total_size);
+    profiler.call_path_count = call_path_count;
+    profiler.interval_us = interval_us;
+    BH_ATOMIC_32_STORE(profiler.native_count, 0);
+    BH_ATOMIC_32_STORE(profiler.lost_count, 0);
+
+    BH_ATOMIC_32_STORE(profiler.running, 1);
+    if (os_sampling_timer_start(interval_us, sampling_handler) != BHT_OK) {
+        LOG_ERROR("start sampling timer failed");
+        BH_ATOMIC_32_STORE(profiler.running, 0);
+        return false;
+    }
+    return true;
+}
+
+void
+wasm_runtime_stop_sampling_profiler(void)
+{
+    if (!BH_ATOMIC_32_LOAD(profiler.running))
+        return;
+
+    BH_ATOMIC_32_STORE(profiler.running, 0);
+    os_sampling_timer_stop();
+
+    /* Wait until the handlers interrupting the other threads finish */
+    while (BH_ATOMIC_32_LOAD(profiler.handler_count) > 0)
+        os_usleep(100);
+
+    LOG_VERBOSE("Sampling profiler stopped, %" PRIu32 " samples out of wasm, "
+                "%" PRIu32 " samples lost",
+                BH_ATOMIC_32_LOAD(profiler.native_count),
+                BH_ATOMIC_32_LOAD(profiler.lost_count));
+}
+
+void
+wasm_sampling_prof_destroy(void)
+{
+    wasm_runtime_stop_sampling_profiler();
+    if (profiler.call_paths) {
+        wasm_runtime_free(profiler.call_paths);
+        profiler.call_paths = NULL;
+    }
+}
+
+/* The writer only counts the size if buf is NULL */
+typedef struct ProfileWriter {
+    uint8 *buf;
+    uint64 len;
+    uint64 size;
+} ProfileWriter;
+
+static void
+write_bytes(ProfileWriter *writer, const void *data, uint64 size)
+{
+    if (writer->buf && writer->size + size <= writer->len)
+        bh_memcpy_s(writer->buf + writer->size,
+                    (uint32)(writer->len - writer->size), data, (uint32)size);
+    writer->size += size;
+}
+
+static const char *
+get_func_name(WASMModuleInstanceCommon *module_inst, uint32 func_index,
+              char *buf, uint32 buf_size)
+{
+    const char *func_name = NULL;
+
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        func_name = wasm_get_func_name_by_index(
+            (WASMModuleInstance *)module_inst, func_index);
+#endif
+#if WASM_ENABLE_AOT != 0 && WASM_ENABLE_AOT_STACK_FRAME != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        func_name = aot_get_func_name_by_index(
+            (AOTModuleInstance *)module_inst, func_index);
+#endif
+
+    if (!func_name) {
+        snprintf(buf, buf_size, "$f%" PRIu32, func_index);
+        func_name = buf;
+    }
+    return func_name;
+}
+
+static void
+write_folded_profile(ProfileWriter *writer)
+{
+    char name_buf[16], count_buf[16];
+    const char *func_name;
+    uint32 i, j;
+
+    for (i = 0; i < profiler.call_path_count; i++) {
+        SampledCallPath *call_path = profiler.call_paths + i;
+
+        if (!call_path->hash)
+            continue;
+
+        /* From the root caller to the leaf callee */
+        for (j = call_path->frame_count; j > 0; j--) {
+            func_name = get_func_name(call_path->module_inst,
+                                      call_path->func_indexes[j - 1],
+                                      name_buf, sizeof(name_buf));
+            if (j < call_path->frame_count)
+                write_bytes(writer, ";", 1);
+            /* The frames are separated by ';' and the count by ' ' */
+            for (; *func_name; func_name++) {
+                char c = (*func_name == ';' || *func_name == ' ')
+                             ? '_'
+                             : *func_name;
+                write_bytes(writer, &c, 1);
+            }
+        }
+        snprintf(count_buf, sizeof(count_buf), " %" PRIu32 "\n",
+                 call_path->count);
+        write_bytes(writer, count_buf, strlen(count_buf));
+    }
+}
+
+/*
+ * The pprof profile is a protobuf message, see
+ * https://github.com/google/pprof/blob/main/proto/profile.proto
+ */
+
+/* Field numbers of the messages */
+#define PROFILE_SAMPLE_TYPE 1
+#define PROFILE_SAMPLE 2
+#define PROFILE_LOCATION 4
+#define PROFILE_FUNCTION 5
+#define PROFILE_STRING_TABLE 6
+#define PROFILE_PERIOD_TYPE 11
+#define PROFILE_PERIOD 12
+#define VALUE_TYPE_TYPE 1
+#define VALUE_TYPE_UNIT 2
+#define SAMPLE_LOCATION_ID 1
+#define SAMPLE_VALUE 2
+#define LOCATION_ID 1
+#define LOCATION_LINE 4
+#define LINE_FUNCTION_ID 1
+#define FUNCTION_ID 1
+#define FUNCTION_NAME 2
+#define FUNCTION_SYSTEM_NAME 3
+
+/* Wire types */
+#define WIRE_VARINT 0
+#define WIRE_LEN 2
+
+/* Indexes of the string table, the function names follow them */
+enum {
+    STR_EMPTY = 0,
+    STR_SAMPLES,
+    STR_COUNT,
+    STR_CPU,
+    STR_NANOSECONDS,
+    STR_FUNC_NAME_START,
+};
+
+static const char *profile_strings[] = { "", "samples", "count", "cpu",
+                                         "nanoseconds" };
+
+/* A function (location) of the profile, the id is its index plus 1 */
+typedef struct ProfileFunc {
+    WASMModuleInstanceCommon *module_inst;
+    uint32 func_index;
+} ProfileFunc;
+
+static void
+write_varint(ProfileWriter *writer, uint64 value)
+{
+    uint8 bytes[10];
+    uint32 n = 0;
+
+    do {
+        bytes[n] = value & 0x7F;
+        value >>= 7;
+        if (value)
+            bytes[n] |= 0x80;
+        n++;
+    } while (value);
+    write_bytes(writer, bytes, n);
+}
+
+static void
+write_tag(ProfileWriter *writer, uint32 field, uint32 wire_type)
+{
+    write_varint(writer, ((uint64)field << 3) | wire_type);
+}
+
+static void
+write_varint_field(ProfileWriter *writer, uint32 field, uint64 value)
+{
+    write_tag(writer, field, WIRE_VARINT);
+    write_varint(writer, value);
+}
+
+static void
+write_len_field(ProfileWriter *writer, uint32 field, uint64 size)
+{
+    write_tag(writer, field, WIRE_LEN);
+    write_varint(writer, size);
+}
+
+static void
+write_string_field(ProfileWriter *writer, uint32 field, const char *str)
+{
+    uint64 size = strlen(str);
+
+    write_len_field(writer, field, size);
+    write_bytes(writer, str, size);
+}
+
+static int
+profile_func_cmp(const void *a, const void *b)
+{
+    const ProfileFunc *func_a = a, *func_b = b;
+
+    if (func_a->module_inst != func_b->module_inst)
+        return (uintptr_t)func_a->module_inst < (uintptr_t)func_b->module_inst
+                   ? -1
+                   : 1;
+    if (func_a->func_index != func_b->func_index)
+        return func_a->func_index < func_b->func_index ? -1 : 1;
+    return 0;
+}
+
+static uint32
+get_profile_func_id(ProfileFunc *funcs, uint32 func_count,
+                    WASMModuleInstanceCommon *module_inst, uint32 func_index)
+{
+    ProfileFunc key = { module_inst, func_index }, *func;
+
+    func = bsearch(&key, funcs, func_count, sizeof(ProfileFunc),
+                   profile_func_cmp);
+    bh_assert(func);
+    return (uint32)(func - funcs) + 1;
+}
+
+static void
+write_value_type(ProfileWriter *writer, uint32 field, uint32 type,
+                 uint32 unit)
+{
+    ProfileWriter counter = { 0 };
+
+    write_varint_field(&counter, VALUE_TYPE_TYPE, type);
+    write_varint_field(&counter, VALUE_TYPE_UNIT, unit);
+    write_len_field(writer, field, counter.size);
+    write_varint_field(writer, VALUE_TYPE_TYPE, type);
+    write_varint_field(writer, VALUE_TYPE_UNIT, unit);
+}
+
+static void
+write_sample(ProfileWriter *writer, SampledCallPath *call_path,
+             ProfileFunc *funcs, uint32 func_count)
+{
+    ProfileWriter counter;
+    uint64 nanoseconds =
+        (uint64)call_path->count * profiler.interval_us * 1000;
+    uint64 location_ids_size = 0, values_size, sample_size;
+    uint32 i, id;
+
+    /* The location ids are from the leaf callee to the root caller */
+    for (i = 0; i < call_path->frame_count; i++) {
+        memset(&counter, 0, sizeof(counter));
+        write_varint(&counter,
+                     get_profile_func_id(funcs, func_count,
+                                         call_path->module_inst,
+                                         call_path->func_indexes[i]));
+        location_ids_size += counter.size;
+    }
+    memset(&counter, 0, sizeof(counter));
+    write_varint(&counter, call_path->count);
+    write_varint(&counter, nanoseconds);
+    values_size = counter.size;
+
+    memset(&counter, 0, sizeof(counter));
+    write_len_field(&counter, SAMPLE_LOCATION_ID, location_ids_size);
+    write_len_field(&counter, SAMPLE_VALUE, values_size);
+    sample_size = counter.size + location_ids_size + values_size;
+
+    write_len_field(writer, PROFILE_SAMPLE, sample_size);
+    /* Packed repeated fields */
+    write_len_field(writer, SAMPLE_LOCATION_ID, location_ids_size);
+    for (i = 0; i < call_path->frame_count; i++) {
+        id = get_profile_func_id(funcs, func_count, call_path->module_inst,
+                                 call_path->func_indexes[i]);
+        write_varint(writer, id);
+    }
+    write_len_field(writer, SAMPLE_VALUE, values_size);
+    write_varint(writer, call_path->count);
+    write_varint(writer, nanoseconds);
+}
+
+static void
+write_location(ProfileWriter *writer, uint32 id)
+{
+    ProfileWriter counter = { 0 };
+    uint64 line_size;
+
+    /* Each function has a location with the same id */
+    write_varint_field(&counter, LINE_FUNCTION_ID, id);
+    line_size = counter.size;
+
+    memset(&counter, 0, sizeof(counter));
+    write_varint_field(&counter, LOCATION_ID, id);
+    write_len_field(&counter, LOCATION_LINE, line_size);
+
+    write_len_field(writer, PROFILE_LOCATION, counter.size + line_size);
+    write_varint_field(writer, LOCATION_ID, id);
+    write_len_field(writer, LOCATION_LINE, line_size);
+    write_varint_field(writer, LINE_FUNCTION_ID, id);
+}
+
+static void
+write_function(ProfileWriter *writer, uint32 id)
+{
+    ProfileWriter counter = { 0 };
+    uint32 name = STR_FUNC_NAME_START + id - 1;
+
+    write_varint_field(&counter, FUNCTION_ID, id);
+    write_varint_field(&counter, FUNCTION_NAME, name);
+    write_varint_field(&counter, FUNCTION_SYSTEM_NAME, name);
+
+    write_len_field(writer, PROFILE_FUNCTION, counter.size);
+    write_varint_field(writer, FUNCTION_ID, id);
+    write_varint_field(writer, FUNCTION_NAME, name);
+    write_varint_field(writer, FUNCTION_SYSTEM_NAME, name);
+}
+
+static bool
+write_pprof_profile(ProfileWriter *writer)
+{
+    ProfileFunc *funcs = NULL;
+    char name_buf[16];
+    uint64 total_size = 0;
+    uint32 func_count = 0, i, j;
+
+    /* Collect the distinct functions of the call paths */
+    for (i = 0; i < profiler.call_path_count; i++) {
+        if (profiler.call_paths[i].hash)
+            total_size += profiler.call_paths[i].frame_count;
+    }
+    total_size *= sizeof(ProfileFunc);
+    if (total_size >= UINT32_MAX
+        || (total_size > 0
+            && !(funcs = wasm_runtime_malloc((uint32)total_size)))) {
+        LOG_ERROR("allocate memory for sampling profile failed");
+        return false;
+    }
+    for (i = 0; i < profiler.call_path_count; i++) {
+        SampledCallPath *call_path = profiler.call_paths + i;
+
+        if (!call_path->hash)
+            continue;
+        for (j = 0; j < call_path->frame_count; j++) {
+            funcs[func_count].module_inst = call_path->module_inst;
+            funcs[func_count].func_index = call_path->func_indexes[j];
+            func_count++;
+        }
+    }
+    if (func_count > 0) {
+        qsort(funcs, func_count, sizeof(ProfileFunc), profile_func_cmp);
+        for (i = 1, j = 1; i < func_count; i++) {
+            if (profile_func_cmp(funcs + i, funcs + j - 1) != 0)
+                funcs[j++] = funcs[i];
+        }
+        func_count = j;
+    }
+
+    write_value_type(writer, PROFILE_SAMPLE_TYPE, STR_SAMPLES, STR_COUNT);
+    write_value_type(writer, PROFILE_SAMPLE_TYPE, STR_CPU, STR_NANOSECONDS);
+    for (i = 0; i < profiler.call_path_count; i++) {
+        if (profiler.call_paths[i].hash)
+            write_sample(writer, profiler.call_paths + i, funcs, func_count);
+    }
+    for (i = 0; i < func_count; i++) {
+        write_location(writer, i + 1);
+        write_function(writer, i + 1);
+    }
+    for (i = 0; i < STR_FUNC_NAME_START; i++)
+        write_string_field(writer, PROFILE_STRING_TABLE, profile_strings[i]);
+    for (i = 0; i < func_count; i++) {
+        write_string_field(writer, PROFILE_STRING_TABLE,
+                           get_func_name(funcs[i].module_inst,
+                                         funcs[i].func_index, name_buf,
+                                         sizeof(name_buf)));
+    }
+    write_value_type(writer, PROFILE_PERIOD_TYPE, STR_CPU, STR_NANOSECONDS);
+    write_varint_field(writer, PROFILE_PERIOD,
+                       (uint64)profiler.interval_us * 1000);
+
+    if (funcs)
+        wasm_runtime_free(funcs);
+    return true;
+}
+
+static bool
+write_profile(wasm_sampling_profile_format_t format, ProfileWriter *writer)
+{
+    if (BH_ATOMIC_32_LOAD(profiler.running)) {
+        LOG_ERROR("sampling profiler is still running");
+        return false;
+    }
+    if (!profiler.call_paths) {
+        LOG_ERROR("sampling profiler isn't started");
+        return false;
+    }
+
+    switch (format) {
+        case WASM_SAMPLING_PROFILE_FOLDED:
+            write_folded_profile(writer);
+            return true;
+        case WASM_SAMPLING_PROFILE_PPROF:
+            return write_pprof_profile(writer);
+        default:
+            LOG_ERROR("invalid sampling profile format");
+            return false;
+    }
+}
+
+uint32
+wasm_runtime_get_sampling_profile_size(wasm_sampling_profile_format_t format)
+{
+    ProfileWriter writer = { 0 };
+
+    if (!write_profile(format, &writer) || writer.size >= UINT32_MAX)
+        return 0;
+    return (uint32)writer.size;
+}
+
+uint32
+wasm_runtime_dump_sampling_profile_to_buf(
+    wasm_sampling_profile_format_t format, char *buf, uint32 len)
+{
+    ProfileWriter writer = { 0 };
+
+    if (!buf)
+        return 0;
+
+    writer.buf = (uint8 *)buf;
+    writer.len = len;
+    if (!write_profile(format, &writer) || writer.size > len)
+        return 0;
+    return (uint32)writer.size;
+}
+
+#endif /* end of WASM_ENABLE_SAMPLING_PROFILING != 0 */
@@ -11,6 +11,9 @@
 #if WASM_ENABLE_AOT != 0
 #include "../aot/aot_runtime.h"
 #endif
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+#include "../libraries/task-scheduler/task_scheduler.h"
+#endif
 
 /*
  * Note: this lock can be per memory.
@@ -41,6 +44,11 @@ typedef struct AtomicWaitNode {
     bh_list_link l;
     uint8 status;
     korp_cond wait_cond;
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    /* The waiting task, which is switched out instead of waiting
+       on wait_cond */
+    WASMTask *task;
+#endif
 } AtomicWaitNode;
 
 /* Atomic wait map */
@@ -165,7 +173,12 @@ notify_wait_list(bh_list *wait_list, uint32 count)
 
         node->status = S_NOTIFIED;
         /* wakeup */
-        os_cond_signal(&node->wait_cond);
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+        if (node->task)
+            wasm_task_wake(node->task);
+        else
+#endif
+            os_cond_signal(&node->wait_cond);
 
         node = next;
     }
@@ -173,6 +186,18 @@ notify_wait_list(bh_list *wait_list, uint32 count)
     return notify_count;
 }
 
+static void
+wait_node_wait(AtomicWaitNode *node, korp_mutex *lock, uint64 useconds)
+{
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    if (node->task) {
+        wasm_task_wait(node->task, lock, useconds);
+        return;
+    }
+#endif
+    os_cond_reltimedwait(&node->wait_cond, lock, useconds);
+}
+
 static AtomicWaitInfo *
 acquire_wait_info(void *address, AtomicWaitNode *wait_node)
 {
@@ -355,6 +380,9 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
     }
 
     wait_node->status = S_WAITING;
+#if WASM_ENABLE_TASK_SCHEDULER != 0
+    wait_node->task = wasm_task_get_current();
+#endif
 
     /* Acquire the wait info, create new one if not exists */
     wait_info = acquire_wait_info(address, wait_node);
@@ -375,8 +403,7 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
         if (timeout < 0) {
             /* wait forever until it is notified or terminated
                here we keep waiting and checking every second */
-            os_cond_reltimedwait(&wait_node->wait_cond, lock,
-                                 (uint64)timeout_1sec);
+            wait_node_wait(wait_node, lock, (uint64)timeout_1sec);
             if (wait_node->status == S_NOTIFIED /* notified by atomic.notify */
 #if WASM_ENABLE_THREAD_MGR != 0
                 /* terminated by other thread */
@@ -389,7 +416,7 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
         else {
             timeout_wait =
                 timeout_left < timeout_1sec ? timeout_left : timeout_1sec;
-            os_cond_reltimedwait(&wait_node->wait_cond, lock, timeout_wait);
+            wait_node_wait(wait_node, lock, timeout_wait);
             if (wait_node->status == S_NOTIFIED /* notified by atomic.notify */
                 || timeout_left <= timeout_wait /* time out */
 #if WASM_ENABLE_THREAD_MGR != 0
@@ -456,6 +456,89 @@ fail:
 }
 
 #if WASM_ENABLE_GC != 0
+/* Get the end offset of the fields of a struct type in the target */
+static uint32
+get_struct_fields_end_offset(const WASMStructType *struct_type, bool is_64bit)
+{
+    const WASMStructFieldType *fields = struct_type->fields;
+    /* offsetof(WASMStructObject, field_data) in the target */
+    uint32 end_offset = is_64bit ? sizeof(uint64) : sizeof(uint32);
+    uint32 field_end, j;
+
+    for (j = 0; j < struct_type->field_count; j++) {
+        if (is_64bit)
+            field_end =
+                fields[j].field_offset_64bit + fields[j].field_size_64bit;
+        else
+            field_end =
+                fields[j].field_offset_32bit + fields[j].field_size_32bit;
+        if (field_end > end_offset)
+            end_offset = field_end;
+    }
+    return end_offset;
+}
+
+/**
+ * Calculate the field offsets of a struct type in the same way as
+ * wasm_struct_type_set_layout() with sort_by_size set, the fields
+ * inherited from parent_type keep their offsets and the others are laid
+ * out in descending order of field size.
+ */
+static void
+calculate_struct_field_offsets(WASMStructType *struct_type,
+                               const WASMStructType *parent_type,
+                               bool is_target_x86, bool is_64bit)
+{
+    static const uint8 field_sizes[] = { 16, 8, 4, 2, 1 };
+    WASMStructFieldType *fields = struct_type->fields;
+    uint32 offset = is_64bit ? sizeof(uint64) : sizeof(uint32);
+    uint32 inherited_count = 0, field_size, i, j;
+
+    if (parent_type && parent_type->field_count <= struct_type->field_count) {
+        for (i = 0; i < parent_type->field_count; i++) {
+            if (fields[i].field_size_64bit
+                    != parent_type->fields[i].field_size_64bit
+                || fields[i].field_size_32bit
+                       != parent_type->fields[i].field_size_32bit)
+                break;
+        }
+        if (i == parent_type->field_count) {
+            for (i = 0; i < parent_type->field_count; i++) {
+                if (is_64bit)
+                    fields[i].field_offset_64bit =
+                        parent_type->fields[i].field_offset_64bit;
+                else
+                    fields[i].field_offset_32bit =
+                        parent_type->fields[i].field_offset_32bit;
+            }
+            inherited_count = parent_type->field_count;
+            offset = get_struct_fields_end_offset(parent_type, is_64bit);
+        }
+    }
+
+    for (i = 0; i < sizeof(field_sizes); i++) {
+        for (j = inherited_count; j < struct_type->field_count; j++) {
+            field_size = is_64bit ? fields[j].field_size_64bit
+                                  : fields[j].field_size_32bit;
+            if (field_size != field_sizes[i])
+                continue;
+
+            if (!is_target_x86) {
+                if (field_size == 2)
+                    offset = align_uint(offset, 2);
+                else if (field_size >= 4)
+                    offset = align_uint(offset, 4);
+            }
+
+            if (is_64bit)
+                fields[j].field_offset_64bit = offset;
+            else
+                fields[j].field_offset_32bit = offset;
+            offset += field_size;
+        }
+    }
+}
+
 static void
 calculate_struct_field_sizes_offsets(AOTCompData *comp_data, bool is_target_x86,
                                      bool gc_enabled)
@@ -465,15 +548,10 @@ calculate_struct_field_sizes_offsets(AOTCompData *comp_data, bool is_target_x86,
     for (i = 0; i < comp_data->type_count; i++) {
         if (comp_data->types[i]->type_flag == WASM_TYPE_STRUCT) {
             WASMStructType *struct_type = (WASMStructType *)comp_data->types[i];
+            WASMStructType *parent_type = NULL;
             WASMStructFieldType *fields = struct_type->fields;
-            uint32 field_offset_64bit, field_offset_32bit;
             uint32 field_size_64bit, field_size_32bit, j;
-
-            /* offsetof(WASMStructObject, field_data) in 64-bit */
-            field_offset_64bit = sizeof(uint64);
-
-            /* offsetof(WASMStructObject, field_data) in 32-bit */
-            field_offset_32bit = sizeof(uint32);
+            uint32 parent_type_idx = struct_type->base_type.parent_type_idx;
 
             for (j = 0; j < struct_type->field_count; j++) {
                 get_value_type_size(fields[j].field_type, gc_enabled,
@@ -481,25 +559,19 @@ calculate_struct_field_sizes_offsets(AOTCompData *comp_data, bool is_target_x86,
 
                 fields[j].field_size_64bit = field_size_64bit;
                 fields[j].field_size_32bit = field_size_32bit;
-
-                if (!is_target_x86) {
-                    if (field_size_64bit == 2)
-                        field_offset_64bit = align_uint(field_offset_64bit, 2);
-                    else if (field_size_64bit >= 4)
-                        field_offset_64bit = align_uint(field_offset_64bit, 4);
-
-                    if (field_size_32bit == 2)
-                        field_offset_32bit = align_uint(field_offset_32bit, 2);
-                    else if (field_size_32bit >= 4)
-                        field_offset_32bit = align_uint(field_offset_32bit, 4);
-                }
-
-                fields[j].field_offset_64bit = field_offset_64bit;
-                fields[j].field_offset_32bit = field_offset_32bit;
-
-                field_offset_64bit += field_size_64bit;
-                field_offset_32bit += field_size_32bit;
             }
+
+            /* the parent type has a smaller index and has been handled */
+            if (parent_type_idx < i
+                && comp_data->types[parent_type_idx]->type_flag
+                       == WASM_TYPE_STRUCT)
+                parent_type =
+                    (WASMStructType *)comp_data->types[parent_type_idx];
+
+            calculate_struct_field_offsets(struct_type, parent_type,
+                                           is_target_x86, true);
+            calculate_struct_field_offsets(struct_type, parent_type,
+                                           is_target_x86, false);
         }
     }
 }
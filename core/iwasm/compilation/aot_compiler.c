@@ -995,6 +995,60 @@ init_comp_frame(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
+/* Whether the opcode ends a basic block, the instruction count of the
+   block is charged before translating it */
+static bool
+is_instruction_metering_point(uint8 opcode, const uint8 *frame_ip)
+{
+    switch (opcode) {
+        case WASM_OP_UNREACHABLE:
+        case WASM_OP_BLOCK:
+        case WASM_OP_LOOP:
+        case WASM_OP_IF:
+        case WASM_OP_ELSE:
+        case WASM_OP_END:
+        case WASM_OP_BR:
+        case WASM_OP_BR_IF:
+        case WASM_OP_BR_TABLE:
+        case WASM_OP_RETURN:
+        case WASM_OP_CALL:
+        case WASM_OP_CALL_INDIRECT:
+        case WASM_OP_RETURN_CALL:
+        case WASM_OP_RETURN_CALL_INDIRECT:
+        case WASM_OP_CALL_REF:
+        case WASM_OP_RETURN_CALL_REF:
+        case WASM_OP_BR_ON_NULL:
+        case WASM_OP_BR_ON_NON_NULL:
+        case EXT_OP_BLOCK:
+        case EXT_OP_LOOP:
+        case EXT_OP_IF:
+        case EXT_OP_BR_TABLE_CACHE:
+            return true;
+        case WASM_OP_GC_PREFIX:
+            /* The sub opcodes of br_on_cast and br_on_cast_fail are
+               single byte LEB128 */
+            return *frame_ip == WASM_OP_BR_ON_CAST
+                   || *frame_ip == WASM_OP_BR_ON_CAST_FAIL;
+        default:
+            return false;
+    }
+}
+
+/* Check the instruction count and the epoch deadline in the loop header */
+static bool
+compile_loop_header_checks(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    if (comp_ctx->enable_instruction_metering
+        && !aot_check_instruction_count(comp_ctx, func_ctx))
+        return false;
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    if (comp_ctx->enable_epoch_interruption
+        && !aot_check_epoch_deadline(comp_ctx, func_ctx))
+        return false;
+#endif
+    return true;
+}
+
 static bool
 aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
 {
@@ -1012,6 +1066,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
     uint32 bytes = 4, align;
     mem_offset_t offset;
     uint32 type_index;
+    uint32 instr_count = 0;
     bool sign = true;
     int32 i32_const;
     int64 i64_const;
@@ -1027,6 +1082,10 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
         comp_ctx->builder,
         func_ctx->block_stack.block_list_head->llvm_entry_block);
 
+#if WASM_ENABLE_LINUX_PERF != 0
+    aot_set_perf_debug_location(comp_ctx, func_ctx, frame_ip);
+#endif
+
     if (comp_ctx->aux_stack_frame_type
         && comp_ctx->call_stack_features.frame_per_function) {
         INT_CONST(func_index_ref,
@@ -1043,7 +1102,21 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
         }
     }
 
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, false)) {
+        return false;
+    }
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    if (comp_ctx->enable_epoch_interruption
+        && (!aot_reload_epoch_deadline(comp_ctx, func_ctx)
+            || !aot_check_epoch_deadline(comp_ctx, func_ctx))) {
+        return false;
+    }
+#endif
+
     while (frame_ip < frame_ip_end) {
+        func_ctx->opcode_ip = frame_ip;
         opcode = *frame_ip++;
 
         if (comp_ctx->aot_frame) {
@@ -1059,6 +1132,20 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
         }
 #endif
 
+#if WASM_ENABLE_LINUX_PERF != 0
+        aot_set_perf_debug_location(comp_ctx, func_ctx, frame_ip - 1);
+#endif
+
+        if (comp_ctx->enable_instruction_metering) {
+            instr_count++;
+            if (is_instruction_metering_point(opcode, frame_ip)) {
+                if (!aot_emit_instruction_metering(comp_ctx, func_ctx,
+                                                   instr_count))
+                    return false;
+                instr_count = 0;
+            }
+        }
+
         switch (opcode) {
             case WASM_OP_UNREACHABLE:
                 if (!aot_compile_op_unreachable(comp_ctx, func_ctx, &frame_ip))
@@ -1114,6 +1201,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                         (uint32)(LABEL_TYPE_BLOCK + opcode - WASM_OP_BLOCK),
                         param_count, param_types, result_count, result_types))
                     return false;
+                if (opcode == WASM_OP_LOOP
+                    && !compile_loop_header_checks(comp_ctx, func_ctx))
+                    return false;
                 break;
             }
 
@@ -1135,6 +1225,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                         (uint32)(LABEL_TYPE_BLOCK + opcode - EXT_OP_BLOCK),
                         param_count, param_types, result_count, result_types))
                     return false;
+                if (opcode == EXT_OP_LOOP
+                    && !compile_loop_header_checks(comp_ctx, func_ctx))
+                    return false;
                 break;
             }
 
@@ -2555,6 +2648,18 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                         break;
                     }
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                    {
+                        if (!comp_ctx->enable_memory_discard)
+                            goto unsupport_memory_discard;
+                        /* memidx, only the default memory is supported */
+                        frame_ip++;
+                        if (!aot_compile_op_memory_discard(comp_ctx, func_ctx))
+                            return false;
+                        break;
+                    }
+#endif /* WASM_ENABLE_MEMORY_DISCARD */
 #if WASM_ENABLE_REF_TYPES != 0 || WASM_ENABLE_GC != 0
                     case WASM_OP_TABLE_INIT:
                     {
@@ -3995,6 +4100,13 @@ unsupport_bulk_memory:
     return false;
 #endif
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+unsupport_memory_discard:
+    aot_set_last_error("memory.discard instruction was found, "
+                       "try adding --enable-memory-discard option");
+    return false;
+#endif
+
 fail:
     return false;
 }
@@ -4038,6 +4150,13 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
     LLVMDIBuilderFinalize(comp_ctx->debug_builder);
 #endif
 
+#if WASM_ENABLE_LINUX_PERF != 0
+    if (comp_ctx->perf_debug_builder) {
+        LLVMSetCurrentDebugLocation2(comp_ctx->builder, NULL);
+        LLVMDIBuilderFinalize(comp_ctx->perf_debug_builder);
+    }
+#endif
+
     /* Disable LLVM module verification for jit mode to speedup
        the compilation process */
     if (!comp_ctx->is_jit_mode) {
@@ -4503,6 +4503,8 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     }
     if (comp_ctx->enable_gc) {
         obj_data->target_info.feature_flags |= WASM_FEATURE_GARBAGE_COLLECTION;
+        obj_data->target_info.feature_flags |=
+            WASM_FEATURE_PACKED_STRUCT_FIELDS;
     }
     if (comp_ctx->aux_stack_frame_type == AOT_STACK_FRAME_TYPE_TINY) {
         obj_data->target_info.feature_flags |= WASM_FEATURE_TINY_STACK_FRAME;
@@ -4513,6 +4515,20 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     if (!comp_ctx->call_stack_features.func_idx) {
         obj_data->target_info.feature_flags |= WASM_FEATURE_FRAME_NO_FUNC_IDX;
     }
+    if (comp_ctx->enable_instruction_metering) {
+        obj_data->target_info.feature_flags |=
+            WASM_FEATURE_INSTRUCTION_METERING;
+    }
+    if (comp_ctx->enable_epoch_interruption) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_EPOCH_INTERRUPTION;
+    }
+    if (comp_ctx->enable_memory_discard) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_MEMORY_DISCARD;
+    }
+    if (comp_ctx->mem64_clamp_log2 > 0) {
+        obj_data->target_info.feature_flags |=
+            WASM_FEATURE_MEMORY64_HW_BOUND_CHECK;
+    }
 
     bh_print_time("Begin to resolve object file info");
 
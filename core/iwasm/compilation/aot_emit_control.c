@@ -7,6 +7,7 @@
 #include "aot_compiler.h"
 #include "aot_emit_exception.h"
 #include "aot_stack_frame_comp.h"
+#include "aot_interp_prof.h"
 #if WASM_ENABLE_GC != 0
 #include "aot_emit_gc.h"
 #endif
@@ -435,6 +436,10 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
     }
     if (block->label_type == LABEL_TYPE_FUNCTION) {
+        if (comp_ctx->enable_instruction_metering
+            && !aot_sync_instruction_count(comp_ctx, func_ctx, true))
+            goto fail;
+
         if (block->result_count) {
             /* Return the first return value */
             if (!(ret =
@@ -715,31 +720,31 @@ aot_compile_op_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                 MOVE_BLOCK_AFTER(block->llvm_else_block,
                                  block->llvm_entry_block);
                 /* Create condition br IR */
-#if WASM_ENABLE_BRANCH_HINTS != 0
                 LLVMValueRef br_if_val = NULL;
                 BUILD_COND_BR_V(value, block->llvm_entry_block,
                                 block->llvm_else_block, br_if_val);
+#if WASM_ENABLE_BRANCH_HINTS != 0
                 const uint32 off =
                     *p_frame_ip - func_ctx->aot_func->code_body_begin;
                 aot_emit_branch_hint(comp_ctx, func_ctx, off, br_if_val);
-#else
-                BUILD_COND_BR(value, block->llvm_entry_block,
-                              block->llvm_else_block);
 #endif
+                if (!aot_interp_prof_set_branch_weights(comp_ctx, func_ctx,
+                                                        br_if_val))
+                    goto fail;
             }
             else {
                 /* Create condition br IR */
-#if WASM_ENABLE_BRANCH_HINTS != 0
                 LLVMValueRef br_if_val = NULL;
                 BUILD_COND_BR_V(value, block->llvm_entry_block,
                                 block->llvm_end_block, br_if_val);
+#if WASM_ENABLE_BRANCH_HINTS != 0
                 const uint32 off =
                     *p_frame_ip - func_ctx->aot_func->code_body_begin;
                 aot_emit_branch_hint(comp_ctx, func_ctx, off, br_if_val);
-#else
-                BUILD_COND_BR(value, block->llvm_entry_block,
-                              block->llvm_end_block);
 #endif
+                if (!aot_interp_prof_set_branch_weights(comp_ctx, func_ctx,
+                                                        br_if_val))
+                    goto fail;
                 block->is_reachable = true;
             }
             if (!push_aot_block_to_stack_and_pass_params(comp_ctx, func_ctx,
@@ -1005,6 +1010,203 @@ fail:
     return false;
 }
 
+/* Charge the instructions of the basic block ending at current position,
+   the count left is only checked at loop headers, calls and returns */
+bool
+aot_emit_instruction_metering(AOTCompContext *comp_ctx,
+                              AOTFuncContext *func_ctx, uint32 instr_count)
+{
+    LLVMValueRef count;
+
+    if (instr_count == 0)
+        return true;
+
+    if (!(count = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                 func_ctx->instr_count, "instr_count"))
+        || !(count = LLVMBuildSub(comp_ctx->builder, count,
+                                  I64_CONST(instr_count), "instr_count_sub"))
+        || !LLVMBuildStore(comp_ctx->builder, count, func_ctx->instr_count)) {
+        aot_set_last_error("llvm build instructions failed");
+        return false;
+    }
+    return true;
+}
+
+/* Throw exception if the instructions charged exceed the limit */
+bool
+aot_check_instruction_count(AOTCompContext *comp_ctx,
+                            AOTFuncContext *func_ctx)
+{
+    LLVMValueRef count, is_exceeded;
+    LLVMBasicBlockRef check_succ;
+
+    if (!(count = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                 func_ctx->instr_count, "instr_count"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+
+    BUILD_ICMP(LLVMIntSLT, count, I64_ZERO, is_exceeded,
+               "instr_count_exceeded");
+
+    CREATE_BLOCK(check_succ, "instr_count_check_succ");
+    MOVE_BLOCK_AFTER_CURR(check_succ);
+
+    if (!aot_emit_exception(comp_ctx, func_ctx,
+                            EXCE_INSTRUCTION_LIMIT_EXCEEDED, true, is_exceeded,
+                            check_succ))
+        goto fail;
+
+    SET_BUILDER_POS(check_succ);
+    return true;
+fail:
+    return false;
+}
+
+/* The count left is kept in a 64-bit local variable, in which no limit
+   (a negative exec_env->instructions_to_execute) is represented by
+   INT64_MAX. Check and sync it to exec_env before calling other functions
+   or returning, and reload it after the callee returns */
+bool
+aot_sync_instruction_count(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           bool to_exec_env)
+{
+    LLVMValueRef count, count_i32, is_unlimited;
+
+    if (to_exec_env) {
+        if (!aot_check_instruction_count(comp_ctx, func_ctx))
+            return false;
+
+        if (!(count = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                     func_ctx->instr_count, "instr_count"))) {
+            aot_set_last_error("llvm build load failed");
+            return false;
+        }
+        BUILD_ICMP(LLVMIntSGT, count, I64_CONST(INT32_MAX), is_unlimited,
+                   "instr_count_unlimited");
+        if (!(count_i32 = LLVMBuildTrunc(comp_ctx->builder, count, I32_TYPE,
+                                         "instr_count_i32"))
+            || !(count_i32 =
+                     LLVMBuildSelect(comp_ctx->builder, is_unlimited,
+                                     I32_NEG_ONE, count_i32, "instr_count"))
+            || !LLVMBuildStore(comp_ctx->builder, count_i32,
+                               func_ctx->instr_count_ptr)) {
+            aot_set_last_error("llvm build instructions failed");
+            return false;
+        }
+    }
+    else {
+        if (!(count_i32 = LLVMBuildLoad2(comp_ctx->builder, I32_TYPE,
+                                         func_ctx->instr_count_ptr,
+                                         "instr_count_i32"))) {
+            aot_set_last_error("llvm build load failed");
+            return false;
+        }
+        BUILD_ICMP(LLVMIntSLT, count_i32, I32_ZERO, is_unlimited,
+                   "instr_count_unlimited");
+        if (!(count = LLVMBuildSExt(comp_ctx->builder, count_i32, I64_TYPE,
+                                    "instr_count"))
+            || !(count = LLVMBuildSelect(comp_ctx->builder, is_unlimited,
+                                         I64_CONST(INT64_MAX), count,
+                                         "instr_count"))
+            || !LLVMBuildStore(comp_ctx->builder, count,
+                               func_ctx->instr_count)) {
+            aot_set_last_error("llvm build instructions failed");
+            return false;
+        }
+    }
+    return true;
+fail:
+    return false;
+}
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+/* Copy exec_env->epoch_deadline to the local variable, the deadline can
+   only be changed by the host, so it is reloaded after calls */
+bool
+aot_reload_epoch_deadline(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMValueRef deadline;
+
+    if (!(deadline = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                    func_ctx->epoch_deadline_ptr,
+                                    "epoch_deadline"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+    if (!LLVMBuildStore(comp_ctx->builder, deadline,
+                        func_ctx->epoch_deadline)) {
+        aot_set_last_error("llvm build store failed");
+        return false;
+    }
+    return true;
+}
+
+/* Call wasm_runtime_epoch_deadline_reached if the epoch reaches the
+   deadline of exec_env, and throw exception if it returns false */
+bool
+aot_check_epoch_deadline(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMValueRef epoch, deadline, is_reached, ret, is_interrupted;
+    LLVMValueRef param_values[1], func, value;
+    LLVMTypeRef param_types[1], ret_type, func_type, func_ptr_type;
+    LLVMBasicBlockRef reached_block, check_succ;
+
+    if (!(epoch = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                 func_ctx->epoch_ptr, "epoch"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+    /* The epoch is incremented by other threads, always load it from
+       memory */
+    LLVMSetVolatile(epoch, true);
+
+    if (!(deadline = LLVMBuildLoad2(comp_ctx->builder, I64_TYPE,
+                                    func_ctx->epoch_deadline, "deadline"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+
+    BUILD_ICMP(LLVMIntUGE, epoch, deadline, is_reached,
+               "is_epoch_deadline_reached");
+
+    CREATE_BLOCK(reached_block, "epoch_deadline_reached");
+    MOVE_BLOCK_AFTER_CURR(reached_block);
+    CREATE_BLOCK(check_succ, "epoch_check_succ");
+    MOVE_BLOCK_AFTER(check_succ, reached_block);
+
+    BUILD_COND_BR(is_reached, reached_block, check_succ);
+
+    SET_BUILDER_POS(reached_block);
+
+    param_types[0] = comp_ctx->exec_env_type;
+    ret_type = INT8_TYPE;
+    GET_AOT_FUNCTION(wasm_runtime_epoch_deadline_reached, 1);
+
+    param_values[0] = func_ctx->exec_env;
+    if (!(ret = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                               param_values, 1, "call"))) {
+        aot_set_last_error("llvm build call failed");
+        return false;
+    }
+
+    /* The callback may have extended the deadline */
+    if (!aot_reload_epoch_deadline(comp_ctx, func_ctx))
+        return false;
+
+    /* The exception was set by the runtime */
+    BUILD_ICMP(LLVMIntEQ, ret, I8_ZERO, is_interrupted, "is_interrupted");
+    if (!aot_emit_exception(comp_ctx, func_ctx, EXCE_ALREADY_THROWN, true,
+                            is_interrupted, check_succ))
+        goto fail;
+
+    SET_BUILDER_POS(check_succ);
+    return true;
+fail:
+    return false;
+}
+#endif
+
 bool
 aot_compile_op_br(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                   uint32 br_depth, uint8 **p_frame_ip)
@@ -1178,15 +1380,15 @@ aot_compile_conditional_br(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                 values = NULL;
             }
 
-#if WASM_ENABLE_BRANCH_HINTS != 0
             LLVMValueRef br_if_val = NULL;
             BUILD_COND_BR_V(value_cmp, block_dst->llvm_entry_block,
                             llvm_else_block, br_if_val);
+#if WASM_ENABLE_BRANCH_HINTS != 0
             aot_emit_branch_hint(comp_ctx, func_ctx, instr_offset, br_if_val);
-#else
-            BUILD_COND_BR(value_cmp, block_dst->llvm_entry_block,
-                          llvm_else_block);
 #endif
+            if (!aot_interp_prof_set_branch_weights(comp_ctx, func_ctx,
+                                                    br_if_val))
+                goto fail;
 
             /* Move builder to else block */
             SET_BUILDER_POS(llvm_else_block);
@@ -1229,15 +1431,15 @@ aot_compile_conditional_br(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             }
 
             /* Condition jump to end block */
-#if WASM_ENABLE_BRANCH_HINTS != 0
             LLVMValueRef br_if_val = NULL;
             BUILD_COND_BR_V(value_cmp, block_dst->llvm_end_block,
                             llvm_else_block, br_if_val);
+#if WASM_ENABLE_BRANCH_HINTS != 0
             aot_emit_branch_hint(comp_ctx, func_ctx, instr_offset, br_if_val);
-#else
-            BUILD_COND_BR(value_cmp, block_dst->llvm_end_block,
-                          llvm_else_block);
 #endif
+            if (!aot_interp_prof_set_branch_weights(comp_ctx, func_ctx,
+                                                    br_if_val))
+                goto fail;
             /* Move builder to else block */
             SET_BUILDER_POS(llvm_else_block);
         }
@@ -1495,6 +1697,11 @@ aot_compile_op_return(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         (*p_frame_ip - 1) - comp_ctx->comp_data->wasm_module->buf_code);
 #endif
 
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, true)) {
+        return false;
+    }
+
     if (comp_ctx->aux_stack_frame_type
         && comp_ctx->call_stack_features.frame_per_function
         && !aot_free_frame_per_function_frame_for_aot_func(comp_ctx,
@@ -54,6 +54,26 @@ bool
 check_suspend_flags(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     bool check_terminate_and_suspend);
 
+bool
+aot_emit_instruction_metering(AOTCompContext *comp_ctx,
+                              AOTFuncContext *func_ctx, uint32 instr_count);
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+bool
+aot_reload_epoch_deadline(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+
+bool
+aot_check_epoch_deadline(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+#endif
+
+bool
+aot_check_instruction_count(AOTCompContext *comp_ctx,
+                            AOTFuncContext *func_ctx);
+
+bool
+aot_sync_instruction_count(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           bool to_exec_env);
+
 #if WASM_ENABLE_GC != 0
 bool
 aot_compile_op_br_on_null(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -1455,6 +1455,11 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             return false;
     }
 
+    /* Store the instruction count for the callee */
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, true))
+        return false;
+
 #if WASM_ENABLE_AOT_STACK_FRAME != 0
     if (comp_ctx->aux_stack_frame_type) {
         if (func_idx < import_func_count
@@ -1865,6 +1870,18 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             goto fail;
     }
 
+    /* Load the instruction count left by the callee */
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, false))
+        goto fail;
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* The callee may have changed the epoch deadline */
+    if (comp_ctx->enable_epoch_interruption
+        && !aot_reload_epoch_deadline(comp_ctx, func_ctx))
+        goto fail;
+#endif
+
     ret = true;
 fail:
     if (param_types)
@@ -2156,6 +2173,11 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             return false;
     }
 
+    /* Store the instruction count for the callee */
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, true))
+        return false;
+
     func_param_count = func_type->param_count;
     func_result_count = func_type->result_count;
 
@@ -2733,6 +2755,18 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             goto fail;
     }
 
+    /* Load the instruction count left by the callee */
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, false))
+        goto fail;
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* The callee may have changed the epoch deadline */
+    if (comp_ctx->enable_epoch_interruption
+        && !aot_reload_epoch_deadline(comp_ctx, func_ctx))
+        goto fail;
+#endif
+
     ret = true;
 
 fail:
@@ -2888,6 +2922,11 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             return false;
     }
 
+    /* Store the instruction count for the callee */
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, true))
+        return false;
+
     POP_GC_REF(func_obj);
 
     /* Check if func object is NULL */
@@ -3241,6 +3280,18 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             goto fail;
     }
 
+    /* Load the instruction count left by the callee */
+    if (comp_ctx->enable_instruction_metering
+        && !aot_sync_instruction_count(comp_ctx, func_ctx, false))
+        goto fail;
+
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    /* The callee may have changed the epoch deadline */
+    if (comp_ctx->enable_epoch_interruption
+        && !aot_reload_epoch_deadline(comp_ctx, func_ctx))
+        goto fail;
+#endif
+
     ret = true;
 
 fail:
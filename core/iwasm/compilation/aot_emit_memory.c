@@ -567,12 +567,13 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMValueRef addr, maddr, offset1, cmp1, cmp;
     LLVMValueRef mem_base_addr, mem_check_bound;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
-    LLVMBasicBlockRef check_succ;
+    LLVMBasicBlockRef check_succ, block_check;
     AOTValue *aot_value_top;
     uint32 local_idx_of_aot_value = 0;
     uint64 const_value;
     bool is_target_64bit, is_local_of_aot_value = false;
-    bool is_const = false;
+    bool is_const = false, clamp_addr = false;
+    bool enable_bound_check = comp_ctx->enable_bound_check;
 #if WASM_ENABLE_SHARED_MEMORY != 0
     bool is_shared_memory =
         comp_ctx->comp_data->memories[0].flags & SHARED_MEMORY_FLAG;
@@ -589,6 +590,19 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     is_target_64bit = (comp_ctx->pointer_size == sizeof(uint64)) ? true : false;
 
+#if WASM_ENABLE_MEMORY64 != 0
+    if (is_memory64 && comp_ctx->mem64_clamp_log2 > 0) {
+        /* The guard regions only cover the offset in range 0 to 4G, and
+           the addresses of shared heap can't be clamped, check the other
+           accesses by software */
+        if (offset <= UINT32_MAX && !comp_ctx->is_indirect_mode
+            && !comp_ctx->enable_shared_heap && !comp_ctx->enable_shared_chain)
+            clamp_addr = true;
+        else
+            enable_bound_check = true;
+    }
+#endif
+
     if (comp_ctx->is_indirect_mode
         && aot_intrinsic_check_capability(
             comp_ctx, MEMORY64_COND_VALUE("i64.const", "i32.const"))) {
@@ -729,12 +743,35 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
     }
 
+    if (clamp_addr) {
+        /* addr = umin(addr, 2^mem64_clamp_log2), the address beyond the max
+           memory size is clamped to the guard regions, so that the out of
+           bounds access is caught by the hardware trap */
+        LLVMTypeRef param_types[2] = { I64_TYPE, I64_TYPE };
+        LLVMValueRef clamp_size =
+            I64_CONST((uint64)1 << comp_ctx->mem64_clamp_log2);
+
+        CHECK_LLVM_CONST(clamp_size);
+        if (!(addr = aot_call_llvm_intrinsic(comp_ctx, func_ctx,
+                                             "llvm.umin.i64", I64_TYPE,
+                                             param_types, 2, addr,
+                                             clamp_size))) {
+            goto fail;
+        }
+
+        /* Mark the clamp so that it can be hoisted out of loops too */
+        if (!aot_set_bound_check_metadata(comp_ctx, addr)) {
+            goto fail;
+        }
+    }
+
     /* offset1 = offset + addr; */
     BUILD_OP(Add, offset_const, addr, offset1, "offset1");
 
-    /* 1.1 offset + addr can overflow when it's memory64
+    /* 1.1 offset + addr can overflow when it's memory64, unless addr
+     *     is clamped
      * 2.1 Or when it's on 32-bit platform */
-    if (is_memory64 || !is_target_64bit) {
+    if ((is_memory64 && !clamp_addr) || !is_target_64bit) {
         /* Check whether integer overflow occurs in offset + addr */
         LLVMBasicBlockRef check_integer_overflow_end;
         ADD_BASIC_BLOCK(check_integer_overflow_end,
@@ -774,7 +811,7 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 #endif
 
-    if (comp_ctx->enable_bound_check
+    if (enable_bound_check
         && !(is_local_of_aot_value
              && aot_checked_addr_list_find(func_ctx, local_idx_of_aot_value,
                                            offset, bytes))) {
@@ -811,12 +848,20 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         ADD_BASIC_BLOCK(check_succ, "check_succ");
         LLVMMoveBasicBlockAfter(check_succ, block_curr);
 
+        block_check = LLVMGetInsertBlock(comp_ctx->builder);
         if (!aot_emit_exception(comp_ctx, func_ctx,
                                 EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true, cmp,
                                 check_succ)) {
             goto fail;
         }
 
+        /* Mark the check so that it can be hoisted out of loops, see
+           BoundCheckVersioningPass */
+        if (!aot_set_bound_check_metadata(
+                comp_ctx, LLVMGetBasicBlockTerminator(block_check))) {
+            goto fail;
+        }
+
         SET_BUILD_POS(check_succ);
 
         if (is_local_of_aot_value) {
@@ -1945,6 +1990,79 @@ fail:
 }
 #endif /* end of WASM_ENABLE_BULK_MEMORY_OPT */
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+bool
+aot_compile_op_memory_discard(AOTCompContext *comp_ctx,
+                              AOTFuncContext *func_ctx)
+{
+    LLVMValueRef addr, len, param_values[3], ret_value, func, value;
+    LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
+    AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
+    LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+    LLVMBasicBlockRef mem_discard_fail, discard_success;
+
+    POP_MEM_OFFSET(len);
+    POP_MEM_OFFSET(addr);
+
+    /* The runtime function takes the 64-bit address and length */
+    if (LLVMTypeOf(addr) != I64_TYPE
+        && (!(addr = LLVMBuildZExt(comp_ctx->builder, addr, I64_TYPE,
+                                   "addr64"))
+            || !(len = LLVMBuildZExt(comp_ctx->builder, len, I64_TYPE,
+                                     "len64")))) {
+        aot_set_last_error("llvm build zero extend failed.");
+        return false;
+    }
+
+    param_types[0] = INT8_PTR_TYPE;
+    param_types[1] = I64_TYPE;
+    param_types[2] = I64_TYPE;
+    ret_type = INT8_TYPE;
+
+    if (comp_ctx->is_jit_mode)
+        GET_AOT_FUNCTION(llvm_jit_memory_discard, 3);
+    else
+        GET_AOT_FUNCTION(aot_memory_discard, 3);
+
+    /* Call function aot_memory_discard() */
+    param_values[0] = func_ctx->aot_inst;
+    param_values[1] = addr;
+    param_values[2] = len;
+    if (!(ret_value = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                                     param_values, 3, "call"))) {
+        aot_set_last_error("llvm build call failed.");
+        return false;
+    }
+
+    BUILD_ICMP(LLVMIntUGT, ret_value, I8_ZERO, ret_value, "mem_discard_ret");
+
+    ADD_BASIC_BLOCK(mem_discard_fail, "mem_discard_fail");
+    ADD_BASIC_BLOCK(discard_success, "discard_success");
+
+    LLVMMoveBasicBlockAfter(mem_discard_fail, block_curr);
+    LLVMMoveBasicBlockAfter(discard_success, block_curr);
+
+    if (!LLVMBuildCondBr(comp_ctx->builder, ret_value, discard_success,
+                         mem_discard_fail)) {
+        aot_set_last_error("llvm build cond br failed.");
+        goto fail;
+    }
+
+    /* If memory.discard failed, return this function
+       so the runtime can catch the exception */
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, mem_discard_fail);
+    if (!aot_build_zero_function_ret(comp_ctx, func_ctx, aot_func_type)) {
+        goto fail;
+    }
+
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, discard_success);
+
+    return true;
+fail:
+    return false;
+}
+#endif /* end of WASM_ENABLE_MEMORY_DISCARD */
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
 bool
 aot_compile_op_atomic_rmw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -88,6 +88,12 @@ bool
 aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
 #endif
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+bool
+aot_compile_op_memory_discard(AOTCompContext *comp_ctx,
+                              AOTFuncContext *func_ctx);
+#endif
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
 bool
 aot_compile_op_atomic_rmw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "aot_interp_prof.h"
+#include "bh_read_file.h"
+
+static bool
+read_uint64(char **p_str, uint64 *p_value)
+{
+    char *str = *p_str, *end;
+
+    while (*str == ' ' || *str == '\t')
+        str++;
+    if (*str < '0' || *str > '9')
+        return false;
+
+    *p_value = (uint64)strtoull(str, &end, 10);
+    *p_str = end;
+    return true;
+}
+
+static bool
+read_uint32(char **p_str, uint32 *p_value)
+{
+    uint64 value;
+
+    if (!read_uint64(p_str, &value) || value > UINT32_MAX)
+        return false;
+    *p_value = (uint32)value;
+    return true;
+}
+
+static int
+branch_cmp(const void *a, const void *b)
+{
+    const AOTInterpProfBranch *branch_a = a, *branch_b = b;
+
+    if (branch_a->func_idx != branch_b->func_idx)
+        return branch_a->func_idx < branch_b->func_idx ? -1 : 1;
+    if (branch_a->offset != branch_b->offset)
+        return branch_a->offset < branch_b->offset ? -1 : 1;
+    return 0;
+}
+
+static bool
+parse_interp_prof(AOTInterpProf *prof, char *text, const char *file)
+{
+    AOTInterpProfBranch *branch = prof->branches;
+    AOTInterpProfFunc *func;
+    char *line = text, *line_end, *p;
+    uint32 line_no = 0, branch_count, func_idx, i;
+    uint64 exec_count;
+    bool has_header = false;
+
+    for (; line; line = line_end ? line_end + 1 : NULL) {
+        if ((line_end = strchr(line, '\n')))
+            *line_end = '\0';
+        line_no++;
+
+        p = line + strlen(line);
+        while (p > line && (p[-1] == '\r' || p[-1] == ' '))
+            *--p = '\0';
+        if (line[0] == '\0' || line[0] == '#')
+            continue;
+
+        if (!has_header) {
+            if (strcmp(line, "wamr-interp-profile 1")) {
+                aot_set_last_error_v("%s is not an interpreter profile file.",
+                                     file);
+                return false;
+            }
+            has_header = true;
+        }
+        else if (!strncmp(line, "func ", 5)) {
+            p = line + 5;
+            if (!read_uint32(&p, &func_idx) || !read_uint64(&p, &exec_count)
+                || *p != '\0' || func_idx >= prof->func_count)
+                goto fail;
+            prof->funcs[func_idx].exec_count = exec_count;
+        }
+        else if (!strncmp(line, "branch ", 7)) {
+            p = line + 7;
+            if (!read_uint32(&p, &branch->func_idx)
+                || !read_uint32(&p, &branch->offset)
+                || !read_uint64(&p, &branch->taken_count)
+                || !read_uint64(&p, &branch->not_taken_count) || *p != '\0'
+                || branch->func_idx >= prof->func_count)
+                goto fail;
+            branch++;
+        }
+        /* Other records, e.g. the opcode pairs, aren't used by the
+           compiler */
+    }
+
+    if (!has_header) {
+        aot_set_last_error_v("%s is not an interpreter profile file.", file);
+        return false;
+    }
+
+    branch_count = (uint32)(branch - prof->branches);
+    qsort(prof->branches, branch_count, sizeof(AOTInterpProfBranch),
+          branch_cmp);
+    for (i = 0; i < branch_count; i++) {
+        func = prof->funcs + prof->branches[i].func_idx;
+        if (func->branch_count == 0)
+            func->branches = prof->branches + i;
+        func->branch_count++;
+    }
+
+    for (i = 0; i < prof->func_count; i++) {
+        if (prof->funcs[i].exec_count > prof->max_exec_count)
+            prof->max_exec_count = prof->funcs[i].exec_count;
+    }
+
+    return true;
+fail:
+    aot_set_last_error_v("invalid record at line %" PRIu32
+                         " of interpreter profile file %s.",
+                         line_no, file);
+    return false;
+}
+
+AOTInterpProf *
+aot_load_interp_prof(const char *file, uint32 func_count)
+{
+    AOTInterpProf *prof = NULL;
+    char *buf, *text = NULL;
+    uint32 size, line_count = 1, i;
+    uint64 total_size;
+
+    if (!(buf = bh_read_file_to_buffer(file, &size))) {
+        aot_set_last_error_v("read interpreter profile file %s failed.", file);
+        return NULL;
+    }
+
+    /* Make the content NUL terminated to parse it line by line */
+    if (!(text = wasm_runtime_malloc(size + 1))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+    bh_memcpy_s(text, size + 1, buf, size);
+    text[size] = '\0';
+
+    /* There are no more branch records than lines */
+    for (i = 0; i < size; i++) {
+        if (text[i] == '\n')
+            line_count++;
+    }
+
+    total_size = sizeof(AOTInterpProf)
+                 + sizeof(AOTInterpProfFunc) * (uint64)func_count
+                 + sizeof(AOTInterpProfBranch) * (uint64)line_count;
+    if (total_size >= UINT32_MAX
+        || !(prof = wasm_runtime_malloc((uint32)total_size))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+    memset(prof, 0, (uint32)total_size);
+
+    prof->func_count = func_count;
+    prof->funcs = (AOTInterpProfFunc *)(prof + 1);
+    prof->branches = (AOTInterpProfBranch *)(prof->funcs + func_count);
+
+    if (!parse_interp_prof(prof, text, file)) {
+        wasm_runtime_free(prof);
+        prof = NULL;
+    }
+
+fail:
+    if (text)
+        wasm_runtime_free(text);
+    wasm_runtime_free(buf);
+    return prof;
+}
+
+void
+aot_destroy_interp_prof(AOTInterpProf *prof)
+{
+    wasm_runtime_free(prof);
+}
+
+static bool
+add_func_attr(AOTCompContext *comp_ctx, LLVMValueRef func, const char *name)
+{
+    unsigned kind = LLVMGetEnumAttributeKindForName(name, strlen(name));
+    LLVMAttributeRef attr;
+
+    if (!(attr = LLVMCreateEnumAttribute(comp_ctx->context, kind, 0))) {
+        aot_set_last_error_v("create LLVM attribute (%s) failed.", name);
+        return false;
+    }
+    LLVMAddAttributeAtIndex(func, LLVMAttributeFunctionIndex, attr);
+    return true;
+}
+
+bool
+aot_interp_prof_set_func_attrs(AOTCompContext *comp_ctx,
+                               AOTFuncContext *func_ctx)
+{
+    AOTInterpProfFunc *func_prof = func_ctx->interp_prof;
+    const char *prof_kind = "prof", *entry_count = "function_entry_count";
+    LLVMMetadataRef md_nodes[2], meta_data;
+
+    /* The entry count scales the block frequencies derived from the branch
+       weights, so that they are comparable across the functions */
+    md_nodes[0] = LLVMMDStringInContext2(comp_ctx->context, entry_count,
+                                         strlen(entry_count));
+    md_nodes[1] = LLVMValueAsMetadata(I64_CONST(func_prof->exec_count));
+    meta_data = LLVMMDNodeInContext2(comp_ctx->context, md_nodes, 2);
+    LLVMGlobalSetMetadata(func_ctx->func,
+                          LLVMGetMDKindIDInContext(comp_ctx->context,
+                                                   prof_kind,
+                                                   strlen(prof_kind)),
+                          meta_data);
+
+    if (func_prof->exec_count == 0) {
+        /* Never executed in the profiling run */
+        if (!add_func_attr(comp_ctx, func_ctx->func, "cold")
+            || (func_ctx->precheck_func != func_ctx->func
+                && !add_func_attr(comp_ctx, func_ctx->precheck_func, "cold")))
+            return false;
+    }
+    else if (func_prof->exec_count * AOT_INTERP_PROF_HOT_RATIO
+             >= comp_ctx->interp_prof->max_exec_count) {
+        /* The callers call the precheck function if there is one */
+        if (!add_func_attr(comp_ctx, func_ctx->precheck_func, "inlinehint"))
+            return false;
+    }
+
+    return true;
+}
+
+bool
+aot_interp_prof_set_branch_weights(AOTCompContext *comp_ctx,
+                                   AOTFuncContext *func_ctx,
+                                   LLVMValueRef cond_br)
+{
+    AOTInterpProfFunc *func_prof = func_ctx->interp_prof;
+    AOTInterpProfBranch *branch;
+    uint32 offset, low = 0, high, mid;
+    uint64 taken, not_taken;
+
+    if (!func_prof || func_prof->branch_count == 0)
+        return true;
+
+    offset = (uint32)(func_ctx->opcode_ip - func_ctx->aot_func->code);
+    high = func_prof->branch_count;
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (func_prof->branches[mid].offset < offset)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == func_prof->branch_count
+        || func_prof->branches[low].offset != offset)
+        return true;
+
+    branch = func_prof->branches + low;
+    taken = branch->taken_count;
+    not_taken = branch->not_taken_count;
+    /* Scale the counts to fit the 32-bit weights, and keep the weight of
+       a never taken edge non-zero */
+    while (taken >= INT32_MAX || not_taken >= INT32_MAX) {
+        taken >>= 1;
+        not_taken >>= 1;
+    }
+
+    return aot_set_cond_br_weights(comp_ctx, cond_br, (int32)(taken + 1),
+                                   (int32)(not_taken + 1));
+}
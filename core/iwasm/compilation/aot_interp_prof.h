@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _AOT_INTERP_PROF_H_
+#define _AOT_INTERP_PROF_H_
+
+#include "aot_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A function is marked as inline hint if its execution count is at least
+   1/AOT_INTERP_PROF_HOT_RATIO of the hottest function's */
+#define AOT_INTERP_PROF_HOT_RATIO 100
+
+typedef struct AOTInterpProfBranch {
+    uint32 func_idx;
+    /* offset of the if/br_if opcode, relative to the function's code */
+    uint32 offset;
+    uint64 taken_count;
+    uint64 not_taken_count;
+} AOTInterpProfBranch;
+
+typedef struct AOTInterpProfFunc {
+    uint64 exec_count;
+    uint32 branch_count;
+    /* sorted by offset */
+    AOTInterpProfBranch *branches;
+} AOTInterpProfFunc;
+
+/* The profile collected by the interpreter, see
+   wasm_runtime_dump_interp_prof_data_to_buf for the file format */
+typedef struct AOTInterpProf {
+    /* the import functions are included */
+    uint32 func_count;
+    AOTInterpProfFunc *funcs;
+    uint64 max_exec_count;
+    AOTInterpProfBranch *branches;
+} AOTInterpProf;
+
+AOTInterpProf *
+aot_load_interp_prof(const char *file, uint32 func_count);
+
+void
+aot_destroy_interp_prof(AOTInterpProf *prof);
+
+/* Set the entry count of the function and mark it as cold or inline hint */
+bool
+aot_interp_prof_set_func_attrs(AOTCompContext *comp_ctx,
+                               AOTFuncContext *func_ctx);
+
+/* Set the branch weights of the conditional branch created for the opcode
+   being compiled if the interpreter has profiled it */
+bool
+aot_interp_prof_set_branch_weights(AOTCompContext *comp_ctx,
+                                   AOTFuncContext *func_ctx,
+                                   LLVMValueRef cond_br);
+
+#ifdef __cplusplus
+} /* end of extern "C" */
+#endif
+
+#endif /* end of _AOT_INTERP_PROF_H_ */
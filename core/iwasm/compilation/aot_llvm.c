@@ -8,6 +8,7 @@
 #include "aot_compiler.h"
 #include "aot_emit_exception.h"
 #include "aot_emit_table.h"
+#include "aot_interp_prof.h"
 #include "../aot/aot_runtime.h"
 #include "../aot/aot_intrinsic.h"
 #include "../interpreter/wasm_runtime.h"
@@ -1088,6 +1089,89 @@ create_native_symbol(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     return true;
 }
 
+static bool
+create_instruction_count(const AOTCompContext *comp_ctx,
+                         AOTFuncContext *func_ctx)
+{
+    /* exec_env->instructions_to_execute, following the wasm_stack */
+    LLVMValueRef offset = I32_CONST(13);
+
+    if (!(func_ctx->instr_count_ptr = LLVMBuildInBoundsGEP2(
+              comp_ctx->builder, OPQ_PTR_TYPE, func_ctx->exec_env, &offset, 1,
+              "instr_count_ptr"))) {
+        aot_set_last_error("llvm build in bounds gep failed");
+        return false;
+    }
+
+    if (!(func_ctx->instr_count_ptr =
+              LLVMBuildBitCast(comp_ctx->builder, func_ctx->instr_count_ptr,
+                               INT32_PTR_TYPE, "instr_count_ptr"))) {
+        aot_set_last_error("llvm build bit cast failed");
+        return false;
+    }
+
+    /* It is initialized by aot_sync_instruction_count when translating
+       the function */
+    if (!(func_ctx->instr_count = LLVMBuildAlloca(comp_ctx->builder, I64_TYPE,
+                                                  "instr_count"))) {
+        aot_set_last_error("llvm build alloca failed.");
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+create_epoch_ptrs(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    /* exec_env->epoch_deadline follows the instructions_to_execute, and
+       exec_env->epoch_ptr follows it */
+    LLVMValueRef offset = I32_CONST(14), epoch_ptr_addr;
+    LLVMTypeRef int64_ptr_ptr_type;
+
+    if (!(func_ctx->epoch_deadline_ptr = LLVMBuildInBoundsGEP2(
+              comp_ctx->builder, OPQ_PTR_TYPE, func_ctx->exec_env, &offset, 1,
+              "epoch_deadline_ptr"))
+        || !(func_ctx->epoch_deadline_ptr = LLVMBuildBitCast(
+                 comp_ctx->builder, func_ctx->epoch_deadline_ptr,
+                 INT64_PTR_TYPE, "epoch_deadline_ptr"))) {
+        aot_set_last_error("llvm build gep or bit cast failed");
+        return false;
+    }
+
+    offset = I32_CONST(sizeof(uint64));
+    if (!(int64_ptr_ptr_type = LLVMPointerType(INT64_PTR_TYPE, 0))
+        || !(epoch_ptr_addr = LLVMBuildBitCast(
+                 comp_ctx->builder, func_ctx->epoch_deadline_ptr,
+                 INT8_PTR_TYPE, "epoch_ptr_addr"))
+        || !(epoch_ptr_addr =
+                 LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
+                                       epoch_ptr_addr, &offset, 1,
+                                       "epoch_ptr_addr"))
+        || !(epoch_ptr_addr =
+                 LLVMBuildBitCast(comp_ctx->builder, epoch_ptr_addr,
+                                  int64_ptr_ptr_type, "epoch_ptr_addr"))) {
+        aot_set_last_error("llvm build gep or bit cast failed");
+        return false;
+    }
+
+    /* The address of the epoch counter never changes */
+    if (!(func_ctx->epoch_ptr =
+              LLVMBuildLoad2(comp_ctx->builder, INT64_PTR_TYPE,
+                             epoch_ptr_addr, "epoch_ptr"))) {
+        aot_set_last_error("llvm build load failed");
+        return false;
+    }
+
+    if (!(func_ctx->epoch_deadline = LLVMBuildAlloca(
+              comp_ctx->builder, I64_TYPE, "epoch_deadline"))) {
+        aot_set_last_error("llvm build alloca failed");
+        return false;
+    }
+
+    return true;
+}
+
 static bool
 create_local_variables(const AOTCompData *comp_data,
                        const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -1856,6 +1940,86 @@ aot_create_stack_sizes(const AOTCompData *comp_data, AOTCompContext *comp_ctx)
 /**
  * Create function compiler context
  */
+#if WASM_ENABLE_LINUX_PERF != 0
+static bool
+create_perf_debug_info(AOTCompContext *comp_ctx)
+{
+    const char *file_name = WASM_JITDUMP_LINE_FILE_NAME;
+    const char *producer = "WAMR LLVM JIT", *key = "Debug Info Version";
+
+    if (!(comp_ctx->perf_debug_builder =
+              LLVMCreateDIBuilder(comp_ctx->module))) {
+        aot_set_last_error("create LLVM debug info builder failed.");
+        return false;
+    }
+
+    LLVMAddModuleFlag(
+        comp_ctx->module, LLVMModuleFlagBehaviorWarning, key, strlen(key),
+        LLVMValueAsMetadata(LLVMConstInt(LLVMInt32Type(), 3, false)));
+
+    if (!(comp_ctx->perf_debug_file =
+              LLVMDIBuilderCreateFile(comp_ctx->perf_debug_builder, file_name,
+                                      strlen(file_name), "", 0))
+        || !LLVMDIBuilderCreateCompileUnit(
+            comp_ctx->perf_debug_builder, LLVMDWARFSourceLanguageC,
+            comp_ctx->perf_debug_file, producer, strlen(producer), true, "", 0,
+            0, "", 0, LLVMDWARFEmissionLineTablesOnly, 0, false, false, "", 0,
+            "", 0)) {
+        aot_set_last_error("create LLVM debug compile unit failed.");
+        return false;
+    }
+
+    return true;
+}
+
+/* The line numbers are the offsets of the opcodes in the wasm binary */
+static uint32
+get_perf_debug_line(const AOTCompContext *comp_ctx, const uint8 *ip)
+{
+    return (uint32)(ip - comp_ctx->comp_data->wasm_module->load_addr);
+}
+
+static LLVMMetadataRef
+create_perf_debug_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMDIBuilderRef builder = comp_ctx->perf_debug_builder;
+    LLVMMetadataRef func_type, subprogram;
+    const char *name;
+    size_t name_len;
+    unsigned line = get_perf_debug_line(comp_ctx, func_ctx->aot_func->code);
+
+    name = LLVMGetValueName2(func_ctx->func, &name_len);
+    if (!(func_type = LLVMDIBuilderCreateSubroutineType(
+              builder, comp_ctx->perf_debug_file, NULL, 0, LLVMDIFlagZero))
+        || !(subprogram = LLVMDIBuilderCreateFunction(
+                 builder, comp_ctx->perf_debug_file, name, name_len, name,
+                 name_len, comp_ctx->perf_debug_file, line, func_type, false,
+                 true, line, LLVMDIFlagZero, true))) {
+        aot_set_last_error("create LLVM debug function failed.");
+        return NULL;
+    }
+
+    LLVMSetSubprogram(func_ctx->func, subprogram);
+    return subprogram;
+}
+
+void
+aot_set_perf_debug_location(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                            const uint8 *ip)
+{
+    LLVMMetadataRef location = NULL;
+
+    if (!func_ctx->perf_debug_func)
+        return;
+
+    if (ip)
+        location = LLVMDIBuilderCreateDebugLocation(
+            comp_ctx->context, get_perf_debug_line(comp_ctx, ip), 0,
+            func_ctx->perf_debug_func, NULL);
+    LLVMSetCurrentDebugLocation2(comp_ctx->builder, location);
+}
+#endif
+
 static AOTFuncContext *
 aot_create_func_context(const AOTCompData *comp_data, AOTCompContext *comp_ctx,
                         AOTFunc *func, uint32 func_index)
@@ -1930,6 +2094,16 @@ aot_create_func_context(const AOTCompData *comp_data, AOTCompContext *comp_ctx,
         goto fail;
     }
 
+    if (comp_ctx->enable_instruction_metering
+        && !create_instruction_count(comp_ctx, func_ctx)) {
+        goto fail;
+    }
+
+    if (comp_ctx->enable_epoch_interruption
+        && !create_epoch_ptrs(comp_ctx, func_ctx)) {
+        goto fail;
+    }
+
     if (!(int8_ptr_type = LLVMPointerType(INT8_PTR_TYPE, 0))) {
         aot_set_last_error("llvm add pointer type failed.");
         goto fail;
@@ -1970,6 +2144,20 @@ aot_create_func_context(const AOTCompData *comp_data, AOTCompContext *comp_ctx,
             : NULL;
 #endif
 
+    if (comp_ctx->interp_prof) {
+        func_ctx->interp_prof = comp_ctx->interp_prof->funcs
+                                + comp_data->import_func_count + func_index;
+        if (!aot_interp_prof_set_func_attrs(comp_ctx, func_ctx))
+            goto fail;
+    }
+
+#if WASM_ENABLE_LINUX_PERF != 0
+    if (comp_ctx->perf_debug_builder
+        && !(func_ctx->perf_debug_func =
+                 create_perf_debug_func(comp_ctx, func_ctx)))
+        goto fail;
+#endif
+
     return func_ctx;
 
 fail:
@@ -2734,6 +2922,9 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->enable_bulk_memory_opt)
         comp_ctx->enable_bulk_memory_opt = true;
 
+    if (option->enable_memory_discard)
+        comp_ctx->enable_memory_discard = true;
+
     if (option->enable_thread_mgr)
         comp_ctx->enable_thread_mgr = true;
 
@@ -2758,6 +2949,12 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->enable_aux_stack_check)
         comp_ctx->enable_aux_stack_check = true;
 
+    if (option->enable_instruction_metering)
+        comp_ctx->enable_instruction_metering = true;
+
+    if (option->enable_epoch_interruption)
+        comp_ctx->enable_epoch_interruption = true;
+
     if (option->is_indirect_mode) {
         comp_ctx->is_indirect_mode = true;
         /* avoid LUT relocations ("switch-table") */
@@ -2779,6 +2976,12 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->use_prof_file)
         comp_ctx->use_prof_file = option->use_prof_file;
 
+    if (option->use_interp_prof_file
+        && !(comp_ctx->interp_prof = aot_load_interp_prof(
+                 option->use_interp_prof_file,
+                 comp_data->import_func_count + comp_data->func_count)))
+        goto fail;
+
     if (option->enable_stack_estimation)
         comp_ctx->enable_stack_estimation = true;
 
@@ -2839,6 +3042,12 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
         /* Create LLJIT Instance */
         if (!orc_jit_create(comp_ctx))
             goto fail;
+
+#if WASM_ENABLE_LINUX_PERF != 0 && WASM_ENABLE_DEBUG_AOT == 0
+        /* The wasm source lines are emitted if debug AOT is enabled */
+        if (wasm_runtime_get_linux_perf() && !create_perf_debug_info(comp_ctx))
+            goto fail;
+#endif
     }
     else {
         /* Create LLVM target machine */
@@ -3316,8 +3525,16 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
 
     if (!(option->bounds_checks == 1 || option->bounds_checks == 0)
         && is_memory64) {
-        /* For memory64, the boundary check default value is true */
-        comp_ctx->enable_bound_check = true;
+        AOTMemory *memory = &comp_data->memories[0];
+
+        /* For memory64, the boundary check default value is true, unless
+           the memory is small enough to clamp the load/store addresses
+           and catch the out of bounds accesses with the guard regions */
+        if (!comp_ctx->enable_bound_check && comp_data->memory_count > 0)
+            comp_ctx->mem64_clamp_log2 = wasm_get_mem64_clamp_log2(
+                (uint64)memory->num_bytes_per_page * memory->max_page_count);
+        if (comp_ctx->mem64_clamp_log2 == 0)
+            comp_ctx->enable_bound_check = true;
     }
 
     /* Return error if SIMD is disabled by command line but SIMD instructions
@@ -3478,6 +3695,11 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx)
         LLVMDisposeDIBuilder(comp_ctx->debug_builder);
 #endif
 
+#if WASM_ENABLE_LINUX_PERF != 0
+    if (comp_ctx->perf_debug_builder)
+        LLVMDisposeDIBuilder(comp_ctx->perf_debug_builder);
+#endif
+
     if (comp_ctx->orc_thread_safe_context)
         LLVMOrcDisposeThreadSafeContext(comp_ctx->orc_thread_safe_context);
 
@@ -3492,6 +3714,9 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx)
         aot_destroy_func_contexts(comp_ctx, comp_ctx->func_ctxes,
                                   comp_ctx->func_ctx_count);
 
+    if (comp_ctx->interp_prof)
+        aot_destroy_interp_prof(comp_ctx->interp_prof);
+
     if (bh_list_length(&comp_ctx->native_symbols) > 0) {
         AOTNativeSymbol *sym = bh_list_first_elem(&comp_ctx->native_symbols);
         while (sym) {
@@ -4205,3 +4430,19 @@ aot_set_cond_br_weights(AOTCompContext *comp_ctx, LLVMValueRef cond_br,
 
     return true;
 }
+
+bool
+aot_set_bound_check_metadata(AOTCompContext *comp_ctx, LLVMValueRef check)
+{
+    LLVMMetadataRef meta_data;
+    unsigned kind_id;
+
+    kind_id = LLVMGetMDKindIDInContext(comp_ctx->context,
+                                       AOT_BOUND_CHECK_METADATA,
+                                       strlen(AOT_BOUND_CHECK_METADATA));
+    meta_data = LLVMMDNodeInContext2(comp_ctx->context, NULL, 0);
+    LLVMSetMetadata(check, kind_id,
+                    LLVMMetadataAsValue(comp_ctx->context, meta_data));
+
+    return true;
+}
@@ -30,7 +30,7 @@
 
 #include "llvm-c/TargetMachine.h"
 #include "llvm-c/LLJIT.h"
-#if WASM_ENABLE_DEBUG_AOT != 0
+#if WASM_ENABLE_DEBUG_AOT != 0 || WASM_ENABLE_LINUX_PERF != 0
 #include "llvm-c/DebugInfo.h"
 #endif
 
@@ -251,6 +251,18 @@ typedef struct AOTFuncContext {
     LLVMValueRef wasm_stack_top_bound;
     LLVMValueRef wasm_stack_top_ptr;
 
+    /* Address of exec_env->instructions_to_execute, and the local copy
+       of it, which is only synced with exec_env around calls */
+    LLVMValueRef instr_count_ptr;
+    LLVMValueRef instr_count;
+
+    /* Address of the global epoch counter, address of
+       exec_env->epoch_deadline, and the local copy of the deadline, which
+       is reloaded at function entry and after calls */
+    LLVMValueRef epoch_ptr;
+    LLVMValueRef epoch_deadline_ptr;
+    LLVMValueRef epoch_deadline;
+
     bool mem_space_unchanged;
     AOTCheckedAddrList checked_addr_list;
 
@@ -270,10 +282,19 @@ typedef struct AOTFuncContext {
 #if WASM_ENABLE_DEBUG_AOT != 0
     LLVMMetadataRef debug_func;
 #endif
+#if WASM_ENABLE_LINUX_PERF != 0
+    /* Subprogram whose line numbers are the bytecode offsets */
+    LLVMMetadataRef perf_debug_func;
+#endif
 #if WASM_ENABLE_BRANCH_HINTS != 0
     struct WASMCompilationHint *function_hints;
 #endif
 
+    /* Profile of the function collected by the interpreter */
+    struct AOTInterpProfFunc *interp_prof;
+    /* Address of the opcode being compiled */
+    uint8 *opcode_ip;
+
     unsigned int stack_consumption_for_func_call;
 
     LLVMValueRef locals[1];
@@ -392,6 +413,12 @@ typedef struct AOTCompContext {
     LLVMDIBuilderRef debug_builder;
     LLVMMetadataRef debug_file;
     LLVMMetadataRef debug_comp_unit;
+#endif
+#if WASM_ENABLE_LINUX_PERF != 0
+    /* Emit the bytecode offsets as the line table in LLVM JIT mode, so
+       that the jitdump written by the perf JIT event listener carries them */
+    LLVMDIBuilderRef perf_debug_builder;
+    LLVMMetadataRef perf_debug_file;
 #endif
     LLVMTargetMachineRef target_machine;
     char *target_cpu;
@@ -420,9 +447,17 @@ typedef struct AOTCompContext {
      * enable_bulk_memory */
     bool enable_bulk_memory_opt;
 
+    /* memory.discard of the memory control proposal */
+    bool enable_memory_discard;
+
     /* Boundary Check */
     bool enable_bound_check;
 
+    /* For memory64 bound checked with hardware trap, log2 of the size
+       which the load/store addresses are clamped to, see
+       wasm_get_mem64_clamp_log2, 0 otherwise */
+    uint8 mem64_clamp_log2;
+
     /* Native stack boundary Check */
     bool enable_stack_bound_check;
 
@@ -444,6 +479,12 @@ typedef struct AOTCompContext {
     /* Function performance profiling */
     bool enable_perf_profiling;
 
+    /* Instruction metering with exec_env->instructions_to_execute */
+    bool enable_instruction_metering;
+
+    /* Check exec_env->epoch_deadline at function entries and loops */
+    bool enable_epoch_interruption;
+
     /* Memory usage profiling */
     bool enable_memory_profiling;
 
@@ -481,6 +522,9 @@ typedef struct AOTCompContext {
     /* Use profile file collected by LLVM PGO */
     char *use_prof_file;
 
+    /* Profile collected by the interpreter */
+    struct AOTInterpProf *interp_prof;
+
     /* Enable to use segment register as the base addr
        of linear memory for load/store operations */
     bool enable_segue_i32_load;
@@ -667,6 +711,14 @@ bool
 aot_set_cond_br_weights(AOTCompContext *comp_ctx, LLVMValueRef cond_br,
                         int32 weights_true, int32 weights_false);
 
+/* Name of the metadata attached to the cond br of the linear memory
+   bound checks, which are `br (icmp ugt addr, bound), exception, succ`,
+   and to the memory64 address clamps, which are `umin(addr, bound)` */
+#define AOT_BOUND_CHECK_METADATA "wamr.bound_check"
+
+bool
+aot_set_bound_check_metadata(AOTCompContext *comp_ctx, LLVMValueRef check);
+
 bool
 aot_target_precheck_can_use_musttail(const AOTCompContext *comp_ctx);
 
@@ -674,6 +726,14 @@ unsigned int
 aot_estimate_stack_usage_for_function_call(const AOTCompContext *comp_ctx,
                                            const AOTFuncType *callee_func_type);
 
+#if WASM_ENABLE_LINUX_PERF != 0
+/* Set the debug location of the instructions built next to the opcode at
+   ip, or clear it if ip is NULL, no-op if no line table is emitted */
+void
+aot_set_perf_debug_location(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                            const uint8 *ip);
+#endif
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
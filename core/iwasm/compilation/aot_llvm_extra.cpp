@@ -32,6 +32,7 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/PassManager.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/ErrorHandling.h>
 #if LLVM_VERSION_MAJOR >= 17
@@ -45,6 +46,11 @@
 #include <llvm/TargetParser/Triple.h>
 #endif
 #include <llvm/Transforms/Utils/LowerMemIntrinsics.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/LoopSimplify.h>
+#include <llvm/Transforms/Utils/LoopUtils.h>
+#include <llvm/Transforms/Utils/ScalarEvolutionExpander.h>
 #include <llvm/Transforms/Vectorize/LoopVectorize.h>
 #include <llvm/Transforms/Vectorize/LoadStoreVectorizer.h>
 #include <llvm/Transforms/Vectorize/SLPVectorizer.h>
@@ -53,8 +59,13 @@
 #include <llvm/Transforms/Scalar/SimpleLoopUnswitch.h>
 #include <llvm/Transforms/Scalar/LICM.h>
 #include <llvm/Transforms/Scalar/GVN.h>
+#include <llvm/Transforms/Scalar/SimplifyCFG.h>
+#include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
 #if LLVM_VERSION_MAJOR >= 12
 #include <llvm/Analysis/AliasAnalysis.h>
 #endif
@@ -145,6 +156,345 @@ ExpandMemoryOpPass::run(Function &F, FunctionAnalysisManager &AM)
     return PA;
 }
 
+/*
+ * Version the innermost loops whose linear memory bound checks can be done
+ * once in the preheader: the address checked in the loop is either loop
+ * invariant, or an increasing affine induction variable, whose largest
+ * value is the one in the last iteration. The loop is cloned, and if the
+ * hoisted checks pass, the clone without the bound checks is run, else the
+ * original loop is run, which traps at the exact access out of bounds.
+ */
+class BoundCheckVersioningPass
+  : public PassInfoMixin<BoundCheckVersioningPass>
+{
+  public:
+    PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+};
+
+/* Don't duplicate large loops */
+#define BOUND_CHECK_VERSIONING_MAX_LOOP_SIZE 512
+/* The max step of the induction variables, and the max value of the
+   operands when calculating the upper bound of the address, so that the
+   calculation doesn't overflow in i64 */
+#define BOUND_CHECK_VERSIONING_MAX_STEP 4096
+#define BOUND_CHECK_VERSIONING_MAX_VALUE ((uint64_t)1 << 50)
+
+/* Get the upper bound of the i64 SCEV in all the iterations of the loop,
+   which is its value in the last iteration, return nullptr if it isn't a
+   non-decreasing function of the induction variables. The conditions
+   (LHS ule RHS) are added to Conds to ensure that nothing overflows. */
+static const SCEV *
+get_upper_bound(const SCEV *S, Loop *L, const SCEV *ExitCount,
+                ScalarEvolution &SE,
+                SmallVectorImpl<std::pair<const SCEV *, const SCEV *>> &Conds)
+{
+    Type *Ty = S->getType();
+    const SCEV *Limit =
+        SE.getConstant(Ty, BOUND_CHECK_VERSIONING_MAX_VALUE), *Max;
+    const SCEVAddRecExpr *AddRec;
+    const SCEVConstant *Step;
+    bool Extended = false;
+
+    if (SE.isLoopInvariant(S, L))
+        return S;
+
+    if (auto *Add = dyn_cast<SCEVAddExpr>(S)) {
+        SmallVector<const SCEV *, 4> Ops;
+
+        for (const SCEV *Op : Add->operands()) {
+            if (!(Max = get_upper_bound(Op, L, ExitCount, SE, Conds)))
+                return nullptr;
+            Conds.push_back({ Max, Limit });
+            Ops.push_back(Max);
+        }
+        return SE.getAddExpr(Ops);
+    }
+
+    if (auto *Mul = dyn_cast<SCEVMulExpr>(S)) {
+        auto *Scale = dyn_cast<SCEVConstant>(Mul->getOperand(0));
+
+        if (Mul->getNumOperands() != 2 || !Scale || Scale->getAPInt().isZero()
+            || Scale->getAPInt().ugt(BOUND_CHECK_VERSIONING_MAX_STEP)
+            || !(Max = get_upper_bound(Mul->getOperand(1), L, ExitCount, SE,
+                                       Conds)))
+            return nullptr;
+        Conds.push_back({ Max, Limit });
+        return SE.getMulExpr(Scale, Max);
+    }
+
+    /* The address of memory32 is zero extended from i32, and the induction
+       variable may wrap around in i32 */
+    if (auto *ZExt = dyn_cast<SCEVZeroExtendExpr>(S)) {
+        S = ZExt->getOperand();
+        Extended = true;
+    }
+
+    if (!ExitCount || !(AddRec = dyn_cast<SCEVAddRecExpr>(S))
+        || AddRec->getLoop() != L || !AddRec->isAffine()
+        || !(Step = dyn_cast<SCEVConstant>(AddRec->getStepRecurrence(SE)))
+        || Step->getAPInt().isZero()
+        || Step->getAPInt().ugt(BOUND_CHECK_VERSIONING_MAX_STEP))
+        return nullptr;
+
+    /* start + step * ExitCount doesn't overflow in i64 if the start and
+       ExitCount are not larger than the limit */
+    Max = SE.getAddExpr(
+        SE.getZeroExtendExpr(AddRec->getStart(), Ty),
+        SE.getMulExpr(SE.getConstant(Ty, Step->getAPInt().getZExtValue()),
+                      SE.getNoopOrZeroExtend(ExitCount, Ty)));
+    Conds.push_back({ SE.getZeroExtendExpr(AddRec->getStart(), Ty), Limit });
+    Conds.push_back({ SE.getNoopOrZeroExtend(ExitCount, Ty), Limit });
+    if (Extended) {
+        /* And it doesn't wrap around in the narrower type */
+        Conds.push_back(
+            { Max, SE.getConstant(APInt::getMaxValue(
+                       SE.getTypeSizeInBits(AddRec->getType()))
+                                      .zext(64)) });
+    }
+    return Max;
+}
+
+/* Get the address and the bound of the bound check, which passes if
+   the address isn't larger than the bound */
+static bool
+get_bound_check_operands(Instruction *Check, Value *&Addr, Value *&Bound)
+{
+    if (auto *II = dyn_cast<IntrinsicInst>(Check)) {
+        /* The memory64 address clamp */
+        if (II->getIntrinsicID() != Intrinsic::umin)
+            return false;
+        Addr = II->getArgOperand(0);
+        Bound = II->getArgOperand(1);
+        return true;
+    }
+
+    ICmpInst *Cmp = dyn_cast<ICmpInst>(cast<BranchInst>(Check)->getCondition());
+
+    if (!Cmp)
+        return false;
+    /* The true successor is the exception block */
+    if (Cmp->getPredicate() == ICmpInst::ICMP_UGT) {
+        Addr = Cmp->getOperand(0);
+        Bound = Cmp->getOperand(1);
+    }
+    else if (Cmp->getPredicate() == ICmpInst::ICMP_ULT) {
+        Addr = Cmp->getOperand(1);
+        Bound = Cmp->getOperand(0);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/* Get the hoisted check of the bound check in the loop preheader, return
+   nullptr if the address can't be bounded in the loop */
+static Value *
+hoist_bound_check(Loop *L, Instruction *Check, ScalarEvolution &SE,
+                  SCEVExpander &Expander, const SCEV *ExitCount)
+{
+    Instruction *InsertPt = L->getLoopPreheader()->getTerminator();
+    SmallVector<std::pair<const SCEV *, const SCEV *>, 8> Conds;
+    SmallVector<Value *, 8> Checks;
+    Value *Addr, *Bound;
+    const SCEV *Max;
+
+    if (!get_bound_check_operands(Check, Addr, Bound)
+        || !Addr->getType()->isIntegerTy(64) || !L->isLoopInvariant(Bound)
+        || !(Max = get_upper_bound(SE.getSCEV(Addr), L, ExitCount, SE,
+                                   Conds)))
+        return nullptr;
+
+    /* Drop the conditions known to be true, and give up if any of them
+       is known to be false */
+    erase_if(Conds, [&](std::pair<const SCEV *, const SCEV *> &Cond) {
+        return SE.isKnownPredicate(ICmpInst::ICMP_ULE, Cond.first,
+                                   Cond.second);
+    });
+    for (auto &Cond : Conds) {
+        if (SE.isKnownPredicate(ICmpInst::ICMP_UGT, Cond.first, Cond.second)
+#if LLVM_VERSION_MAJOR >= 15
+            || !Expander.isSafeToExpandAt(Cond.first, InsertPt))
+#else
+            || !isSafeToExpandAt(Cond.first, InsertPt, SE))
+#endif
+            return nullptr;
+    }
+#if LLVM_VERSION_MAJOR >= 15
+    if (!Expander.isSafeToExpandAt(Max, InsertPt))
+#else
+    if (!isSafeToExpandAt(Max, InsertPt, SE))
+#endif
+        return nullptr;
+
+    IRBuilder<> Builder(InsertPt);
+    for (auto &Cond : Conds) {
+        Checks.push_back(Builder.CreateICmpULE(
+            Expander.expandCodeFor(Cond.first, Addr->getType(), InsertPt),
+            Expander.expandCodeFor(Cond.second, Addr->getType(), InsertPt)));
+    }
+    Checks.push_back(Builder.CreateICmpULE(
+        Expander.expandCodeFor(Max, Addr->getType(), InsertPt), Bound));
+    return Builder.CreateAnd(Checks);
+}
+
+static void
+version_loop(Loop *L, Value *Cond, ArrayRef<Instruction *> Checks,
+             LoopInfo &LI, DominatorTree &DT)
+{
+    BasicBlock *CheckBB = L->getLoopPreheader(), *OrigPH;
+    SmallVector<BasicBlock *, 8> ExitBlocks, NewBlocks;
+    ValueToValueMapTy VMap;
+    Loop *NewLoop;
+
+    L->getUniqueExitBlocks(ExitBlocks);
+
+    /* CheckBB -> OrigPH -> original loop
+                \-> NewPH -> loop without bound checks */
+    OrigPH = SplitBlock(CheckBB, CheckBB->getTerminator(), &DT, &LI, nullptr,
+                        L->getHeader()->getName() + ".ph");
+    NewLoop = cloneLoopWithPreheader(OrigPH, CheckBB, L, VMap, ".nobc", &LI,
+                                     &DT, NewBlocks);
+    remapInstructionsInBlocks(NewBlocks, VMap);
+
+    Instruction *Term = CheckBB->getTerminator();
+    BranchInst::Create(NewLoop->getLoopPreheader(), OrigPH, Cond, Term);
+    Term->eraseFromParent();
+
+    /* The loop is in LCSSA form, the values used outside the loop all
+       go through the phis of the exit blocks */
+    for (BasicBlock *Exit : ExitBlocks) {
+        for (PHINode &PN : Exit->phis()) {
+            for (unsigned I = 0, E = PN.getNumIncomingValues(); I < E; I++) {
+                BasicBlock *InBB = PN.getIncomingBlock(I);
+                if (!L->contains(InBB))
+                    continue;
+                Value *V = PN.getIncomingValue(I);
+                auto It = VMap.find(V);
+                if (It != VMap.end())
+                    V = It->second;
+                PN.addIncoming(V, cast<BasicBlock>(VMap[InBB]));
+            }
+        }
+    }
+
+    for (Instruction *Check : Checks) {
+        auto *NewCheck = cast<Instruction>(VMap[Check]);
+
+        if (auto *BI = dyn_cast<BranchInst>(NewCheck)) {
+            BI->setCondition(ConstantInt::getFalse(BI->getContext()));
+        }
+        else {
+            /* The address is never clamped */
+            NewCheck->replaceAllUsesWith(
+                cast<IntrinsicInst>(NewCheck)->getArgOperand(0));
+            NewCheck->eraseFromParent();
+        }
+    }
+
+    /* The idom of the exit blocks changed */
+    DT.recalculate(*CheckBB->getParent());
+}
+
+PreservedAnalyses
+BoundCheckVersioningPass::run(Function &F, FunctionAnalysisManager &AM)
+{
+    LoopInfo &LI = AM.getResult<LoopAnalysis>(F);
+    DominatorTree &DT = AM.getResult<DominatorTreeAnalysis>(F);
+    ScalarEvolution &SE = AM.getResult<ScalarEvolutionAnalysis>(F);
+    unsigned KindID = F.getContext().getMDKindID(AOT_BOUND_CHECK_METADATA);
+    SCEVExpander Expander(SE, F.getParent()->getDataLayout(), "bound_check");
+    SmallVector<Loop *, 8> Loops;
+    SmallVector<std::pair<Loop *, Value *>, 8> VersionedLoops;
+    SmallVector<SmallVector<Instruction *, 8>, 8> HoistedChecks;
+    bool Changed = false;
+
+    for (Loop *L : LI.getLoopsInPreorder()) {
+        if (L->isInnermost())
+            Loops.push_back(L);
+    }
+
+    for (Loop *L : Loops) {
+        SmallVector<Instruction *, 8> Checks;
+        SmallVector<Value *, 8> Conds;
+        const SCEV *ExitCount = nullptr;
+        BasicBlock *Latch;
+        unsigned Size = 0;
+
+        for (BasicBlock *BB : L->blocks()) {
+            Size += BB->size();
+            if (auto *BI = dyn_cast<BranchInst>(BB->getTerminator())) {
+                if (BI->isConditional() && BI->getMetadata(KindID)
+                    && !L->contains(BI->getSuccessor(0)))
+                    Checks.push_back(BI);
+            }
+            for (Instruction &I : *BB) {
+                if (isa<IntrinsicInst>(I) && I.getMetadata(KindID))
+                    Checks.push_back(&I);
+            }
+        }
+        if (Checks.empty() || Size > BOUND_CHECK_VERSIONING_MAX_LOOP_SIZE)
+            continue;
+
+        simplifyLoop(L, &DT, &LI, &SE, nullptr, nullptr, false);
+        formLCSSARecursively(*L, DT, &LI, &SE);
+        Changed = true;
+        if (!L->getLoopPreheader() || !L->hasDedicatedExits())
+            continue;
+
+        /* Each iteration runs the exiting blocks which dominate the latch,
+           so the loop runs at most their exit count + 1 iterations */
+        if ((Latch = L->getLoopLatch())) {
+            SmallVector<BasicBlock *, 8> ExitingBlocks;
+
+            L->getExitingBlocks(ExitingBlocks);
+            for (BasicBlock *ExitingBB : ExitingBlocks) {
+                const SCEV *Count = SE.getExitCount(L, ExitingBB);
+                if (!DT.dominates(ExitingBB, Latch)
+                    || isa<SCEVCouldNotCompute>(Count)
+                    || SE.getTypeSizeInBits(Count->getType()) > 64)
+                    continue;
+                ExitCount = ExitCount
+                                ? SE.getUMinFromMismatchedTypes(ExitCount, Count)
+                                : Count;
+            }
+        }
+        /* Only version the countable loops, the others usually run a few
+           iterations, in which the checks cost little */
+        if (!ExitCount)
+            continue;
+
+        auto It = Checks.begin();
+        while (It != Checks.end()) {
+            Value *Cond = hoist_bound_check(L, *It, SE, Expander, ExitCount);
+            if (Cond) {
+                Conds.push_back(Cond);
+                It++;
+            }
+            else {
+                It = Checks.erase(It);
+            }
+        }
+        if (Checks.empty())
+            continue;
+
+        IRBuilder<> Builder(L->getLoopPreheader()->getTerminator());
+        VersionedLoops.push_back({ L, Builder.CreateAnd(Conds) });
+        HoistedChecks.push_back(Checks);
+    }
+
+    if (!Changed)
+        return PreservedAnalyses::all();
+
+    /* Clone the loops after all the SCEVs are expanded */
+    for (unsigned I = 0; I < VersionedLoops.size(); I++) {
+        version_loop(VersionedLoops[I].first, VersionedLoops[I].second,
+                     HoistedChecks[I], LI, DT);
+    }
+
+    return PreservedAnalyses::none();
+}
+
 bool
 aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str)
 {
@@ -362,6 +712,17 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
             ExitOnErr(PB.parsePassPipeline(MPM, comp_ctx->llvm_passes));
         }
 
+        if (comp_ctx->enable_bound_check || comp_ctx->mem64_clamp_log2 > 0) {
+            /* Hoist the bound checks out of loops before vectorizing them,
+               and remove the unreachable exception paths of the clones */
+            PB.registerVectorizerStartEPCallback(
+                [](FunctionPassManager &FPM, auto Level) {
+                    (void)Level;
+                    FPM.addPass(BoundCheckVersioningPass());
+                    FPM.addPass(SimplifyCFGPass());
+                });
+        }
+
         if (
 #if LLVM_VERSION_MAJOR <= 13
             PassBuilder::OptimizationLevel::O0 == OL
@@ -379,8 +740,23 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
                     /* Add the pre-link optimizations if the func count
                        is large enough or PGO is enabled */
                     MPM.addPass(PB.buildLTOPreLinkDefaultPipeline(OL));
-                else
+                else {
                     MPM.addPass(PB.buildLTODefaultPipeline(OL, NULL));
+                    /* The LTO pipeline doesn't run the vectorizer start
+                       EP callbacks, hoist the bound checks and vectorize
+                       the loops again here */
+                    if (comp_ctx->enable_bound_check
+                        || comp_ctx->mem64_clamp_log2 > 0) {
+                        FunctionPassManager FPM1;
+                        FPM1.addPass(BoundCheckVersioningPass());
+                        FPM1.addPass(SimplifyCFGPass());
+                        FPM1.addPass(LoopVectorizePass());
+                        FPM1.addPass(InstCombinePass());
+                        FPM1.addPass(SimplifyCFGPass());
+                        MPM.addPass(
+                            createModuleToFunctionPassAdaptor(std::move(FPM1)));
+                    }
+                }
             }
             else {
                 MPM.addPass(PB.buildPerModuleDefaultPipeline(OL));
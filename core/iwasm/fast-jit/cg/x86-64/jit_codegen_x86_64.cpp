@@ -9198,6 +9198,10 @@ jit_codegen_init()
 
     bh_memcpy_s(stream, code_size, code_buf, code_size);
     code_block_switch_to_jitted_from_interp = stream;
+#if WASM_ENABLE_LINUX_PERF != 0
+    if (wasm_runtime_get_linux_perf())
+        wasm_jitdump_code_load("fast_jit_switch_to_jitted_from_interp", stream, code_size, NULL, 0);
+#endif
 
 #if 0
     dump_native(stream, code_size);
@@ -9246,6 +9250,10 @@ jit_codegen_init()
     bh_memcpy_s(stream, code_size, code_buf, code_size);
     code_block_return_to_interp_from_jitted =
         jit_globals->return_to_interp_from_jitted = stream;
+#if WASM_ENABLE_LINUX_PERF != 0
+    if (wasm_runtime_get_linux_perf())
+        wasm_jitdump_code_load("fast_jit_return_to_interp_from_jitted", stream, code_size, NULL, 0);
+#endif
 
 #if 0
     dump_native(stream, code_size);
@@ -9351,6 +9359,10 @@ jit_codegen_init()
     bh_memcpy_s(stream, code_size, code_buf, code_size);
     code_block_compile_fast_jit_and_then_call =
         jit_globals->compile_fast_jit_and_then_call = stream;
+#if WASM_ENABLE_LINUX_PERF != 0
+    if (wasm_runtime_get_linux_perf())
+        wasm_jitdump_code_load("fast_jit_compile_and_then_call", stream, code_size, NULL, 0);
+#endif
 
 #if 0
     dump_native(stream, code_size);
@@ -9,6 +9,7 @@
 #include "../jit_frontend.h"
 #include "../jit_codegen.h"
 #include "../../interpreter/wasm_runtime.h"
+#include "../../common/wasm_memory.h"
 #include "jit_emit_control.h"
 
 #ifndef OS_ENABLE_HW_BOUND_CHECK
@@ -839,6 +840,54 @@ fail:
 }
 #endif
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+static int
+wasm_discard_memory_range(WASMModuleInstance *inst, uint32 mem_idx, uint32 len,
+                          uint32 addr)
+{
+    if ((addr | len) % DEFAULT_NUM_BYTES_PER_PAGE != 0) {
+        wasm_set_exception(inst, "unaligned memory discard");
+        return -1;
+    }
+
+    if (!wasm_discard_memory(inst->memories[mem_idx], addr, len)) {
+        wasm_set_exception(inst, "out of bounds memory access");
+        return -1;
+    }
+
+    return 0;
+}
+
+bool
+jit_compile_op_memory_discard(JitCompContext *cc, uint32 mem_idx)
+{
+    JitReg res, len, addr;
+    JitReg args[4] = { 0 };
+
+    POP_I32(len);
+    POP_I32(addr);
+
+    res = jit_cc_new_reg_I32(cc);
+    args[0] = get_module_inst_reg(cc->jit_frame);
+    args[1] = NEW_CONST(I32, mem_idx);
+    args[2] = len;
+    args[3] = addr;
+
+    if (!jit_emit_callnative(cc, wasm_discard_memory_range, res, args,
+                             sizeof(args) / sizeof(args[0])))
+        goto fail;
+
+    GEN_INSN(CMP, cc->cmp_reg, res, NEW_CONST(I32, 0));
+    if (!jit_emit_exception(cc, EXCE_ALREADY_THROWN, JIT_OP_BLTS, cc->cmp_reg,
+                            NULL))
+        goto fail;
+
+    return true;
+fail:
+    return false;
+}
+#endif
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #define GEN_AT_RMW_INSN(op, op_type, bytes, result, value, memory_data,       \
                         offset1)                                              \
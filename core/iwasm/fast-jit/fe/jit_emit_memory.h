@@ -66,6 +66,11 @@ bool
 jit_compile_op_memory_fill(JitCompContext *cc, uint32 mem_idx);
 #endif
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+bool
+jit_compile_op_memory_discard(JitCompContext *cc, uint32 mem_idx);
+#endif
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
 bool
 jit_compile_op_atomic_rmw(JitCompContext *cc, uint8 atomic_op, uint8 op_type,
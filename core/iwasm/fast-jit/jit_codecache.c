@@ -53,6 +53,76 @@ jit_code_cache_free(void *ptr)
         mem_allocator_free(code_cache_pool_allocator, ptr);
 }
 
+#if WASM_ENABLE_LINUX_PERF != 0
+static int
+compare_jitdump_lines(const void *l1, const void *l2)
+{
+    uintptr_t addr1 = (uintptr_t)((const WASMJitDumpLine *)l1)->code_addr;
+    uintptr_t addr2 = (uintptr_t)((const WASMJitDumpLine *)l2)->code_addr;
+
+    if (addr1 < addr2)
+        return -1;
+    else if (addr1 > addr2)
+        return 1;
+    else
+        return 0;
+}
+
+/* Write the jitted code into the jitdump, with the line table built from the
+   beginning bytecode of each basic block */
+static void
+write_perf_jitdump(JitCompContext *cc)
+{
+    WASMModule *module = cc->cur_wasm_module;
+    const char *module_name = wasm_get_module_name(module);
+    uint32 jit_func_idx = cc->cur_wasm_func_idx - module->import_function_count;
+    uint32 label_num = jit_cc_label_num(cc), line_count = 0, i, j;
+    WASMJitDumpLine *lines = NULL;
+    char func_name[96];
+    uint8 *bcip;
+
+    if (jit_annl_is_enabled_begin_bcip(cc)
+        && (lines = jit_malloc(sizeof(WASMJitDumpLine) * label_num))) {
+        for (i = 0; i < label_num; i++) {
+            JitReg label = jit_reg_new(JIT_REG_KIND_L32, i);
+
+            if (!(bcip = *jit_annl_begin_bcip(cc, label)))
+                continue;
+            lines[line_count].code_addr = *jit_annl_jitted_addr(cc, label);
+            lines[line_count].bytecode_offset =
+                (uint32)(bcip - module->load_addr);
+            line_count++;
+        }
+
+        qsort(lines, line_count, sizeof(WASMJitDumpLine),
+              compare_jitdump_lines);
+
+        /* Keep one line for the empty basic blocks sharing the address */
+        for (i = j = 0; i < line_count; i++) {
+            if (j > 0 && lines[j - 1].code_addr == lines[i].code_addr)
+                j--;
+            lines[j++] = lines[i];
+        }
+        line_count = j;
+    }
+
+    if (module_name && strlen(module_name) > 0)
+        (void)snprintf(func_name, sizeof(func_name), "[%s]#fast_jit_func#%u",
+                       module_name, jit_func_idx);
+    else
+        (void)snprintf(func_name, sizeof(func_name), "fast_jit_func#%u",
+                       jit_func_idx);
+
+    wasm_jitdump_code_load(
+        func_name, cc->jitted_addr_begin,
+        (uint32)((uint8 *)cc->jitted_addr_end - (uint8 *)cc->jitted_addr_begin),
+        lines, line_count);
+
+    if (lines)
+        jit_free(lines);
+}
+#endif
+
 bool
 jit_pass_register_jitted_code(JitCompContext *cc)
 {
@@ -61,6 +131,12 @@ jit_pass_register_jitted_code(JitCompContext *cc)
     WASMFunction *func = cc->cur_wasm_func;
     uint32 jit_func_idx = cc->cur_wasm_func_idx - module->import_function_count;
 
+#if WASM_ENABLE_LINUX_PERF != 0
+    /* Before the code is published and may be executed */
+    if (wasm_runtime_get_linux_perf())
+        write_perf_jitdump(cc);
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
     os_mutex_lock(&module->instance_list_lock);
@@ -2356,6 +2356,15 @@ jit_compile_func(JitCompContext *cc)
                         break;
                     }
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                    {
+                        read_leb_uint32(frame_ip, frame_ip_end, mem_idx);
+                        if (!jit_compile_op_memory_discard(cc, mem_idx))
+                            return false;
+                        break;
+                    }
+#endif /* WASM_ENABLE_MEMORY_DISCARD */
 #if WASM_ENABLE_REF_TYPES != 0
                     case WASM_OP_TABLE_INIT:
                     {
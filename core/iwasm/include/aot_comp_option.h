@@ -63,6 +63,7 @@ typedef struct AOTCompOption {
     bool is_sgx_platform;
     bool enable_bulk_memory;
     bool enable_bulk_memory_opt;
+    bool enable_memory_discard;
     bool enable_thread_mgr;
     bool enable_tail_call;
     bool enable_simd;
@@ -84,7 +85,10 @@ typedef struct AOTCompOption {
     bool quick_invoke_c_api_import;
     bool enable_shared_heap;
     bool enable_shared_chain;
+    bool enable_instruction_metering;
+    bool enable_epoch_interruption;
     char *use_prof_file;
+    char *use_interp_prof_file;
     uint32_t opt_level;
     uint32_t size_level;
     uint32_t output_format;
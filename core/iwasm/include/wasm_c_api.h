@@ -189,6 +189,7 @@ struct wasm_config_t {
     MemAllocOption mem_alloc_option;
     uint32_t segue_flags;
     bool enable_linux_perf;
+    uint64_t module_cache_budget;
     /*TODO: wasi args*/
 };
 
@@ -207,6 +208,7 @@ typedef struct InstantiationArgs {
  * - mem_alloc_type is Alloc_With_System_Allocator
  * - mem_alloc_option is all 0
  * - enable_linux_perf is false
+ * - module_cache_budget is 0
  */
 WASM_API_EXTERN own wasm_config_t* wasm_config_new(void);
 
@@ -228,6 +230,17 @@ wasm_config_set_linux_perf_opt(wasm_config_t *, bool);
 WASM_API_EXTERN wasm_config_t*
 wasm_config_set_segue_flags(wasm_config_t *config, uint32_t segue_flags);
 
+/**
+ * Set the budget in bytes of the module cache when WAMR_BUILD_WASM_CACHE
+ * is enabled. The modules created with the same binary share one loaded
+ * module, and a module loaded from a cloned binary is kept in the cache
+ * after all its stores are deleted, until the total binary size of the
+ * cached modules exceeds the budget and it is the least recently used.
+ * 0 means that a module is unloaded once it isn't used by any store.
+ */
+WASM_API_EXTERN wasm_config_t*
+wasm_config_set_module_cache_budget(wasm_config_t *config, uint64_t budget);
+
 // Engine
 
 WASM_DECLARE_OWN(engine)
@@ -250,6 +263,27 @@ WASM_API_EXTERN own wasm_engine_t* wasm_engine_new_with_config(wasm_config_t*);
 WASM_API_DEPRECATED WASM_API_EXTERN own wasm_engine_t *
 wasm_engine_new_with_args(mem_alloc_type_t type, const MemAllocOption *opts);
 
+/* Statistics of the module cache */
+typedef struct wasm_module_cache_stats_t {
+    /* the modules created by reusing a cached module */
+    uint64_t hits;
+    /* the modules loaded because no cached module has the same binary */
+    uint64_t misses;
+    /* the unused modules unloaded to keep the cache within the budget */
+    uint64_t evictions;
+    /* the cached modules and the total size of their binaries */
+    uint32_t module_count;
+    uint64_t size;
+} wasm_module_cache_stats_t;
+
+/**
+ * Get the statistics of the module cache, return false if
+ * WAMR_BUILD_WASM_CACHE isn't enabled
+ */
+WASM_API_EXTERN bool
+wasm_engine_get_module_cache_stats(wasm_engine_t *engine,
+                                   wasm_module_cache_stats_t *stats);
+
 // Store
 
 WASM_DECLARE_OWN(store)
@@ -538,6 +572,8 @@ typedef struct LoadArgs {
        wasm_runtime_load_ex has to be followed by a wasm_runtime_resolve_symbols
        call */
     bool no_resolve;
+    /* This option is only used by the wasm loader (see wasm_export.h) */
+    bool use_prepared_code;
     /* TODO: more fields? */
 } LoadArgs;
 #endif /* LOAD_ARGS_OPTION_DEFINED */
@@ -556,6 +592,11 @@ WASM_API_EXTERN bool wasm_module_validate(wasm_store_t*, const wasm_byte_vec_t*
 WASM_API_EXTERN void wasm_module_imports(const wasm_module_t*, own wasm_importtype_vec_t* out);
 WASM_API_EXTERN void wasm_module_exports(const wasm_module_t*, own wasm_exporttype_vec_t* out);
 
+// With WAMR_BUILD_PREPARED_MODULE, wasm_module_serialize generates a prepared
+// module, and wasm_module_deserialize loads it like wasm_module_new, i.e. the
+// functions are validated and prepared again. The prepared code isn't
+// validated, to skip the preparation load a prepared module from a trusted
+// source with wasm_module_new_ex and LoadArgs.use_prepared_code set.
 WASM_API_EXTERN void wasm_module_serialize(wasm_module_t*, own wasm_byte_vec_t* out);
 WASM_API_EXTERN own wasm_module_t* wasm_module_deserialize(wasm_store_t*, const wasm_byte_vec_t*);
 
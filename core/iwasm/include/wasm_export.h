@@ -250,9 +250,13 @@ typedef struct RuntimeInitArgs {
     uint32_t segue_flags;
     /**
      * If enabled
-     * - llvm-jit will output a jitdump file for `perf inject`
-     * - aot will output a perf-${pid}.map for `perf record`
-     * - fast-jit. TBD
+     * - llvm-jit will output a jitdump file for `perf inject`, with the
+     *   wasm bytecode offsets as the line numbers
+     * - aot will output a perf-${pid}.map for `perf record`, and the
+     *   code load records into ${JITDUMPDIR:-/tmp}/jit-${pid}.dump for
+     *   `perf inject`
+     * - fast-jit will output the code load records and the bytecode offset
+     *   line tables into ${JITDUMPDIR:-/tmp}/jit-${pid}.dump
      * - multi-tier-jit. TBD
      * - interpreter. TBD
      */
@@ -275,6 +279,17 @@ typedef struct LoadArgs {
        wasm_runtime_load_ex has to be followed by a wasm_runtime_resolve_symbols
        call */
     bool no_resolve;
+    /* false by default, if true and the wasm binary is a prepared module
+       generated by wasm_runtime_prepare_module with the same build of the
+       runtime, the fast interpreter uses the prepared code instead of
+       validating and preparing the function bodies again. Only set it for
+       the binaries from a trusted source, the prepared code isn't validated */
+    bool use_prepared_code;
+    /* false by default, if true, the AOT loader maps the text section in
+       the granularity of 2MB huge pages and advises the OS to back it with
+       transparent huge pages, which reduces the iTLB misses of large AOT
+       modules at the cost of up to one huge page of padding */
+    bool huge_page_text;
     /* TODO: more fields? */
 } LoadArgs;
 #endif /* LOAD_ARGS_OPTION_DEFINED */
@@ -291,6 +306,38 @@ typedef struct InstantiationArgs {
 
 struct InstantiationArgs2;
 
+/* Policy of backing the linear memory of an instance with huge pages */
+typedef enum {
+    /* Leave it to the platform, on Linux the mappings larger than 2MB are
+       advised to be backed with transparent huge pages */
+    HUGE_PAGE_POLICY_DEFAULT = 0,
+    /* Don't back the linear memory with huge pages */
+    HUGE_PAGE_POLICY_NONE,
+    /* Back the linear memory with transparent huge pages, and map it in
+       the granularity of 2MB when it is bound checked by software */
+    HUGE_PAGE_POLICY_THP,
+    /* Back the 2MB chunks of the linear memory with the pages of the huge
+       page pool (hugetlbfs) when it is bound checked with hardware trap,
+       and fall back to transparent huge pages for the others or when the
+       pool is exhausted */
+    HUGE_PAGE_POLICY_HUGETLB,
+} huge_page_policy_t;
+
+/* Policy of faulting in the pages of the linear memory of an instance which
+   are committed by instantiation and memory.grow */
+typedef enum {
+    /* Fault in the pages on demand when they are accessed the first time */
+    MEMORY_PREFAULT_POLICY_LAZY = 0,
+    /* Fault in the pages before instantiation and memory.grow return */
+    MEMORY_PREFAULT_POLICY_EAGER,
+    /* Fault in the pages with a background thread of the runtime, so that
+       memory.grow returns immediately and the pages are likely faulted in
+       when they are accessed. It falls back to eager if the runtime isn't
+       built with the thread manager, and to lazy if the OS can't fault in
+       the pages without changing them, e.g. Linux older than 5.14 */
+    MEMORY_PREFAULT_POLICY_BACKGROUND,
+} memory_prefault_policy_t;
+
 #ifndef WASM_VALKIND_T_DEFINED
 #define WASM_VALKIND_T_DEFINED
 typedef uint8_t wasm_valkind_t;
@@ -599,6 +646,29 @@ WASM_RUNTIME_API_EXTERN wasm_module_t
 wasm_runtime_load_ex(uint8_t *buf, uint32_t size, const LoadArgs *args,
                      char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Generate the prepared module of a WASM binary, which is the binary with the
+ * code prepared by the fast interpreter loader kept in a custom section. The
+ * runtime must be built with WAMR_BUILD_PREPARED_MODULE=1. Loading the
+ * prepared module with LoadArgs::use_prepared_code set skips validating and
+ * preparing the function bodies. The prepared code only works with the same
+ * build of the runtime, otherwise the loader prepares the function bodies
+ * again. The prepared module is still a valid WASM binary for other runtimes.
+ *
+ * @param buf the WASM binary, it isn't modified
+ * @param size the size of the WASM binary
+ * @param p_size return the size of the prepared module
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return the prepared module, which should be freed with wasm_runtime_free,
+ *         NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN uint8_t *
+wasm_runtime_prepare_module(const uint8_t *buf, uint32_t size,
+                            uint32_t *p_size, char *error_buf,
+                            uint32_t error_buf_size);
+
 /**
  * Resolve symbols for a previously loaded WASM module. Only useful when the
  * module was loaded with LoadArgs::no_resolve set to true
@@ -699,6 +769,30 @@ wasm_runtime_set_wasi_ns_lookup_pool(wasm_module_t module,
                                      const char *ns_lookup_pool[],
                                      uint32_t ns_lookup_pool_size);
 
+/**
+ * Enable the mmap mode of preopened WASI directories.
+ *
+ * The regular files opened read-only below the directories are mapped
+ * into memory, and fd_read/fd_pread copy the data from the mappings
+ * instead of calling into the kernel. The directories become read-only to
+ * the wasm app, which can't write the files below them or change their
+ * sizes. The host and other processes mustn't truncate the files while
+ * they are open, and they mustn't be reachable through another writable
+ * preopened directory, or accessing the truncated part of a mapping
+ * crashes the process. It is ignored on the platforms which don't support
+ * it.
+ *
+ * @param module         The module to set the WASI parameters for.
+ * @param mmap_dir_list  The guest paths of the directories, which must be
+ *                       preopened with dir_list or map_dir_list of
+ *                       wasm_runtime_set_wasi_args.
+ * @param mmap_dir_count The number of elements in mmap_dir_list.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_wasi_mmap_dir(wasm_module_t module,
+                               const char *mmap_dir_list[],
+                               uint32_t mmap_dir_count);
+
 /**
  * Instantiate a WASM module.
  *
@@ -764,6 +858,33 @@ WASM_RUNTIME_API_EXTERN void
 wasm_runtime_instantiation_args_set_max_memory_pages(
     struct InstantiationArgs2 *p, uint32_t v);
 
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_instantiation_args_set_huge_page_policy(
+    struct InstantiationArgs2 *p, huge_page_policy_t v);
+
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_instantiation_args_set_memory_prefault_policy(
+    struct InstantiationArgs2 *p, memory_prefault_policy_t v);
+
+/**
+ * Bind the linear memories, including the app heap, and the wasm stacks of
+ * the exec envs of the instance to a NUMA node, the threads spawned by the
+ * instance inherit it. v is -1 by default, which doesn't bind them.
+ * It requires WAMR_BUILD_NUMA=1 and is ignored otherwise.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_instantiation_args_set_numa_node(struct InstantiationArgs2 *p,
+                                              int32_t v);
+
+/**
+ * Pin the threads spawned by the instance to the CPUs of the NUMA node set
+ * with wasm_runtime_instantiation_args_set_numa_node. The thread calling
+ * the instance isn't pinned by the runtime.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_instantiation_args_set_numa_pin_threads(
+    struct InstantiationArgs2 *p, bool v);
+
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_instantiation_args_set_wasi_arg(struct InstantiationArgs2 *p,
                                              char *argv[], int argc);
@@ -796,6 +917,11 @@ wasm_runtime_instantiation_args_set_wasi_ns_lookup_pool(
     struct InstantiationArgs2 *p, const char *ns_lookup_pool[],
     uint32_t ns_lookup_pool_size);
 
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_instantiation_args_set_wasi_mmap_dir(struct InstantiationArgs2 *p,
+                                                  const char *mmap_dir_list[],
+                                                  uint32_t mmap_dir_count);
+
 /**
  * Instantiate a WASM module, with specified instantiation arguments
  *
@@ -1439,6 +1565,38 @@ WASM_RUNTIME_API_EXTERN uint64_t
 wasm_runtime_module_dup_data(wasm_module_inst_t module_inst, const char *src,
                              uint64_t size);
 
+/**
+ * Give the pages inside the free chunks of the heap of WASM module instance
+ * back to the OS, so that they don't occupy physical memory until the chunks
+ * are allocated and written again. It is a no-op if the runtime isn't built
+ * with WAMR_BUILD_HEAP_TRIM=1 or the heap is managed by the wasm application
+ * itself.
+ *
+ * It mustn't be called while the memory of the module instance is being
+ * grown by another thread unless the memory is shared, e.g. call it from
+ * the thread running the module instance after a request is handled.
+ *
+ * @param module_inst the WASM module instance which contains heap
+ *
+ * @return the size of the pages given back
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_runtime_trim_app_heap(wasm_module_inst_t module_inst);
+
+/**
+ * Set the min size of the pages given back to the OS when a chunk is freed
+ * from the heap of WASM module instance, the smaller ones are kept until
+ * wasm_runtime_trim_app_heap is called. The default is 128 KB, and 0 means
+ * that the pages are only given back by wasm_runtime_trim_app_heap.
+ * It is a no-op if the runtime isn't built with WAMR_BUILD_HEAP_TRIM=1.
+ *
+ * @param module_inst the WASM module instance which contains heap
+ * @param threshold the min size of the pages given back
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_app_heap_trim_threshold(wasm_module_inst_t module_inst,
+                                         uint32_t threshold);
+
 /**
  * Validate the app address, check whether it belongs to WASM module
  * instance's address space, or in its heap space or memory space.
@@ -1919,7 +2077,9 @@ wasm_runtime_set_native_stack_boundary(wasm_exec_env_t exec_env,
  * By default the instruction count limit is -1, which means no limit.
  * However, if the instruction count limit is set to a positive value,
  * the execution will be terminated when the instruction count reaches
- * the limit.
+ * the limit. The limit applies to each wasm_runtime_call_* call. For
+ * AOT, the module must be compiled with `--enable-instruction-metering`,
+ * and the limit is checked at loop headers, calls and returns.
  *
  * @param exec_env the execution environment
  * @param instruction_count the instruction count limit
@@ -1928,6 +2088,76 @@ WASM_RUNTIME_API_EXTERN void
 wasm_runtime_set_instruction_count_limit(wasm_exec_env_t exec_env,
                                          int instruction_count);
 
+/*
+ * The epoch interruption APIs, available when WASM_ENABLE_EPOCH_INTERRUPTION
+ * is enabled.
+ *
+ * The runtime keeps a global epoch counter, which is usually incremented
+ * periodically by a host timer thread. Each exec_env has a deadline in
+ * epochs, AOT code generated by `wamrc --enable-epoch-interruption` and
+ * LLVM JIT code compare the epoch with the deadline at function entries
+ * and loop headers. When the deadline is reached, the deadline callback
+ * of the exec_env is called, the execution goes on if it returns true,
+ * otherwise the "epoch deadline reached" exception is thrown. The check
+ * is a load and a compare, which is much cheaper than the instruction
+ * metering, and the interruption doesn't rely on signals.
+ *
+ * The interpreters and Fast JIT don't check the deadline.
+ */
+
+/**
+ * Callback called when the epoch deadline of an exec_env is reached
+ *
+ * @param exec_env the exec_env which reached its deadline
+ * @param user_data the user data passed to
+ *        wasm_runtime_set_epoch_deadline_callback
+ *
+ * @return true to go on executing, in which case the callback should set
+ *         a new deadline, e.g. after yielding the current task with
+ *         wasm_runtime_yield_task; false to interrupt the execution
+ */
+typedef bool (*wasm_epoch_deadline_callback_t)(wasm_exec_env_t exec_env,
+                                               void *user_data);
+
+/**
+ * Increment the global epoch counter, it can be called by any thread
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_increment_epoch(void);
+
+/**
+ * Get the global epoch counter
+ *
+ * @return the current epoch
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_runtime_get_epoch(void);
+
+/**
+ * Set the epoch deadline of the exec_env relative to the current epoch,
+ * by default there is no deadline
+ *
+ * @param exec_env the execution environment
+ * @param ticks_beyond_current the number of epochs after the current one
+ *        when the deadline is reached, UINT64_MAX for no deadline
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline(wasm_exec_env_t exec_env,
+                                uint64_t ticks_beyond_current);
+
+/**
+ * Set the callback called when the epoch deadline of the exec_env is
+ * reached, by default the execution is interrupted
+ *
+ * @param exec_env the execution environment
+ * @param callback the callback, NULL to remove it
+ * @param user_data the user data passed to the callback
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_epoch_deadline_callback(
+    wasm_exec_env_t exec_env, wasm_epoch_deadline_callback_t callback,
+    void *user_data);
+
 /**
  * Dump runtime memory consumption, including:
  *     Exec env memory consumption
@@ -2151,6 +2381,99 @@ WASM_RUNTIME_API_EXTERN uint32_t
 wasm_runtime_dump_pgo_prof_data_to_buf(wasm_module_inst_t module_inst,
                                        char *buf, uint32_t len);
 
+/**
+ * Get the size required to store the profile collected by the interpreter,
+ * which is available when the runtime is built with interpreter profiling
+ * and can be passed to wamrc with --use-interp-prof-file
+ *
+ * @param module_inst the WASM module instance
+ *
+ * @return size required to store the contents, 0 means error
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_get_interp_prof_data_size(wasm_module_inst_t module_inst);
+
+/**
+ * Dump the profile collected by the interpreter to buffer
+ *
+ * @param module_inst the WASM module instance
+ * @param buf buffer to store the dumped content
+ * @param len length of the buffer
+ *
+ * @return bytes dumped to the buffer, 0 means error and data in buf
+ *         may be invalid
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_dump_interp_prof_data_to_buf(wasm_module_inst_t module_inst,
+                                          char *buf, uint32_t len);
+
+/* The format of the profile dumped by the sampling profiler */
+typedef enum {
+    /* The folded stacks, one line per call path, e.g. "main;foo;bar 42",
+       which can be rendered by flamegraph.pl or speedscope */
+    WASM_SAMPLING_PROFILE_FOLDED = 0,
+    /* The uncompressed protobuf of pprof, read by `go tool pprof` */
+    WASM_SAMPLING_PROFILE_PPROF,
+} wasm_sampling_profile_format_t;
+
+/**
+ * Start the sampling profiler, available when WASM_ENABLE_SAMPLING_PROFILING
+ * is enabled.
+ *
+ * A process-wide SIGPROF timer interrupts the thread which consumes the
+ * CPU time, and the call stack of the exec_env it is running, if any, is
+ * recorded, so the overhead doesn't depend on the number of calls. The
+ * interpreters, Fast JIT, LLVM JIT and the AOT files generated with
+ * `wamrc --enable-dump-call-stack` are supported. The previous samples
+ * are discarded.
+ *
+ * @param interval_us the sampling interval in microseconds of CPU time,
+ *        the OS may not support intervals shorter than its timer tick
+ * @param max_call_paths the max number of distinct call paths recorded,
+ *        0 for the default, the samples of the other call paths are lost
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_start_sampling_profiler(uint32_t interval_us,
+                                     uint32_t max_call_paths);
+
+/**
+ * Stop the sampling profiler, the samples are kept until the profiler is
+ * started again or the runtime is destroyed
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_stop_sampling_profiler(void);
+
+/**
+ * Get the size required to store the profile of the sampling profiler
+ *
+ * @note the profiler must be stopped, and the sampled module instances
+ *       must not be deinstantiated yet, since the function names are got
+ *       from them
+ *
+ * @param format the format of the profile
+ *
+ * @return size required to store the contents, 0 means error, or that
+ *         there is no sample in the folded format
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_get_sampling_profile_size(wasm_sampling_profile_format_t format);
+
+/**
+ * Dump the profile of the sampling profiler to buffer
+ *
+ * @param format the format of the profile
+ * @param buf buffer to store the dumped content
+ * @param len length of the buffer
+ *
+ * @return bytes dumped to the buffer, 0 means error and data in buf
+ *         may be invalid
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_dump_sampling_profile_to_buf(
+    wasm_sampling_profile_format_t format, char *buf, uint32_t len);
+
 /**
  * Get a custom section by name
  *
@@ -2199,6 +2522,23 @@ WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_enlarge_memory(wasm_module_inst_t module_inst,
                             uint64_t inc_page_count);
 
+/**
+ * Discard a range of the default memory of a module instance: the range is
+ * filled with zeros, and the whole pages inside it are given back to the OS,
+ * so that they don't occupy physical memory until they are written again.
+ * The memory size isn't changed. It is the host side of the memory.discard
+ * instruction, except that the range doesn't need to be page aligned.
+ *
+ * @param module_inst the module instance
+ * @param offset the offset of the range in the memory
+ * @param len the length of the range
+ *
+ * @return true if success, false if the range is out of bounds
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_discard_memory(wasm_module_inst_t module_inst, uint64_t offset,
+                            uint64_t len);
+
 typedef enum {
     INTERNAL_ERROR,
     MAX_SIZE_REACHED,
@@ -2331,6 +2671,156 @@ wasm_runtime_begin_blocking_op(wasm_exec_env_t exec_env);
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_end_blocking_op(wasm_exec_env_t exec_env);
 
+/*
+ * The task scheduler APIs, available when WASM_ENABLE_TASK_SCHEDULER
+ * is enabled.
+ *
+ * The task scheduler runs many wasm function calls (tasks) on a fixed
+ * number of worker threads. Each task runs on its own native stack and
+ * its own exec_env (which also holds its wasm operand stack). A task is
+ * switched out when it waits in memory.atomic.wait, so that its worker
+ * thread runs other tasks in the meantime, and the worker threads steal
+ * ready tasks from each other.
+ *
+ * When a host function called by a task enters a blocking operation with
+ * wasm_runtime_begin_blocking_op, its worker thread hands the worker slot
+ * over to a spare worker thread (created on demand) until the operation
+ * ends, so host functions should wrap their blocking calls with these
+ * APIs. Host functions must not block in other ways, e.g. waiting on
+ * a lock held by another task.
+ *
+ * The task stacks are allocated without guard pages, the native stack
+ * overflow of a task is detected by the software boundary checks of the
+ * runtime with the stack size given to wasm_runtime_init_task_scheduler.
+ */
+
+typedef struct WASMTask *wasm_task_t;
+
+/**
+ * Initialize the task scheduler and create its worker threads
+ *
+ * @param worker_num the number of tasks running at the same time, i.e.
+ *        the number of worker threads which aren't blocked in blocking
+ *        operations
+ * @param task_stack_size the native stack size of each task, 0 to use
+ *        the default size
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_init_task_scheduler(uint32_t worker_num,
+                                 uint32_t task_stack_size);
+
+/**
+ * Wait until all the spawned tasks finish and destroy the task scheduler
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_task_scheduler(void);
+
+/**
+ * Spawn a task to call the wasm function with the exec_env
+ *
+ * @param exec_env the exec_env to run the task, it must not be used by
+ *        others until the task is joined
+ * @param function the function to call
+ * @param argc the number of arguments
+ * @param argv the arguments, the return values are also written back
+ *        to it, it must be kept valid until the task is joined
+ *
+ * @return the task if success, NULL otherwise
+ */
+WASM_RUNTIME_API_EXTERN wasm_task_t
+wasm_runtime_spawn_task(wasm_exec_env_t exec_env,
+                        wasm_function_inst_t function, uint32_t argc,
+                        uint32_t argv[]);
+
+/**
+ * Wait until the task finishes and release it, a task can be joined
+ * only once. When called by another task, the calling task is switched
+ * out instead of blocking its worker thread.
+ *
+ * @param task the task to join
+ *
+ * @return true if the function call succeeded, false if an exception
+ *         was thrown
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_join_task(wasm_task_t task);
+
+/**
+ * Put the current task back to the run queue to let other ready tasks
+ * run, it does nothing when it isn't called by a task or there is no
+ * other ready task. It can be called by host functions and by the epoch
+ * deadline callback to time slice the tasks.
+ *
+ * @param exec_env the exec_env of the calling function
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_yield_task(wasm_exec_env_t exec_env);
+
+/*
+ * The async op APIs, available when WASM_ENABLE_TASK_SCHEDULER is enabled.
+ *
+ * They let a host function wait for an operation completed later by
+ * another thread, e.g. an RPC, without pinning a thread: the host function
+ * creates an op, starts the operation which completes the op with
+ * wasm_runtime_complete_async_op from any thread, and then awaits it with
+ * wasm_runtime_await_async_op. When the host function is called by a task,
+ * the task is switched out together with all its wasm frames (interpreter
+ * frames or AOT native frames) and the native frames of the host function,
+ * and is resumed by a worker thread after the op is completed. Otherwise
+ * the calling thread is blocked until then.
+ *
+ * Example:
+ *
+ *   static int32_t
+ *   rpc_wrapper(wasm_exec_env_t exec_env, int32_t request)
+ *   {
+ *       wasm_async_op_t op = wasm_runtime_create_async_op(exec_env);
+ *       if (!op)
+ *           return -1;
+ *       // my_rpc_send calls wasm_runtime_complete_async_op(op, response)
+ *       // when the response arrives
+ *       my_rpc_send(request, op);
+ *       return (int32_t)wasm_runtime_await_async_op(exec_env, op);
+ *   }
+ */
+
+typedef struct WASMAsyncOp *wasm_async_op_t;
+
+/**
+ * Create an async op, it must be awaited once by the host function which
+ * creates it and completed once
+ *
+ * @param exec_env the exec_env of the calling host function
+ *
+ * @return the op if success, NULL otherwise
+ */
+WASM_RUNTIME_API_EXTERN wasm_async_op_t
+wasm_runtime_create_async_op(wasm_exec_env_t exec_env);
+
+/**
+ * Suspend the calling wasm function until the op is completed, and
+ * destroy the op
+ *
+ * @param exec_env the exec_env of the calling host function
+ * @param op the op to await
+ *
+ * @return the result passed to wasm_runtime_complete_async_op
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_runtime_await_async_op(wasm_exec_env_t exec_env, wasm_async_op_t op);
+
+/**
+ * Complete an async op and resume the wasm function awaiting it, it can
+ * be called by any thread, before or after the op is awaited
+ *
+ * @param op the op to complete
+ * @param result the result returned by wasm_runtime_await_async_op
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_complete_async_op(wasm_async_op_t op, uint64_t result);
+
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_set_module_name(wasm_module_t module, const char *name,
                              char *error_buf, uint32_t error_buf_size);
@@ -119,6 +119,29 @@ extern "C" {
 #define GET_MAX_LINEAR_MEMORY_SIZE(is_memory64) \
     (is_memory64 ? MAX_LINEAR_MEM64_MEMORY_SIZE : MAX_LINEAR_MEMORY_SIZE)
 
+#if WASM_ENABLE_MEMORY64 != 0
+/**
+ * Get log2 of the size of the address range which the load/store addresses
+ * of a memory64 linear memory are clamped to when the memory is bound
+ * checked with hardware trap: the max memory size rounded up to a power
+ * of two, and at least 4G. Return 0 if the max memory size exceeds
+ * WASM_MEMORY64_HW_BOUND_CHECK_MAX_GB.
+ */
+static inline uint8
+wasm_get_mem64_clamp_log2(uint64 max_memory_size)
+{
+    uint8 log2 = 32;
+
+    if (max_memory_size
+        > (uint64)WASM_MEMORY64_HW_BOUND_CHECK_MAX_GB * (uint64)BH_GB)
+        return 0;
+
+    while (((uint64)1 << log2) < max_memory_size)
+        log2++;
+    return log2;
+}
+#endif
+
 #if WASM_ENABLE_GC == 0
 typedef uintptr_t table_elem_type_t;
 #define NULL_REF (0xFFFFFFFF)
@@ -713,6 +736,12 @@ struct WASMFunction {
     uint8 *code_compiled;
     uint8 *consts;
     uint32 const_cell_num;
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    /* Offsets of the pointers in code_compiled, only recorded when the
+       module is loaded to be serialized into a prepared module */
+    uint32 *code_compiled_ptr_offsets;
+    uint32 code_compiled_ptr_count;
+#endif
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -755,6 +784,14 @@ struct WASMFunction {
 #if WASM_ENABLE_BRANCH_HINTS != 0
     uint8 *code_body_begin;
 #endif
+
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    /* Offsets (relative to code) of the conditional branches (if and
+       br_if) of the function in ascending order, only recorded for the
+       classic interpreter */
+    uint32 *prof_branch_offsets;
+    uint32 prof_branch_count;
+#endif
 };
 
 #if WASM_ENABLE_TAGS != 0
@@ -845,6 +882,9 @@ typedef struct WASIArguments {
     uint32 addr_count;
     const char **ns_lookup_pool;
     uint32 ns_lookup_count;
+    /* names of the preopened directories in the mmap mode */
+    const char **mmap_dir_list;
+    uint32 mmap_dir_count;
     char **argv;
     uint32 argc;
     os_raw_file_handle stdio[3];
@@ -1071,6 +1111,18 @@ struct WASMModule {
     const uint8 *name_section_buf_end;
 #endif
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    /* Whether to use the prepared code section of the binary */
+    bool use_prepared_code;
+    /* Whether to record the pointers in the prepared code to serialize it */
+    bool record_code_ptrs;
+    /* The content of the prepared code section, only valid while loading */
+    const uint8 *prepared_section_buf;
+    const uint8 *prepared_section_buf_end;
+    /* The hash of the function bodies in the code section */
+    uint64 code_section_hash;
+#endif
+
 #if WASM_ENABLE_BRANCH_HINTS != 0
     struct WASMCompilationHint **function_hints;
 #endif
@@ -1473,7 +1473,15 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
 #if WASM_ENABLE_LABELS_AS_VALUES != 0
 
 #define HANDLE_OP(opcode) HANDLE_##opcode:
+#if WASM_ENABLE_INTERP_PROFILING != 0
+#define FETCH_OPCODE_AND_DISPATCH()      \
+    do {                                 \
+        PROFILE_OPCODE();                \
+        goto *handle_table[*frame_ip++]; \
+    } while (0)
+#else
 #define FETCH_OPCODE_AND_DISPATCH() goto *handle_table[*frame_ip++]
+#endif
 
 #if WASM_ENABLE_THREAD_MGR != 0 && WASM_ENABLE_DEBUG_INTERP != 0
 #define HANDLE_OP_END()                                                       \
@@ -1495,6 +1503,7 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
             os_mutex_unlock(&exec_env->wait_lock);                            \
         }                                                                     \
         CHECK_INSTRUCTION_LIMIT();                                            \
+        PROFILE_OPCODE();                                                     \
         goto *handle_table[*frame_ip++];                                      \
     } while (0)
 #else
@@ -1558,6 +1567,48 @@ get_global_addr(uint8 *global_data, WASMGlobalInstance *global)
 #define CHECK_INSTRUCTION_LIMIT() (void)0
 #endif
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+/* Count the pair of the previous opcode and the opcode to execute */
+#define PROFILE_OPCODE()                                         \
+    do {                                                         \
+        prof_opcode_ip = frame_ip;                               \
+        prof_opcode_pairs[prof_prev_opcode * 256 + *frame_ip]++; \
+        prof_prev_opcode = *frame_ip;                            \
+    } while (0)
+
+/* Count the taken or not-taken edge of the conditional branch
+   being executed */
+#define PROFILE_BRANCH(taken)                                       \
+    do {                                                            \
+        if (cur_func->prof_branch_counts)                           \
+            profile_branch(cur_func, prof_opcode_ip, (taken) != 0); \
+    } while (0)
+
+static void
+profile_branch(WASMFunctionInstance *func, const uint8 *opcode_ip, bool taken)
+{
+    WASMFunction *wasm_func = func->u.func;
+    uint32 offset = (uint32)(opcode_ip - wasm_func->code);
+    uint32 low = 0, high = wasm_func->prof_branch_count, mid;
+
+    /* The offsets were recorded in ascending order by the loader */
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (wasm_func->prof_branch_offsets[mid] < offset)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low < wasm_func->prof_branch_count
+        && wasm_func->prof_branch_offsets[low] == offset)
+        func->prof_branch_counts[low * 2 + (taken ? 0 : 1)]++;
+}
+#else
+#define PROFILE_OPCODE() (void)0
+#define PROFILE_BRANCH(taken) (void)0
+#endif
+
 static void
 wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                WASMExecEnv *exec_env,
@@ -1567,6 +1618,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
     WASMMemoryInstance *memory = wasm_get_default_memory(module);
 #if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
     || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_MEMORY64 != 0                    \
     || WASM_ENABLE_BULK_MEMORY_OPT != 0
     uint64 linear_mem_size = 0;
     if (memory)
@@ -1611,10 +1663,17 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
 #if WASM_ENABLE_EXCE_HANDLING != 0
     int32_t exception_tag_index;
+#endif
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    uint64 *prof_opcode_pairs = module->e->prof_opcode_pairs;
+    uint8 *prof_opcode_ip = NULL;
+    /* The opcode executed before the first one is treated as unreachable */
+    uint32 prof_prev_opcode = WASM_OP_UNREACHABLE;
 #endif
     uint8 value_type;
-#if !defined(OS_ENABLE_HW_BOUND_CHECK) \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0
+#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
+    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_MEMORY64 != 0
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     bool disable_bounds_checks = !wasm_runtime_is_bounds_checks_enabled(
         (WASMModuleInstanceCommon *)module);
@@ -1673,6 +1732,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
 #if WASM_ENABLE_LABELS_AS_VALUES == 0
     while (frame_ip < frame_ip_end) {
+        PROFILE_OPCODE();
         opcode = *frame_ip++;
         switch (opcode) {
 #else
@@ -2170,6 +2230,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 }
 
                 cond = (uint32)POP_I32();
+                PROFILE_BRANCH(cond);
 
                 if (cond) { /* if branch is met */
                     PUSH_CSP(LABEL_TYPE_IF, param_cell_num, cell_num, end_addr);
@@ -2247,6 +2308,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #endif
                 read_leb_uint32(frame_ip, frame_ip_end, depth);
                 cond = (uint32)POP_I32();
+                PROFILE_BRANCH(cond);
                 if (cond)
                     goto label_pop_csp_n;
                 HANDLE_OP_END();
@@ -4712,6 +4774,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                        it isn't changed in wasm_enlarge_memory */
 #if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
     || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_MEMORY64 != 0                    \
     || WASM_ENABLE_BULK_MEMORY != 0
                     linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
 #endif
@@ -5730,7 +5793,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         linear_mem_size = get_linear_mem_size();
 #endif
 
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || WASM_ENABLE_MEMORY64 != 0
                         CHECK_BULK_MEMORY_OVERFLOW(addr, bytes, maddr);
 #else
 #if WASM_ENABLE_SHARED_HEAP != 0
@@ -5797,7 +5860,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         linear_mem_size = get_linear_mem_size();
 #endif
                         /* dst boundary check */
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || WASM_ENABLE_MEMORY64 != 0
                         CHECK_BULK_MEMORY_OVERFLOW(dst, len, mdst);
 #else /* else of OS_ENABLE_HW_BOUND_CHECK */
 #if WASM_ENABLE_SHARED_HEAP != 0
@@ -5825,7 +5888,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         linear_mem_size = get_linear_mem_size();
 #endif
                         /* src boundary check */
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || WASM_ENABLE_MEMORY64 != 0
                         CHECK_BULK_MEMORY_OVERFLOW(src, len, msrc);
 #else
 #if WASM_ENABLE_SHARED_HEAP != 0
@@ -5877,7 +5940,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         linear_mem_size = get_linear_mem_size();
 #endif
 
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || WASM_ENABLE_MEMORY64 != 0
                         CHECK_BULK_MEMORY_OVERFLOW(dst, len, mdst);
 #else
 #if WASM_ENABLE_SHARED_HEAP != 0
@@ -5897,6 +5960,35 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         break;
                     }
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                    {
+                        mem_offset_t addr, len;
+
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        read_leb_memidx(frame_ip, frame_ip_end, memidx);
+#else
+                        /* skip memory index */
+                        frame_ip++;
+#endif
+
+                        len = POP_MEM_OFFSET();
+                        addr = POP_MEM_OFFSET();
+
+                        if ((addr | len) % DEFAULT_NUM_BYTES_PER_PAGE != 0) {
+                            wasm_set_exception(module,
+                                               "unaligned memory discard");
+                            goto got_exception;
+                        }
+                        if (!wasm_discard_memory(memory, (uint64)addr,
+                                                 (uint64)len)) {
+                            wasm_set_exception(module,
+                                               "out of bounds memory access");
+                            goto got_exception;
+                        }
+                        break;
+                    }
+#endif /* WASM_ENABLE_MEMORY_DISCARD */
 #if WASM_ENABLE_REF_TYPES != 0 || WASM_ENABLE_GC != 0
                     case WASM_OP_TABLE_INIT:
                     {
@@ -6722,6 +6814,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                it isn't changed in wasm_enlarge_memory */
 #if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
     || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_MEMORY64 != 0                    \
     || WASM_ENABLE_BULK_MEMORY != 0
             if (memory)
                 linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
@@ -6798,6 +6891,9 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             /* Initialize the interpreter context. */
             frame->function = cur_func;
+#if WASM_ENABLE_INTERP_PROFILING != 0
+            cur_func->prof_exec_cnt++;
+#endif
             frame_ip = wasm_get_func_code(cur_func);
             frame_ip_end = wasm_get_func_code_end(cur_func);
             frame_lp = frame->lp;
@@ -6879,6 +6975,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
 #if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
     || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_MEMORY64 != 0                    \
     || WASM_ENABLE_BULK_MEMORY_OPT != 0
     out_of_bounds:
         wasm_set_exception(module, "out of bounds memory access");
@@ -102,6 +102,25 @@ typedef float64 CellType_F64;
 #define CHECK_INSTRUCTION_LIMIT() (void)0
 #endif
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+/* Count the pair of the previous opcode and the opcode being executed.
+   Several opcodes may share one handler, only the first label reached
+   after the dispatch counts, so that falling through the labels of the
+   shared handler isn't treated as executing the other opcodes. */
+#define PROFILE_OPCODE(op)                                      \
+    do {                                                        \
+        if (prof_dispatched) {                                  \
+            prof_opcode_pairs[prof_prev_opcode * 256 + (op)]++; \
+            prof_prev_opcode = (op);                            \
+            prof_dispatched = false;                            \
+        }                                                       \
+    } while (0)
+#define PROFILE_DISPATCH() prof_dispatched = true
+#else
+#define PROFILE_OPCODE(op) (void)0
+#define PROFILE_DISPATCH() (void)0
+#endif
+
 static inline uint32
 rotl32(uint32 n, uint32 c)
 {
@@ -1430,6 +1449,8 @@ wasm_interp_dump_op_count()
 /* #define HANDLE_OP(opcode) HANDLE_##opcode:printf(#opcode"\n"); */
 #if WASM_ENABLE_OPCODE_COUNTER != 0
 #define HANDLE_OP(opcode) HANDLE_##opcode : opcode_table[opcode].count++;
+#elif WASM_ENABLE_INTERP_PROFILING != 0
+#define HANDLE_OP(opcode) HANDLE_##opcode : PROFILE_OPCODE(opcode);
 #else
 #define HANDLE_OP(opcode) HANDLE_##opcode:
 #endif
@@ -1439,6 +1460,7 @@ wasm_interp_dump_op_count()
         const void *p_label_addr = *(void **)frame_ip; \
         frame_ip += sizeof(void *);                    \
         CHECK_INSTRUCTION_LIMIT();                     \
+        PROFILE_DISPATCH();                            \
         goto *p_label_addr;                            \
     } while (0)
 #else
@@ -1451,6 +1473,7 @@ wasm_interp_dump_op_count()
         p_label_addr = label_base + (int32)LOAD_U32_WITH_2U16S(frame_ip); \
         frame_ip += sizeof(int32);                                        \
         CHECK_INSTRUCTION_LIMIT();                                        \
+        PROFILE_DISPATCH();                                               \
         goto *p_label_addr;                                               \
     } while (0)
 #else
@@ -1462,6 +1485,7 @@ wasm_interp_dump_op_count()
         p_label_addr = (void *)(uintptr_t)LOAD_U32_WITH_2U16S(frame_ip); \
         frame_ip += sizeof(int32);                                       \
         CHECK_INSTRUCTION_LIMIT();                                       \
+        PROFILE_DISPATCH();                                              \
         goto *p_label_addr;                                              \
     } while (0)
 #endif
@@ -1573,6 +1597,12 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_TAIL_CALL != 0 || WASM_ENABLE_GC != 0
     bool is_return_call = false;
 #endif
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    uint64 *prof_opcode_pairs = module->e ? module->e->prof_opcode_pairs : NULL;
+    /* The opcode executed before the first one is treated as unreachable */
+    uint32 prof_prev_opcode = WASM_OP_UNREACHABLE;
+    bool prof_dispatched = false;
+#endif
 #if WASM_ENABLE_SHARED_HEAP != 0
     /* TODO: currently flowing two variables are only dummy for shared heap
      * boundary check, need to be updated when multi-memory or memory64
@@ -1600,6 +1630,8 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0
         frame_ip++;
 #endif
+        PROFILE_DISPATCH();
+        PROFILE_OPCODE(opcode);
         switch (opcode) {
 #else
     goto *handle_table[WASM_OP_IMPDEP];
@@ -5297,6 +5329,28 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         break;
                     }
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                    {
+                        uint32 addr, len;
+
+                        len = POP_I32();
+                        addr = POP_I32();
+
+                        if ((addr | len) % DEFAULT_NUM_BYTES_PER_PAGE != 0) {
+                            wasm_set_exception(module,
+                                               "unaligned memory discard");
+                            goto got_exception;
+                        }
+                        if (!wasm_discard_memory(memory, (uint64)addr,
+                                                 (uint64)len)) {
+                            wasm_set_exception(module,
+                                               "out of bounds memory access");
+                            goto got_exception;
+                        }
+                        break;
+                    }
+#endif /* WASM_ENABLE_MEMORY_DISCARD */
 #if WASM_ENABLE_REF_TYPES != 0 || WASM_ENABLE_GC != 0
                     case WASM_OP_TABLE_INIT:
                     {
@@ -7741,6 +7795,9 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             /* Initialize the interpreter context. */
             frame->function = cur_func;
+#if WASM_ENABLE_INTERP_PROFILING != 0
+            cur_func->prof_exec_cnt++;
+#endif
             frame_ip = wasm_get_func_code(cur_func);
             frame_ip_end = wasm_get_func_code_end(cur_func);
 
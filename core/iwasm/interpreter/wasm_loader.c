@@ -25,11 +25,19 @@
 #if WASM_ENABLE_JIT != 0
 #include "../compilation/aot_llvm.h"
 #endif
+#if WASM_ENABLE_PREPARED_MODULE != 0
+#include "../../version.h"
+#endif
 
 #ifndef TRACE_WASM_LOADER
 #define TRACE_WASM_LOADER 0
 #endif
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+/* Name of the custom section which keeps the prepared code */
+#define PREPARED_SECTION_NAME "wamr.prepared"
+#endif
+
 /* Read a value of given type from the address pointed to by the given
    pointer and increase the pointer to the position just after the
    value being read.  */
@@ -379,6 +387,30 @@ memory_realloc(void *mem_old, uint32 size_old, uint32 size_new, char *error_buf,
         mem = mem_new;                                                     \
     } while (0)
 
+#if WASM_ENABLE_INTERP_PROFILING != 0 && WASM_ENABLE_FAST_INTERP == 0
+/* Record the offset of a conditional branch for the interpreter profiling,
+   the offsets array grows by doubling, so its capacity is 8 or the count
+   if the count is a power of 2 larger than 8 */
+static bool
+record_prof_branch(WASMFunction *func, const uint8 *p_opcode, char *error_buf,
+                   uint32 error_buf_size)
+{
+    uint32 count = func->prof_branch_count;
+
+    if (count == 0 || (count >= 8 && (count & (count - 1)) == 0)) {
+        uint32 capacity = count == 0 ? 8 : count * 2;
+        MEM_REALLOC(func->prof_branch_offsets, sizeof(uint32) * count,
+                    sizeof(uint32) * capacity);
+    }
+
+    func->prof_branch_offsets[count] = (uint32)(p_opcode - func->code);
+    func->prof_branch_count++;
+    return true;
+fail:
+    return false;
+}
+#endif
+
 static bool
 check_type_index(const WASMModule *module, uint32 type_count, uint32 type_index,
                  char *error_buf, uint32 error_buf_size)
@@ -1900,8 +1932,7 @@ resolve_struct_type(const uint8 **p_buf, const uint8 *buf_end,
 {
     const uint8 *p = *p_buf, *p_end = buf_end, *p_org;
     uint32 field_count, ref_type_map_count = 0, ref_field_count = 0;
-    uint32 i, j = 0, offset;
-    uint16 *reference_table;
+    uint32 i, j = 0;
     uint64 total_size;
     uint8 mutable;
     bool need_ref_type_map;
@@ -1955,16 +1986,15 @@ resolve_struct_type(const uint8 **p_buf, const uint8 *buf_end,
         }
     }
 
-    type->reference_table = reference_table =
+    type->reference_table =
         (uint16 *)((uint8 *)type + offsetof(WASMStructType, fields)
                    + sizeof(WASMStructFieldType) * field_count);
-    *reference_table++ = ref_field_count;
+    type->reference_table[0] = ref_field_count;
 
     type->base_type.type_flag = WASM_TYPE_STRUCT;
     type->field_count = field_count;
     type->ref_type_map_count = ref_type_map_count;
 
-    offset = (uint32)offsetof(WASMStructObject, field_data);
     for (i = 0; i < field_count; i++) {
         if (!resolve_value_type(&p, p_end, module, type_count,
                                 &need_ref_type_map, &ref_type, true, error_buf,
@@ -1989,22 +2019,10 @@ resolve_struct_type(const uint8 **p_buf, const uint8 *buf_end,
         type->fields[i].field_flags = read_uint8(p);
         type->fields[i].field_size =
             (uint8)wasm_reftype_size(ref_type.ref_type);
-#if !(defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
-      || defined(BUILD_TARGET_X86_32))
-        if (type->fields[i].field_size == 2)
-            offset = align_uint(offset, 2);
-        else if (type->fields[i].field_size >= 4) /* field size is 4 or 8 */
-            offset = align_uint(offset, 4);
-#endif
-        type->fields[i].field_offset = offset;
-        if (wasm_is_type_reftype(ref_type.ref_type))
-            *reference_table++ = offset;
-        offset += type->fields[i].field_size;
 
         LOG_VERBOSE("                field: %d, flags: %d, type: %d", i,
                     type->fields[i].field_flags, type->fields[i].field_type);
     }
-    type->total_size = offset;
 
     bh_assert(j == type->ref_type_map_count);
 #if TRACE_WASM_LOADER != 0
@@ -2401,6 +2419,20 @@ load_type_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
 
                 cur_type = module->types[processed_type_count + j];
 
+                if (cur_type->type_flag == WASM_TYPE_STRUCT) {
+                    WASMStructType *parent_type = NULL;
+
+                    if (parent_type_idx != (uint32)-1
+                        && module->types[parent_type_idx]->type_flag
+                               == WASM_TYPE_STRUCT)
+                        parent_type =
+                            (WASMStructType *)module->types[parent_type_idx];
+                    /* field offsets are set after the parent type is known,
+                       the fields are sorted by size to pack the object */
+                    wasm_struct_type_set_layout((WASMStructType *)cur_type,
+                                                parent_type, true);
+                }
+
                 cur_type->ref_count = 1;
                 cur_type->parent_type_idx = parent_type_idx;
                 cur_type->is_sub_final = is_sub_final;
@@ -5697,6 +5729,16 @@ load_user_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
     }
 #endif
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    if (name_len == sizeof(PREPARED_SECTION_NAME) - 1
+        && memcmp(p, PREPARED_SECTION_NAME, name_len) == 0
+        && module->use_prepared_code) {
+        module->prepared_section_buf = p + name_len;
+        module->prepared_section_buf_end = p_end;
+        LOG_VERBOSE("Found prepared code section.");
+    }
+#endif
+
 #if WASM_ENABLE_BRANCH_HINTS != 0
     if (name_len == 25
         && memcmp((const char *)p, "metadata.code.branch_hint", 25) == 0) {
@@ -5872,6 +5914,9 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
 #if WASM_ENABLE_BULK_MEMORY_OPT != 0
     option.enable_bulk_memory_opt = true;
 #endif
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+    option.enable_memory_discard = true;
+#endif
 #if WASM_ENABLE_THREAD_MGR != 0
     option.enable_thread_mgr = true;
 #endif
@@ -5905,6 +5950,12 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
 #if WASM_ENABLE_SHARED_HEAP != 0
     option.enable_shared_heap = true;
 #endif
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    option.enable_instruction_metering = true;
+#endif
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    option.enable_epoch_interruption = true;
+#endif
 
     module->comp_ctx = aot_create_comp_context(module->comp_data, &option);
     if (!module->comp_ctx) {
@@ -6247,6 +6298,228 @@ wasm_interp_get_handle_table(void);
 static void **handle_table;
 #endif
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+/*
+ * A prepared module is the wasm binary with a custom section appended, which
+ * keeps the code of the functions prepared by the fast interpreter loader:
+ *
+ *   uint32 version, uint32 function count,
+ *   uint64 fingerprint of the runtime, uint64 hash of the code section,
+ *   uint32 flags of the module,
+ *   then for each function:
+ *     uint32 code size, uint32 const cell num,
+ *     uint32 max stack cell num, uint32 max block num,
+ *     uint32 exception handler count, uint32 pointer count,
+ *     uint8 code[code size], uint32 pointer offsets[pointer count],
+ *     uint32 consts[const cell num]
+ *
+ * The integers are in the byte order of the host. The pointers in the code
+ * are relative to the code of the function, plus 1 so that 0 is NULL, or
+ * relative to the first opcode handler if their offsets have the
+ * PREPARED_PTR_HANDLER bit. The fingerprint covers the build features and
+ * the layout of the opcode handlers, the prepared code is only used by the
+ * same build of the runtime.
+ */
+#define PREPARED_VERSION 1
+#define PREPARED_PTR_HANDLER 0x80000000
+#define PREPARED_FLAG_POSSIBLE_MEMORY_GROW 1
+
+#define PREPARED_HASH_INIT 0xcbf29ce484222325ULL
+#define PREPARED_HASH_PRIME 0x100000001b3ULL
+
+/* FNV-1a on 64-bit words, it only has to detect a code section changed
+   after the prepared code was generated */
+static uint64
+prepared_hash(uint64 hash, const uint8 *buf, uint64 size)
+{
+    uint64 word;
+
+    for (; size >= sizeof(uint64);
+         buf += sizeof(uint64), size -= sizeof(uint64)) {
+        bh_memcpy_s(&word, sizeof(uint64), buf, sizeof(uint64));
+        hash = (hash ^ word) * PREPARED_HASH_PRIME;
+    }
+    for (; size > 0; buf++, size--)
+        hash = (hash ^ *buf) * PREPARED_HASH_PRIME;
+    return hash;
+}
+
+/* The build features which change the code generated by the loader or the
+   opcodes handled by the fast interpreter */
+#define PREPARED_FEATURE(feature, bit) ((feature) != 0 ? (1u << (bit)) : 0)
+#define PREPARED_FEATURES                                             \
+    (PREPARED_FEATURE(WASM_ENABLE_LABELS_AS_VALUES, 0)                \
+     | PREPARED_FEATURE(WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS, 1)   \
+     | PREPARED_FEATURE(WASM_ENABLE_REF_TYPES, 2)                     \
+     | PREPARED_FEATURE(WASM_ENABLE_BULK_MEMORY, 3)                   \
+     | PREPARED_FEATURE(WASM_ENABLE_BULK_MEMORY_OPT, 4)               \
+     | PREPARED_FEATURE(WASM_ENABLE_TAIL_CALL, 5)                     \
+     | PREPARED_FEATURE(WASM_ENABLE_MEMORY64, 6)                      \
+     | PREPARED_FEATURE(WASM_ENABLE_MULTI_MEMORY, 7)                  \
+     | PREPARED_FEATURE(WASM_ENABLE_SIMD, 8)                          \
+     | PREPARED_FEATURE(WASM_ENABLE_SIMDE, 9)                         \
+     | PREPARED_FEATURE(WASM_ENABLE_EXCE_HANDLING, 10)                \
+     | PREPARED_FEATURE(WASM_ENABLE_TAGS, 11)                         \
+     | PREPARED_FEATURE(WASM_ENABLE_SHARED_MEMORY, 12)                \
+     | PREPARED_FEATURE(WASM_ENABLE_SHARED_HEAP, 13)                  \
+     | PREPARED_FEATURE(WASM_ENABLE_THREAD_MGR, 14)                   \
+     | PREPARED_FEATURE(WASM_ENABLE_MULTI_MODULE, 15)                 \
+     | PREPARED_FEATURE(WASM_ENABLE_DEBUG_INTERP, 16)                 \
+     | PREPARED_FEATURE(WASM_ENABLE_MEMORY_DISCARD, 17)               \
+     | PREPARED_FEATURE(WASM_ENABLE_BRANCH_HINTS, 18)                 \
+     | PREPARED_FEATURE(WASM_ENABLE_EXTENDED_CONST_EXPR, 19)          \
+     | PREPARED_FEATURE(WASM_ENABLE_INSTRUCTION_METERING, 20)         \
+     | PREPARED_FEATURE(WASM_ENABLE_EPOCH_INTERRUPTION, 21)           \
+     | PREPARED_FEATURE(WASM_ENABLE_CALL_INDIRECT_OVERLONG, 22))
+
+static uint64
+prepared_fingerprint(void)
+{
+    uint32 build[] = { WAMR_VERSION_MAJOR, WAMR_VERSION_MINOR,
+                       WAMR_VERSION_PATCH, (uint32)sizeof(void *),
+                       (uint32)sizeof(WASMFunction), PREPARED_FEATURES };
+    uint64 hash = prepared_hash(PREPARED_HASH_INIT, (uint8 *)build,
+                                sizeof(build));
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    uint32 i;
+
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++) {
+        /* the unused opcodes may have no handler */
+        int64 offset =
+            handle_table[i]
+                ? (int64)((uint8 *)handle_table[i] - (uint8 *)handle_table[0])
+                : -1;
+        hash = prepared_hash(hash, (uint8 *)&offset, sizeof(int64));
+    }
+#endif
+    return hash;
+}
+
+static bool
+read_prepared_data(const uint8 **p_buf, const uint8 *buf_end, void *data,
+                   uint32 size)
+{
+    if ((uint64)(buf_end - *p_buf) < size)
+        return false;
+    bh_memcpy_s(data, size, *p_buf, size);
+    *p_buf += size;
+    return true;
+}
+
+static void
+free_prepared_code(WASMModule *module, uint32 function_count)
+{
+    WASMFunction *func;
+    uint32 i;
+
+    for (i = 0; i < function_count; i++) {
+        func = module->functions[i];
+        if (func->code_compiled)
+            wasm_runtime_free(func->code_compiled);
+        if (func->consts)
+            wasm_runtime_free(func->consts);
+        func->code_compiled = func->consts = NULL;
+    }
+}
+
+/* Set the prepared code of the functions from the prepared code section,
+   return false if it doesn't match the module or the runtime */
+static bool
+load_prepared_code(WASMModule *module)
+{
+    const uint8 *p = module->prepared_section_buf;
+    const uint8 *p_end = module->prepared_section_buf_end;
+    WASMFunction *func;
+    uint32 version, function_count, flags, i, j;
+    uint32 values[6], ptr_offset, consts_size;
+    uint64 fingerprint, code_section_hash;
+    uintptr_t value;
+    uint8 *code, *ptr;
+
+    if (!read_prepared_data(&p, p_end, &version, sizeof(uint32))
+        || version != PREPARED_VERSION
+        || !read_prepared_data(&p, p_end, &function_count, sizeof(uint32))
+        || function_count != module->function_count
+        || !read_prepared_data(&p, p_end, &fingerprint, sizeof(uint64))
+        || fingerprint != prepared_fingerprint()
+        || !read_prepared_data(&p, p_end, &code_section_hash, sizeof(uint64))
+        || code_section_hash != module->code_section_hash
+        || !read_prepared_data(&p, p_end, &flags, sizeof(uint32)))
+        return false;
+
+    for (i = 0; i < function_count; i++) {
+        func = module->functions[i];
+
+        /* code size, const cell num, max stack cell num, max block num,
+           exception handler count and pointer count */
+        if (!read_prepared_data(&p, p_end, values, sizeof(values))
+            || values[0] < sizeof(void *) || (uint64)(p_end - p) < values[0]
+            || !(code = loader_malloc(values[0], NULL, 0)))
+            goto fail;
+
+        bh_memcpy_s(code, values[0], p, values[0]);
+        p += values[0];
+        func->code_compiled = code;
+        func->code_compiled_size = values[0];
+
+        for (j = 0; j < values[5]; j++) {
+            if (!read_prepared_data(&p, p_end, &ptr_offset, sizeof(uint32)))
+                goto fail;
+
+            if ((ptr_offset & ~PREPARED_PTR_HANDLER)
+                > values[0] - sizeof(void *))
+                goto fail;
+
+            bh_memcpy_s(&value, sizeof(uintptr_t),
+                        code + (ptr_offset & ~PREPARED_PTR_HANDLER),
+                        sizeof(uintptr_t));
+            if (ptr_offset & PREPARED_PTR_HANDLER) {
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+                ptr = (uint8 *)handle_table[0] + (intptr_t)value;
+#else
+                goto fail;
+#endif
+            }
+            else if (value > values[0] + 1)
+                goto fail;
+            else
+                ptr = value > 0 ? code + value - 1 : NULL;
+
+            bh_memcpy_s(code + (ptr_offset & ~PREPARED_PTR_HANDLER),
+                        sizeof(void *), &ptr, sizeof(void *));
+        }
+
+        func->const_cell_num = values[1];
+        consts_size = (uint32)sizeof(uint32) * values[1];
+        if (values[1] > 0) {
+            if (values[1] > UINT32_MAX / sizeof(uint32)
+                || (uint64)(p_end - p) < consts_size
+                || !(func->consts = loader_malloc(consts_size, NULL, 0)))
+                goto fail;
+            bh_memcpy_s(func->consts, consts_size, p, consts_size);
+            p += consts_size;
+        }
+
+        func->max_stack_cell_num = values[2];
+        func->max_block_num = values[3];
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        func->exception_handler_count = values[4];
+#endif
+    }
+
+    if (p != p_end)
+        goto fail;
+
+    module->possible_memory_grow =
+        (flags & PREPARED_FLAG_POSSIBLE_MEMORY_GROW) ? true : false;
+    return true;
+
+fail:
+    free_prepared_code(module, i < function_count ? i + 1 : function_count);
+    return false;
+}
+#endif /* end of WASM_ENABLE_PREPARED_MODULE != 0 */
+
 static bool
 load_from_sections(WASMModule *module, WASMSection *sections,
                    bool is_load_from_file_buf, bool wasm_binary_freeable,
@@ -6267,6 +6540,7 @@ load_from_sections(WASMModule *module, WASMSection *sections,
     uint8 malloc_free_io_type = VALUE_TYPE_I32;
     bool reuse_const_strings = is_load_from_file_buf && !wasm_binary_freeable;
     bool clone_data_seg = is_load_from_file_buf && wasm_binary_freeable;
+    bool prepared = false;
 #if WASM_ENABLE_BULK_MEMORY != 0
     bool has_datacount_section = false;
 #endif
@@ -6623,10 +6897,25 @@ load_from_sections(WASMModule *module, WASMSection *sections,
     handle_table = wasm_interp_get_handle_table();
 #endif
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    if (module->record_code_ptrs || module->prepared_section_buf)
+        module->code_section_hash =
+            prepared_hash(PREPARED_HASH_INIT, buf_code,
+                          (uint64)(buf_code_end - buf_code));
+    if (module->prepared_section_buf) {
+        prepared = load_prepared_code(module);
+        if (!prepared)
+            LOG_WARNING("warning: the prepared code doesn't match the module "
+                        "or the runtime, prepare the module again");
+        module->prepared_section_buf = module->prepared_section_buf_end = NULL;
+    }
+#endif
+
     for (i = 0; i < module->function_count; i++) {
         WASMFunction *func = module->functions[i];
-        if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
-                                          error_buf_size)) {
+        if (!prepared
+            && !wasm_loader_prepare_bytecode(module, func, i, error_buf,
+                                             error_buf_size)) {
             return false;
         }
 
@@ -7222,6 +7511,10 @@ wasm_loader_load(uint8 *buf, uint32 size,
     module->load_size = size;
 #endif
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    module->use_prepared_code = args->use_prepared_code;
+#endif
+
     if (!load(buf, size, module, args->wasm_binary_freeable, args->no_resolve,
               error_buf, error_buf_size)) {
         goto fail;
@@ -7246,6 +7539,217 @@ fail:
     return NULL;
 }
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+static uint32
+write_leb_uint32(uint8 *buf, uint32 value)
+{
+    uint32 size = 0;
+
+    do {
+        uint8 byte = value & 0x7F;
+        value >>= 7;
+        if (value)
+            byte |= 0x80;
+        if (buf)
+            buf[size] = byte;
+        size++;
+    } while (value);
+    return size;
+}
+
+static void
+write_prepared_data(uint8 **p_buf, const void *data, uint32 size)
+{
+    bh_memcpy_s(*p_buf, size, data, size);
+    *p_buf += size;
+}
+
+/* Copy the sections of the binary except the prepared code section into
+   buf if it isn't NULL, and return the total size of them */
+static bool
+copy_sections_to_prepare(const uint8 *binary, uint32 binary_size, uint8 *buf,
+                         uint32 *p_size, char *error_buf,
+                         uint32 error_buf_size)
+{
+    const uint8 *p = binary + 8, *p_end = binary + binary_size;
+    const uint8 *section, *p_name;
+    uint32 section_size, name_len, size = 8;
+
+    if (buf)
+        bh_memcpy_s(buf, 8, binary, 8);
+
+    while (p < p_end) {
+        section = p++;
+        read_leb_uint32(p, p_end, section_size);
+        if (section_size > (uint32)(p_end - p)) {
+            set_error_buf(error_buf, error_buf_size, "unexpected end");
+            return false;
+        }
+
+        if (*section == SECTION_TYPE_USER) {
+            p_name = p;
+            read_leb_uint32(p_name, p_end, name_len);
+            if (name_len == sizeof(PREPARED_SECTION_NAME) - 1
+                && name_len <= (uint32)(p_end - p_name)
+                && !memcmp(p_name, PREPARED_SECTION_NAME, name_len)) {
+                p += section_size;
+                continue;
+            }
+        }
+
+        if (buf)
+            bh_memcpy_s(buf + size, (uint32)(p + section_size - section),
+                        section, (uint32)(p + section_size - section));
+        size += (uint32)(p + section_size - section);
+        p += section_size;
+    }
+
+    *p_size = size;
+    return true;
+fail:
+    return false;
+}
+
+uint8 *
+wasm_loader_prepare_module(const uint8 *binary, uint32 binary_size,
+                           uint32 *p_size, char *error_buf,
+                           uint32 error_buf_size)
+{
+    WASMModule *module = NULL;
+    WASMFunction *func;
+    uint8 *binary_copy = NULL, *buf = NULL, *p, *code, *ptr;
+    uint64 payload_size, size;
+    uint32 name_len = sizeof(PREPARED_SECTION_NAME) - 1;
+    uint32 sections_size, section_size, version = PREPARED_VERSION, flags = 0;
+    uint32 values[6], ptr_offset, i, j;
+    uint64 fingerprint;
+    uintptr_t value;
+
+#if WASM_ENABLE_LABELS_AS_VALUES != 0 \
+    && WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 && UINTPTR_MAX != UINT64_MAX
+    /* the opcode handler addresses are emitted as absolute uint32 */
+    set_error_buf(error_buf, error_buf_size,
+                  "prepared module isn't supported on this target");
+    return NULL;
+#endif
+
+    /* the loader may modify the binary, e.g. to terminate the strings */
+    if (!(binary_copy = loader_malloc(binary_size, error_buf, error_buf_size)))
+        return NULL;
+    bh_memcpy_s(binary_copy, binary_size, binary, binary_size);
+
+    if (!(module = create_module("", error_buf, error_buf_size)))
+        goto fail;
+
+    module->record_code_ptrs = true;
+    if (!load(binary_copy, binary_size, module, true, true, error_buf,
+              error_buf_size))
+        goto fail;
+
+    payload_size = sizeof(uint32) * 3 + sizeof(uint64) * 2;
+    for (i = 0; i < module->function_count; i++) {
+        func = module->functions[i];
+        payload_size += sizeof(values) + (uint64)func->code_compiled_size
+                        + sizeof(uint32) * (uint64)func->code_compiled_ptr_count
+                        + sizeof(uint32) * (uint64)func->const_cell_num;
+        if (func->code_compiled_size >= PREPARED_PTR_HANDLER) {
+            set_error_buf(error_buf, error_buf_size, "function too large");
+            goto fail;
+        }
+    }
+
+    section_size = 0;
+    if (payload_size < UINT32_MAX)
+        section_size =
+            write_leb_uint32(NULL, name_len) + name_len + (uint32)payload_size;
+    if (!copy_sections_to_prepare(binary, binary_size, NULL, &sections_size,
+                                  error_buf, error_buf_size))
+        goto fail;
+    size = (uint64)sections_size + 1 + write_leb_uint32(NULL, section_size)
+           + section_size;
+    if (payload_size >= UINT32_MAX || section_size < payload_size
+        || size >= UINT32_MAX) {
+        set_error_buf(error_buf, error_buf_size, "prepared module too large");
+        goto fail;
+    }
+
+    if (!(buf = loader_malloc(size, error_buf, error_buf_size)))
+        goto fail;
+
+    copy_sections_to_prepare(binary, binary_size, buf, &sections_size,
+                             error_buf, error_buf_size);
+    p = buf + sections_size;
+    *p++ = SECTION_TYPE_USER;
+    p += write_leb_uint32(p, section_size);
+    p += write_leb_uint32(p, name_len);
+    write_prepared_data(&p, PREPARED_SECTION_NAME, name_len);
+
+    fingerprint = prepared_fingerprint();
+    if (module->possible_memory_grow)
+        flags |= PREPARED_FLAG_POSSIBLE_MEMORY_GROW;
+    write_prepared_data(&p, &version, sizeof(uint32));
+    write_prepared_data(&p, &module->function_count, sizeof(uint32));
+    write_prepared_data(&p, &fingerprint, sizeof(uint64));
+    write_prepared_data(&p, &module->code_section_hash, sizeof(uint64));
+    write_prepared_data(&p, &flags, sizeof(uint32));
+
+    for (i = 0; i < module->function_count; i++) {
+        func = module->functions[i];
+        values[0] = func->code_compiled_size;
+        values[1] = func->const_cell_num;
+        values[2] = func->max_stack_cell_num;
+        values[3] = func->max_block_num;
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        values[4] = func->exception_handler_count;
+#else
+        values[4] = 0;
+#endif
+        values[5] = func->code_compiled_ptr_count;
+        write_prepared_data(&p, values, sizeof(values));
+
+        code = p;
+        write_prepared_data(&p, func->code_compiled, func->code_compiled_size);
+
+        /* make the pointers relative */
+        for (j = 0; j < func->code_compiled_ptr_count; j++) {
+            ptr_offset = func->code_compiled_ptr_offsets[j];
+            bh_memcpy_s(&ptr, sizeof(void *), code + ptr_offset,
+                        sizeof(void *));
+            if (!ptr)
+                value = 0;
+            else if (ptr >= func->code_compiled
+                     && ptr <= func->code_compiled + func->code_compiled_size)
+                value = (uintptr_t)(ptr - func->code_compiled) + 1;
+            else {
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+                value = (uintptr_t)(ptr - (uint8 *)handle_table[0]);
+                ptr_offset |= PREPARED_PTR_HANDLER;
+#else
+                bh_assert(0);
+#endif
+            }
+            bh_memcpy_s(code + (ptr_offset & ~PREPARED_PTR_HANDLER),
+                        sizeof(uintptr_t), &value, sizeof(uintptr_t));
+            write_prepared_data(&p, &ptr_offset, sizeof(uint32));
+        }
+
+        if (func->const_cell_num > 0)
+            write_prepared_data(&p, func->consts,
+                                (uint32)sizeof(uint32) * func->const_cell_num);
+    }
+
+    bh_assert(p == buf + size);
+    *p_size = (uint32)size;
+
+fail:
+    if (module)
+        wasm_loader_unload(module);
+    if (binary_copy)
+        wasm_runtime_free(binary_copy);
+    return buf;
+}
+#endif /* end of WASM_ENABLE_PREPARED_MODULE != 0 */
+
 void
 wasm_loader_unload(WASMModule *module)
 {
@@ -7297,6 +7801,11 @@ wasm_loader_unload(WASMModule *module)
                     wasm_runtime_free(module->functions[i]->code_compiled);
                 if (module->functions[i]->consts)
                     wasm_runtime_free(module->functions[i]->consts);
+#if WASM_ENABLE_PREPARED_MODULE != 0
+                if (module->functions[i]->code_compiled_ptr_offsets)
+                    wasm_runtime_free(
+                        module->functions[i]->code_compiled_ptr_offsets);
+#endif
 #endif
 #if WASM_ENABLE_FAST_JIT != 0
                 if (module->functions[i]->fast_jit_jitted_code) {
@@ -7315,6 +7824,11 @@ wasm_loader_unload(WASMModule *module)
                     wasm_runtime_free(
                         module->functions[i]->local_ref_type_maps);
                 }
+#endif
+#if WASM_ENABLE_INTERP_PROFILING != 0
+                if (module->functions[i]->prof_branch_offsets)
+                    wasm_runtime_free(
+                        module->functions[i]->prof_branch_offsets);
 #endif
                 wasm_runtime_free(module->functions[i]);
             }
@@ -8180,6 +8694,11 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                         skip_leb_memidx(p, p_end);
                         break;
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                        skip_leb_memidx(p, p_end);
+                        break;
+#endif
 #if WASM_ENABLE_REF_TYPES != 0
                     case WASM_OP_TABLE_INIT:
                     case WASM_OP_TABLE_COPY:
@@ -8488,6 +9007,15 @@ typedef struct WASMLoaderContext {
      * than the final code_compiled_size, we record the peak size to ensure
      * there will not be invalid memory access during second traverse */
     uint32 code_compiled_peak_size;
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    /* offsets of the emitted pointers, only recorded when the module is
+       loaded to be serialized, the first traverse counts the pointers */
+    bool record_ptrs;
+    uint8 *p_code_compiled_begin;
+    uint32 *ptr_offsets;
+    uint32 ptr_count;
+    uint32 ptr_peak_count;
+#endif
 #endif
 } WASMLoaderContext;
 
@@ -8723,6 +9251,10 @@ wasm_loader_ctx_destroy(WASMLoaderContext *ctx)
             wasm_runtime_free(ctx->i32_consts);
         if (ctx->v128_consts)
             wasm_runtime_free(ctx->v128_consts);
+#if WASM_ENABLE_PREPARED_MODULE != 0
+        if (ctx->ptr_offsets)
+            wasm_runtime_free(ctx->ptr_offsets);
+#endif
 #endif
         wasm_runtime_free(ctx);
     }
@@ -9479,6 +10011,14 @@ wasm_loader_ctx_reinit(WASMLoaderContext *ctx)
     ctx->p_code_compiled_end =
         ctx->p_code_compiled + ctx->code_compiled_peak_size;
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    ctx->p_code_compiled_begin = ctx->p_code_compiled;
+    if (ctx->record_ptrs && ctx->ptr_peak_count > 0
+        && !(ctx->ptr_offsets = loader_malloc(
+                 (uint64)sizeof(uint32) * ctx->ptr_peak_count, NULL, 0)))
+        return false;
+#endif
+
     /* clean up frame ref */
     memset(ctx->frame_ref_bottom, 0, ctx->frame_ref_size);
     ctx->frame_ref = ctx->frame_ref_bottom;
@@ -9602,6 +10142,13 @@ wasm_loader_emit_ptr(WASMLoaderContext *ctx, void *value)
     if (ctx->p_code_compiled) {
 #if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0
         bh_assert(((uintptr_t)ctx->p_code_compiled & 1) == 0);
+#endif
+#if WASM_ENABLE_PREPARED_MODULE != 0
+        if (ctx->record_ptrs) {
+            bh_assert(ctx->ptr_count < ctx->ptr_peak_count);
+            ctx->ptr_offsets[ctx->ptr_count++] =
+                (uint32)(ctx->p_code_compiled - ctx->p_code_compiled_begin);
+        }
 #endif
         STORE_PTR(ctx->p_code_compiled, value);
         ctx->p_code_compiled += sizeof(void *);
@@ -9611,6 +10158,10 @@ wasm_loader_emit_ptr(WASMLoaderContext *ctx, void *value)
         bh_assert((ctx->code_compiled_size & 1) == 0);
 #endif
         increase_compiled_code_space(ctx, sizeof(void *));
+#if WASM_ENABLE_PREPARED_MODULE != 0
+        /* count all of them, some may be removed later */
+        ctx->ptr_peak_count++;
+#endif
     }
 }
 
@@ -9624,6 +10175,14 @@ wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
             ctx->p_code_compiled--;
             bh_assert(((uintptr_t)ctx->p_code_compiled & 1) == 0);
         }
+#endif
+#if WASM_ENABLE_PREPARED_MODULE != 0
+        /* forget the pointers removed */
+        while (ctx->ptr_count > 0
+               && ctx->ptr_offsets[ctx->ptr_count - 1]
+                      >= (uint32)(ctx->p_code_compiled
+                                  - ctx->p_code_compiled_begin))
+            ctx->ptr_count--;
 #endif
     }
     else {
@@ -11794,6 +12353,9 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
      * drop opcodes need to know which slots are preserved, so those slots will
      * not be treated as dynamically allocated slots */
     loader_ctx->preserved_local_offset = INT16_MAX;
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    loader_ctx->record_ptrs = module->record_code_ptrs;
+#endif
 
 re_scan:
     if (loader_ctx->code_compiled_size > 0) {
@@ -11939,6 +12501,11 @@ re_scan:
 
                 PRESERVE_LOCAL_FOR_BLOCK();
 #endif
+#if WASM_ENABLE_INTERP_PROFILING != 0 && WASM_ENABLE_FAST_INTERP == 0
+                if (!record_prof_branch(func, p - 1, error_buf,
+                                        error_buf_size))
+                    goto fail;
+#endif
 #if WASM_ENABLE_GC == 0
                 POP_I32();
 #endif
@@ -12688,6 +13255,11 @@ re_scan:
 
             case WASM_OP_BR_IF:
             {
+#if WASM_ENABLE_INTERP_PROFILING != 0 && WASM_ENABLE_FAST_INTERP == 0
+                if (!record_prof_branch(func, p - 1, error_buf,
+                                        error_buf_size))
+                    goto fail;
+#endif
                 POP_I32();
 
                 if (!(frame_csp_tmp =
@@ -15844,6 +16416,25 @@ re_scan:
                         break;
                     }
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                    {
+                        pb_read_leb_uint32(p, p_end, memidx);
+                        check_memidx(module, memidx);
+                        if (module->import_memory_count == 0
+                            && module->memory_count == 0) {
+                            set_error_buf(error_buf, error_buf_size,
+                                          "unknown memory 0");
+                            goto fail;
+                        }
+                        POP_MEM_OFFSET();
+                        POP_MEM_OFFSET();
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+                        func->has_memory_operations = true;
+#endif
+                        break;
+                    }
+#endif /* WASM_ENABLE_MEMORY_DISCARD */
 #if WASM_ENABLE_REF_TYPES != 0 || WASM_ENABLE_GC != 0
                     case WASM_OP_TABLE_INIT:
                     {
@@ -17016,6 +17607,11 @@ re_scan:
 
     func->max_stack_cell_num = loader_ctx->preserved_local_offset
                                - loader_ctx->start_dynamic_offset + 1;
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    func->code_compiled_ptr_offsets = loader_ctx->ptr_offsets;
+    func->code_compiled_ptr_count = loader_ctx->ptr_count;
+    loader_ctx->ptr_offsets = NULL;
+#endif
 #else
     func->max_stack_cell_num = loader_ctx->max_stack_cell_num;
 #endif
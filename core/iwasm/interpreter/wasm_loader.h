@@ -30,6 +30,24 @@ wasm_loader_load(uint8 *buf, uint32 size,
 #endif
                  const LoadArgs *args, char *error_buf, uint32 error_buf_size);
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+/**
+ * Load a WASM binary, and generate the binary with the prepared code of the
+ * functions kept in a custom section.
+ *
+ * @param buf the byte buffer which contains the WASM binary data
+ * @param size the size of the buffer
+ * @param p_size return the size of the generated binary
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return the generated binary if succeed, NULL otherwise
+ */
+uint8 *
+wasm_loader_prepare_module(const uint8 *buf, uint32 size, uint32 *p_size,
+                           char *error_buf, uint32 error_buf_size);
+#endif
+
 /**
  * Load a WASM module from a specified WASM section list.
  *
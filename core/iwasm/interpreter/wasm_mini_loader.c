@@ -2391,6 +2391,9 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
 #if WASM_ENABLE_BULK_MEMORY_OPT != 0
     option.enable_bulk_memory_opt = true;
 #endif
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+    option.enable_memory_discard = true;
+#endif
 #if WASM_ENABLE_THREAD_MGR != 0
     option.enable_thread_mgr = true;
 #endif
@@ -2422,6 +2425,12 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
 #if WASM_ENABLE_SHARED_HEAP != 0
     option.enable_shared_heap = true;
 #endif
+#if WASM_ENABLE_INSTRUCTION_METERING != 0
+    option.enable_instruction_metering = true;
+#endif
+#if WASM_ENABLE_EPOCH_INTERRUPTION != 0
+    option.enable_epoch_interruption = true;
+#endif
 
     module->comp_ctx = aot_create_comp_context(module->comp_data, &option);
     if (!module->comp_ctx) {
@@ -4127,6 +4136,11 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                         skip_leb_memidx(p, p_end);
                         break;
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                        skip_leb_memidx(p, p_end);
+                        break;
+#endif
 #if WASM_ENABLE_REF_TYPES != 0
                     case WASM_OP_TABLE_INIT:
                     case WASM_OP_TABLE_COPY:
@@ -8327,6 +8341,21 @@ re_scan:
                         break;
                     }
 #endif /* WASM_ENABLE_BULK_MEMORY_OPT */
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+                    case WASM_OP_MEMORY_DISCARD:
+                    {
+                        CHECK_MEMORY();
+                        pb_read_leb_memidx(p, p_end, memidx);
+                        check_memidx(module, memidx);
+
+                        POP_MEM_OFFSET();
+                        POP_MEM_OFFSET();
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+                        func->has_memory_operations = true;
+#endif
+                        break;
+                    }
+#endif /* WASM_ENABLE_MEMORY_DISCARD */
 #if WASM_ENABLE_REF_TYPES != 0
                     case WASM_OP_TABLE_INIT:
                     {
@@ -405,6 +405,7 @@ typedef enum WASMMiscEXTOpcode {
     WASM_OP_TABLE_GROW = 0x0f,
     WASM_OP_TABLE_SIZE = 0x10,
     WASM_OP_TABLE_FILL = 0x11,
+    WASM_OP_MEMORY_DISCARD = 0x12,
 } WASMMiscEXTOpcode;
 
 typedef enum WASMSimdEXTOpcode {
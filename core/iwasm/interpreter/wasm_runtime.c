@@ -77,6 +77,16 @@ wasm_load_from_sections(WASMSection *section_list, char *error_buf,
                                           error_buf_size);
 }
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+uint8 *
+wasm_prepare_module(const uint8 *buf, uint32 size, uint32 *p_size,
+                    char *error_buf, uint32 error_buf_size)
+{
+    return wasm_loader_prepare_module(buf, size, p_size, error_buf,
+                                      error_buf_size);
+}
+#endif
+
 void
 wasm_unload(WASMModule *module)
 {
@@ -277,7 +287,9 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
                    WASMMemoryInstance *memory, uint32 memory_idx,
                    uint32 num_bytes_per_page, uint32 init_page_count,
                    uint32 max_page_count, uint32 heap_size, uint32 flags,
-                   char *error_buf, uint32 error_buf_size)
+                   uint8 huge_page_policy, int8 numa_node,
+                   uint8 prefault_policy, char *error_buf,
+                   uint32 error_buf_size)
 {
     WASMModule *module = module_inst->module;
     uint32 inc_page_count, global_idx, default_max_page;
@@ -433,10 +445,13 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
 
     bh_assert(memory != NULL);
 
+    /* The interpreter bound checks memory64 by software, so there is no
+       need to clamp the addresses and map the guard regions */
     if (wasm_allocate_linear_memory(&memory->memory_data, is_shared_memory,
-                                    memory->is_memory64, num_bytes_per_page,
+                                    memory->is_memory64, 0, num_bytes_per_page,
                                     init_page_count, max_page_count,
-                                    &memory_data_size)
+                                    huge_page_policy, numa_node,
+                                    prefault_policy, &memory_data_size)
         != BHT_OK) {
         set_error_buf(error_buf, error_buf_size,
                       "allocate linear memory failed");
@@ -444,6 +459,9 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
     }
 
     memory->module_type = Wasm_Module_Bytecode;
+    memory->huge_page_policy = huge_page_policy;
+    memory->numa_node = numa_node;
+    memory->prefault_policy = prefault_policy;
     memory->num_bytes_per_page = num_bytes_per_page;
     memory->cur_page_count = init_page_count;
     memory->max_page_count = max_page_count;
@@ -469,6 +487,10 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
             set_error_buf(error_buf, error_buf_size, "init app heap failed");
             goto fail2;
         }
+#if WASM_ENABLE_HEAP_TRIM != 0
+        mem_allocator_set_trim_threshold(memory->heap_handle,
+                                         HEAP_TRIM_THRESHOLD_DEFAULT);
+#endif
     }
 
     if (memory_data_size > 0) {
@@ -501,7 +523,8 @@ fail1:
 static WASMMemoryInstance **
 memories_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
                      WASMModuleInstance *parent, uint32 heap_size,
-                     uint32 max_memory_pages, char *error_buf,
+                     uint32 max_memory_pages, uint8 huge_page_policy,
+                     int8 numa_node, uint8 prefault_policy, char *error_buf,
                      uint32 error_buf_size)
 {
     WASMImport *import;
@@ -554,7 +577,8 @@ memories_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
             if (!(memories[mem_index] = memory_instantiate(
                       module_inst, parent, memory, mem_index,
                       num_bytes_per_page, init_page_count, max_page_count,
-                      actual_heap_size, flags, error_buf, error_buf_size))) {
+                      actual_heap_size, flags, huge_page_policy, numa_node,
+                      prefault_policy, error_buf, error_buf_size))) {
                 memories_deinstantiate(module_inst, memories, memory_count);
                 return NULL;
             }
@@ -571,8 +595,8 @@ memories_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
                   module_inst, parent, memory, mem_index,
                   module->memories[i].num_bytes_per_page,
                   module->memories[i].init_page_count, max_page_count,
-                  heap_size, module->memories[i].flags, error_buf,
-                  error_buf_size))) {
+                  heap_size, module->memories[i].flags, huge_page_policy,
+                  numa_node, prefault_policy, error_buf, error_buf_size))) {
             memories_deinstantiate(module_inst, memories, memory_count);
             return NULL;
         }
@@ -783,11 +807,30 @@ functions_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
         function_count = module->import_function_count + module->function_count;
     uint64 total_size = sizeof(WASMFunctionInstance) * (uint64)function_count;
     WASMFunctionInstance *functions, *function;
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    uint64 *prof_branch_counts;
+#endif
 
     if (!(functions = runtime_malloc(total_size, error_buf, error_buf_size))) {
         return NULL;
     }
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    total_size = 0;
+    for (i = 0; i < module->function_count; i++)
+        total_size += sizeof(uint64) * 2
+                      * (uint64)module->functions[i]->prof_branch_count;
+    if ((total_size > 0
+         && !(module_inst->e->prof_branch_counts =
+                  runtime_malloc(total_size, error_buf, error_buf_size)))
+        || !(module_inst->e->prof_opcode_pairs = runtime_malloc(
+                 sizeof(uint64) * 256 * 256, error_buf, error_buf_size))) {
+        wasm_runtime_free(functions);
+        return NULL;
+    }
+    prof_branch_counts = module_inst->e->prof_branch_counts;
+#endif
+
     total_size = sizeof(void *) * (uint64)module->import_function_count;
     if (total_size > 0
         && !(module_inst->import_func_ptrs =
@@ -852,6 +895,13 @@ functions_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
         function->const_cell_num = function->u.func->const_cell_num;
 #endif
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+        if (function->u.func->prof_branch_count > 0) {
+            function->prof_branch_counts = prof_branch_counts;
+            prof_branch_counts += function->u.func->prof_branch_count * 2;
+        }
+#endif
+
         function++;
     }
     bh_assert((uint32)(function - functions) == function_count);
@@ -2443,6 +2493,9 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
     uint32 stack_size = args->v1.default_stack_size;
     uint32 heap_size = args->v1.host_managed_heap_size;
     uint32 max_memory_pages = args->v1.max_memory_pages;
+    uint8 huge_page_policy = (uint8)args->huge_page_policy;
+    uint8 prefault_policy = (uint8)args->memory_prefault_policy;
+    int8 numa_node = -1;
 
     if (!module)
         return NULL;
@@ -2559,6 +2612,22 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
     }
 #endif
 
+#if WASM_ENABLE_NUMA != 0
+    /* The sub instance of a spawned thread inherits the NUMA placement of
+       its parent */
+    if (is_sub_inst) {
+        module_inst->e->common.numa_node = parent->e->common.numa_node;
+        module_inst->e->common.numa_pin_threads =
+            parent->e->common.numa_pin_threads;
+    }
+    else {
+        module_inst->e->common.numa_node =
+            args->numa_node >= 0 ? args->numa_node : -1;
+        module_inst->e->common.numa_pin_threads = args->numa_pin_threads;
+    }
+    numa_node = (int8)module_inst->e->common.numa_node;
+#endif
+
 #if WASM_ENABLE_GC != 0
     if (!is_sub_inst) {
         uint32 gc_heap_size = wasm_runtime_get_gc_heap_size_default();
@@ -2632,7 +2701,8 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
     if ((module_inst->memory_count > 0
          && !(module_inst->memories = memories_instantiate(
                   module, module_inst, parent, heap_size, max_memory_pages,
-                  error_buf, error_buf_size)))
+                  huge_page_policy, numa_node, prefault_policy, error_buf,
+                  error_buf_size)))
         || (module_inst->table_count > 0
             && !(module_inst->tables =
                      tables_instantiate(module, module_inst, first_table,
@@ -3292,6 +3362,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                 wasi_args->map_dir_count, wasi_args->env, wasi_args->env_count,
                 wasi_args->addr_pool, wasi_args->addr_count,
                 wasi_args->ns_lookup_pool, wasi_args->ns_lookup_count,
+                wasi_args->mmap_dir_list, wasi_args->mmap_dir_count,
                 wasi_args->argv, wasi_args->argc, wasi_args->stdio[0],
                 wasi_args->stdio[1], wasi_args->stdio[2], error_buf,
                 error_buf_size)) {
@@ -3449,6 +3520,12 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
 
     tables_deinstantiate(module_inst);
     functions_deinstantiate(module_inst->e->functions);
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    if (module_inst->e->prof_branch_counts)
+        wasm_runtime_free(module_inst->e->prof_branch_counts);
+    if (module_inst->e->prof_opcode_pairs)
+        wasm_runtime_free(module_inst->e->prof_opcode_pairs);
+#endif
 #if WASM_ENABLE_TAGS != 0
     tags_deinstantiate(module_inst->e->tags, module_inst->e->import_tag_ptrs);
 #endif
@@ -3701,7 +3778,8 @@ wasm_call_function(WASMExecEnv *exec_env, WASMFunctionInstance *function,
     return !wasm_copy_exception(module_inst, NULL);
 }
 
-#if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0
+#if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0 \
+    || WASM_ENABLE_SAMPLING_PROFILING != 0
 /* look for the function name */
 static char *
 get_func_name_from_index(const WASMModuleInstance *inst, uint32 func_index)
@@ -3733,7 +3811,20 @@ get_func_name_from_index(const WASMModuleInstance *inst, uint32 func_index)
 
     return func_name;
 }
-#endif /*WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0*/
+
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+const char *
+wasm_get_func_name_by_index(const WASMModuleInstance *module_inst,
+                            uint32 func_index)
+{
+    if (func_index >= module_inst->e->function_count)
+        return NULL;
+    return get_func_name_from_index(module_inst, func_index);
+}
+#endif
+#endif /* end of WASM_ENABLE_PERF_PROFILING != 0 \
+          || WASM_ENABLE_DUMP_CALL_STACK != 0 \
+          || WASM_ENABLE_SAMPLING_PROFILING != 0 */
 
 #if WASM_ENABLE_PERF_PROFILING != 0
 void
@@ -3799,6 +3890,99 @@ wasm_get_wasm_func_exec_time(const WASMModuleInstance *inst,
 }
 #endif /*WASM_ENABLE_PERF_PROFILING != 0*/
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+/* Dump the profile in text format, one record per line:
+ *   wamr-interp-profile <version>
+ *   interp <classic|fast>
+ *   func <func_idx> <exec_count>
+ *   branch <func_idx> <offset> <taken_count> <not_taken_count>
+ *   oppair <prev_opcode> <opcode> <count>
+ * the function index includes the import functions, the branch offset is
+ * relative to the function's code, and the opcodes are the interpreter's
+ * internal opcodes in hex. Only the size is calculated if buf is NULL. */
+static uint32
+dump_interp_prof_data(const WASMModuleInstance *module_inst, char *buf,
+                      uint32 len)
+{
+    WASMFunctionInstance *func_inst;
+    WASMFunction *func;
+    uint64 *counts;
+    char line[128];
+    uint32 total_len = 0, i, j;
+    int n;
+
+#define DUMP_LINE(...)                                          \
+    do {                                                        \
+        n = snprintf(line, sizeof(line), __VA_ARGS__);          \
+        if (buf) {                                              \
+            if ((uint64)total_len + (uint32)n > len)            \
+                return 0;                                       \
+            bh_memcpy_s(buf + total_len, len - total_len, line, \
+                        (uint32)n);                             \
+        }                                                       \
+        total_len += (uint32)n;                                 \
+    } while (0)
+
+    DUMP_LINE("wamr-interp-profile 1\n");
+#if WASM_ENABLE_FAST_INTERP != 0
+    DUMP_LINE("interp fast\n");
+#else
+    DUMP_LINE("interp classic\n");
+#endif
+
+    for (i = 0; i < module_inst->e->function_count; i++) {
+        func_inst = module_inst->e->functions + i;
+        if (func_inst->prof_exec_cnt > 0)
+            DUMP_LINE("func %" PRIu32 " %" PRIu64 "\n", i,
+                      func_inst->prof_exec_cnt);
+    }
+
+    for (i = 0; i < module_inst->e->function_count; i++) {
+        func_inst = module_inst->e->functions + i;
+        if (func_inst->is_import_func || !func_inst->prof_branch_counts)
+            continue;
+
+        func = func_inst->u.func;
+        counts = func_inst->prof_branch_counts;
+        for (j = 0; j < func->prof_branch_count; j++, counts += 2) {
+            if (counts[0] + counts[1] > 0)
+                DUMP_LINE("branch %" PRIu32 " %" PRIu32 " %" PRIu64
+                          " %" PRIu64 "\n",
+                          i, func->prof_branch_offsets[j], counts[0],
+                          counts[1]);
+        }
+    }
+
+    if (module_inst->e->prof_opcode_pairs) {
+        counts = module_inst->e->prof_opcode_pairs;
+        for (i = 0; i < 256 * 256; i++) {
+            if (counts[i] > 0)
+                DUMP_LINE("oppair %02" PRIx32 " %02" PRIx32 " %" PRIu64 "\n",
+                          i / 256, i % 256, counts[i]);
+        }
+    }
+
+#undef DUMP_LINE
+
+    return total_len;
+}
+
+uint32
+wasm_get_interp_prof_data_size(const WASMModuleInstance *module_inst)
+{
+    return dump_interp_prof_data(module_inst, NULL, 0);
+}
+
+uint32
+wasm_dump_interp_prof_data_to_buf(const WASMModuleInstance *module_inst,
+                                  char *buf, uint32 len)
+{
+    if (!buf)
+        return 0;
+    return dump_interp_prof_data(module_inst, buf, len);
+}
+#endif /* end of WASM_ENABLE_INTERP_PROFILING != 0 */
+
 uint64
 wasm_module_malloc_internal(WASMModuleInstance *module_inst,
                             WASMExecEnv *exec_env, uint64 size,
@@ -4726,6 +4910,30 @@ llvm_jit_data_drop(WASMModuleInstance *module_inst, uint32 seg_index)
 }
 #endif /* end of WASM_ENABLE_BULK_MEMORY != 0 */
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+bool
+llvm_jit_memory_discard(WASMModuleInstance *module_inst, uint64 addr,
+                        uint64 len)
+{
+    WASMMemoryInstance *memory_inst;
+
+    bh_assert(module_inst->module_type == Wasm_Module_Bytecode);
+
+    memory_inst = wasm_get_default_memory(module_inst);
+
+    if ((addr | len) % DEFAULT_NUM_BYTES_PER_PAGE != 0) {
+        wasm_set_exception(module_inst, "unaligned memory discard");
+        return false;
+    }
+
+    if (!memory_inst || !wasm_discard_memory(memory_inst, addr, len)) {
+        wasm_set_exception(module_inst, "out of bounds memory access");
+        return false;
+    }
+    return true;
+}
+#endif /* end of WASM_ENABLE_MEMORY_DISCARD != 0 */
+
 #if WASM_ENABLE_REF_TYPES != 0 || WASM_ENABLE_GC != 0
 void
 llvm_jit_drop_table_seg(WASMModuleInstance *module_inst, uint32 tbl_seg_idx)
@@ -83,6 +83,7 @@ typedef enum WASMExceptionID {
     EXCE_FAILED_TO_CREATE_STRINGREF,
     EXCE_FAILED_TO_CREATE_STRINGVIEW,
     EXCE_FAILED_TO_ENCODE_STRING,
+    EXCE_INSTRUCTION_LIMIT_EXCEEDED,
     EXCE_ALREADY_THROWN,
     EXCE_NUM,
 } WASMExceptionID;
@@ -124,9 +125,20 @@ struct WASMMemoryInstance {
          0: non-shared memory, > 0: shared memory */
     bh_atomic_16_t ref_count;
 
-    /* Four-byte paddings to ensure the layout of WASMMemoryInstance is the same
-     * in both 64-bit and 32-bit */
-    uint8 _paddings[4];
+    /* For memory64, log2 of the size of the address range which the
+       load/store addresses are clamped to when the memory is bound checked
+       with hardware trap, 0 if it is bound checked by software */
+    uint8 mem64_clamp_log2;
+
+    /* The huge page policy of the linear memory, see huge_page_policy_t */
+    uint8 huge_page_policy;
+
+    /* The NUMA node the linear memory is bound to, -1 if it isn't bound */
+    int8 numa_node;
+
+    /* The policy of faulting in the committed pages of the linear memory,
+       see memory_prefault_policy_t */
+    uint8 prefault_policy;
 
     /* Number bytes per page */
     uint32 num_bytes_per_page;
@@ -249,6 +261,13 @@ struct WASMFunctionInstance {
     /* children execution time */
     uint64 children_exec_time;
 #endif
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    /* execution count counted by the interpreter */
+    uint64 prof_exec_cnt;
+    /* taken and not-taken counts of each conditional branch, NULL
+       for import function */
+    uint64 *prof_branch_counts;
+#endif
 };
 
 #if WASM_ENABLE_TAGS != 0
@@ -334,6 +353,13 @@ typedef struct WASMModuleInstanceExtraCommon {
     /* The gc heap created */
     void *gc_heap_handle;
 #endif
+
+#if WASM_ENABLE_NUMA != 0
+    /* The NUMA node the instance is bound to, -1 if it isn't bound */
+    int32 numa_node;
+    /* Whether to pin the threads spawned by the instance to the node */
+    bool numa_pin_threads;
+#endif
 } WASMModuleInstanceExtraCommon;
 
 /* Extra info of WASM module instance for interpreter/jit mode */
@@ -372,6 +398,15 @@ typedef struct WASMModuleInstanceExtra {
     uint32 max_aux_stack_used;
 #endif
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    /* taken and not-taken counts of the conditional branches of all
+       functions, each function instance refers to its own part */
+    uint64 *prof_branch_counts;
+    /* execution counts of the opcode pairs, indexed by
+       previous opcode * 256 + opcode */
+    uint64 *prof_opcode_pairs;
+#endif
+
 #if WASM_ENABLE_SHARED_HEAP != 0
     /*
      * Adjusted shared heap based addr to simple the calculation
@@ -541,6 +576,12 @@ WASMModule *
 wasm_load_from_sections(WASMSection *section_list, char *error_buf,
                         uint32 error_buf_size);
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+uint8 *
+wasm_prepare_module(const uint8 *buf, uint32 size, uint32 *p_size,
+                    char *error_buf, uint32 error_buf_size);
+#endif
+
 void
 wasm_unload(WASMModule *module);
 
@@ -567,6 +608,15 @@ double
 wasm_get_wasm_func_exec_time(const WASMModuleInstance *inst,
                              const char *func_name);
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+uint32
+wasm_get_interp_prof_data_size(const WASMModuleInstance *module_inst);
+
+uint32
+wasm_dump_interp_prof_data_to_buf(const WASMModuleInstance *module_inst,
+                                  char *buf, uint32 len);
+#endif
+
 void
 wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst);
 
@@ -737,8 +787,6 @@ wasm_get_table_inst(const WASMModuleInstance *module_inst, uint32 tbl_idx)
     return tbl_inst;
 }
 
-#if WASM_ENABLE_DUMP_CALL_STACK != 0
-
 #if WASM_ENABLE_COPY_CALL_STACK != 0
 uint32
 wasm_interp_copy_callstack(WASMExecEnv *exec_env, WASMCApiFrame *buffer,
@@ -746,6 +794,15 @@ wasm_interp_copy_callstack(WASMExecEnv *exec_env, WASMCApiFrame *buffer,
                            uint32_t error_buf_size);
 #endif // WASM_ENABLE_COPY_CALL_STACK
 
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+/* Get the function name, NULL if it isn't found or the index is invalid */
+const char *
+wasm_get_func_name_by_index(const WASMModuleInstance *module_inst,
+                            uint32 func_index);
+#endif
+
+#if WASM_ENABLE_DUMP_CALL_STACK != 0
+
 bool
 wasm_interp_create_call_stack(struct WASMExecEnv *exec_env);
 
@@ -815,6 +872,12 @@ bool
 llvm_jit_data_drop(WASMModuleInstance *module_inst, uint32 seg_index);
 #endif
 
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+bool
+llvm_jit_memory_discard(WASMModuleInstance *module_inst, uint64 addr,
+                        uint64 len);
+#endif
+
 #if WASM_ENABLE_REF_TYPES != 0
 void
 llvm_jit_drop_table_seg(WASMModuleInstance *module_inst, uint32 tbl_seg_idx);
@@ -694,6 +694,10 @@ pthread_join_wrapper(wasm_exec_env_t exec_env, uint32 thread,
     if (node->status != THREAD_EXIT) {
         /* if the thread is still running, call the platforms join API */
         join_ret = wasm_cluster_join_thread(target_exec_env, (void **)&ret);
+        /* The thread may have exited and been removed from the cluster
+           after the status check, return the stored result then */
+        if (join_ret == 0 && node->status == THREAD_EXIT)
+            ret = node->u.ret;
     }
     else {
         /* if the thread has exited, return stored results */
@@ -708,9 +712,16 @@ pthread_join_wrapper(wasm_exec_env_t exec_env, uint32 thread,
            wasm_cluster_exit_thread to exit, so here its resources may
            haven't been destroyed yet, we wait enough time to ensure that
            they are actually destroyed to avoid unexpected behavior. */
+#if CLUSTER_THREAD_POOL_SIZE > 0
+        /* The native thread is parked in the thread pool instead of
+           exiting, wait for the thread routine of its worker to exit,
+           which is after the resources are destroyed */
+        wasm_cluster_join_thread(target_exec_env, NULL);
+#else
         os_mutex_lock(&exec_env->wait_lock);
         os_cond_reltimedwait(&exec_env->wait_cond, &exec_env->wait_lock, 1000);
         os_mutex_unlock(&exec_env->wait_lock);
+#endif
     }
 
     if (retval_offset != 0)
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef __wasi__
+#error This example only compiles to WASM/WASI target
+#endif
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+unsigned int threads_executed = 0;
+
+void *
+thread_func(void *arg)
+{
+    (void)(arg);
+    __atomic_fetch_add(&threads_executed, 1, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+static unsigned long long
+time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void
+test(int iter_num, int batch_size)
+{
+    pthread_t threads[batch_size];
+    unsigned long long start, spawn_ns = 0, join_ns = 0;
+    int status_code;
+
+    for (int iter = 0; iter < iter_num; ++iter) {
+        start = time_ns();
+        for (int i = 0; i < batch_size; ++i) {
+            status_code = pthread_create(&threads[i], NULL, &thread_func, NULL);
+            assert(status_code == 0 && "Thread creation should succeed");
+        }
+        spawn_ns += time_ns() - start;
+
+        start = time_ns();
+        for (int i = 0; i < batch_size; ++i) {
+            status_code = pthread_join(threads[i], NULL);
+            assert(status_code == 0 && "Thread join should succeed");
+        }
+        join_ns += time_ns() - start;
+    }
+    (void)status_code;
+
+    assert(threads_executed == (unsigned int)(iter_num * batch_size)
+           && "Every spawned thread should be executed once");
+
+    fprintf(stderr,
+            "Spawned and joined %d threads in batches of %d: "
+            "spawn %llu ns, join %llu ns per thread\n",
+            iter_num * batch_size, batch_size,
+            spawn_ns / (iter_num * batch_size),
+            join_ns / (iter_num * batch_size));
+}
+
+enum DEFAULT_PARAMETERS {
+    ITER_NUM = 2000,
+    BATCH_SIZE = 8,
+};
+
+int
+main(int argc, char **argv)
+{
+    /* The latency of spawning a thread when no other thread is running */
+    test(ITER_NUM * BATCH_SIZE, 1);
+    threads_executed = 0;
+    /* The latency of spawning threads which run concurrently */
+    test(ITER_NUM, BATCH_SIZE);
+    return 0;
+}
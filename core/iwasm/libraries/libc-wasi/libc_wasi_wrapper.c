@@ -352,60 +352,90 @@ wasi_fd_datasync(wasm_exec_env_t exec_env, wasi_fd_t fd)
     return wasmtime_ssp_fd_datasync(exec_env, curfds, fd);
 }
 
+/* Max number of the iovecs converted in a buffer on the native stack,
+   the buffer of more iovecs is allocated from the runtime heap */
+#define WASI_IOVEC_STACK_BUF_CNT 8
+
+/**
+ * Validate the iovecs of wasm app and convert them to native iovecs
+ *
+ * @param module_inst the module instance
+ * @param iovec_app the iovecs of wasm app
+ * @param iovs_len the number of iovecs
+ * @param iovec_buf the buffer of WASI_IOVEC_STACK_BUF_CNT native iovecs
+ * @param p_iovec return the native iovecs, which are iovec_buf if
+ *        iovs_len isn't larger than WASI_IOVEC_STACK_BUF_CNT, otherwise
+ *        they should be freed with wasm_runtime_free by the caller
+ *
+ * @return 0 if success, (wasi_errno_t)-1 otherwise
+ */
 static wasi_errno_t
-wasi_fd_pread(wasm_exec_env_t exec_env, wasi_fd_t fd, iovec_app_t *iovec_app,
-              uint32 iovs_len, wasi_filesize_t offset, uint32 *nread_app)
+convert_iovec_app_to_native(wasm_module_inst_t module_inst,
+                            const iovec_app_t *iovec_app, uint32 iovs_len,
+                            wasi_iovec_t *iovec_buf, wasi_iovec_t **p_iovec)
 {
-    wasm_module_inst_t module_inst = get_module_inst(exec_env);
-    wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
-    struct fd_table *curfds = wasi_ctx_get_curfds(wasi_ctx);
-    wasi_iovec_t *iovec, *iovec_begin;
+    wasi_iovec_t *iovec, *iovec_begin = iovec_buf;
     uint64 total_size;
-    size_t nread;
     uint32 i;
-    wasi_errno_t err;
-
-    if (!wasi_ctx)
-        return (wasi_errno_t)-1;
 
     total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
-    if (!validate_native_addr(nread_app, (uint64)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr(iovec_app, total_size))
+    if (total_size >= UINT32_MAX
+        || !validate_native_addr((void *)iovec_app, total_size))
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(wasi_iovec_t) * (uint64)iovs_len;
-    if (total_size == 0) {
-        total_size = 1; /* avoid user-triggered 0-sized allocation */
+    if (iovs_len > WASI_IOVEC_STACK_BUF_CNT) {
+        total_size = sizeof(wasi_iovec_t) * (uint64)iovs_len;
+        if (total_size >= UINT32_MAX
+            || !(iovec_begin = wasm_runtime_malloc((uint32)total_size)))
+            return (wasi_errno_t)-1;
     }
-    if (total_size >= UINT32_MAX
-        || !(iovec_begin = wasm_runtime_malloc((uint32)total_size)))
-        return (wasi_errno_t)-1;
 
     iovec = iovec_begin;
 
     for (i = 0; i < iovs_len; i++, iovec_app++, iovec++) {
         if (!validate_app_addr((uint64)iovec_app->buf_offset,
                                (uint64)iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
+            if (iovec_begin != iovec_buf)
+                wasm_runtime_free(iovec_begin);
+            return (wasi_errno_t)-1;
         }
         iovec->buf = (void *)addr_app_to_native((uint64)iovec_app->buf_offset);
         iovec->buf_len = iovec_app->buf_len;
     }
 
-    err = wasmtime_ssp_fd_pread(exec_env, curfds, fd, iovec_begin, iovs_len,
-                                offset, &nread);
-    if (err)
-        goto fail;
+    *p_iovec = iovec_begin;
+    return 0;
+}
 
-    *nread_app = (uint32)nread;
+static wasi_errno_t
+wasi_fd_pread(wasm_exec_env_t exec_env, wasi_fd_t fd, iovec_app_t *iovec_app,
+              uint32 iovs_len, wasi_filesize_t offset, uint32 *nread_app)
+{
+    wasm_module_inst_t module_inst = get_module_inst(exec_env);
+    wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
+    struct fd_table *curfds = wasi_ctx_get_curfds(wasi_ctx);
+    wasi_iovec_t iovec_buf[WASI_IOVEC_STACK_BUF_CNT], *iovec_begin;
+    size_t nread;
+    wasi_errno_t err;
 
-    /* success */
-    err = 0;
+    if (!wasi_ctx)
+        return (wasi_errno_t)-1;
 
-fail:
-    wasm_runtime_free(iovec_begin);
+    if (!validate_native_addr(nread_app, (uint64)sizeof(uint32)))
+        return (wasi_errno_t)-1;
+
+    err = convert_iovec_app_to_native(module_inst, iovec_app, iovs_len,
+                                      iovec_buf, &iovec_begin);
+    if (err)
+        return err;
+
+    err = wasmtime_ssp_fd_pread(exec_env, curfds, fd, iovec_begin, iovs_len,
+                                offset, &nread);
+    if (!err)
+        *nread_app = (uint32)nread;
+
+    if (iovec_begin != iovec_buf)
+        wasm_runtime_free(iovec_begin);
     return err;
 }
 
@@ -417,53 +447,29 @@ wasi_fd_pwrite(wasm_exec_env_t exec_env, wasi_fd_t fd,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(wasi_ctx);
-    wasi_ciovec_t *ciovec, *ciovec_begin;
-    uint64 total_size;
+    wasi_iovec_t iovec_buf[WASI_IOVEC_STACK_BUF_CNT], *iovec_begin;
     size_t nwritten;
-    uint32 i;
     wasi_errno_t err;
 
     if (!wasi_ctx)
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
-    if (!validate_native_addr(nwritten_app, (uint64)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr((void *)iovec_app, total_size))
+    if (!validate_native_addr(nwritten_app, (uint64)sizeof(uint32)))
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(wasi_ciovec_t) * (uint64)iovs_len;
-    if (total_size == 0) {
-        total_size = 1; /* avoid user-triggered 0-sized allocation */
-    }
-    if (total_size >= UINT32_MAX
-        || !(ciovec_begin = wasm_runtime_malloc((uint32)total_size)))
-        return (wasi_errno_t)-1;
-
-    ciovec = ciovec_begin;
-
-    for (i = 0; i < iovs_len; i++, iovec_app++, ciovec++) {
-        if (!validate_app_addr((uint64)iovec_app->buf_offset,
-                               (uint64)iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
-        }
-        ciovec->buf = (char *)addr_app_to_native((uint64)iovec_app->buf_offset);
-        ciovec->buf_len = iovec_app->buf_len;
-    }
-
-    err = wasmtime_ssp_fd_pwrite(exec_env, curfds, fd, ciovec_begin, iovs_len,
-                                 offset, &nwritten);
+    err = convert_iovec_app_to_native(module_inst, iovec_app, iovs_len,
+                                      iovec_buf, &iovec_begin);
     if (err)
-        goto fail;
-
-    *nwritten_app = (uint32)nwritten;
+        return err;
 
-    /* success */
-    err = 0;
+    err = wasmtime_ssp_fd_pwrite(exec_env, curfds, fd,
+                                 (const wasi_ciovec_t *)iovec_begin, iovs_len,
+                                 offset, &nwritten);
+    if (!err)
+        *nwritten_app = (uint32)nwritten;
 
-fail:
-    wasm_runtime_free(ciovec_begin);
+    if (iovec_begin != iovec_buf)
+        wasm_runtime_free(iovec_begin);
     return err;
 }
 
@@ -474,53 +480,28 @@ wasi_fd_read(wasm_exec_env_t exec_env, wasi_fd_t fd,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(wasi_ctx);
-    wasi_iovec_t *iovec, *iovec_begin;
-    uint64 total_size;
+    wasi_iovec_t iovec_buf[WASI_IOVEC_STACK_BUF_CNT], *iovec_begin;
     size_t nread;
-    uint32 i;
     wasi_errno_t err;
 
     if (!wasi_ctx)
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
-    if (!validate_native_addr(nread_app, (uint64)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr((void *)iovec_app, total_size))
+    if (!validate_native_addr(nread_app, (uint64)sizeof(uint32)))
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(wasi_iovec_t) * (uint64)iovs_len;
-    if (total_size == 0) {
-        total_size = 1; /* avoid user-triggered 0-sized allocation */
-    }
-    if (total_size >= UINT32_MAX
-        || !(iovec_begin = wasm_runtime_malloc((uint32)total_size)))
-        return (wasi_errno_t)-1;
-
-    iovec = iovec_begin;
-
-    for (i = 0; i < iovs_len; i++, iovec_app++, iovec++) {
-        if (!validate_app_addr((uint64)iovec_app->buf_offset,
-                               (uint64)iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
-        }
-        iovec->buf = (void *)addr_app_to_native((uint64)iovec_app->buf_offset);
-        iovec->buf_len = iovec_app->buf_len;
-    }
+    err = convert_iovec_app_to_native(module_inst, iovec_app, iovs_len,
+                                      iovec_buf, &iovec_begin);
+    if (err)
+        return err;
 
     err = wasmtime_ssp_fd_read(exec_env, curfds, fd, iovec_begin, iovs_len,
                                &nread);
-    if (err)
-        goto fail;
-
-    *nread_app = (uint32)nread;
+    if (!err)
+        *nread_app = (uint32)nread;
 
-    /* success */
-    err = 0;
-
-fail:
-    wasm_runtime_free(iovec_begin);
+    if (iovec_begin != iovec_buf)
+        wasm_runtime_free(iovec_begin);
     return err;
 }
 
@@ -647,53 +628,29 @@ wasi_fd_write(wasm_exec_env_t exec_env, wasi_fd_t fd,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(wasi_ctx);
-    wasi_ciovec_t *ciovec, *ciovec_begin;
-    uint64 total_size;
+    wasi_iovec_t iovec_buf[WASI_IOVEC_STACK_BUF_CNT], *iovec_begin;
     size_t nwritten;
-    uint32 i;
     wasi_errno_t err;
 
     if (!wasi_ctx)
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
-    if (!validate_native_addr(nwritten_app, (uint64)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr((void *)iovec_app, total_size))
+    if (!validate_native_addr(nwritten_app, (uint64)sizeof(uint32)))
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(wasi_ciovec_t) * (uint64)iovs_len;
-    if (total_size == 0) {
-        total_size = 1; /* avoid user-triggered 0-sized allocation */
-    }
-    if (total_size >= UINT32_MAX
-        || !(ciovec_begin = wasm_runtime_malloc((uint32)total_size)))
-        return (wasi_errno_t)-1;
-
-    ciovec = ciovec_begin;
-
-    for (i = 0; i < iovs_len; i++, iovec_app++, ciovec++) {
-        if (!validate_app_addr((uint64)iovec_app->buf_offset,
-                               (uint64)iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
-        }
-        ciovec->buf = (char *)addr_app_to_native((uint64)iovec_app->buf_offset);
-        ciovec->buf_len = iovec_app->buf_len;
-    }
-
-    err = wasmtime_ssp_fd_write(exec_env, curfds, fd, ciovec_begin, iovs_len,
-                                &nwritten);
+    err = convert_iovec_app_to_native(module_inst, iovec_app, iovs_len,
+                                      iovec_buf, &iovec_begin);
     if (err)
-        goto fail;
-
-    *nwritten_app = (uint32)nwritten;
+        return err;
 
-    /* success */
-    err = 0;
+    err = wasmtime_ssp_fd_write(exec_env, curfds, fd,
+                                (const wasi_ciovec_t *)iovec_begin, iovs_len,
+                                &nwritten);
+    if (!err)
+        *nwritten_app = (uint32)nwritten;
 
-fail:
-    wasm_runtime_free(ciovec_begin);
+    if (iovec_begin != iovec_buf)
+        wasm_runtime_free(iovec_begin);
     return err;
 }
 
@@ -9,6 +9,16 @@
 #include "blocking_op.h"
 #include "libc_errno.h"
 
+#if CONFIG_HAS_OPENAT2
+#include <fcntl.h>
+#include <linux/openat2.h>
+#include <sys/syscall.h>
+
+#if !defined(SYS_openat2) && defined(__NR_openat2)
+#define SYS_openat2 __NR_openat2
+#endif
+#endif
+
 __wasi_errno_t
 blocking_op_close(wasm_exec_env_t exec_env, os_file_handle handle,
                   bool is_stdio)
@@ -157,6 +167,31 @@ blocking_op_socket_addr_resolve(wasm_exec_env_t exec_env, const char *host,
     return ret;
 }
 
+#if CONFIG_HAS_OPENAT2
+__wasi_errno_t
+blocking_op_openat_beneath(wasm_exec_env_t exec_env, os_file_handle handle,
+                           const char *path, os_file_handle *out)
+{
+    struct open_how how = { 0 };
+
+    // The same flags as opening a directory with blocking_op_openat(), but
+    // the kernel fails the lookup with EXDEV if it would leave the
+    // directory, e.g. by "..", an absolute path or an absolute symlink.
+    how.flags = O_RDONLY | O_DIRECTORY;
+    how.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+
+    if (!wasm_runtime_begin_blocking_op(exec_env)) {
+        return __WASI_EINTR;
+    }
+    long fd = syscall(SYS_openat2, handle, path, &how, sizeof(how));
+    __wasi_errno_t error = fd < 0 ? convert_errno(errno) : __WASI_ESUCCESS;
+    wasm_runtime_end_blocking_op(exec_env);
+    if (error == __WASI_ESUCCESS)
+        *out = (os_file_handle)fd;
+    return error;
+}
+#endif
+
 __wasi_errno_t
 blocking_op_openat(wasm_exec_env_t exec_env, os_file_handle handle,
                    const char *path, __wasi_oflags_t oflags,
@@ -8,6 +8,7 @@
 
 #include "bh_platform.h"
 #include "wasm_export.h"
+#include "ssp_config.h"
 
 __wasi_errno_t
 blocking_op_close(wasm_exec_env_t exec_env, os_file_handle handle,
@@ -55,6 +56,14 @@ blocking_op_openat(wasm_exec_env_t exec_env, os_file_handle handle,
                    __wasi_fdflags_t fd_flags, __wasi_lookupflags_t lookup_flags,
                    wasi_libc_file_access_mode access_mode, os_file_handle *out);
 
+#if CONFIG_HAS_OPENAT2
+/* Open the directory at path with openat2(RESOLVE_BENEATH), which fails
+   if the resolution escapes the directory of handle */
+__wasi_errno_t
+blocking_op_openat_beneath(wasm_exec_env_t exec_env, os_file_handle handle,
+                           const char *path, os_file_handle *out);
+#endif
+
 #ifndef BH_PLATFORM_WINDOWS
 __wasi_errno_t
 blocking_op_poll(wasm_exec_env_t exec_env, os_poll_file_handle *pfds,
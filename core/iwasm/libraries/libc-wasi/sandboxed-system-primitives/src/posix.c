@@ -23,17 +23,9 @@
 #include "rights.h"
 #include "str.h"
 
-/* Some platforms (e.g. Windows) already define `min()` macro.
- We're undefing it here to make sure the `min` call does exactly
- what we want it to do. */
-#ifdef min
-#undef min
+#if CONFIG_HAS_MMAP_FILES
+#include <sys/mman.h>
 #endif
-static inline size_t
-min(size_t a, size_t b)
-{
-    return a > b ? b : a;
-}
 
 #if 0 /* TODO: -std=gnu99 causes compile error, comment them first */
 // struct iovec must have the same layout as __wasi_iovec_t.
@@ -327,7 +319,20 @@ struct fd_object {
             struct mutex lock;         // Lock to protect members below.
             os_dir_stream handle;      // Directory handle.
             __wasi_dircookie_t offset; // Offset of the directory.
+#if CONFIG_HAS_MMAP_FILES
+            bool mmap_files; // Whether files opened below it are mapped.
+#endif
         } directory;
+#if CONFIG_HAS_MMAP_FILES
+        // Data associated with regular files mapped into memory. The
+        // offset of fd_read() is tracked here instead of by the kernel.
+        struct {
+            struct mutex lock;        // Lock to protect the offset.
+            const uint8 *addr;        // Mapping of the file, or NULL.
+            size_t size;              // Size of the mapping.
+            __wasi_filesize_t offset; // Offset of the file.
+        } file;
+#endif
     };
 };
 
@@ -421,9 +426,84 @@ fd_object_new(__wasi_filetype_t type, bool is_stdio, struct fd_object **fo)
     (*fo)->type = type;
     (*fo)->file_handle = os_get_invalid_handle();
     (*fo)->is_stdio = is_stdio;
+#if CONFIG_HAS_MMAP_FILES
+    if (type == __WASI_FILETYPE_REGULAR_FILE)
+        (*fo)->file.addr = NULL;
+#endif
     return 0;
 }
 
+#if CONFIG_HAS_MMAP_FILES
+static bool
+fd_object_is_mapped(struct fd_object *fo)
+{
+    return fo->type == __WASI_FILETYPE_REGULAR_FILE && fo->file.addr != NULL;
+}
+
+// Maps a regular file opened read-only into memory. Failing to map it isn't
+// an error, the file is then accessed with the system calls.
+static void
+fd_object_map_file(struct fd_object *fo)
+{
+    struct __wasi_filestat_t buf;
+    void *addr;
+
+    if (os_fstat(fo->file_handle, &buf) != __WASI_ESUCCESS
+        || buf.st_size == 0 || buf.st_size > SIZE_MAX)
+        return;
+
+    if (!mutex_init(&fo->file.lock))
+        return;
+
+    addr = mmap(NULL, (size_t)buf.st_size, PROT_READ, MAP_SHARED,
+                fo->file_handle, 0);
+    if (addr == MAP_FAILED) {
+        mutex_destroy(&fo->file.lock);
+        return;
+    }
+
+    fo->file.addr = addr;
+    fo->file.size = (size_t)buf.st_size;
+    fo->file.offset = 0;
+}
+
+static void
+fd_object_unmap_file(struct fd_object *fo)
+{
+    munmap((void *)fo->file.addr, fo->file.size);
+    mutex_destroy(&fo->file.lock);
+    fo->file.addr = NULL;
+}
+
+// Copies the data at the offset of a mapped file into the iovecs. Returns
+// false if the mapping doesn't cover all of it, e.g. the read reaches the
+// end of the file or the file has grown since it was mapped, in which case
+// the caller falls back to preadv().
+static bool
+fd_object_read_mapped(struct fd_object *fo, const __wasi_iovec_t *iov,
+                      size_t iovcnt, __wasi_filesize_t offset, size_t *nread)
+{
+    size_t total = 0, i;
+
+    for (i = 0; i < iovcnt; i++) {
+        if (total + iov[i].buf_len < total)
+            return false;
+        total += iov[i].buf_len;
+    }
+
+    if (offset > fo->file.size || total > fo->file.size - offset)
+        return false;
+
+    for (i = 0; i < iovcnt; i++) {
+        bh_memcpy_s(iov[i].buf, (uint32)iov[i].buf_len,
+                    fo->file.addr + offset, (uint32)iov[i].buf_len);
+        offset += iov[i].buf_len;
+    }
+    *nread = total;
+    return true;
+}
+#endif
+
 // Attaches a file descriptor to the file descriptor table.
 static void
 fd_table_attach(struct fd_table *ft, __wasi_fd_t fd, struct fd_object *fo,
@@ -559,6 +639,10 @@ fd_object_release(wasm_exec_env_t env, struct fd_object *fo)
 
     if (refcount_release(&fo->refcount)) {
         int saved_errno = errno;
+#if CONFIG_HAS_MMAP_FILES
+        if (fd_object_is_mapped(fo))
+            fd_object_unmap_file(fo);
+#endif
         switch (fo->type) {
             case __WASI_FILETYPE_DIRECTORY:
                 // For directories we may keep track of a DIR object.
@@ -621,6 +705,9 @@ fd_table_insert_existing(struct fd_table *ft, __wasi_fd_t in,
             return false;
         }
         fo->directory.handle = os_get_invalid_dir_stream();
+#if CONFIG_HAS_MMAP_FILES
+        fo->directory.mmap_files = false;
+#endif
     }
 
     // Grow the file descriptor table if needed.
@@ -636,6 +723,45 @@ fd_table_insert_existing(struct fd_table *ft, __wasi_fd_t in,
     return true;
 }
 
+// The rights which let the guest write the files below a directory or
+// change their sizes. Reading the part of a mapping beyond the end of a
+// truncated file raises SIGBUS, which the runtime can't recover from.
+#define RIGHTS_MMAP_FILES_DENIED                                   \
+    (__WASI_RIGHT_FD_WRITE | __WASI_RIGHT_FD_FILESTAT_SET_SIZE     \
+     | __WASI_RIGHT_PATH_FILESTAT_SET_SIZE)
+
+// Enables the mmap mode of the preopened directories with the name, see
+// CONFIG_HAS_MMAP_FILES, and makes them read-only so that the guest can't
+// truncate the mapped files. It's a no-op if the platform doesn't support
+// it.
+bool
+fd_table_enable_mmap_files(struct fd_table *ft, struct fd_prestats *pt,
+                           const char *dir)
+{
+    struct fd_entry *fe;
+    bool found = false;
+
+    /* Always lock the prestats before the fd table */
+    rwlock_rdlock(&pt->lock);
+    rwlock_wrlock(&ft->lock);
+    for (size_t fd = 0; fd < pt->size; fd++) {
+        if (pt->prestats[fd].dir == NULL || strcmp(pt->prestats[fd].dir, dir)
+            || fd_table_get_entry(ft, (__wasi_fd_t)fd, 0, 0, &fe) != 0
+            || fe->object->type != __WASI_FILETYPE_DIRECTORY)
+            continue;
+#if CONFIG_HAS_MMAP_FILES
+        fe->rights_base &= ~RIGHTS_MMAP_FILES_DENIED;
+        fe->rights_inheriting &= ~RIGHTS_MMAP_FILES_DENIED;
+        fe->object->directory.mmap_files = true;
+#endif
+        found = true;
+    }
+    rwlock_unlock(&ft->lock);
+    rwlock_unlock(&pt->lock);
+
+    return found;
+}
+
 // Picks an unused slot from the file descriptor table.
 static __wasi_errno_t
 fd_table_unused(struct fd_table *ft, __wasi_fd_t *out) REQUIRES_SHARED(ft->lock)
@@ -683,13 +809,15 @@ fd_table_insert(wasm_exec_env_t exec_env, struct fd_table *ft,
     return error;
 }
 
-// Inserts a numerical file descriptor into the file descriptor table.
+// Inserts a numerical file descriptor into the file descriptor table. If
+// mmap_files is set, a regular file is mapped into memory, and the regular
+// files opened below a directory will be.
 static __wasi_errno_t
 fd_table_insert_fd(wasm_exec_env_t exec_env, struct fd_table *ft,
                    os_file_handle in, __wasi_filetype_t type,
                    __wasi_rights_t rights_base,
-                   __wasi_rights_t rights_inheriting, __wasi_fd_t *out)
-    REQUIRES_UNLOCKED(ft->lock)
+                   __wasi_rights_t rights_inheriting, bool mmap_files,
+                   __wasi_fd_t *out) REQUIRES_UNLOCKED(ft->lock)
 {
     struct fd_object *fo;
 
@@ -706,7 +834,17 @@ fd_table_insert_fd(wasm_exec_env_t exec_env, struct fd_table *ft,
             return (__wasi_errno_t)-1;
         }
         fo->directory.handle = os_get_invalid_dir_stream();
+#if CONFIG_HAS_MMAP_FILES
+        fo->directory.mmap_files = mmap_files;
+#endif
+    }
+#if CONFIG_HAS_MMAP_FILES
+    else if (type == __WASI_FILETYPE_REGULAR_FILE && mmap_files) {
+        fd_object_map_file(fo);
     }
+#else
+    (void)mmap_files;
+#endif
     return fd_table_insert(exec_env, ft, fo, rights_base, rights_inheriting,
                            out);
 }
@@ -765,14 +903,14 @@ wasmtime_ssp_fd_close(wasm_exec_env_t exec_env, struct fd_table *curfds,
 {
     // Validate the file descriptor.
     struct fd_table *ft = curfds;
-    rwlock_wrlock(&ft->lock);
     rwlock_wrlock(&prestats->lock);
+    rwlock_wrlock(&ft->lock);
 
     struct fd_entry *fe;
     __wasi_errno_t error = fd_table_get_entry(ft, fd, 0, 0, &fe);
     if (error != 0) {
-        rwlock_unlock(&prestats->lock);
         rwlock_unlock(&ft->lock);
+        rwlock_unlock(&prestats->lock);
         return error;
     }
 
@@ -783,8 +921,8 @@ wasmtime_ssp_fd_close(wasm_exec_env_t exec_env, struct fd_table *curfds,
     // Remove it from the preopened resource table if it exists
     error = fd_prestats_remove_entry(prestats, fd);
 
-    rwlock_unlock(&prestats->lock);
     rwlock_unlock(&ft->lock);
+    rwlock_unlock(&prestats->lock);
     fd_object_release(exec_env, fo);
 
     // Ignore the error if there is no preopen associated with this fd
@@ -865,6 +1003,14 @@ wasmtime_ssp_fd_pread(wasm_exec_env_t exec_env, struct fd_table *curfds,
     if (error != 0)
         return error;
 
+#if CONFIG_HAS_MMAP_FILES
+    if (fd_object_is_mapped(fo)
+        && fd_object_read_mapped(fo, iov, iovcnt, offset, nread)) {
+        fd_object_release(exec_env, fo);
+        return 0;
+    }
+#endif
+
     error = blocking_op_preadv(exec_env, fo->file_handle, iov, (int)iovcnt,
                                offset, nread);
 
@@ -905,6 +1051,20 @@ wasmtime_ssp_fd_read(wasm_exec_env_t exec_env, struct fd_table *curfds,
     if (error != 0)
         return error;
 
+#if CONFIG_HAS_MMAP_FILES
+    if (fd_object_is_mapped(fo)) {
+        mutex_lock(&fo->file.lock);
+        if (!fd_object_read_mapped(fo, iov, iovcnt, fo->file.offset, nread))
+            error = blocking_op_preadv(exec_env, fo->file_handle, iov,
+                                       (int)iovcnt, fo->file.offset, nread);
+        if (error == 0)
+            fo->file.offset += *nread;
+        mutex_unlock(&fo->file.lock);
+        fd_object_release(exec_env, fo);
+        return error;
+    }
+#endif
+
     error =
         blocking_op_readv(exec_env, fo->file_handle, iov, (int)iovcnt, nread);
 
@@ -919,21 +1079,21 @@ wasmtime_ssp_fd_renumber(wasm_exec_env_t exec_env, struct fd_table *curfds,
                          __wasi_fd_t to)
 {
     struct fd_table *ft = curfds;
-    rwlock_wrlock(&ft->lock);
     rwlock_wrlock(&prestats->lock);
+    rwlock_wrlock(&ft->lock);
 
     struct fd_entry *fe_from;
     __wasi_errno_t error = fd_table_get_entry(ft, from, 0, 0, &fe_from);
     if (error != 0) {
-        rwlock_unlock(&prestats->lock);
         rwlock_unlock(&ft->lock);
+        rwlock_unlock(&prestats->lock);
         return error;
     }
     struct fd_entry *fe_to;
     error = fd_table_get_entry(ft, to, 0, 0, &fe_to);
     if (error != 0) {
-        rwlock_unlock(&prestats->lock);
         rwlock_unlock(&ft->lock);
+        rwlock_unlock(&prestats->lock);
         return error;
     }
 
@@ -992,8 +1152,8 @@ wasmtime_ssp_fd_renumber(wasm_exec_env_t exec_env, struct fd_table *curfds,
         }
     }
 
-    rwlock_unlock(&prestats->lock);
     rwlock_unlock(&ft->lock);
+    rwlock_unlock(&prestats->lock);
 
     return error;
 }
@@ -1013,6 +1173,29 @@ wasmtime_ssp_fd_seek(wasm_exec_env_t exec_env, struct fd_table *curfds,
     if (error != 0)
         return error;
 
+#if CONFIG_HAS_MMAP_FILES
+    if (fd_object_is_mapped(fo)) {
+        mutex_lock(&fo->file.lock);
+        // The kernel's offset isn't updated by fd_read(), seek relative to
+        // the tracked offset instead.
+        if (whence == __WASI_WHENCE_CUR) {
+            __wasi_filesize_t pos =
+                fo->file.offset + (__wasi_filesize_t)offset;
+            if ((offset < 0 && pos > fo->file.offset) || pos > INT64_MAX)
+                error = __WASI_EINVAL;
+            offset = (__wasi_filedelta_t)pos;
+            whence = __WASI_WHENCE_SET;
+        }
+        if (error == 0)
+            error = os_lseek(fo->file_handle, offset, whence, newoffset);
+        if (error == 0)
+            fo->file.offset = *newoffset;
+        mutex_unlock(&fo->file.lock);
+        fd_object_release(exec_env, fo);
+        return error;
+    }
+#endif
+
     error = os_lseek(fo->file_handle, offset, whence, newoffset);
 
     fd_object_release(exec_env, fo);
@@ -1030,6 +1213,16 @@ wasmtime_ssp_fd_tell(wasm_exec_env_t exec_env, struct fd_table *curfds,
     if (error != 0)
         return error;
 
+#if CONFIG_HAS_MMAP_FILES
+    if (fd_object_is_mapped(fo)) {
+        mutex_lock(&fo->file.lock);
+        *newoffset = fo->file.offset;
+        mutex_unlock(&fo->file.lock);
+        fd_object_release(exec_env, fo);
+        return 0;
+    }
+#endif
+
     error = os_lseek(fo->file_handle, 0, __WASI_WHENCE_CUR, newoffset);
 
     fd_object_release(exec_env, fo);
@@ -1293,6 +1486,68 @@ struct path_access {
     struct fd_object *fd_object; // Internal: directory file descriptor object.
 };
 
+#if CONFIG_HAS_OPENAT2
+// Cleared if the kernel doesn't implement openat2() or a seccomp filter
+// denies it.
+static bool openat2_supported = true;
+
+// Fast path of path_get(): the kernel resolves the directory part of the
+// pathname underneath the directory with a single openat2() call, instead of
+// opening every component and expanding the symlinks in userspace. Returns
+// false if the pathname has to be resolved manually, which includes all the
+// pathnames the kernel refuses, so that the manual resolution reports the
+// error.
+static bool
+path_get_beneath(wasm_exec_env_t exec_env, struct fd_object *fo, char *path,
+                 __wasi_lookupflags_t flags, struct path_access *pa)
+{
+    os_file_handle dir = fo->file_handle;
+    char *file = strrchr(path, '/');
+    char buf[1];
+    size_t nread;
+    __wasi_errno_t error;
+
+    if (!openat2_supported || path[0] == '\0' || path[0] == '/')
+        return false;
+
+    // Trailing slashes require the expansion of a final symlink, and "."
+    // and ".." refer to the directories themselves.
+    file = file ? file + 1 : path;
+    if (file[0] == '\0' || strcmp(file, ".") == 0 || strcmp(file, "..") == 0)
+        return false;
+
+    if (file != path) {
+        file[-1] = '\0';
+        error = blocking_op_openat_beneath(exec_env, fo->file_handle, path,
+                                           &dir);
+        file[-1] = '/';
+        if (error != __WASI_ESUCCESS) {
+            if (error == __WASI_ENOSYS || error == __WASI_EPERM)
+                openat2_supported = false;
+            return false;
+        }
+    }
+
+    // The callers don't follow the final component, as a symlink may point
+    // outside of the directory. Expand it manually if it is one.
+    if ((flags & __WASI_LOOKUP_SYMLINK_FOLLOW) != 0) {
+        error = os_readlinkat(dir, file, buf, sizeof(buf), &nread);
+        if (error != __WASI_EINVAL && error != __WASI_ENOENT) {
+            if (file != path)
+                os_close(dir, false);
+            return false;
+        }
+    }
+
+    pa->fd = dir;
+    pa->path = file;
+    pa->path_start = path;
+    pa->follow = false;
+    pa->fd_object = fo;
+    return true;
+}
+#endif
+
 // Creates a lease to a file descriptor and pathname pair. If the
 // operating system does not implement Capsicum, it also normalizes the
 // pathname to ensure the target path is placed underneath the
@@ -1326,6 +1581,11 @@ path_get(wasm_exec_env_t exec_env, struct fd_table *curfds,
     pa->fd_object = fo;
     return 0;
 #else
+#if CONFIG_HAS_OPENAT2
+    if (path_get_beneath(exec_env, fo, path, flags, pa))
+        return 0;
+#endif
+
     // The implementation provides no mechanism to constrain lookups to a
     // directory automatically. Emulate this logic by resolving the
     // pathname manually.
@@ -1733,6 +1993,14 @@ wasmtime_ssp_path_open(wasm_exec_env_t exec_env, struct fd_table *curfds,
     error = blocking_op_openat(exec_env, pa.fd, pa.path, oflags, fs_flags,
                                dirflags, access_mode, &handle);
 
+    // The mapping of a file can't be written through, the files opened
+    // for writing are accessed with the system calls.
+    bool mmap_files = false;
+#if CONFIG_HAS_MMAP_FILES
+    mmap_files = pa.fd_object->type == __WASI_FILETYPE_DIRECTORY
+                 && pa.fd_object->directory.mmap_files && !write;
+#endif
+
     path_put(&pa);
 
     if (error != __WASI_ESUCCESS)
@@ -1752,7 +2020,8 @@ wasmtime_ssp_path_open(wasm_exec_env_t exec_env, struct fd_table *curfds,
 
     return fd_table_insert_fd(exec_env, curfds, handle, type,
                               rights_base & max_base,
-                              rights_inheriting & max_inheriting, fd);
+                              rights_inheriting & max_inheriting, mmap_files,
+                              fd);
 }
 
 // Copies out directory entry metadata or filename, potentially
@@ -2391,7 +2660,7 @@ wasi_ssp_sock_accept(wasm_exec_env_t exec_env, struct fd_table *curfds,
     }
 
     error = fd_table_insert_fd(exec_env, curfds, new_sock, wasi_type, max_base,
-                               max_inheriting, fd_new);
+                               max_inheriting, false, fd_new);
     if (error != __WASI_ESUCCESS) {
         /* released in fd_table_insert_fd() */
         new_sock = os_get_invalid_handle();
@@ -2747,7 +3016,7 @@ wasi_ssp_sock_open(wasm_exec_env_t exec_env, struct fd_table *curfds,
 
     // TODO: base rights and inheriting rights ?
     error = fd_table_insert_fd(exec_env, curfds, sock, wasi_type, max_base,
-                               max_inheriting, sockfd);
+                               max_inheriting, false, sockfd);
     if (error != __WASI_ESUCCESS) {
         return error;
     }
@@ -3081,6 +3350,42 @@ fd_prestats_destroy(struct fd_prestats *pt)
     rwlock_destroy(&pt->lock);
 }
 
+// A node of the binary trie of address prefixes. The children are
+// indexed by the next bit of the address in network order.
+struct addr_pool_node {
+    struct addr_pool_node *children[2];
+    // Whether the prefix ending here is in the pool, which makes the
+    // children unnecessary.
+    bool terminal;
+};
+
+static inline uint8
+address_bit(const uint8_t *addr, size_t i)
+{
+    return (addr[i / 8] >> (7 - i % 8)) & 1;
+}
+
+static void
+addr_pool_node_destroy(struct addr_pool_node *node)
+{
+    if (node) {
+        addr_pool_node_destroy(node->children[0]);
+        addr_pool_node_destroy(node->children[1]);
+        wasm_runtime_free(node);
+    }
+}
+
+static struct addr_pool_node *
+addr_pool_node_new(void)
+{
+    struct addr_pool_node *node =
+        wasm_runtime_malloc(sizeof(struct addr_pool_node));
+
+    if (node)
+        memset(node, 0, sizeof(*node));
+    return node;
+}
+
 bool
 addr_pool_init(struct addr_pool *addr_pool)
 {
@@ -3089,142 +3394,103 @@ addr_pool_init(struct addr_pool *addr_pool)
     return true;
 }
 
-bool
-addr_pool_insert(struct addr_pool *addr_pool, const char *addr, uint8 mask)
+/* addr must be in network byte order */
+static bool
+addr_pool_trie_insert(struct addr_pool_node **root, const uint8_t *addr,
+                      size_t addr_size, uint8 mask)
 {
-    struct addr_pool *cur = addr_pool;
-    struct addr_pool *next;
-    bh_ip_addr_buffer_t target;
+    struct addr_pool_node **p_node = root;
+    size_t max_addr_mask = addr_size * 8, i;
 
-    if (!addr_pool) {
-        return false;
+    /* IPv4 0.0.0.0 or IPv6 :: means any address */
+    if (addr[0] == 0 && !memcmp(addr, addr + 1, addr_size - 1)) {
+        mask = 0;
     }
-
-    if (!(next = wasm_runtime_malloc(sizeof(struct addr_pool)))) {
-        return false;
+    /* No support for invalid mask value, the entry matches nothing */
+    else if (mask > max_addr_mask) {
+        return true;
     }
 
-    next->next = NULL;
-    next->mask = mask;
-
-    if (os_socket_inet_network(true, addr, &target) != BHT_OK) {
-        // If parsing IPv4 fails, try IPv6
-        if (os_socket_inet_network(false, addr, &target) != BHT_OK) {
-            wasm_runtime_free(next);
+    for (i = 0;; i++) {
+        if (!*p_node && !(*p_node = addr_pool_node_new())) {
             return false;
         }
-        next->type = IPv6;
-        bh_memcpy_s(next->addr.ip6, sizeof(next->addr.ip6), target.ipv6,
-                    sizeof(target.ipv6));
-    }
-    else {
-        next->type = IPv4;
-        next->addr.ip4 = target.ipv4;
-    }
-
-    /* attach with */
-    while (cur->next) {
-        cur = cur->next;
-    }
-    cur->next = next;
-    return true;
-}
-
-static void
-init_address_mask(uint8_t *buf, size_t buflen, size_t mask)
-{
-    size_t element_size = sizeof(uint8_t) * 8;
-
-    for (size_t i = 0; i < buflen; i++) {
-        if (mask <= i * element_size) {
-            buf[i] = 0;
+        if ((*p_node)->terminal) {
+            /* Already covered by a shorter prefix */
+            return true;
         }
-        else {
-            size_t offset = min(mask - i * element_size, element_size);
-            buf[i] = (~0u) << (element_size - offset);
+        if (i == mask) {
+            break;
         }
+        p_node = &(*p_node)->children[address_bit(addr, i)];
     }
+
+    (*p_node)->terminal = true;
+    addr_pool_node_destroy((*p_node)->children[0]);
+    addr_pool_node_destroy((*p_node)->children[1]);
+    (*p_node)->children[0] = (*p_node)->children[1] = NULL;
+    return true;
 }
 
-/* target must be in network byte order */
-static bool
-compare_address(const struct addr_pool *addr_pool_entry,
-                bh_ip_addr_buffer_t *target)
+bool
+addr_pool_insert(struct addr_pool *addr_pool, const char *addr, uint8 mask)
 {
-    uint8_t maskbuf[16] = { 0 };
-    uint8_t basebuf[16] = { 0 };
-    size_t addr_size;
-    uint8_t max_addr_mask;
-
-    if (addr_pool_entry->type == IPv4) {
-        uint32_t addr_ip4 = htonl(addr_pool_entry->addr.ip4);
-        bh_memcpy_s(basebuf, sizeof(addr_ip4), &addr_ip4, sizeof(addr_ip4));
-        addr_size = 4;
-    }
-    else {
-        uint16_t partial_addr_ip6;
-        for (int i = 0; i < 8; i++) {
-            partial_addr_ip6 = htons(addr_pool_entry->addr.ip6[i]);
-            bh_memcpy_s(&basebuf[i * sizeof(partial_addr_ip6)],
-                        sizeof(partial_addr_ip6), &partial_addr_ip6,
-                        sizeof(partial_addr_ip6));
-        }
-        addr_size = 16;
-    }
-    max_addr_mask = (uint8)(addr_size * 8);
-
-    /* IPv4 0.0.0.0 or IPv6 :: means any address */
-    if (basebuf[0] == 0 && !memcmp(basebuf, basebuf + 1, addr_size - 1)) {
-        return true;
-    }
+    bh_ip_addr_buffer_t target;
+    size_t i;
 
-    /* No support for invalid mask value */
-    if (addr_pool_entry->mask > max_addr_mask) {
+    if (!addr_pool) {
         return false;
     }
 
-    init_address_mask(maskbuf, addr_size, addr_pool_entry->mask);
-
-    for (size_t i = 0; i < addr_size; i++) {
-        uint8_t addr_mask = target->data[i] & maskbuf[i];
-        uint8_t range_mask = basebuf[i] & maskbuf[i];
-        if (addr_mask != range_mask) {
+    if (os_socket_inet_network(true, addr, &target) != BHT_OK) {
+        // If parsing IPv4 fails, try IPv6
+        if (os_socket_inet_network(false, addr, &target) != BHT_OK) {
             return false;
         }
+        for (i = 0; i < sizeof(target.ipv6) / sizeof(target.ipv6[0]); i++) {
+            target.ipv6[i] = htons(target.ipv6[i]);
+        }
+        return addr_pool_trie_insert(&addr_pool->ip6, target.data,
+                                     sizeof(target.ipv6), mask);
     }
 
-    return true;
+    target.ipv4 = htonl(target.ipv4);
+    return addr_pool_trie_insert(&addr_pool->ip4, target.data,
+                                 sizeof(target.ipv4), mask);
 }
 
 bool
 addr_pool_search(struct addr_pool *addr_pool, const char *addr)
 {
-    struct addr_pool *cur = addr_pool->next;
+    struct addr_pool_node *node;
     bh_ip_addr_buffer_t target;
-    __wasi_addr_type_t addr_type;
+    size_t addr_size, i;
 
     if (os_socket_inet_network(true, addr, &target) != BHT_OK) {
-        size_t i;
-
         if (os_socket_inet_network(false, addr, &target) != BHT_OK) {
             return false;
         }
-        addr_type = IPv6;
         for (i = 0; i < sizeof(target.ipv6) / sizeof(target.ipv6[0]); i++) {
             target.ipv6[i] = htons(target.ipv6[i]);
         }
+        node = addr_pool->ip6;
+        addr_size = sizeof(target.ipv6);
     }
     else {
-        addr_type = IPv4;
         target.ipv4 = htonl(target.ipv4);
+        node = addr_pool->ip4;
+        addr_size = sizeof(target.ipv4);
     }
 
-    while (cur) {
-        if (cur->type == addr_type && compare_address(cur, &target)) {
+    /* Walk down the bits of the address until a prefix in the pool */
+    for (i = 0; node; i++) {
+        if (node->terminal) {
             return true;
         }
-
-        cur = cur->next;
+        if (i == addr_size * 8) {
+            break;
+        }
+        node = node->children[address_bit(target.data, i)];
     }
 
     return false;
@@ -3233,13 +3499,9 @@ addr_pool_search(struct addr_pool *addr_pool, const char *addr)
 void
 addr_pool_destroy(struct addr_pool *addr_pool)
 {
-    struct addr_pool *cur = addr_pool->next;
-
-    while (cur) {
-        struct addr_pool *next = cur->next;
-        wasm_runtime_free(cur);
-        cur = next;
-    }
+    addr_pool_node_destroy(addr_pool->ip4);
+    addr_pool_node_destroy(addr_pool->ip6);
+    addr_pool->ip4 = addr_pool->ip6 = NULL;
 }
 
 #define WASMTIME_SSP_PASSTHROUGH_FD_TABLE struct fd_table *curfds,
@@ -46,15 +46,13 @@ struct argv_environ_values {
     size_t environ_count;
 };
 
+struct addr_pool_node;
+
 struct addr_pool {
-    /* addr and mask in host order */
-    union {
-        uint32 ip4;
-        uint16 ip6[8];
-    } addr;
-    struct addr_pool *next;
-    __wasi_addr_type_t type;
-    uint8 mask;
+    /* Binary tries of the address prefixes in the pool, so that checking
+       an address takes at most one step per bit of it */
+    struct addr_pool_node *ip4;
+    struct addr_pool_node *ip6;
 };
 
 bool
@@ -63,6 +61,9 @@ bool
 fd_table_insert_existing(struct fd_table *, __wasi_fd_t, os_file_handle,
                          bool is_stdio);
 bool
+fd_table_enable_mmap_files(struct fd_table *, struct fd_prestats *,
+                           const char *);
+bool
 fd_prestats_init(struct fd_prestats *);
 bool
 fd_prestats_insert(struct fd_prestats *, const char *, __wasi_fd_t);
@@ -49,6 +49,29 @@
 #define CONFIG_HAS_CAP_ENTER 0
 #endif
 
+// openat2() with RESOLVE_BENEATH is available since Linux 5.6. The running
+// kernel may still not support it, in which case path_get() falls back to
+// resolving the pathname manually.
+#if defined(__linux__) && !defined(BH_PLATFORM_LINUX_SGX) \
+    && defined(__has_include)
+#if __has_include(<linux/openat2.h>)
+#define CONFIG_HAS_OPENAT2 1
+#endif
+#endif
+#ifndef CONFIG_HAS_OPENAT2
+#define CONFIG_HAS_OPENAT2 0
+#endif
+
+// The regular files opened read-only below a preopened directory in the
+// mmap mode are mapped into memory, so that fd_read() and fd_pread() copy
+// from the mapping instead of calling into the kernel.
+#if (defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)) \
+    && !defined(BH_PLATFORM_LINUX_SGX)
+#define CONFIG_HAS_MMAP_FILES 1
+#else
+#define CONFIG_HAS_MMAP_FILES 0
+#endif
+
 #if !defined(__APPLE__) && !defined(__FreeBSD__) && !defined(__EMSCRIPTEN__) \
     && !defined(ESP_PLATFORM) && !defined(DISABLE_CLOCK_NANOSLEEP)           \
     && !defined(BH_PLATFORM_FREERTOS) && !defined(BH_PLATFORM_ZEPHYR)
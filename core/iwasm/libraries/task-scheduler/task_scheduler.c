@@ -0,0 +1,1127 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "task_scheduler.h"
+#include "bh_atomic.h"
+
+#include <sched.h>
+#include <ucontext.h>
+
+/* Tell ThreadSanitizer about the stack switches */
+#if defined(__SANITIZE_THREAD__)
+#define TASK_TSAN_FIBER 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define TASK_TSAN_FIBER 1
+#endif
+#endif
+
+#ifdef TASK_TSAN_FIBER
+void *
+__tsan_get_current_fiber(void);
+void *
+__tsan_create_fiber(unsigned flags);
+void
+__tsan_destroy_fiber(void *fiber);
+void
+__tsan_switch_to_fiber(void *fiber, unsigned flags);
+#endif
+
+/* Default native stack size of a task */
+#define TASK_STACK_SIZE_DEFAULT (64 * 1024)
+/* Task stacks are allocated in slabs of this number of stacks to keep
+   the number of memory mappings small with many concurrent tasks */
+#define TASK_STACK_SLAB_NUM 64
+/* Max number of worker threads, including the spare ones which take
+   over the worker slots of the threads blocked in blocking operations,
+   in multiples of the worker number */
+#define TASK_WORKER_NUM_FACTOR 8
+
+typedef enum TaskState {
+    /* In a run queue or running */
+    TASK_READY,
+    TASK_WAITING,
+    TASK_FINISHED,
+} TaskState;
+
+typedef enum TaskSwitchReason {
+    /* The task is put back to a run queue */
+    TASK_SWITCH_YIELD,
+    /* The task waits until it is woken up or the timeout expires */
+    TASK_SWITCH_WAIT,
+    /* The task finishes */
+    TASK_SWITCH_EXIT,
+} TaskSwitchReason;
+
+struct WASMTask {
+    /* Next task in the run queue */
+    struct WASMTask *next;
+    WASMExecEnv *exec_env;
+    WASMFunctionInstanceCommon *function;
+    uint32 argc;
+    uint32 *argv;
+    bool result;
+    /* Protected by the scheduler lock */
+    TaskState state;
+    /* Set when the task is going to wait, until its context is saved by
+       the worker, so that the worker resuming it must wait for that */
+    bh_atomic_32_t is_switching;
+    bool is_in_timer;
+    /* Index in the timer heap */
+    uint32 timer_idx;
+    /* Boot time in us to wake up the waiting task */
+    uint64 wake_time;
+    /* The task which is joining this task */
+    struct WASMTask *joiner;
+    /* Native stack, allocated when the task runs the first time */
+    uint8 *stack;
+    uint8 *saved_stack_boundary;
+    ucontext_t context;
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    /* The exec env tls of the task, saved when it is switched out */
+    WASMExecEnv *exec_env_tls;
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    /* The sampled exec env of the task, saved when it is switched out */
+    WASMExecEnv *sampled_exec_env;
+#endif
+#ifdef TASK_TSAN_FIBER
+    void *tsan_fiber;
+#endif
+};
+
+typedef struct TaskWorker {
+    korp_tid handle;
+    ucontext_t context;
+    WASMTask *cur_task;
+    /* Whether the worker holds a worker slot to run tasks */
+    bool is_active;
+    /* Action done by the worker after the current task is switched out */
+    TaskSwitchReason switch_reason;
+    /* The local run queue, other workers steal tasks from it */
+    korp_mutex queue_lock;
+    WASMTask *queue_head;
+    WASMTask *queue_tail;
+    uint32 queue_len;
+    uint32 rand_seed;
+#ifdef TASK_TSAN_FIBER
+    void *tsan_fiber;
+#endif
+} TaskWorker;
+
+typedef struct TaskScheduler {
+    korp_mutex lock;
+    /* Idle workers wait on it for ready tasks or timers */
+    korp_cond cond;
+    /* Spare workers wait on it for a free worker slot */
+    korp_cond spare_cond;
+    /* Threads other than the workers wait on it to join tasks */
+    korp_cond join_cond;
+    uint32 join_waiter_num;
+
+    /* Number of worker slots, i.e. the max number of workers running
+       tasks at the same time */
+    uint32 worker_num;
+    uint32 active_worker_num;
+    uint32 spare_worker_num;
+    bh_atomic_32_t idle_worker_num;
+    /* Created workers, the array is only appended */
+    TaskWorker **workers;
+    uint32 max_worker_num;
+    bh_atomic_32_t created_worker_num;
+
+    /* Number of tasks in all the run queues */
+    bh_atomic_32_t ready_task_num;
+    /* The global run queue for the tasks made ready by other threads */
+    WASMTask *queue_head;
+    WASMTask *queue_tail;
+    bh_atomic_32_t queue_len;
+
+    /* Waiting tasks with timeout, in a min heap of the wake time */
+    WASMTask **timers;
+    uint32 timer_num;
+    uint32 timer_capacity;
+    bh_atomic_64_t next_wake_time;
+
+    /* Number of the unfinished tasks */
+    uint32 task_num;
+    bool is_destroying;
+
+    uint32 stack_size;
+    /* Free task stacks linked with their first word */
+    uint8 *free_stacks;
+    /* Stack slabs linked with their first word */
+    uint8 *stack_slabs;
+} TaskScheduler;
+
+static TaskScheduler *scheduler;
+
+static os_thread_local_attribute TaskWorker *worker_tls;
+
+/* A task may be resumed by another worker after it is switched out, the
+   tls must be read with a real call so that the compiler doesn't cache
+   its address in the task across the context switch */
+static __attribute__((noinline)) TaskWorker *
+get_cur_worker(void)
+{
+    return worker_tls;
+}
+
+static void *
+worker_routine(void *arg);
+
+static inline uint32
+stack_slab_size(TaskScheduler *sched)
+{
+    return os_getpagesize() + sched->stack_size * TASK_STACK_SLAB_NUM;
+}
+
+static uint8 *
+alloc_task_stack(TaskScheduler *sched)
+{
+    uint8 *stack, *slab;
+    uint32 i;
+
+    os_mutex_lock(&sched->lock);
+    if (!sched->free_stacks) {
+        /* The first page of the slab keeps the slab link */
+        if (!(slab = os_mmap(NULL, stack_slab_size(sched),
+                             MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_NONE,
+                             os_get_invalid_handle()))) {
+            os_mutex_unlock(&sched->lock);
+            return NULL;
+        }
+        *(uint8 **)slab = sched->stack_slabs;
+        sched->stack_slabs = slab;
+
+        for (i = 0; i < TASK_STACK_SLAB_NUM; i++) {
+            stack = slab + os_getpagesize() + sched->stack_size * i;
+            *(uint8 **)stack = sched->free_stacks;
+            sched->free_stacks = stack;
+        }
+    }
+    stack = sched->free_stacks;
+    sched->free_stacks = *(uint8 **)stack;
+    os_mutex_unlock(&sched->lock);
+    return stack;
+}
+
+/* Called with the scheduler lock held */
+static void
+free_task_stack(TaskScheduler *sched, uint8 *stack)
+{
+    *(uint8 **)stack = sched->free_stacks;
+    sched->free_stacks = stack;
+}
+
+static void
+notify_idle_worker(TaskScheduler *sched)
+{
+    if (BH_ATOMIC_32_LOAD(sched->idle_worker_num) > 0) {
+        os_mutex_lock(&sched->lock);
+        os_cond_signal(&sched->cond);
+        os_mutex_unlock(&sched->lock);
+    }
+}
+
+static void
+push_local_task(TaskWorker *worker, WASMTask *task)
+{
+    task->next = NULL;
+    os_mutex_lock(&worker->queue_lock);
+    if (worker->queue_tail)
+        worker->queue_tail->next = task;
+    else
+        worker->queue_head = task;
+    worker->queue_tail = task;
+    worker->queue_len++;
+    os_mutex_unlock(&worker->queue_lock);
+}
+
+/* Called with the scheduler lock held */
+static void
+push_global_task(TaskScheduler *sched, WASMTask *task)
+{
+    task->next = NULL;
+    if (sched->queue_tail)
+        sched->queue_tail->next = task;
+    else
+        sched->queue_head = task;
+    sched->queue_tail = task;
+    BH_ATOMIC_32_FETCH_ADD(sched->queue_len, 1);
+}
+
+static WASMTask *
+pop_local_task(TaskWorker *worker)
+{
+    WASMTask *task;
+
+    os_mutex_lock(&worker->queue_lock);
+    if ((task = worker->queue_head)) {
+        if (!(worker->queue_head = task->next))
+            worker->queue_tail = NULL;
+        worker->queue_len--;
+    }
+    os_mutex_unlock(&worker->queue_lock);
+    return task;
+}
+
+static WASMTask *
+pop_global_task(TaskScheduler *sched)
+{
+    WASMTask *task;
+
+    if (BH_ATOMIC_32_LOAD(sched->queue_len) == 0)
+        return NULL;
+
+    os_mutex_lock(&sched->lock);
+    if ((task = sched->queue_head)) {
+        if (!(sched->queue_head = task->next))
+            sched->queue_tail = NULL;
+        BH_ATOMIC_32_FETCH_SUB(sched->queue_len, 1);
+    }
+    os_mutex_unlock(&sched->lock);
+    return task;
+}
+
+/* Steal half of the tasks from the local run queue of another worker,
+   return the first one and push the others to the worker's own queue */
+static WASMTask *
+steal_tasks(TaskScheduler *sched, TaskWorker *worker)
+{
+    uint32 worker_num = BH_ATOMIC_32_LOAD(sched->created_worker_num);
+    uint32 start, i, j, steal_num;
+    TaskWorker *victim;
+    WASMTask *head, *tail;
+
+    /* xorshift, to start from a random victim */
+    worker->rand_seed ^= worker->rand_seed << 13;
+    worker->rand_seed ^= worker->rand_seed >> 17;
+    worker->rand_seed ^= worker->rand_seed << 5;
+    start = worker->rand_seed % worker_num;
+
+    for (i = 0; i < worker_num; i++) {
+        victim = sched->workers[(start + i) % worker_num];
+        if (victim == worker)
+            continue;
+
+        os_mutex_lock(&victim->queue_lock);
+        if (victim->queue_len == 0) {
+            os_mutex_unlock(&victim->queue_lock);
+            continue;
+        }
+        steal_num = (victim->queue_len + 1) / 2;
+        head = tail = victim->queue_head;
+        for (j = 1; j < steal_num; j++)
+            tail = tail->next;
+        if (!(victim->queue_head = tail->next))
+            victim->queue_tail = NULL;
+        victim->queue_len -= steal_num;
+        os_mutex_unlock(&victim->queue_lock);
+
+        tail->next = NULL;
+        if (head != tail) {
+            os_mutex_lock(&worker->queue_lock);
+            if (worker->queue_tail)
+                worker->queue_tail->next = head->next;
+            else
+                worker->queue_head = head->next;
+            worker->queue_tail = tail;
+            worker->queue_len += steal_num - 1;
+            os_mutex_unlock(&worker->queue_lock);
+        }
+        return head;
+    }
+    return NULL;
+}
+
+static void
+set_timer(TaskScheduler *sched, uint32 idx, WASMTask *task)
+{
+    sched->timers[idx] = task;
+    task->timer_idx = idx;
+}
+
+static void
+sift_timer_up(TaskScheduler *sched, uint32 idx, WASMTask *task)
+{
+    uint32 parent;
+
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (sched->timers[parent]->wake_time <= task->wake_time)
+            break;
+        set_timer(sched, idx, sched->timers[parent]);
+        idx = parent;
+    }
+    set_timer(sched, idx, task);
+}
+
+static void
+sift_timer_down(TaskScheduler *sched, uint32 idx, WASMTask *task)
+{
+    uint32 child;
+
+    while ((child = idx * 2 + 1) < sched->timer_num) {
+        if (child + 1 < sched->timer_num
+            && sched->timers[child + 1]->wake_time
+                   < sched->timers[child]->wake_time)
+            child++;
+        if (task->wake_time <= sched->timers[child]->wake_time)
+            break;
+        set_timer(sched, idx, sched->timers[child]);
+        idx = child;
+    }
+    set_timer(sched, idx, task);
+}
+
+static void
+update_next_wake_time(TaskScheduler *sched)
+{
+    BH_ATOMIC_64_STORE(sched->next_wake_time,
+                       sched->timer_num > 0 ? sched->timers[0]->wake_time
+                                            : UINT64_MAX);
+}
+
+/* Called with the scheduler lock held */
+static bool
+insert_timer(TaskScheduler *sched, WASMTask *task)
+{
+    WASMTask **timers;
+    uint64 capacity;
+
+    if (sched->timer_num == sched->timer_capacity) {
+        capacity = sched->timer_capacity ? (uint64)sched->timer_capacity * 2
+                                         : 64;
+        if (capacity * sizeof(WASMTask *) >= UINT32_MAX
+            || !(timers = wasm_runtime_realloc(
+                     sched->timers,
+                     (uint32)(capacity * sizeof(WASMTask *)))))
+            return false;
+        sched->timers = timers;
+        sched->timer_capacity = (uint32)capacity;
+    }
+
+    sift_timer_up(sched, sched->timer_num++, task);
+    task->is_in_timer = true;
+    update_next_wake_time(sched);
+    return true;
+}
+
+/* Called with the scheduler lock held */
+static void
+remove_timer(TaskScheduler *sched, WASMTask *task)
+{
+    uint32 idx = task->timer_idx;
+    WASMTask *last = sched->timers[--sched->timer_num];
+
+    if (last != task) {
+        if (idx > 0
+            && last->wake_time < sched->timers[(idx - 1) / 2]->wake_time)
+            sift_timer_up(sched, idx, last);
+        else
+            sift_timer_down(sched, idx, last);
+    }
+    task->is_in_timer = false;
+    update_next_wake_time(sched);
+}
+
+/* Called with the scheduler lock held, the ready task is pushed to the
+   local run queue of the current worker if it is running tasks, or to the
+   global run queue otherwise */
+static void
+wake_task_locked(TaskScheduler *sched, WASMTask *task)
+{
+    TaskWorker *worker = get_cur_worker();
+
+    if (task->state != TASK_WAITING)
+        return;
+
+    if (task->is_in_timer)
+        remove_timer(sched, task);
+
+    task->state = TASK_READY;
+    if (worker && worker->is_active)
+        push_local_task(worker, task);
+    else
+        push_global_task(sched, task);
+    BH_ATOMIC_32_FETCH_ADD(sched->ready_task_num, 1);
+
+    if (BH_ATOMIC_32_LOAD(sched->idle_worker_num) > 0)
+        os_cond_signal(&sched->cond);
+}
+
+/* Called with the scheduler lock held */
+static void
+fire_timers(TaskScheduler *sched, uint64 now)
+{
+    while (sched->timer_num > 0 && sched->timers[0]->wake_time <= now)
+        wake_task_locked(sched, sched->timers[0]);
+}
+
+static void
+check_timers(TaskScheduler *sched)
+{
+    uint64 now;
+
+    if (BH_ATOMIC_64_LOAD(sched->next_wake_time) == UINT64_MAX)
+        return;
+
+    now = os_time_get_boot_us();
+    if (BH_ATOMIC_64_LOAD(sched->next_wake_time) <= now) {
+        os_mutex_lock(&sched->lock);
+        fire_timers(sched, now);
+        os_mutex_unlock(&sched->lock);
+    }
+}
+
+/* Called with the scheduler lock held */
+static TaskWorker *
+create_worker(TaskScheduler *sched)
+{
+    uint32 worker_idx = BH_ATOMIC_32_LOAD(sched->created_worker_num);
+    TaskWorker *worker;
+
+    if (worker_idx >= sched->max_worker_num
+        || !(worker = wasm_runtime_malloc(sizeof(TaskWorker))))
+        return NULL;
+
+    memset(worker, 0, sizeof(TaskWorker));
+    worker->rand_seed = worker_idx * 2654435761u + 1;
+    if (os_mutex_init(&worker->queue_lock) != 0) {
+        wasm_runtime_free(worker);
+        return NULL;
+    }
+
+    if (os_thread_create(&worker->handle, worker_routine, worker,
+                         APP_THREAD_STACK_SIZE_DEFAULT)
+        != 0) {
+        os_mutex_destroy(&worker->queue_lock);
+        wasm_runtime_free(worker);
+        return NULL;
+    }
+
+    sched->workers[worker_idx] = worker;
+    BH_ATOMIC_32_STORE(sched->created_worker_num, worker_idx + 1);
+    return worker;
+}
+
+/* Let the worker hold a worker slot, wait as a spare worker if there is
+   no free slot. Return false if the scheduler is being destroyed. */
+static bool
+activate_worker(TaskScheduler *sched, TaskWorker *worker)
+{
+    WASMTask *task;
+
+    os_mutex_lock(&sched->lock);
+
+    /* Hand the local tasks over to the active workers */
+    while ((task = pop_local_task(worker)))
+        push_global_task(sched, task);
+
+    while (!(sched->is_destroying && sched->task_num == 0)
+           && sched->active_worker_num >= sched->worker_num) {
+        sched->spare_worker_num++;
+        os_cond_wait(&sched->spare_cond, &sched->lock);
+        sched->spare_worker_num--;
+    }
+
+    if (sched->is_destroying && sched->task_num == 0) {
+        os_mutex_unlock(&sched->lock);
+        return false;
+    }
+
+    sched->active_worker_num++;
+    worker->is_active = true;
+    os_mutex_unlock(&sched->lock);
+    return true;
+}
+
+/* Called with the scheduler lock held */
+static void
+deactivate_worker(TaskScheduler *sched, TaskWorker *worker)
+{
+    worker->is_active = false;
+    sched->active_worker_num--;
+
+    if (sched->spare_worker_num > 0)
+        os_cond_signal(&sched->spare_cond);
+    else
+        /* Failing to create a worker only lowers the parallelism */
+        create_worker(sched);
+}
+
+/* Get a ready task to run, return NULL if the scheduler is destroyed */
+static WASMTask *
+pick_next_task(TaskScheduler *sched, TaskWorker *worker)
+{
+    WASMTask *task;
+    uint64 now, timeout;
+
+    while (true) {
+        if (!worker->is_active && !activate_worker(sched, worker))
+            return NULL;
+
+        check_timers(sched);
+
+        if ((task = pop_local_task(worker)) || (task = pop_global_task(sched))
+            || (task = steal_tasks(sched, worker))) {
+            BH_ATOMIC_32_FETCH_SUB(sched->ready_task_num, 1);
+            return task;
+        }
+
+        os_mutex_lock(&sched->lock);
+        if (sched->is_destroying && sched->task_num == 0) {
+            worker->is_active = false;
+            sched->active_worker_num--;
+            os_mutex_unlock(&sched->lock);
+            return NULL;
+        }
+
+        /* The idle count must be increased before checking the ready
+           count, see notify_idle_worker */
+        BH_ATOMIC_32_FETCH_ADD(sched->idle_worker_num, 1);
+        if (BH_ATOMIC_32_LOAD(sched->ready_task_num) == 0) {
+            if (sched->timer_num > 0) {
+                now = os_time_get_boot_us();
+                if (sched->timers[0]->wake_time > now) {
+                    timeout = sched->timers[0]->wake_time - now;
+                    os_cond_reltimedwait(&sched->cond, &sched->lock, timeout);
+                }
+                fire_timers(sched, os_time_get_boot_us());
+            }
+            else {
+                os_cond_wait(&sched->cond, &sched->lock);
+            }
+        }
+        BH_ATOMIC_32_FETCH_SUB(sched->idle_worker_num, 1);
+        os_mutex_unlock(&sched->lock);
+    }
+}
+
+static void
+task_switch_out(WASMTask *task, TaskSwitchReason reason)
+{
+    TaskWorker *worker = get_cur_worker();
+
+    bh_assert(worker->cur_task == task);
+    worker->switch_reason = reason;
+#ifdef TASK_TSAN_FIBER
+    __tsan_switch_to_fiber(worker->tsan_fiber, 0);
+#endif
+    swapcontext(&task->context, &worker->context);
+    /* Resumed, maybe by another worker */
+}
+
+static void
+task_entry(void)
+{
+    WASMTask *task = get_cur_worker()->cur_task;
+
+    task->result = wasm_runtime_call_wasm(task->exec_env, task->function,
+                                          task->argc, task->argv);
+    task_switch_out(task, TASK_SWITCH_EXIT);
+    bh_assert(0);
+}
+
+static void
+finish_task(TaskScheduler *sched, WASMTask *task)
+{
+#ifdef TASK_TSAN_FIBER
+    if (task->tsan_fiber) {
+        __tsan_destroy_fiber(task->tsan_fiber);
+        task->tsan_fiber = NULL;
+    }
+#endif
+
+    os_mutex_lock(&sched->lock);
+    if (task->stack) {
+        task->exec_env->user_native_stack_boundary =
+            task->saved_stack_boundary;
+        free_task_stack(sched, task->stack);
+        task->stack = NULL;
+    }
+    task->state = TASK_FINISHED;
+    if (task->joiner)
+        /* Joined by another task */
+        wake_task_locked(sched, task->joiner);
+    if (--sched->task_num == 0 || sched->join_waiter_num > 0)
+        os_cond_broadcast(&sched->join_cond);
+    os_mutex_unlock(&sched->lock);
+}
+
+static void
+run_task(TaskScheduler *sched, TaskWorker *worker, WASMTask *task)
+{
+    WASMExecEnv *exec_env = task->exec_env;
+
+    if (!task->stack) {
+        if (!(task->stack = alloc_task_stack(sched))) {
+            wasm_runtime_set_exception(exec_env->module_inst,
+                                       "allocate task stack failed");
+            task->result = false;
+            finish_task(sched, task);
+            return;
+        }
+
+        getcontext(&task->context);
+        task->context.uc_stack.ss_sp = task->stack;
+        task->context.uc_stack.ss_size = sched->stack_size;
+        task->context.uc_link = NULL;
+        makecontext(&task->context, task_entry, 0);
+#ifdef TASK_TSAN_FIBER
+        task->tsan_fiber = __tsan_create_fiber(0);
+#endif
+
+        task->saved_stack_boundary = exec_env->user_native_stack_boundary;
+        exec_env->user_native_stack_boundary =
+            task->stack + WASM_STACK_GUARD_SIZE;
+    }
+
+    /* The task may be woken up just before it is switched out by another
+       worker, wait until its context is saved, which is quick */
+    while (BH_ATOMIC_32_LOAD(task->is_switching))
+        sched_yield();
+    worker->cur_task = task;
+
+#if WASM_ENABLE_THREAD_MGR != 0
+    os_mutex_lock(&exec_env->wait_lock);
+#endif
+    exec_env->handle = os_self_thread();
+#if WASM_ENABLE_THREAD_MGR != 0
+    os_mutex_unlock(&exec_env->wait_lock);
+#endif
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    wasm_runtime_set_exec_env_tls(task->exec_env_tls);
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    wasm_runtime_set_sampled_exec_env(task->sampled_exec_env);
+#endif
+
+#ifdef TASK_TSAN_FIBER
+    __tsan_switch_to_fiber(task->tsan_fiber, 0);
+#endif
+    swapcontext(&worker->context, &task->context);
+
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    task->exec_env_tls = wasm_runtime_get_exec_env_tls();
+    wasm_runtime_set_exec_env_tls(NULL);
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    task->sampled_exec_env = wasm_runtime_set_sampled_exec_env(NULL);
+#endif
+    worker->cur_task = NULL;
+
+    switch (worker->switch_reason) {
+        case TASK_SWITCH_YIELD:
+            /* Put the task to the tail of the global run queue rather than
+               the local one, so that a worker yielding repeatedly doesn't
+               starve the tasks in the global run queue */
+            os_mutex_lock(&sched->lock);
+            push_global_task(sched, task);
+            BH_ATOMIC_32_FETCH_ADD(sched->ready_task_num, 1);
+            if (BH_ATOMIC_32_LOAD(sched->idle_worker_num) > 0)
+                os_cond_signal(&sched->cond);
+            os_mutex_unlock(&sched->lock);
+            break;
+        case TASK_SWITCH_WAIT:
+            BH_ATOMIC_32_STORE(task->is_switching, 0);
+            break;
+        case TASK_SWITCH_EXIT:
+            finish_task(sched, task);
+            break;
+    }
+}
+
+static void *
+worker_routine(void *arg)
+{
+    TaskWorker *worker = (TaskWorker *)arg;
+    TaskScheduler *sched = scheduler;
+    WASMTask *task;
+
+    if (!wasm_runtime_init_thread_env()) {
+        LOG_ERROR("task scheduler: init thread env failed");
+        return NULL;
+    }
+
+    worker_tls = worker;
+#ifdef TASK_TSAN_FIBER
+    worker->tsan_fiber = __tsan_get_current_fiber();
+#endif
+    while ((task = pick_next_task(sched, worker)))
+        run_task(sched, worker, task);
+    worker_tls = NULL;
+
+    wasm_runtime_destroy_thread_env();
+    return NULL;
+}
+
+bool
+wasm_task_scheduler_init(uint32 worker_num, uint32 task_stack_size)
+{
+    TaskScheduler *sched;
+    uint32 page_size = os_getpagesize(), i;
+    uint64 total_size;
+
+    if (scheduler) {
+        LOG_ERROR("task scheduler was already initialized");
+        return false;
+    }
+
+    if (worker_num == 0)
+        worker_num = 1;
+    if (task_stack_size == 0)
+        task_stack_size = TASK_STACK_SIZE_DEFAULT;
+    if (task_stack_size < APP_THREAD_STACK_SIZE_MIN)
+        task_stack_size = APP_THREAD_STACK_SIZE_MIN;
+    task_stack_size = (task_stack_size + page_size - 1) & ~(page_size - 1);
+
+    total_size = sizeof(TaskScheduler)
+                 + sizeof(TaskWorker *) * (uint64)worker_num
+                       * TASK_WORKER_NUM_FACTOR;
+    if (total_size >= UINT32_MAX
+        || (uint64)task_stack_size * TASK_STACK_SLAB_NUM >= UINT32_MAX
+        || !(sched = wasm_runtime_malloc((uint32)total_size))) {
+        LOG_ERROR("task scheduler: allocate memory failed");
+        return false;
+    }
+
+    memset(sched, 0, (uint32)total_size);
+    sched->workers = (TaskWorker **)(sched + 1);
+    sched->worker_num = worker_num;
+    sched->max_worker_num = worker_num * TASK_WORKER_NUM_FACTOR;
+    sched->stack_size = task_stack_size;
+    sched->next_wake_time = UINT64_MAX;
+
+    if (os_mutex_init(&sched->lock) != 0)
+        goto fail1;
+    if (os_cond_init(&sched->cond) != 0)
+        goto fail2;
+    if (os_cond_init(&sched->spare_cond) != 0)
+        goto fail3;
+    if (os_cond_init(&sched->join_cond) != 0)
+        goto fail4;
+
+    scheduler = sched;
+
+    os_mutex_lock(&sched->lock);
+    for (i = 0; i < worker_num; i++) {
+        if (!create_worker(sched)) {
+            os_mutex_unlock(&sched->lock);
+            LOG_ERROR("task scheduler: create worker thread failed");
+            wasm_task_scheduler_destroy();
+            return false;
+        }
+    }
+    os_mutex_unlock(&sched->lock);
+
+    return true;
+
+fail4:
+    os_cond_destroy(&sched->spare_cond);
+fail3:
+    os_cond_destroy(&sched->cond);
+fail2:
+    os_mutex_destroy(&sched->lock);
+fail1:
+    wasm_runtime_free(sched);
+    return false;
+}
+
+void
+wasm_task_scheduler_destroy(void)
+{
+    TaskScheduler *sched = scheduler;
+    TaskWorker *worker;
+    uint32 worker_num, i;
+    uint8 *slab;
+
+    if (!sched)
+        return;
+
+    /* Wait until all the spawned tasks finish */
+    os_mutex_lock(&sched->lock);
+    sched->is_destroying = true;
+    while (sched->task_num > 0)
+        os_cond_wait(&sched->join_cond, &sched->lock);
+    os_cond_broadcast(&sched->cond);
+    os_cond_broadcast(&sched->spare_cond);
+    worker_num = BH_ATOMIC_32_LOAD(sched->created_worker_num);
+    os_mutex_unlock(&sched->lock);
+
+    /* Join all the workers before freeing any of them, since the exiting
+       workers may still try to steal tasks from the others */
+    for (i = 0; i < worker_num; i++)
+        os_thread_join(sched->workers[i]->handle, NULL);
+    for (i = 0; i < worker_num; i++) {
+        worker = sched->workers[i];
+        os_mutex_destroy(&worker->queue_lock);
+        wasm_runtime_free(worker);
+    }
+
+    if (sched->timers)
+        wasm_runtime_free(sched->timers);
+
+    while ((slab = sched->stack_slabs)) {
+        sched->stack_slabs = *(uint8 **)slab;
+        os_munmap(slab, stack_slab_size(sched));
+    }
+
+    os_cond_destroy(&sched->join_cond);
+    os_cond_destroy(&sched->spare_cond);
+    os_cond_destroy(&sched->cond);
+    os_mutex_destroy(&sched->lock);
+    wasm_runtime_free(sched);
+    scheduler = NULL;
+}
+
+WASMTask *
+wasm_task_spawn(WASMExecEnv *exec_env, WASMFunctionInstanceCommon *function,
+                uint32 argc, uint32 argv[])
+{
+    TaskScheduler *sched = scheduler;
+    TaskWorker *worker = get_cur_worker();
+    WASMTask *task;
+
+    if (!sched) {
+        LOG_ERROR("task scheduler isn't initialized");
+        return NULL;
+    }
+
+    if (!(task = wasm_runtime_malloc(sizeof(WASMTask)))) {
+        LOG_ERROR("task scheduler: allocate memory failed");
+        return NULL;
+    }
+
+    memset(task, 0, sizeof(WASMTask));
+    task->exec_env = exec_env;
+    task->function = function;
+    task->argc = argc;
+    task->argv = argv;
+
+    os_mutex_lock(&sched->lock);
+    if (sched->is_destroying) {
+        os_mutex_unlock(&sched->lock);
+        wasm_runtime_free(task);
+        return NULL;
+    }
+    sched->task_num++;
+    if (!(worker && worker->is_active))
+        push_global_task(sched, task);
+    os_mutex_unlock(&sched->lock);
+
+    /* Spawned by a task, run it on the same worker unless it is stolen */
+    if (worker && worker->is_active)
+        push_local_task(worker, task);
+
+    BH_ATOMIC_32_FETCH_ADD(sched->ready_task_num, 1);
+    notify_idle_worker(sched);
+    return task;
+}
+
+bool
+wasm_task_join(WASMTask *task)
+{
+    TaskScheduler *sched = scheduler;
+    WASMTask *cur_task = wasm_task_get_current();
+    bool result;
+
+    bh_assert(sched && task != cur_task);
+
+    os_mutex_lock(&sched->lock);
+    if (cur_task) {
+        /* Switch out the current task instead of blocking the worker */
+        bh_assert(!task->joiner);
+        task->joiner = cur_task;
+        while (task->state != TASK_FINISHED)
+            wasm_task_wait(cur_task, &sched->lock, BHT_WAIT_FOREVER);
+    }
+    else {
+        sched->join_waiter_num++;
+        while (task->state != TASK_FINISHED)
+            os_cond_wait(&sched->join_cond, &sched->lock);
+        sched->join_waiter_num--;
+    }
+    os_mutex_unlock(&sched->lock);
+
+    result = task->result;
+    wasm_runtime_free(task);
+    return result;
+}
+
+WASMTask *
+wasm_task_get_current(void)
+{
+    TaskWorker *worker = get_cur_worker();
+
+    return worker ? worker->cur_task : NULL;
+}
+
+void
+wasm_task_wait(WASMTask *task, korp_mutex *lock, uint64 useconds)
+{
+    TaskScheduler *sched = scheduler;
+    bool is_waiting = true;
+
+    bh_assert(task == wasm_task_get_current());
+
+    /* The task is set to waiting state before the lock is released, so
+       the waker which holds the lock either sees the waiting state, or
+       changes the condition before the task checks it */
+    if (lock != &sched->lock)
+        os_mutex_lock(&sched->lock);
+    task->state = TASK_WAITING;
+    if (useconds != BHT_WAIT_FOREVER) {
+        task->wake_time = os_time_get_boot_us() + useconds;
+        if (!insert_timer(sched, task)) {
+            /* Return at once, the caller checks its condition again */
+            task->state = TASK_READY;
+            is_waiting = false;
+        }
+    }
+    if (is_waiting)
+        BH_ATOMIC_32_STORE(task->is_switching, 1);
+    if (lock != &sched->lock)
+        os_mutex_unlock(&sched->lock);
+
+    /* Release the lock on the task itself rather than on the worker after
+       the switch, so that the lock is always released by its owner */
+    os_mutex_unlock(lock);
+    if (is_waiting)
+        task_switch_out(task, TASK_SWITCH_WAIT);
+    os_mutex_lock(lock);
+}
+
+void
+wasm_task_wake(WASMTask *task)
+{
+    TaskScheduler *sched = scheduler;
+
+    os_mutex_lock(&sched->lock);
+    wake_task_locked(sched, task);
+    os_mutex_unlock(&sched->lock);
+}
+
+void
+wasm_task_yield(WASMTask *task)
+{
+    TaskScheduler *sched = scheduler;
+
+    bh_assert(task == wasm_task_get_current());
+
+    if (BH_ATOMIC_32_LOAD(sched->ready_task_num) > 0)
+        task_switch_out(task, TASK_SWITCH_YIELD);
+}
+
+void
+wasm_task_begin_blocking(WASMTask *task)
+{
+    TaskScheduler *sched = scheduler;
+    TaskWorker *worker = get_cur_worker();
+
+    bh_assert(worker->cur_task == task);
+    (void)task;
+
+    /* Hand the worker slot over to a spare worker, so that the other
+       tasks keep running while this thread is blocked */
+    os_mutex_lock(&sched->lock);
+    deactivate_worker(sched, worker);
+    os_mutex_unlock(&sched->lock);
+}
+
+void
+wasm_task_end_blocking(WASMTask *task)
+{
+    TaskScheduler *sched = scheduler;
+    TaskWorker *worker = get_cur_worker();
+
+    bh_assert(worker->cur_task == task && !worker->is_active);
+
+    os_mutex_lock(&sched->lock);
+    if (sched->active_worker_num < sched->worker_num) {
+        /* Take a free slot back and go on running */
+        sched->active_worker_num++;
+        worker->is_active = true;
+        os_mutex_unlock(&sched->lock);
+        return;
+    }
+    os_mutex_unlock(&sched->lock);
+
+    /* All the slots are taken, put the task to the global run queue and
+       let the worker become a spare one */
+    task_switch_out(task, TASK_SWITCH_YIELD);
+}
+
+struct WASMAsyncOp {
+    korp_mutex lock;
+    /* Signaled when the op is awaited by a thread not running a task */
+    korp_cond cond;
+    /* The task awaiting the op */
+    WASMTask *task;
+    bool is_completed;
+    uint64 result;
+};
+
+WASMAsyncOp *
+wasm_task_create_async_op(void)
+{
+    WASMAsyncOp *op;
+
+    if (!(op = wasm_runtime_malloc(sizeof(WASMAsyncOp)))) {
+        LOG_ERROR("task scheduler: allocate memory failed");
+        return NULL;
+    }
+
+    memset(op, 0, sizeof(WASMAsyncOp));
+    if (os_mutex_init(&op->lock) != 0)
+        goto fail1;
+    if (os_cond_init(&op->cond) != 0)
+        goto fail2;
+    return op;
+
+fail2:
+    os_mutex_destroy(&op->lock);
+fail1:
+    wasm_runtime_free(op);
+    return NULL;
+}
+
+uint64
+wasm_task_await_async_op(WASMAsyncOp *op)
+{
+    WASMTask *task = wasm_task_get_current();
+    uint64 result;
+
+    os_mutex_lock(&op->lock);
+    op->task = task;
+    while (!op->is_completed) {
+        if (task)
+            wasm_task_wait(task, &op->lock, BHT_WAIT_FOREVER);
+        else
+            os_cond_wait(&op->cond, &op->lock);
+    }
+    result = op->result;
+    os_mutex_unlock(&op->lock);
+
+    os_cond_destroy(&op->cond);
+    os_mutex_destroy(&op->lock);
+    wasm_runtime_free(op);
+    return result;
+}
+
+void
+wasm_task_complete_async_op(WASMAsyncOp *op, uint64 result)
+{
+    os_mutex_lock(&op->lock);
+    bh_assert(!op->is_completed);
+    op->is_completed = true;
+    op->result = result;
+    if (op->task)
+        wasm_task_wake(op->task);
+    else
+        os_cond_signal(&op->cond);
+    os_mutex_unlock(&op->lock);
+}
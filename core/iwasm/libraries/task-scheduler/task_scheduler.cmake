@@ -0,0 +1,12 @@
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+set (TASK_SCHEDULER_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+add_definitions (-DWASM_ENABLE_TASK_SCHEDULER=1)
+
+include_directories(${TASK_SCHEDULER_DIR})
+
+file (GLOB source_all ${TASK_SCHEDULER_DIR}/*.c)
+
+set (TASK_SCHEDULER_SOURCE ${source_all})
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _TASK_SCHEDULER_H
+#define _TASK_SCHEDULER_H
+
+#include "bh_common.h"
+#include "bh_log.h"
+#include "wasm_export.h"
+#include "../common/wasm_runtime_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The task scheduler multiplexes many wasm calls (tasks) onto a fixed
+ * number of worker threads. Each task runs on its own native stack, and
+ * is switched out when it waits in memory.atomic.wait, so that the worker
+ * thread can run other tasks. When a task enters a blocking operation
+ * (wasm_runtime_begin_blocking_op), the worker thread hands its slot over
+ * to a spare worker thread until the operation finishes.
+ */
+
+typedef struct WASMTask WASMTask;
+
+bool
+wasm_task_scheduler_init(uint32 worker_num, uint32 task_stack_size);
+
+void
+wasm_task_scheduler_destroy(void);
+
+WASMTask *
+wasm_task_spawn(WASMExecEnv *exec_env, WASMFunctionInstanceCommon *function,
+                uint32 argc, uint32 argv[]);
+
+bool
+wasm_task_join(WASMTask *task);
+
+/* Get the task running on current thread, NULL if it isn't in a task */
+WASMTask *
+wasm_task_get_current(void);
+
+/**
+ * Switch out the current task until it is woken up by wasm_task_wake or
+ * the timeout expires, like os_cond_reltimedwait: the lock must be held
+ * by the caller, it is released after the task is switched out and is
+ * acquired again before returning. Spurious wakeups are possible, the
+ * caller should check its condition again.
+ */
+void
+wasm_task_wait(WASMTask *task, korp_mutex *lock, uint64 useconds);
+
+/* Wake up a task waiting in wasm_task_wait, the lock passed to
+   wasm_task_wait must be held by the caller */
+void
+wasm_task_wake(WASMTask *task);
+
+/* Put the task back to the run queue if there are other ready tasks */
+void
+wasm_task_yield(WASMTask *task);
+
+void
+wasm_task_begin_blocking(WASMTask *task);
+
+void
+wasm_task_end_blocking(WASMTask *task);
+
+typedef struct WASMAsyncOp WASMAsyncOp;
+
+WASMAsyncOp *
+wasm_task_create_async_op(void);
+
+/* Wait until the op is completed and destroy it, the current task is
+   switched out if it is called by a task */
+uint64
+wasm_task_await_async_op(WASMAsyncOp *op);
+
+void
+wasm_task_complete_async_op(WASMAsyncOp *op, uint64 result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _TASK_SCHEDULER_H */
@@ -22,6 +22,34 @@ typedef struct {
     void (*destroy_cb)(WASMCluster *);
 } DestroyCallBackNode;
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+/* A native thread of the cluster's thread pool, which runs the thread
+   routines of the spawned threads one by one and is parked in between */
+typedef struct WASMClusterWorker {
+    /* Next worker in the worker list of the cluster */
+    struct WASMClusterWorker *next;
+    /* Next worker in the idle worker list of the cluster */
+    struct WASMClusterWorker *next_idle;
+    korp_tid handle;
+    korp_mutex lock;
+    korp_cond cond;
+    /* The thread to run, NULL if the worker is parked */
+    WASMExecEnv *exec_env;
+    /* The return value of the last thread routine */
+    void *ret_value;
+    /* The count of threads which are joining the current thread */
+    uint32 join_count;
+    /* Whether the current thread routine has exited */
+    bool is_routine_exited;
+    /* Set by the cluster to make a parked worker exit */
+    bool is_terminating;
+    /* Set when the worker exits as the thread pool is full or its thread
+       routine exits the native thread, the native thread is to be joined
+       by the cluster */
+    bool is_exited;
+} WASMClusterWorker;
+#endif
+
 static bh_list destroy_callback_list_head;
 static bh_list *const destroy_callback_list = &destroy_callback_list_head;
 
@@ -242,6 +270,14 @@ wasm_cluster_create(WASMExecEnv *exec_env)
         LOG_ERROR("thread manager error: failed to init mutex");
         return NULL;
     }
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    if (os_mutex_init(&cluster->pool_lock) != 0) {
+        os_mutex_destroy(&cluster->lock);
+        wasm_runtime_free(cluster);
+        LOG_ERROR("thread manager error: failed to init mutex");
+        return NULL;
+    }
+#endif
 
     /* Prepare the aux stack top and size for every thread */
     if (!wasm_exec_env_get_aux_stack(exec_env, &aux_stack_start,
@@ -332,12 +368,54 @@ destroy_cluster_visitor(void *node, void *user_data)
     destroy_node->destroy_cb(cluster);
 }
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+static void
+destroy_thread_pool(WASMCluster *cluster)
+{
+    WASMClusterWorker *worker, *next;
+
+    os_mutex_lock(&cluster->pool_lock);
+    cluster->pool_is_destroying = true;
+    /* Wake up the parked workers to exit */
+    worker = cluster->idle_workers;
+    while (worker) {
+        os_mutex_lock(&worker->lock);
+        worker->is_terminating = true;
+        os_cond_broadcast(&worker->cond);
+        os_mutex_unlock(&worker->lock);
+        worker = worker->next_idle;
+    }
+    cluster->idle_workers = NULL;
+    cluster->idle_worker_num = 0;
+    os_mutex_unlock(&cluster->pool_lock);
+
+    /* The worker list isn't changed after pool_is_destroying is set, and
+       the busy workers exit once their current thread routines exit */
+    worker = cluster->workers;
+    while (worker) {
+        next = worker->next;
+        os_thread_join(worker->handle, NULL);
+        os_cond_destroy(&worker->cond);
+        os_mutex_destroy(&worker->lock);
+        wasm_runtime_free(worker);
+        worker = next;
+    }
+    cluster->workers = NULL;
+
+    os_mutex_destroy(&cluster->pool_lock);
+}
+#endif
+
 void
 wasm_cluster_destroy(WASMCluster *cluster)
 {
     traverse_list(destroy_callback_list, destroy_cluster_visitor,
                   (void *)cluster);
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    destroy_thread_pool(cluster);
+#endif
+
     /* Remove the cluster from the cluster list */
     os_mutex_lock(&cluster_list_lock);
     bh_list_remove(cluster_list, cluster);
@@ -626,6 +704,23 @@ wasm_cluster_destroy_spawned_exec_env(WASMExecEnv *exec_env)
     os_mutex_unlock(&cluster->lock);
 }
 
+#if WASM_ENABLE_NUMA != 0
+/* Pin the calling thread to the NUMA node of the instance if it is
+   required */
+static void
+bind_thread_numa_node(WASMModuleInstanceCommon *module_inst)
+{
+    int32 numa_node = wasm_runtime_get_numa_node(module_inst);
+
+    if (numa_node >= 0 && wasm_runtime_is_numa_pin_threads_enabled(module_inst)
+        && os_thread_bind_numa_node((int)numa_node) != 0) {
+        LOG_WARNING("thread manager error: failed to pin thread to NUMA "
+                    "node %" PRId32,
+                    numa_node);
+    }
+}
+#endif
+
 /* start routine of thread manager */
 static void *
 thread_manager_start_routine(void *arg)
@@ -645,6 +740,10 @@ thread_manager_start_routine(void *arg)
     os_cond_signal(&exec_env->wait_cond);
     os_mutex_unlock(&exec_env->wait_lock);
 
+#if WASM_ENABLE_NUMA != 0
+    bind_thread_numa_node(module_inst);
+#endif
+
     ret = exec_env->thread_start_routine(exec_env);
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
@@ -701,6 +800,247 @@ thread_manager_start_routine(void *arg)
     return ret;
 }
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+/* Park the worker in the thread pool until a new thread is assigned to it,
+   return NULL if the worker should exit */
+static WASMExecEnv *
+park_cluster_worker(WASMCluster *cluster, WASMClusterWorker *worker)
+{
+    WASMExecEnv *exec_env;
+
+    os_mutex_lock(&cluster->pool_lock);
+    if (cluster->pool_is_destroying) {
+        /* Exit and let the cluster join the native thread */
+        os_mutex_unlock(&cluster->pool_lock);
+        return NULL;
+    }
+
+    if (cluster->idle_worker_num >= CLUSTER_THREAD_POOL_SIZE) {
+        /* The pool is full, exit and let the cluster join the native
+           thread when creating a new worker or being destroyed */
+        worker->is_exited = true;
+        os_mutex_unlock(&cluster->pool_lock);
+        return NULL;
+    }
+
+    worker->next_idle = cluster->idle_workers;
+    cluster->idle_workers = worker;
+    cluster->idle_worker_num++;
+    os_mutex_unlock(&cluster->pool_lock);
+
+    os_mutex_lock(&worker->lock);
+    while (!worker->exec_env && !worker->is_terminating) {
+        os_cond_wait(&worker->cond, &worker->lock);
+    }
+    exec_env = worker->exec_env;
+    os_mutex_unlock(&worker->lock);
+
+    return exec_env;
+}
+
+/* start routine of the native threads of the thread pool */
+static void *
+cluster_worker_routine(void *arg)
+{
+    WASMClusterWorker *worker = (WASMClusterWorker *)arg;
+    WASMExecEnv *exec_env = worker->exec_env;
+    WASMCluster *cluster = wasm_exec_env_get_cluster(exec_env);
+    WASMModuleInstanceCommon *module_inst;
+    void *ret;
+
+    bh_assert(cluster != NULL);
+
+    os_mutex_lock(&exec_env->wait_lock);
+    worker->handle = exec_env->handle = os_self_thread();
+    /* Notify the parent thread to continue running */
+    os_cond_signal(&exec_env->wait_cond);
+    os_mutex_unlock(&exec_env->wait_lock);
+
+#if WASM_ENABLE_NUMA != 0
+    /* The threads run by the worker are all spawned in the cluster and
+       share the NUMA placement */
+    bind_thread_numa_node(wasm_exec_env_get_module_inst(exec_env));
+#endif
+
+    while (exec_env) {
+        module_inst = wasm_exec_env_get_module_inst(exec_env);
+        bh_assert(module_inst != NULL);
+
+        ret = exec_env->thread_start_routine(exec_env);
+
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+        os_mutex_lock(&exec_env->wait_lock);
+        if (WASM_SUSPEND_FLAGS_GET(exec_env->suspend_flags)
+            & WASM_SUSPEND_FLAG_EXIT)
+            ret = exec_env->thread_ret_value;
+        os_mutex_unlock(&exec_env->wait_lock);
+#endif
+
+        /* Routine exit */
+
+#if WASM_ENABLE_DEBUG_INTERP != 0
+        wasm_cluster_thread_exited(exec_env);
+#endif
+
+        /* Free aux stack space */
+        if (exec_env->is_aux_stack_allocated)
+            wasm_cluster_free_aux_stack(exec_env,
+                                        (uint64)exec_env->aux_stack_bottom);
+
+        os_mutex_lock(&cluster_list_lock);
+
+        os_mutex_lock(&cluster->lock);
+
+#if WASM_ENABLE_PERF_PROFILING != 0
+        os_printf("============= Spawned thread ===========\n");
+        wasm_runtime_dump_perf_profiling(module_inst);
+        os_printf("========================================\n");
+#endif
+
+        /* Remove exec_env, no thread can start joining it after then */
+        wasm_cluster_del_exec_env_internal(cluster, exec_env, false);
+        /* Destroy exec_env */
+        wasm_exec_env_destroy_internal(exec_env);
+        /* Routine exit, destroy instance */
+        wasm_runtime_deinstantiate_internal(module_inst, true);
+
+        /* Hand the return value to the joining threads */
+        os_mutex_lock(&worker->lock);
+        worker->exec_env = NULL;
+        worker->ret_value = ret;
+        worker->is_routine_exited = true;
+        os_cond_broadcast(&worker->cond);
+        os_mutex_unlock(&worker->lock);
+
+        os_mutex_unlock(&cluster->lock);
+
+        os_mutex_unlock(&cluster_list_lock);
+
+        /* Wait until all the joining threads get the return value */
+        os_mutex_lock(&worker->lock);
+        while (worker->join_count > 0) {
+            os_cond_wait(&worker->cond, &worker->lock);
+        }
+        worker->is_routine_exited = false;
+        os_mutex_unlock(&worker->lock);
+
+        exec_env = park_cluster_worker(cluster, worker);
+    }
+
+    return NULL;
+}
+
+/* Run the thread routine of exec_env with a parked worker of the thread
+   pool, or with a new worker if no worker is parked.
+   The caller must lock cluster->lock */
+static bool
+run_with_cluster_worker(WASMCluster *cluster, WASMExecEnv *exec_env)
+{
+    WASMClusterWorker *worker, *exited_worker, **p_worker;
+    korp_tid tid;
+
+    os_mutex_lock(&cluster->pool_lock);
+    if ((worker = cluster->idle_workers)) {
+        cluster->idle_workers = worker->next_idle;
+        cluster->idle_worker_num--;
+    }
+    os_mutex_unlock(&cluster->pool_lock);
+
+    if (worker) {
+        exec_env->handle = worker->handle;
+        exec_env->worker = worker;
+
+        os_mutex_lock(&worker->lock);
+        worker->exec_env = exec_env;
+        os_cond_broadcast(&worker->cond);
+        os_mutex_unlock(&worker->lock);
+        return true;
+    }
+
+    if (!(worker = wasm_runtime_malloc(sizeof(WASMClusterWorker)))) {
+        LOG_ERROR("thread manager error: failed to allocate memory");
+        return false;
+    }
+    memset(worker, 0, sizeof(WASMClusterWorker));
+
+    if (os_mutex_init(&worker->lock) != 0) {
+        wasm_runtime_free(worker);
+        return false;
+    }
+    if (os_cond_init(&worker->cond) != 0) {
+        os_mutex_destroy(&worker->lock);
+        wasm_runtime_free(worker);
+        return false;
+    }
+    worker->exec_env = exec_env;
+    exec_env->worker = worker;
+
+    os_mutex_lock(&cluster->pool_lock);
+    /* Join the workers exited as the pool was full */
+    p_worker = &cluster->workers;
+    while (*p_worker) {
+        if ((*p_worker)->is_exited) {
+            exited_worker = *p_worker;
+            *p_worker = exited_worker->next;
+            os_thread_join(exited_worker->handle, NULL);
+            os_cond_destroy(&exited_worker->cond);
+            os_mutex_destroy(&exited_worker->lock);
+            wasm_runtime_free(exited_worker);
+        }
+        else {
+            p_worker = &(*p_worker)->next;
+        }
+    }
+    worker->next = cluster->workers;
+    cluster->workers = worker;
+    os_mutex_unlock(&cluster->pool_lock);
+
+    os_mutex_lock(&exec_env->wait_lock);
+
+    if (0
+        != os_thread_create(&tid, cluster_worker_routine, (void *)worker,
+                            APP_THREAD_STACK_SIZE_DEFAULT)) {
+        os_mutex_unlock(&exec_env->wait_lock);
+
+        os_mutex_lock(&cluster->pool_lock);
+        cluster->workers = worker->next;
+        os_mutex_unlock(&cluster->pool_lock);
+
+        exec_env->worker = NULL;
+        os_cond_destroy(&worker->cond);
+        os_mutex_destroy(&worker->lock);
+        wasm_runtime_free(worker);
+        return false;
+    }
+
+    /* Wait until the exec_env->handle is set to avoid it is
+       illegally accessed after unlocking cluster->lock */
+    os_cond_wait(&exec_env->wait_cond, &exec_env->wait_lock);
+    os_mutex_unlock(&exec_env->wait_lock);
+
+    return true;
+}
+
+/* Wait for the thread routine run by the worker to exit */
+static int32
+join_cluster_worker(WASMClusterWorker *worker, void **ret_val)
+{
+    os_mutex_lock(&worker->lock);
+    while (!worker->is_routine_exited) {
+        os_cond_wait(&worker->cond, &worker->lock);
+    }
+    if (ret_val)
+        *ret_val = worker->ret_value;
+    if (--worker->join_count == 0) {
+        /* Let the worker continue to run other threads */
+        os_cond_broadcast(&worker->cond);
+    }
+    os_mutex_unlock(&worker->lock);
+
+    return 0;
+}
+#endif /* end of CLUSTER_THREAD_POOL_SIZE > 0 */
+
 int32
 wasm_cluster_create_thread(WASMExecEnv *exec_env,
                            wasm_module_inst_t module_inst,
@@ -751,6 +1091,11 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
     new_exec_env->thread_start_routine = thread_routine;
     new_exec_env->thread_arg = arg;
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    if (!run_with_cluster_worker(cluster, new_exec_env)) {
+        goto fail3;
+    }
+#else
     os_mutex_lock(&new_exec_env->wait_lock);
 
     if (0
@@ -765,6 +1110,7 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
        illegally accessed after unlocking cluster->lock */
     os_cond_wait(&new_exec_env->wait_cond, &new_exec_env->wait_lock);
     os_mutex_unlock(&new_exec_env->wait_lock);
+#endif
 
     os_mutex_unlock(&cluster->lock);
 
@@ -980,6 +1326,18 @@ clusters_have_exec_env(WASMExecEnv *exec_env)
     return false;
 }
 
+bool
+wasm_cluster_is_thread_alive(WASMExecEnv *exec_env)
+{
+    bool ret;
+
+    os_mutex_lock(&cluster_list_lock);
+    ret = clusters_have_exec_env(exec_env);
+    os_mutex_unlock(&cluster_list_lock);
+
+    return ret;
+}
+
 int32
 wasm_cluster_join_thread(WASMExecEnv *exec_env, void **ret_val)
 {
@@ -995,6 +1353,22 @@ wasm_cluster_join_thread(WASMExecEnv *exec_env, void **ret_val)
         return 0;
     }
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    if (exec_env->worker) {
+        WASMClusterWorker *worker = exec_env->worker;
+
+        /* The native thread is reused after the thread routine exits,
+           wait for the routine instead of the native thread */
+        os_mutex_lock(&worker->lock);
+        worker->join_count++;
+        os_mutex_unlock(&worker->lock);
+
+        os_mutex_unlock(&cluster_list_lock);
+
+        return join_cluster_worker(worker, ret_val);
+    }
+#endif
+
     os_mutex_lock(&exec_env->wait_lock);
     exec_env->wait_count++;
     handle = exec_env->handle;
@@ -1016,6 +1390,14 @@ wasm_cluster_detach_thread(WASMExecEnv *exec_env)
         os_mutex_unlock(&cluster_list_lock);
         return 0;
     }
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    if (exec_env->worker) {
+        /* The native thread is owned by the thread pool */
+        exec_env->thread_is_detached = true;
+        os_mutex_unlock(&cluster_list_lock);
+        return 0;
+    }
+#endif
     if (exec_env->wait_count == 0 && !exec_env->thread_is_detached) {
         /* Only detach current thread when there is no other thread
            joining it, otherwise let the system resources for the
@@ -1032,6 +1414,9 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
 {
     WASMCluster *cluster;
     WASMModuleInstanceCommon *module_inst;
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    WASMClusterWorker *worker;
+#endif
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     if (exec_env->jmpbuf_stack_top) {
@@ -1070,8 +1455,17 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
 
     os_mutex_lock(&cluster->lock);
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    /* The native thread of a worker is joined by the cluster */
+    worker = exec_env->worker;
+#endif
+
     /* Detach the native thread here to ensure the resources are freed */
-    if (exec_env->wait_count == 0 && !exec_env->thread_is_detached) {
+    if (
+#if CLUSTER_THREAD_POOL_SIZE > 0
+        !worker &&
+#endif
+        exec_env->wait_count == 0 && !exec_env->thread_is_detached) {
         /* Only detach current thread when there is no other thread
            joining it, otherwise let the system resources for the
            thread be released after joining */
@@ -1089,10 +1483,40 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
     /* Routine exit, destroy instance */
     wasm_runtime_deinstantiate_internal(module_inst, true);
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    if (worker) {
+        /* Hand the return value to the joining threads */
+        os_mutex_lock(&worker->lock);
+        worker->exec_env = NULL;
+        worker->ret_value = retval;
+        worker->is_routine_exited = true;
+        os_cond_broadcast(&worker->cond);
+        os_mutex_unlock(&worker->lock);
+    }
+#endif
+
     os_mutex_unlock(&cluster->lock);
 
     os_mutex_unlock(&cluster_list_lock);
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    if (worker) {
+        /* The native thread exits and can't be reused, wait until all the
+           joining threads get the return value, and then let the cluster
+           join the native thread when creating a new worker or being
+           destroyed */
+        os_mutex_lock(&worker->lock);
+        while (worker->join_count > 0) {
+            os_cond_wait(&worker->cond, &worker->lock);
+        }
+        os_mutex_unlock(&worker->lock);
+
+        os_mutex_lock(&cluster->pool_lock);
+        worker->is_exited = true;
+        os_mutex_unlock(&cluster->pool_lock);
+    }
+#endif
+
     os_thread_exit(retval);
 }
 
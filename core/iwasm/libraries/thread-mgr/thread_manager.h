@@ -55,6 +55,19 @@ struct WASMCluster {
     WASMDebugInstance *debug_inst;
 #endif
 
+#if CLUSTER_THREAD_POOL_SIZE > 0
+    /* Lock for the native threads of the thread pool */
+    korp_mutex pool_lock;
+    /* All the native threads created for the spawned threads */
+    struct WASMClusterWorker *workers;
+    /* The native threads parked and waiting for new thread routines */
+    struct WASMClusterWorker *idle_workers;
+    uint32 idle_worker_num;
+    /* Set when the cluster is being destroyed, the native threads
+        exit instead of being parked after then */
+    bool pool_is_destroying;
+#endif
+
 #if WASM_ENABLE_DUMP_CALL_STACK != 0
     /* When an exception occurs in a thread, the stack frames of that thread are
      * saved into the cluster
@@ -96,6 +109,11 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
                            uint32 aux_stack_size,
                            void *(*thread_routine)(void *), void *arg);
 
+/* Check whether the thread of exec_env hasn't exited and released
+   its resources */
+bool
+wasm_cluster_is_thread_alive(WASMExecEnv *exec_env);
+
 int32
 wasm_cluster_join_thread(WASMExecEnv *exec_env, void **ret_val);
 
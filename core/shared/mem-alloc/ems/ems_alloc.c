@@ -189,6 +189,14 @@ unlink_hmu(gc_heap_t *heap, hmu_t *hmu)
     }
 #endif
 
+#if GC_ENABLE_BUMP_ALLOC != 0
+    if (hmu == heap->bump_region) {
+        /* the bump region isn't linked into KFC, just detach it */
+        heap->bump_region = NULL;
+        return true;
+    }
+#endif
+
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
     base_addr = heap->base_addr;
     end_addr = base_addr + heap->current_size;
@@ -480,6 +488,160 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
     return NULL;
 }
 
+#if GC_ENABLE_BUMP_ALLOC != 0
+/**
+ * Give the rest space of the bump region back to KFC, merge it with
+ * the next free chunk if there is one
+ */
+static bool
+retire_bump_region(gc_heap_t *heap)
+{
+    hmu_t *region = heap->bump_region, *next;
+    gc_uint8 *end_addr = heap->base_addr + heap->current_size;
+    gc_size_t size;
+
+    if (!region)
+        return true;
+
+    heap->bump_region = NULL;
+    size = hmu_get_size(region);
+
+    next = (hmu_t *)((char *)region + size);
+    if ((gc_uint8 *)next < end_addr && hmu_get_ut(next) == HMU_FC
+        && gci_hmu_is_swept(heap, next)) {
+        if (!unlink_hmu(heap, next))
+            return false;
+        size += hmu_get_size(next);
+    }
+
+    return gci_add_fc(heap, region, size);
+}
+
+/**
+ * Detach a new bump region from the largest free chunk in KFC
+ *
+ * @return true if success, false if there is no free chunk large enough
+ */
+static bool
+refill_bump_region(gc_heap_t *heap)
+{
+    hmu_tree_node_t *tp = heap->kfc_tree_root->right, *largest = NULL;
+    gc_uint8 *end_addr = heap->base_addr + heap->current_size;
+    hmu_t *region, *rest;
+    gc_size_t size;
+
+    bh_assert(!heap->bump_region);
+
+    /* the rightmost node of KFC tree is the largest one */
+    while (tp) {
+        largest = tp;
+        tp = tp->right;
+    }
+
+    if (!largest || largest->size < GC_BUMP_REGION_SIZE)
+        return false;
+
+    if (!remove_tree_node(heap, largest))
+        return false;
+
+    region = (hmu_t *)largest;
+    size = largest->size;
+
+    if (size >= GC_BUMP_REGION_SIZE + GC_SMALLEST_SIZE) {
+        rest = (hmu_t *)((char *)region + GC_BUMP_REGION_SIZE);
+        rest->header = 0;
+        if (!gci_add_fc(heap, rest, size - GC_BUMP_REGION_SIZE))
+            return false;
+        /* the previous chunk of rest is the free bump region */
+        hmu_set_size(region, GC_BUMP_REGION_SIZE);
+        hmu_set_free_size(region);
+    }
+    else {
+        rest = (hmu_t *)((char *)region + size);
+        if ((gc_uint8 *)rest < end_addr)
+            hmu_unmark_pinuse(rest);
+    }
+
+    heap->bump_region = region;
+    return true;
+}
+
+/**
+ * Allocate a hmu by bumping the start address of the bump region
+ *
+ * @return hmu allocated if success, NULL if the region is absent or
+ *         isn't large enough
+ */
+static hmu_t *
+alloc_hmu_from_bump_region(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *region = heap->bump_region, *rest;
+    gc_uint8 *end_addr = heap->base_addr + heap->current_size;
+    gc_size_t region_size;
+
+    if (!region)
+        return NULL;
+
+    region_size = hmu_get_size(region);
+    if (region_size < size)
+        return NULL;
+
+    if (region_size >= size + GC_SMALLEST_SIZE) {
+        rest = (hmu_t *)((char *)region + size);
+        rest->header = 0;
+        hmu_set_ut(rest, HMU_FC);
+        hmu_set_size(rest, region_size - size);
+        hmu_set_free_size(rest);
+        hmu_mark_pinuse(rest);
+        heap->bump_region = rest;
+    }
+    else {
+        size = region_size;
+        rest = (hmu_t *)((char *)region + size);
+        if ((gc_uint8 *)rest < end_addr)
+            hmu_mark_pinuse(rest);
+        heap->bump_region = NULL;
+    }
+
+    heap->total_free_size -= size;
+    if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
+        heap->highmark_size = heap->current_size - heap->total_free_size;
+
+    /* the pinuse bit of region is kept for the allocated hmu */
+    hmu_set_size(region, size);
+    return region;
+}
+
+/**
+ * Try to allocate a small wasm object from the bump region, refill the
+ * region if the current one is used up.
+ *
+ * @return hmu allocated if success, NULL if the caller should fall back
+ *         to alloc_hmu_ex, e.g. the object is large or GC is needed
+ */
+static hmu_t *
+alloc_hmu_bump(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *hmu;
+
+    bh_assert(size > 0 && !(size & 7));
+
+    if (!HMU_IS_FC_NORMAL(size) || heap->total_free_size < heap->gc_threshold)
+        return NULL;
+
+    if (size < GC_SMALLEST_SIZE)
+        size = GC_SMALLEST_SIZE;
+
+    if ((hmu = alloc_hmu_from_bump_region(heap, size)))
+        return hmu;
+
+    if (!retire_bump_region(heap) || !refill_bump_region(heap))
+        return NULL;
+
+    return alloc_hmu_from_bump_region(heap, size);
+}
+#endif /* end of GC_ENABLE_BUMP_ALLOC != 0 */
+
 #if WASM_ENABLE_GC != 0
 static int
 do_gc_heap(gc_heap_t *heap)
@@ -488,7 +650,7 @@ do_gc_heap(gc_heap_t *heap)
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
     uint64 start = 0, end = 0, time = 0;
 
-    start = os_time_get_boot_microsecond();
+    start = os_time_get_boot_us();
 #endif
     if (heap->is_reclaim_enabled) {
         UNLOCK_HEAP(heap);
@@ -496,7 +658,7 @@ do_gc_heap(gc_heap_t *heap)
         LOCK_HEAP(heap);
     }
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
-    end = os_time_get_boot_microsecond();
+    end = os_time_get_boot_us();
     time = end - start;
     heap->total_gc_time += time;
     if (time > heap->max_gc_time) {
@@ -508,6 +670,40 @@ do_gc_heap(gc_heap_t *heap)
 }
 #endif
 
+#if GC_ENABLE_LAZY_SWEEP != 0
+static void
+lazy_sweep_heap(gc_heap_t *heap)
+{
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    uint64 start = 0, time = 0;
+
+    start = os_time_get_boot_us();
+#endif
+    gci_sweep_heap(heap, GC_SWEEP_STEP_SIZE);
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    time = os_time_get_boot_us() - start;
+    heap->total_gc_time += time;
+    if (time > heap->max_gc_time) {
+        heap->max_gc_time = time;
+    }
+#endif
+}
+
+/**
+ * Find a proper HMU with given size, sweep the rest heap step by step
+ * until the request is satisfied if the heap is being swept lazily
+ */
+static hmu_t *
+alloc_hmu_lazy_sweep(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *ret;
+
+    while (!(ret = alloc_hmu(heap, size)) && heap->sweep_cur)
+        lazy_sweep_heap(heap);
+    return ret;
+}
+#endif
+
 /**
  * Find a proper HMU with given size
  *
@@ -526,6 +722,8 @@ do_gc_heap(gc_heap_t *heap)
 static hmu_t *
 alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
 {
+    hmu_t *ret = NULL;
+
     bh_assert(gci_is_heap_valid(heap));
     bh_assert(size > 0 && !(size & 7));
 
@@ -534,12 +732,16 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
     if (GC_SUCCESS != do_gc_heap(heap))
         return NULL;
 #else
+#if GC_ENABLE_LAZY_SWEEP != 0
+    /* GC is triggered only after the lazy sweep of last GC finishes */
+    if (heap->sweep_cur && (ret = alloc_hmu_lazy_sweep(heap, size)))
+        return ret;
+#endif
     if (heap->total_free_size < heap->gc_threshold) {
         if (GC_SUCCESS != do_gc_heap(heap))
             return NULL;
     }
     else {
-        hmu_t *ret = NULL;
         if ((ret = alloc_hmu(heap, size))) {
             return ret;
         }
@@ -549,7 +751,17 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
 #endif
 #endif
 
-    return alloc_hmu(heap, size);
+#if GC_ENABLE_LAZY_SWEEP != 0
+    ret = alloc_hmu_lazy_sweep(heap, size);
+#else
+    ret = alloc_hmu(heap, size);
+#endif
+#if GC_ENABLE_BUMP_ALLOC != 0
+    /* the bump region may hold the space required */
+    if (!ret && heap->bump_region && retire_bump_region(heap))
+        ret = alloc_hmu(heap, size);
+#endif
+    return ret;
 }
 
 #if BH_ENABLE_GC_VERIFY == 0
@@ -659,7 +871,12 @@ gc_realloc_vo_internal(void *vheap, void *ptr, gc_size_t size, const char *file,
 
     if (hmu_old) {
         hmu_next = (hmu_t *)((char *)hmu_old + tot_size_old);
-        if (hmu_is_in_heap(hmu_next, base_addr, end_addr)) {
+        if (hmu_is_in_heap(hmu_next, base_addr, end_addr)
+#if GC_ENABLE_LAZY_SWEEP != 0
+            /* free chunks not swept yet aren't linked into KFC */
+            && gci_hmu_is_swept(heap, hmu_next)
+#endif
+        ) {
             ut = hmu_get_ut(hmu_next);
             tot_size_next = hmu_get_size(hmu_next);
             if (ut == HMU_FC && tot_size <= tot_size_old + tot_size_next) {
@@ -668,6 +885,10 @@ gc_realloc_vo_internal(void *vheap, void *ptr, gc_size_t size, const char *file,
                     UNLOCK_HEAP(heap);
                     return NULL;
                 }
+                if (tot_size + GC_SMALLEST_SIZE > tot_size_old + tot_size_next)
+                    /* the rest is too small to be a free chunk */
+                    tot_size = tot_size_old + tot_size_next;
+                heap->total_free_size -= tot_size - tot_size_old;
                 hmu_set_size(hmu_old, tot_size);
                 memset((char *)hmu_old + tot_size_old, 0,
                        tot_size - tot_size_old);
@@ -683,6 +904,11 @@ gc_realloc_vo_internal(void *vheap, void *ptr, gc_size_t size, const char *file,
                     }
                     hmu_mark_pinuse(hmu_next);
                 }
+                else {
+                    hmu_next = (hmu_t *)((char *)hmu_old + tot_size);
+                    if (hmu_is_in_heap(hmu_next, base_addr, end_addr))
+                        hmu_mark_pinuse(hmu_next);
+                }
                 UNLOCK_HEAP(heap);
                 return obj_old;
             }
@@ -781,7 +1007,10 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
 
     LOCK_HEAP(heap);
 
-    hmu = alloc_hmu_ex(heap, tot_size);
+#if GC_ENABLE_BUMP_ALLOC != 0
+    if (!(hmu = alloc_hmu_bump(heap, tot_size)))
+#endif
+        hmu = alloc_hmu_ex(heap, tot_size);
     if (!hmu)
         goto finish;
 
@@ -796,6 +1025,9 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
 #if GC_STAT_DATA != 0
     heap->total_size_allocated += tot_size;
 #endif
+#if WASM_ENABLE_GC != 0
+    heap->wo_size += tot_size;
+#endif
 
     hmu_set_ut(hmu, HMU_WO);
 #if GC_MANUALLY != 0
@@ -833,6 +1065,63 @@ gci_is_heap_valid(gc_heap_t *heap)
     return GC_TRUE;
 }
 
+#if WASM_ENABLE_HEAP_TRIM != 0
+/* The content of the free chunks isn't needed. On Windows, the pages are
+   reset instead of being decommitted and committed again, which may leave
+   them decommitted when the commit limit is reached */
+#ifdef BH_PLATFORM_WINDOWS
+#define HEAP_TRIM_ADVICE MMAP_ADVICE_FREE
+#else
+#define HEAP_TRIM_ADVICE MMAP_ADVICE_DONTNEED
+#endif
+
+/**
+ * Give the pages of the free chunk which overlap [start, end) back to
+ * the OS, the tree node at the head and the size at the tail of the
+ * chunk are kept
+ *
+ * @param min_size the pages are kept if their total size is less than it
+ *
+ * @return the size of the pages given back
+ */
+static gc_size_t
+release_fc_pages(gc_heap_t *heap, hmu_t *hmu, gc_size_t size, uintptr_t start,
+                 uintptr_t end, gc_size_t min_size)
+{
+    uintptr_t page_mask = (uintptr_t)heap->page_size - 1;
+    uintptr_t begin_addr = (uintptr_t)hmu + sizeof(hmu_tree_node_t);
+    uintptr_t end_addr = (uintptr_t)hmu + size - sizeof(gc_uint32);
+    int ret;
+
+    if (begin_addr < start)
+        begin_addr = start;
+    if (end_addr > end)
+        end_addr = end;
+    begin_addr = (begin_addr + page_mask) & ~page_mask;
+    end_addr &= ~page_mask;
+
+    if (heap->is_trim_failed || end_addr <= begin_addr
+        || end_addr - begin_addr < min_size)
+        return 0;
+
+    ret = os_madvise((void *)begin_addr, end_addr - begin_addr,
+                     HEAP_TRIM_ADVICE);
+    if (ret > 0)
+        /* only this range is rejected, keep trimming the others */
+        return 0;
+
+    if (ret != 0) {
+        LOG_WARNING("warning: failed to give the free pages of heap %p back "
+                    "to the OS",
+                    heap);
+        heap->is_trim_failed = true;
+        return 0;
+    }
+
+    return (gc_size_t)(end_addr - begin_addr);
+}
+#endif
+
 #if BH_ENABLE_GC_VERIFY == 0
 int
 gc_free_vo(void *vheap, gc_object_t obj)
@@ -849,6 +1138,9 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
     gc_size_t size = 0;
     hmu_type_t ut;
     int ret = GC_SUCCESS;
+#if WASM_ENABLE_HEAP_TRIM != 0
+    uintptr_t freed_start, freed_end;
+#endif
 
     if (!obj) {
         return GC_SUCCESS;
@@ -882,12 +1174,29 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
 
             size = hmu_get_size(hmu);
 
-            heap->total_free_size += size;
-
 #if GC_STAT_DATA != 0
             heap->total_size_freed += size;
 #endif
 
+#if GC_ENABLE_LAZY_SWEEP != 0
+            if (!gci_hmu_is_swept(heap, hmu)) {
+                /* just mark it freed, it will be reclaimed when the
+                   lazy sweep reaches it */
+                hmu_free_vo(hmu);
+                heap->total_free_size += size;
+                ret = GC_SUCCESS;
+                goto out;
+            }
+#endif
+
+            heap->total_free_size += size;
+#if WASM_ENABLE_HEAP_TRIM != 0
+            /* the tail size of the previous chunk and the head of the
+               next chunk become free too if they are merged */
+            freed_start = (uintptr_t)hmu - sizeof(gc_uint32);
+            freed_end = (uintptr_t)hmu + size + sizeof(hmu_tree_node_t);
+#endif
+
             if (!hmu_get_pinuse(hmu)) {
                 prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
 
@@ -904,7 +1213,11 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
 
             next = (hmu_t *)((char *)hmu + size);
             if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                if (hmu_get_ut(next) == HMU_FC) {
+                if (hmu_get_ut(next) == HMU_FC
+#if GC_ENABLE_LAZY_SWEEP != 0
+                    && gci_hmu_is_swept(heap, next)
+#endif
+                ) {
                     size += hmu_get_size(next);
                     if (!unlink_hmu(heap, next)) {
                         ret = GC_ERROR;
@@ -922,6 +1235,12 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
             if (hmu_is_in_heap(next, base_addr, end_addr)) {
                 hmu_unmark_pinuse(next);
             }
+
+#if WASM_ENABLE_HEAP_TRIM != 0
+            if (heap->trim_threshold > 0)
+                release_fc_pages(heap, hmu, size, freed_start, freed_end,
+                                 heap->trim_threshold);
+#endif
         }
         else {
             ret = GC_ERROR;
@@ -936,6 +1255,62 @@ out:
     return ret;
 }
 
+#if WASM_ENABLE_HEAP_TRIM != 0
+gc_size_t
+gc_trim_heap(gc_handle_t handle)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    hmu_t *cur, *end;
+    gc_size_t size, total_size = 0;
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap->is_heap_corrupted) {
+        LOG_ERROR("[GC_ERROR]Heap is corrupted, heap trim failed.\n");
+        return 0;
+    }
+#endif
+
+    LOCK_HEAP(heap);
+
+    cur = (hmu_t *)heap->base_addr;
+    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+
+    while (cur < end && !heap->is_trim_failed) {
+        size = hmu_get_size(cur);
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+        if (size == 0 || size > (uint32)((uint8 *)end - (uint8 *)cur)) {
+            LOG_ERROR("[GC_ERROR]Heap is corrupted, heap trim failed.\n");
+            heap->is_heap_corrupted = true;
+            break;
+        }
+#endif
+
+        if (hmu_get_ut(cur) == HMU_FC
+#if GC_ENABLE_BUMP_ALLOC != 0
+            /* its pages are being allocated */
+            && cur != heap->bump_region
+#endif
+        )
+            total_size += release_fc_pages(heap, cur, size, (uintptr_t)cur,
+                                           (uintptr_t)cur + size, 0);
+
+        cur = (hmu_t *)((char *)cur + size);
+    }
+
+    UNLOCK_HEAP(heap);
+    return total_size;
+}
+
+void
+gc_set_trim_threshold(gc_handle_t handle, gc_size_t threshold)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    heap->trim_threshold = threshold;
+}
+#endif /* end of WASM_ENABLE_HEAP_TRIM != 0 */
+
 void
 gc_dump_heap_stats(gc_heap_t *heap)
 {
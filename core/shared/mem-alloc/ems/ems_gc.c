@@ -14,7 +14,7 @@
 
 #if WASM_ENABLE_GC != 0
 
-/* mark node is used for gc marker*/
+/* mark node is a chunk of the mark stack */
 typedef struct mark_node_struct {
     /* number of to-expand objects can be saved in this node */
     gc_size_t cnt;
@@ -29,6 +29,73 @@ typedef struct mark_node_struct {
     gc_object_t set[MARK_NODE_OBJ_CNT];
 } mark_node_t;
 
+/* mark stack is used for gc marker, objects are pushed to and popped
+   from its top node, and only the top node may be partly filled */
+typedef struct mark_stack {
+    mark_node_t *top;
+    /* an empty node kept to avoid allocating and freeing nodes again
+       and again when the stack size goes up and down around a node
+       boundary */
+    mark_node_t *spare;
+    /* total size of the wos marked and pushed to the stack */
+    gc_size_t marked_size;
+} mark_stack_t;
+
+#if GC_ENABLE_PARALLEL_MARK != 0
+/* the pool through which the markers share mark nodes */
+typedef struct mark_pool {
+    korp_mutex lock;
+    korp_cond cond;
+
+    /* the shared mark nodes, they are all full except the split ones */
+    mark_node_t *nodes;
+    uint32 node_num;
+
+    /* number of the markers, and number of those waiting for nodes */
+    uint32 marker_num;
+    uint32 idle_num;
+
+    bool is_done;
+    bool is_failed;
+} mark_pool_t;
+
+typedef struct mark_workers mark_workers_t;
+
+typedef struct gc_marker {
+    gc_heap_t *heap;
+    mark_pool_t *pool;
+    mark_workers_t *workers;
+    mark_stack_t stack;
+    korp_tid tid;
+    /* the last GC cycle which the marker has joined */
+    uint32 cycle;
+} gc_marker_t;
+
+/* the markers shared by all the heaps, the helper threads are kept
+   between GCs and wait for the next GC cycle when they aren't marking */
+struct mark_workers {
+    mark_pool_t pool;
+    gc_marker_t markers[GC_MARK_THREAD_NUM];
+    /* number of the markers, including the thread doing GC */
+    uint32 marker_num;
+    /* the helper markers wait for a GC cycle to start on start_cond,
+       and the thread doing GC waits for them to finish on finish_cond,
+       both with the lock of the pool */
+    korp_cond start_cond;
+    korp_cond finish_cond;
+    uint32 cycle;
+    uint32 running_num;
+    bool is_exiting;
+};
+
+/* the markers are created in the first GC which marks a heap in
+   parallel and kept until the runtime is destroyed, a heap is marked by
+   the thread doing GC alone while another heap is using them */
+static korp_mutex mark_workers_lock;
+static mark_workers_t *mark_workers = NULL;
+static bool is_mark_workers_busy = false;
+#endif
+
 /**
  * Alloc a mark node from the native heap
  *
@@ -60,26 +127,147 @@ free_mark_node(mark_node_t *node)
     BH_FREE((gc_object_t)node);
 }
 
+/* Free a list of mark nodes */
+static void
+free_mark_nodes(mark_node_t *node)
+{
+    mark_node_t *next;
+
+    while (node) {
+        next = node->next;
+        free_mark_node(node);
+        node = next;
+    }
+}
+
+/* Get an empty mark node, the spare one of the stack is reused if any */
+static mark_node_t *
+mark_stack_get_node(mark_stack_t *stack)
+{
+    mark_node_t *node = stack->spare;
+
+    if (node) {
+        stack->spare = NULL;
+        node->idx = 0;
+        node->next = NULL;
+        return node;
+    }
+    return alloc_mark_node();
+}
+
+/* Push an object to the mark stack, return false if no memory */
+static inline bool
+mark_stack_push(mark_stack_t *stack, gc_object_t obj)
+{
+    mark_node_t *node = stack->top;
+
+    if (!node || node->idx == node->cnt) {
+        if (!(node = mark_stack_get_node(stack)))
+            return false;
+        node->next = stack->top;
+        stack->top = node;
+    }
+    node->set[node->idx++] = obj;
+    return true;
+}
+
+/* Pop an object from the mark stack, return NULL if the stack is empty */
+static inline gc_object_t
+mark_stack_pop(mark_stack_t *stack)
+{
+    mark_node_t *node = stack->top;
+    gc_object_t obj;
+
+    if (!node)
+        return NULL;
+
+    bh_assert(node->idx > 0);
+    obj = node->set[--node->idx];
+
+    if (node->idx == 0) {
+        stack->top = node->next;
+        if (stack->spare)
+            free_mark_node(node);
+        else
+            stack->spare = node;
+    }
+    return obj;
+}
+
+/* Free all the nodes of the mark stack */
+static void
+mark_stack_destroy(mark_stack_t *stack)
+{
+    free_mark_nodes(stack->top);
+    if (stack->spare)
+        free_mark_node(stack->spare);
+    stack->top = stack->spare = NULL;
+}
+
+/**
+ * Mark a wo
+ *
+ * @param hmu the hmu of the wo
+ * @param is_atomic whether other markers may mark the wo at the same time
+ *
+ * @return true if the wo is marked by this call, false if it was marked
+ */
+static inline bool
+try_mark_wo(hmu_t *hmu, bool is_atomic)
+{
+#if GC_ENABLE_PARALLEL_MARK != 0
+    gc_uint32 mark_bit = (gc_uint32)1 << HMU_WO_MB_OFFSET;
+
+    if (is_atomic) {
+        if (BH_ATOMIC_32_LOAD(hmu->header) & mark_bit)
+            return false;
+        return !(BH_ATOMIC_32_FETCH_OR(hmu->header, mark_bit) & mark_bit);
+    }
+#endif
+    (void)is_atomic;
+    if (hmu_is_wo_marked(hmu))
+        return false;
+    hmu_mark_wo(hmu);
+    return true;
+}
+
+/**
+ * Invoke the finalizers registered to the objects which are not marked,
+ * so that sweeping, which may be done lazily, needn't handle them
+ *
+ * @param heap the heap which has already been marked
+ */
+static void
+invoke_finalizers(gc_heap_t *heap)
+{
+    extra_info_node_t *node;
+    gc_size_t i = heap->extra_info_node_cnt;
+
+    /* traverse backward as the node is removed from the array */
+    while (i > 0) {
+        node = heap->extra_info_nodes[--i];
+        if (!hmu_is_wo_marked(obj_to_hmu(node->obj))) {
+            node->finalizer(node->obj, node->data);
+            gc_unset_finalizer((gc_handle_t)heap, node->obj);
+        }
+    }
+}
+
 /**
- * Sweep phase of mark_sweep algorithm
+ * Start the sweep phase of mark_sweep algorithm, KFC is reset and then
+ * rebuilt by gci_sweep_heap
+ *
  * @param heap the heap to sweep, should be a valid instance heap
  *        which has already been marked
+ * @param marked_size the total size of the wos marked
  */
 static void
-sweep_instance_heap(gc_heap_t *heap)
+start_sweep(gc_heap_t *heap, gc_size_t marked_size)
 {
-    hmu_t *cur = NULL, *end = NULL, *last = NULL;
-    hmu_type_t ut;
-    gc_size_t size;
     int i, lsize;
-    gc_size_t tot_free = 0;
 
     bh_assert(gci_is_heap_valid(heap));
 
-    cur = (hmu_t *)heap->base_addr;
-    last = NULL;
-    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
-
     /* reset KFC */
     lsize =
         (int)(sizeof(heap->kfc_normal_list) / sizeof(heap->kfc_normal_list[0]));
@@ -88,8 +276,42 @@ sweep_instance_heap(gc_heap_t *heap)
     }
     heap->kfc_tree_root->right = NULL;
     heap->root_set = NULL;
+#if GC_ENABLE_BUMP_ALLOC != 0
+    /* the bump region is a free chunk and will be merged when sweeping */
+    heap->bump_region = NULL;
+#endif
 
-    while (cur < end) {
+    heap->sweep_cur = (hmu_t *)heap->base_addr;
+    heap->sweep_last = NULL;
+
+    /* the wos not marked are garbage, count them as free now rather than
+       when the sweep reaches them, so that the free size is right while
+       the heap is swept lazily */
+    bh_assert(marked_size <= heap->wo_size);
+    heap->total_free_size += heap->wo_size - marked_size;
+    heap->wo_size = marked_size;
+
+#if GC_STAT_DATA != 0
+    heap->total_gc_count++;
+#endif
+}
+
+/* Check ems_gc_internal.h for description */
+bool
+gci_sweep_heap(gc_heap_t *heap, gc_size_t budget)
+{
+    hmu_t *cur = NULL, *end = NULL, *last = NULL;
+    hmu_type_t ut;
+    gc_size_t size, swept = 0;
+
+    bh_assert(gci_is_heap_valid(heap));
+    bh_assert(heap->sweep_cur);
+
+    cur = heap->sweep_cur;
+    last = heap->sweep_last;
+    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+
+    while (cur < end && (budget == 0 || swept < budget)) {
         ut = hmu_get_ut(cur);
         size = hmu_get_size(cur);
         bh_assert(size > 0);
@@ -100,23 +322,10 @@ sweep_instance_heap(gc_heap_t *heap)
             /* merge previous free areas with current one */
             if (!last)
                 last = cur;
-
-            if (ut == HMU_WO) {
-                /* Invoke registered finalizer */
-                gc_object_t cur_obj = hmu_to_obj(cur);
-                if (gct_vm_get_extra_info_flag(cur_obj)) {
-                    extra_info_node_t *node = gc_search_extra_info_node(
-                        (gc_handle_t)heap, cur_obj, NULL);
-                    bh_assert(node);
-                    node->finalizer(node->obj, node->data);
-                    gc_unset_finalizer((gc_handle_t)heap, cur_obj);
-                }
-            }
         }
         else {
             /* current block is still live */
             if (last) {
-                tot_free += (gc_size_t)((char *)cur - (char *)last);
                 gci_add_fc(heap, last, (gc_size_t)((char *)cur - (char *)last));
                 hmu_mark_pinuse(last);
                 last = NULL;
@@ -129,25 +338,28 @@ sweep_instance_heap(gc_heap_t *heap)
         }
 
         cur = (hmu_t *)((char *)cur + size);
+        swept += size;
+    }
+
+    if (cur < end) {
+        /* the rest heap will be swept in the next step */
+        heap->sweep_cur = cur;
+        heap->sweep_last = last;
+        return false;
     }
 
     bh_assert(cur == end);
 
     if (last) {
-        tot_free += (gc_size_t)((char *)cur - (char *)last);
         gci_add_fc(heap, last, (gc_size_t)((char *)cur - (char *)last));
         hmu_mark_pinuse(last);
     }
 
-    heap->total_free_size = tot_free;
-
-#if GC_STAT_DATA != 0
-    heap->total_gc_count++;
-    if ((heap->current_size - tot_free) > heap->highmark_size)
-        heap->highmark_size = heap->current_size - tot_free;
+    heap->sweep_cur = NULL;
+    heap->sweep_last = NULL;
 
-#endif
     gc_update_threshold(heap);
+    return true;
 }
 
 /**
@@ -162,7 +374,6 @@ sweep_instance_heap(gc_heap_t *heap)
 static int
 add_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
 {
-    mark_node_t *mark_node = NULL, *new_node = NULL;
     hmu_t *hmu = NULL;
 
     bh_assert(obj);
@@ -177,21 +388,14 @@ add_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
     if (hmu_is_wo_marked(hmu))
         return GC_SUCCESS; /* already marked*/
 
-    mark_node = (mark_node_t *)heap->root_set;
-    if (!mark_node || mark_node->idx == mark_node->cnt) {
-        new_node = alloc_mark_node();
-        if (!new_node) {
-            LOG_ERROR("can not add obj to mark node because of mark node "
-                      "allocation failed");
-            return GC_ERROR;
-        }
-        new_node->next = mark_node;
-        heap->root_set = new_node;
-        mark_node = new_node;
+    if (!mark_stack_push((mark_stack_t *)heap->root_set, obj)) {
+        LOG_ERROR("can not add obj to mark stack because of mark node "
+                  "allocation failed");
+        return GC_ERROR;
     }
 
-    mark_node->set[mark_node->idx++] = obj;
     hmu_mark_wo(hmu);
+    ((mark_stack_t *)heap->root_set)->marked_size += hmu_get_size(hmu);
     return GC_SUCCESS;
 }
 
@@ -241,7 +445,6 @@ gc_add_root(void *heap_p, gc_object_t obj)
 static void
 rollback_mark(gc_heap_t *heap)
 {
-    mark_node_t *mark_node = NULL, *next_mark_node = NULL;
     hmu_t *cur = NULL, *end = NULL;
     hmu_type_t ut;
     gc_size_t size;
@@ -249,13 +452,7 @@ rollback_mark(gc_heap_t *heap)
     bh_assert(gci_is_heap_valid(heap));
 
     /* roll back*/
-    mark_node = (mark_node_t *)heap->root_set;
-    while (mark_node) {
-        next_mark_node = mark_node->next;
-        free_mark_node(mark_node);
-        mark_node = next_mark_node;
-    }
-
+    mark_stack_destroy((mark_stack_t *)heap->root_set);
     heap->root_set = NULL;
 
     /* then traverse the heap to unmark all marked wos*/
@@ -277,6 +474,385 @@ rollback_mark(gc_heap_t *heap)
     bh_assert(cur == end);
 }
 
+/**
+ * Push the unmarked wos referenced by an object to the mark stack and
+ * mark them
+ *
+ * @param heap the heap being marked
+ * @param stack the mark stack of the marker
+ * @param obj the object to expand, which has been marked
+ * @param is_atomic whether other markers are marking the heap as well
+ *
+ * @return true if success, false otherwise
+ */
+static bool
+expand_object(gc_heap_t *heap, mark_stack_t *stack, gc_object_t obj,
+              bool is_atomic)
+{
+    bool is_compact_mode = false;
+    gc_object_t ref = NULL;
+    hmu_t *hmu = obj_to_hmu(obj);
+    gc_uint32 ref_num = 0, ref_start_offset = 0, offset = 0, j;
+    gc_uint16 *ref_list = NULL;
+
+    if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode, &ref_num,
+                                         &ref_list, &ref_start_offset)) {
+        LOG_ERROR("mark process failed because failed "
+                  "vm_get_wasm_object_ref_list");
+        return false;
+    }
+
+    if (ref_num >= 2U * GB) {
+        LOG_ERROR("Invalid ref_num returned");
+        return false;
+    }
+
+    for (j = 0; j < ref_num; j++) {
+        offset = is_compact_mode ? ref_start_offset + j * sizeof(void *)
+                                 : ref_list[j];
+        bh_assert(offset + sizeof(void *) < hmu_get_size(hmu));
+
+        ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
+        if (ref == NULL_REF || ((uintptr_t)ref & 1))
+            continue; /* null object or i31 object */
+
+        bh_assert((gc_uint8 *)obj_to_hmu(ref) >= heap->base_addr
+                  && (gc_uint8 *)obj_to_hmu(ref)
+                         < heap->base_addr + heap->current_size);
+        bh_assert(hmu_get_ut(obj_to_hmu(ref)) == HMU_WO);
+
+        if (try_mark_wo(obj_to_hmu(ref), is_atomic)) {
+            if (!mark_stack_push(stack, ref)) {
+                LOG_ERROR("mark process failed because of mark node "
+                          "allocation failed");
+                return false;
+            }
+            stack->marked_size += hmu_get_size(obj_to_hmu(ref));
+        }
+    }
+
+    (void)hmu;
+    (void)heap;
+    return true;
+}
+
+/**
+ * Mark all the wos reachable from the mark stack in current thread
+ *
+ * @param heap the heap being marked
+ * @param stack the mark stack which contains the marked rootset
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+mark_heap(gc_heap_t *heap, mark_stack_t *stack)
+{
+    gc_object_t obj;
+
+    while ((obj = mark_stack_pop(stack))) {
+        if (!expand_object(heap, stack, obj, false))
+            return GC_ERROR;
+    }
+    return GC_SUCCESS;
+}
+
+#if GC_ENABLE_PARALLEL_MARK != 0
+/**
+ * Move a part of the mark stack to the pool so that an idle marker can
+ * take it: the node under the top node if there is, or the upper half
+ * of the top node otherwise
+ */
+static void
+share_mark_node(mark_pool_t *pool, mark_stack_t *stack)
+{
+    mark_node_t *top = stack->top, *node;
+    uint32 cnt;
+
+    if (top->next) {
+        node = top->next;
+        top->next = node->next;
+    }
+    else {
+        if (top->idx < 2)
+            return;
+        if (!(node = mark_stack_get_node(stack)))
+            return;
+        cnt = top->idx / 2;
+        top->idx -= cnt;
+        bh_memcpy_s(node->set, sizeof(node->set), top->set + top->idx,
+                    sizeof(gc_object_t) * cnt);
+        node->idx = cnt;
+    }
+
+    os_mutex_lock(&pool->lock);
+    node->next = pool->nodes;
+    pool->nodes = node;
+    BH_ATOMIC_32_FETCH_ADD(pool->node_num, 1);
+    os_cond_signal(&pool->cond);
+    os_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Take a shared node from the pool to the empty mark stack, wait if the
+ * pool is empty and other markers are still marking
+ *
+ * @return true if a node is taken, false if the marking is done
+ */
+static bool
+take_mark_node(mark_pool_t *pool, mark_stack_t *stack)
+{
+    mark_node_t *node = NULL;
+
+    bh_assert(!stack->top);
+
+    os_mutex_lock(&pool->lock);
+    BH_ATOMIC_32_FETCH_ADD(pool->idle_num, 1);
+    while (!pool->nodes && !pool->is_done) {
+        if (pool->idle_num == pool->marker_num) {
+            /* no marker has objects to expand */
+            pool->is_done = true;
+            os_cond_broadcast(&pool->cond);
+            break;
+        }
+        os_cond_wait(&pool->cond, &pool->lock);
+    }
+    if (!pool->is_done) {
+        node = pool->nodes;
+        pool->nodes = node->next;
+        node->next = NULL;
+        BH_ATOMIC_32_FETCH_SUB(pool->node_num, 1);
+        BH_ATOMIC_32_FETCH_SUB(pool->idle_num, 1);
+    }
+    os_mutex_unlock(&pool->lock);
+
+    stack->top = node;
+    return node ? true : false;
+}
+
+static void
+run_marker(gc_marker_t *marker)
+{
+    mark_pool_t *pool = marker->pool;
+    mark_stack_t *stack = &marker->stack;
+    gc_object_t obj;
+
+    do {
+        while ((obj = mark_stack_pop(stack))) {
+            if (!expand_object(marker->heap, stack, obj, true)) {
+                os_mutex_lock(&pool->lock);
+                pool->is_failed = pool->is_done = true;
+                os_cond_broadcast(&pool->cond);
+                os_mutex_unlock(&pool->lock);
+                return;
+            }
+            /* feed the idle markers which haven't got a node */
+            if (stack->top
+                && BH_ATOMIC_32_LOAD(pool->idle_num)
+                       > BH_ATOMIC_32_LOAD(pool->node_num))
+                share_mark_node(pool, stack);
+        }
+    } while (take_mark_node(pool, stack));
+}
+
+static void *
+mark_thread_routine(void *arg)
+{
+    gc_marker_t *marker = (gc_marker_t *)arg;
+    mark_workers_t *workers = marker->workers;
+    mark_pool_t *pool = marker->pool;
+
+    os_mutex_lock(&pool->lock);
+    while (true) {
+        while (marker->cycle == workers->cycle && !workers->is_exiting)
+            os_cond_wait(&workers->start_cond, &pool->lock);
+        if (workers->is_exiting)
+            break;
+        marker->cycle = workers->cycle;
+        os_mutex_unlock(&pool->lock);
+
+        run_marker(marker);
+
+        os_mutex_lock(&pool->lock);
+        if (--workers->running_num == 0)
+            os_cond_signal(&workers->finish_cond);
+    }
+    os_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ * Create the markers and start the helper marker threads, which are
+ * kept until the runtime is destroyed
+ *
+ * @return the markers if success, NULL otherwise
+ */
+static mark_workers_t *
+create_mark_workers(void)
+{
+    mark_workers_t *workers;
+    uint32 i;
+
+    if (!(workers = (mark_workers_t *)BH_MALLOC(sizeof(mark_workers_t)))) {
+        LOG_WARNING("allocate gc markers failed");
+        return NULL;
+    }
+
+    memset(workers, 0, sizeof(mark_workers_t));
+    if (os_mutex_init(&workers->pool.lock) != 0)
+        goto fail1;
+    if (os_cond_init(&workers->pool.cond) != 0)
+        goto fail2;
+    if (os_cond_init(&workers->start_cond) != 0)
+        goto fail3;
+    if (os_cond_init(&workers->finish_cond) != 0)
+        goto fail4;
+
+    for (i = 0; i < GC_MARK_THREAD_NUM; i++) {
+        workers->markers[i].pool = &workers->pool;
+        workers->markers[i].workers = workers;
+    }
+
+    workers->marker_num = 1;
+    for (i = 1; i < GC_MARK_THREAD_NUM; i++) {
+        if (os_thread_create(&workers->markers[i].tid, mark_thread_routine,
+                             &workers->markers[i],
+                             APP_THREAD_STACK_SIZE_DEFAULT)
+            != 0) {
+            /* mark with the threads created */
+            LOG_WARNING("create gc mark thread failed");
+            break;
+        }
+        workers->marker_num++;
+    }
+
+    return workers;
+
+fail4:
+    os_cond_destroy(&workers->start_cond);
+fail3:
+    os_cond_destroy(&workers->pool.cond);
+fail2:
+    os_mutex_destroy(&workers->pool.lock);
+fail1:
+    BH_FREE(workers);
+    return NULL;
+}
+
+static void
+destroy_mark_workers(mark_workers_t *workers)
+{
+    uint32 i;
+
+    os_mutex_lock(&workers->pool.lock);
+    workers->is_exiting = true;
+    os_cond_broadcast(&workers->start_cond);
+    os_mutex_unlock(&workers->pool.lock);
+
+    for (i = 1; i < workers->marker_num; i++)
+        os_thread_join(workers->markers[i].tid, NULL);
+
+    os_cond_destroy(&workers->finish_cond);
+    os_cond_destroy(&workers->start_cond);
+    os_cond_destroy(&workers->pool.cond);
+    os_mutex_destroy(&workers->pool.lock);
+    BH_FREE(workers);
+}
+
+/**
+ * Mark all the wos reachable from the mark stack with the shared
+ * markers, the current thread is one of them, and the helper marker
+ * threads are started in the first GC which marks in parallel. The heap
+ * is marked by the current thread alone if the markers are in use
+ *
+ * @param heap the heap being marked
+ * @param stack the mark stack which contains the marked rootset
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+mark_heap_parallel(gc_heap_t *heap, mark_stack_t *stack)
+{
+    mark_workers_t *workers;
+    mark_pool_t *pool;
+    uint32 i;
+    int ret;
+
+    os_mutex_lock(&mark_workers_lock);
+    if (!mark_workers)
+        mark_workers = create_mark_workers();
+    workers = mark_workers;
+    if (!workers || workers->marker_num == 1 || is_mark_workers_busy) {
+        os_mutex_unlock(&mark_workers_lock);
+        return mark_heap(heap, stack);
+    }
+    is_mark_workers_busy = true;
+    os_mutex_unlock(&mark_workers_lock);
+
+    pool = &workers->pool;
+    for (i = 0; i < workers->marker_num; i++)
+        workers->markers[i].heap = heap;
+    workers->markers[0].stack = *stack;
+
+    os_mutex_lock(&pool->lock);
+    /* all the markers are counted before they run, so that the marking
+       isn't thought to be done when one of them becomes idle */
+    pool->marker_num = workers->marker_num;
+    pool->idle_num = 0;
+    pool->is_done = pool->is_failed = false;
+    workers->running_num = workers->marker_num - 1;
+    workers->cycle++;
+    os_cond_broadcast(&workers->start_cond);
+    os_mutex_unlock(&pool->lock);
+
+    run_marker(&workers->markers[0]);
+
+    os_mutex_lock(&pool->lock);
+    while (workers->running_num > 0)
+        os_cond_wait(&workers->finish_cond, &pool->lock);
+    os_mutex_unlock(&pool->lock);
+
+    *stack = workers->markers[0].stack;
+    memset(&workers->markers[0].stack, 0, sizeof(mark_stack_t));
+    for (i = 1; i < workers->marker_num; i++) {
+        stack->marked_size += workers->markers[i].stack.marked_size;
+        mark_stack_destroy(&workers->markers[i].stack);
+        workers->markers[i].stack.marked_size = 0;
+    }
+    free_mark_nodes(pool->nodes);
+    pool->nodes = NULL;
+    pool->node_num = 0;
+    ret = pool->is_failed ? GC_ERROR : GC_SUCCESS;
+
+    os_mutex_lock(&mark_workers_lock);
+    is_mark_workers_busy = false;
+    os_mutex_unlock(&mark_workers_lock);
+
+    return ret;
+}
+#endif /* end of GC_ENABLE_PARALLEL_MARK != 0 */
+
+bool
+gc_init_mark_workers(void)
+{
+#if GC_ENABLE_PARALLEL_MARK != 0
+    if (os_mutex_init(&mark_workers_lock) != 0)
+        return false;
+#endif
+    return true;
+}
+
+void
+gc_destroy_mark_workers(void)
+{
+#if GC_ENABLE_PARALLEL_MARK != 0
+    if (mark_workers) {
+        destroy_mark_workers(mark_workers);
+        mark_workers = NULL;
+    }
+    os_mutex_destroy(&mark_workers_lock);
+#endif
+}
+
 /**
  * Reclaim GC instance heap
  *
@@ -287,43 +863,56 @@ rollback_mark(gc_heap_t *heap)
 static int
 reclaim_instance_heap(gc_heap_t *heap)
 {
+    mark_stack_t mark_stack = { 0 };
+    int ret_mark;
+    bool ret;
+#if BH_ENABLE_GC_VERIFY != 0
     mark_node_t *mark_node = NULL;
-    int idx = 0, j = 0;
-    bool ret, is_compact_mode = false;
-    gc_object_t obj = NULL, ref = NULL;
+    gc_object_t obj = NULL;
     hmu_t *hmu = NULL;
-    gc_uint32 ref_num = 0, ref_start_offset = 0, size = 0, offset = 0;
-    gc_uint16 *ref_list = NULL;
+    uint32 idx;
+#endif
 
     bh_assert(gci_is_heap_valid(heap));
 
-    heap->root_set = NULL;
+    /* finish the lazy sweep of last GC before marking */
+    if (heap->sweep_cur)
+        gci_sweep_heap(heap, 0);
+
+    heap->root_set = &mark_stack;
 
 #if WASM_ENABLE_THREAD_MGR == 0
-    if (!heap->exec_env)
+    if (!heap->exec_env) {
+        heap->root_set = NULL;
         return GC_SUCCESS;
+    }
     ret = gct_vm_begin_rootset_enumeration(heap->exec_env, heap);
 #else
-    if (!heap->cluster)
+    if (!heap->cluster) {
+        heap->root_set = NULL;
         return GC_SUCCESS;
+    }
     ret = gct_vm_begin_rootset_enumeration(heap->cluster, heap);
 #endif
-    if (!ret)
+    if (!ret) {
+        mark_stack_destroy(&mark_stack);
+        heap->root_set = NULL;
         return GC_ERROR;
+    }
 
 #if BH_ENABLE_GC_VERIFY != 0
     /* no matter whether the enumeration is successful or not, the data
        collected should be checked at first */
-    mark_node = (mark_node_t *)heap->root_set;
+    mark_node = mark_stack.top;
     while (mark_node) {
         /* all nodes except first should be full filled */
-        bh_assert(mark_node == (mark_node_t *)heap->root_set
+        bh_assert(mark_node == mark_stack.top
                   || mark_node->idx == mark_node->cnt);
 
         /* all nodes should be non-empty */
         bh_assert(mark_node->idx > 0);
 
-        for (idx = 0; idx < (int)mark_node->idx; idx++) {
+        for (idx = 0; idx < mark_node->idx; idx++) {
             obj = mark_node->set[idx];
             hmu = obj_to_hmu(obj);
             bh_assert(hmu_is_wo_marked(hmu));
@@ -347,89 +936,38 @@ reclaim_instance_heap(gc_heap_t *heap)
         return GC_ERROR;
     }
 
-    /* the algorithm we use to mark all objects */
-    /* 1. mark rootset and organize them into a mark_node list (last marked
-     * roots at list header, i.e. stack top) */
-    /* 2. in every iteration, we use the top node to expand*/
-    /* 3. execute step 2 till no expanding */
-    /* this is a BFS & DFS mixed algorithm, but more like DFS */
-    mark_node = (mark_node_t *)heap->root_set;
-    while (mark_node) {
-        heap->root_set = mark_node->next;
-
-        /* note that mark_node->idx may change in each loop */
-        for (idx = 0; idx < (int)mark_node->idx; idx++) {
-            obj = mark_node->set[idx];
-            hmu = obj_to_hmu(obj);
-            size = hmu_get_size(hmu);
-
-            if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode,
-                                                 &ref_num, &ref_list,
-                                                 &ref_start_offset)) {
-                LOG_ERROR("mark process failed because failed "
-                          "vm_get_wasm_object_ref_list");
-                break;
-            }
-
-            if (ref_num >= 2U * GB) {
-                LOG_ERROR("Invalid ref_num returned");
-                break;
-            }
-
-            if (is_compact_mode) {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_start_offset + j * sizeof(void *);
-                    bh_assert(offset + sizeof(void *) < size);
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("add_wo_to_expand failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
-                    break;
-            }
-            else {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_list[j];
-                    bh_assert(offset + sizeof(void *) < size);
-
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("mark process failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
-                    break;
-            }
-        }
-        if (idx < (int)mark_node->idx)
-            break; /* not yet done */
-
-        /* obj's in mark_node are all expanded */
-        free_mark_node(mark_node);
-        mark_node = heap->root_set;
-    }
+    /* the rootset has been marked and pushed to the mark stack, pop an
+       object from the stack, mark the unmarked objects it references and
+       push them to the stack, till the stack is empty, which is a DFS */
+#if GC_ENABLE_PARALLEL_MARK != 0
+    if (heap->current_size >= GC_PARALLEL_MARK_MIN_HEAP_SIZE)
+        ret_mark = mark_heap_parallel(heap, &mark_stack);
+    else
+#endif
+        ret_mark = mark_heap(heap, &mark_stack);
 
-    if (mark_node) {
+    if (ret_mark != GC_SUCCESS) {
         LOG_ERROR("mark process is not successfully finished");
 
-        free_mark_node(mark_node);
         /* roll back is required */
         rollback_mark(heap);
 
         return GC_ERROR;
     }
 
-    /* now sweep */
-    sweep_instance_heap(heap);
+    mark_stack_destroy(&mark_stack);
+    heap->root_set = NULL;
 
-    (void)size;
+    invoke_finalizers(heap);
+
+    /* now sweep, the rest heap is swept lazily in allocation if the step
+       doesn't finish it */
+    start_sweep(heap, mark_stack.marked_size);
+#if GC_ENABLE_LAZY_SWEEP != 0
+    gci_sweep_heap(heap, GC_SWEEP_STEP_SIZE);
+#else
+    gci_sweep_heap(heap, 0);
+#endif
 
     return GC_SUCCESS;
 }
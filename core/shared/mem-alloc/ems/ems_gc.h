@@ -67,6 +67,7 @@ typedef enum {
     GC_STAT_HIGHMARK,
     GC_STAT_COUNT,
     GC_STAT_TIME,
+    GC_STAT_MAX_TIME,
     GC_STAT_MAX
 } GC_STAT_INDEX;
 
@@ -145,6 +146,21 @@ gc_enable_gc_reclaim(gc_handle_t handle, void *exec_env);
 void
 gc_enable_gc_reclaim(gc_handle_t handle, void *cluster);
 #endif
+
+/**
+ * Initialize the markers shared by the heaps to mark them in parallel,
+ * the helper marker threads are started in the first parallel marking
+ *
+ * @return true if success, false otherwise
+ */
+bool
+gc_init_mark_workers(void);
+
+/**
+ * Stop the helper marker threads and free the shared markers
+ */
+void
+gc_destroy_mark_workers(void);
 #endif
 
 /**
@@ -185,6 +201,25 @@ gc_is_heap_corrupted(gc_handle_t handle);
 void *
 gc_heap_stats(void *heap, uint32 *stats, int size);
 
+#if WASM_ENABLE_HEAP_TRIM != 0
+/**
+ * Give the pages inside the free chunks of the heap back to the OS
+ *
+ * @param handle the heap
+ *
+ * @return the size of the pages given back
+ */
+gc_size_t
+gc_trim_heap(gc_handle_t handle);
+
+/**
+ * Set the min size of the pages given back to the OS when a chunk is
+ * freed, 0 means that they are only given back by gc_trim_heap
+ */
+void
+gc_set_trim_threshold(gc_handle_t handle, gc_size_t threshold);
+#endif
+
 #if BH_ENABLE_GC_VERIFY == 0
 
 gc_object_t
@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "bh_platform.h"
+#include "bh_atomic.h"
 #include "ems_gc.h"
 
 /* HMU (heap memory unit) basic block type */
@@ -154,6 +155,7 @@ hmu_verify(void *vheap, hmu_t *hmu);
 
 #define HMU_VO_FB_OFFSET 28
 
+#define hmu_free_vo(hmu) SETBIT((hmu)->header, HMU_VO_FB_OFFSET)
 #define hmu_is_vo_freed(hmu) GETBIT((hmu)->header, HMU_VO_FB_OFFSET)
 #define hmu_unfree_vo(hmu) CLRBIT((hmu)->header, HMU_VO_FB_OFFSET)
 
@@ -175,6 +177,66 @@ hmu_verify(void *vheap, hmu_t *hmu);
 #error "Too small GC_MAX_HEAP_SIZE"
 #endif
 
+/**
+ * Size of the bump region which is detached from the largest free chunk,
+ * small wasm objects are allocated from it by bumping its start address
+ * instead of searching KFC. Set it to 0 to disable bump allocation.
+ */
+#ifndef GC_BUMP_REGION_SIZE
+#define GC_BUMP_REGION_SIZE (32 * 1024)
+#endif
+
+#if WASM_ENABLE_GC != 0 && GC_BUMP_REGION_SIZE > 0 \
+    && GC_IN_EVERY_ALLOCATION == 0
+#define GC_ENABLE_BUMP_ALLOC 1
+#if (GC_BUMP_REGION_SIZE & 7) != 0 \
+    || GC_BUMP_REGION_SIZE <= HMU_FC_NORMAL_MAX_SIZE
+#error "Invalid GC_BUMP_REGION_SIZE"
+#endif
+#else
+#define GC_ENABLE_BUMP_ALLOC 0
+#endif
+
+/**
+ * Max size of the heap area swept right after marking, the rest heap
+ * is swept lazily step by step when allocation fails, which bounds the
+ * GC pause time of a large heap. Set it to 0 to sweep the whole heap
+ * in one go.
+ */
+#ifndef GC_SWEEP_STEP_SIZE
+#define GC_SWEEP_STEP_SIZE (256 * 1024)
+#endif
+
+#if WASM_ENABLE_GC != 0 && GC_SWEEP_STEP_SIZE > 0 \
+    && GC_IN_EVERY_ALLOCATION == 0
+#define GC_ENABLE_LAZY_SWEEP 1
+#else
+#define GC_ENABLE_LAZY_SWEEP 0
+#endif
+
+/**
+ * Number of threads marking the heap, including the thread doing GC.
+ * The other GC_MARK_THREAD_NUM - 1 threads are shared by all the heaps
+ * of the runtime, and are created to mark a heap in parallel when the
+ * heap isn't smaller than GC_PARALLEL_MARK_MIN_HEAP_SIZE.
+ */
+#ifndef GC_MARK_THREAD_NUM
+#define GC_MARK_THREAD_NUM 1
+#endif
+
+#ifndef GC_PARALLEL_MARK_MIN_HEAP_SIZE
+#define GC_PARALLEL_MARK_MIN_HEAP_SIZE (4 * 1024 * 1024)
+#endif
+
+#if WASM_ENABLE_GC != 0 && GC_MARK_THREAD_NUM > 1
+#define GC_ENABLE_PARALLEL_MARK 1
+#if BH_ATOMIC_32_IS_ATOMIC == 0
+#error "Parallel marking requires 32-bit atomic operations"
+#endif
+#else
+#define GC_ENABLE_PARALLEL_MARK 0
+#endif
+
 typedef struct hmu_normal_node {
     hmu_t hmu_header;
     gc_int32 next_offset;
@@ -272,7 +334,7 @@ typedef struct gc_heap_struct {
     hmu_tree_node_t *kfc_tree_root;
 
 #if WASM_ENABLE_GC != 0
-    /* for rootset enumeration of private heap*/
+    /* the mark stack which the rootset is pushed to when marking */
     void *root_set;
 
 #if WASM_ENABLE_THREAD_MGR == 0
@@ -296,6 +358,19 @@ typedef struct gc_heap_struct {
 
     /* Whether the heap can do reclaim */
     unsigned is_reclaim_enabled : 1;
+
+    /* the next hmu to sweep, NULL if the heap isn't being swept */
+    hmu_t *sweep_cur;
+    /* the start of the free area being merged by the sweep, which
+       ends at sweep_cur, NULL if there is none */
+    hmu_t *sweep_last;
+
+#endif
+
+#if GC_ENABLE_BUMP_ALLOC != 0
+    /* the free chunk which isn't linked into KFC and from which small
+       wasm objects are bump allocated, NULL if there is none */
+    hmu_t *bump_region;
 #endif
 
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
@@ -304,6 +379,17 @@ typedef struct gc_heap_struct {
     bool is_heap_corrupted;
 #endif
 
+#if WASM_ENABLE_HEAP_TRIM != 0
+    gc_size_t page_size;
+    /* min size of the pages given back to the OS when a chunk is freed,
+       0 means that they are only given back by gc_trim_heap */
+    gc_size_t trim_threshold;
+    /* whether the OS can't take the pages back, e.g. the heap isn't in
+       anonymous memory, after which the heap isn't trimmed anymore. A range
+       which is only rejected by itself doesn't set it */
+    bool is_trim_failed;
+#endif
+
     gc_size_t init_size;
     gc_size_t highmark_size;
     gc_size_t total_free_size;
@@ -311,6 +397,9 @@ typedef struct gc_heap_struct {
 #if WASM_ENABLE_GC != 0
     gc_size_t gc_threshold;
     gc_size_t gc_threshold_factor;
+    /* total size of the wos allocated, including the garbage ones
+       which haven't been reclaimed */
+    gc_size_t wo_size;
     gc_size_t total_gc_count;
     gc_size_t total_gc_time;
     gc_size_t max_gc_time;
@@ -347,6 +436,29 @@ gc_update_threshold(gc_heap_t *heap)
     heap->gc_threshold = (uint32_t)result;
 }
 
+/**
+ * Sweep the heap which is being swept by at most @budget bytes
+ *
+ * @param heap the heap to sweep, KFC is rebuilt for the area swept
+ * @param budget the max size of the area to sweep, 0 means no limit
+ *
+ * @return true if the whole heap has been swept, false otherwise
+ */
+bool
+gci_sweep_heap(gc_heap_t *heap, gc_size_t budget);
+
+/**
+ * Check whether the hmu is in the area which has been swept, only the
+ * free chunks in this area are linked into KFC
+ */
+static inline bool
+gci_hmu_is_swept(gc_heap_t *heap, hmu_t *hmu)
+{
+    hmu_t *boundary = heap->sweep_last ? heap->sweep_last : heap->sweep_cur;
+
+    return !boundary || hmu < boundary;
+}
+
 #define gct_vm_mutex_init os_mutex_init
 #define gct_vm_mutex_destroy os_mutex_destroy
 #define gct_vm_mutex_lock os_mutex_lock
@@ -31,6 +31,12 @@ gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
     heap->gc_threshold_factor = GC_DEFAULT_THRESHOLD_FACTOR;
     gc_update_threshold(heap);
 #endif
+#if WASM_ENABLE_HEAP_TRIM != 0
+    heap->page_size = (gc_size_t)os_getpagesize();
+    /* Only the app heap gives back the pages of the freed chunks by
+       default, see memory_instantiate */
+    heap->trim_threshold = 0;
+#endif
 
     root = heap->kfc_tree_root = (hmu_tree_node_t *)heap->kfc_tree_root_buf;
     memset(root, 0, sizeof *root);
@@ -280,6 +286,14 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     adjust_ptr(p_right, offset);
     adjust_ptr(p_parent, offset);
 
+#if GC_ENABLE_BUMP_ALLOC != 0
+    adjust_ptr((uint8 **)&heap->bump_region, offset);
+#endif
+#if WASM_ENABLE_GC != 0
+    adjust_ptr((uint8 **)&heap->sweep_cur, offset);
+    adjust_ptr((uint8 **)&heap->sweep_last, offset);
+#endif
+
     cur = (hmu_t *)heap->base_addr;
     end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
 
@@ -294,7 +308,16 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
         }
 #endif
 
-        if (hmu_get_ut(cur) == HMU_FC && !HMU_IS_FC_NORMAL(size)) {
+        if (hmu_get_ut(cur) == HMU_FC && !HMU_IS_FC_NORMAL(size)
+#if GC_ENABLE_BUMP_ALLOC != 0
+            /* the bump region isn't linked into KFC tree */
+            && cur != heap->bump_region
+#endif
+#if WASM_ENABLE_GC != 0
+            /* nor are the free chunks not swept yet */
+            && gci_hmu_is_swept(heap, cur)
+#endif
+        ) {
             tree_node = (hmu_tree_node_t *)cur;
 
             ASSERT_TREE_NODE_ALIGNED_ACCESS(tree_node);
@@ -472,6 +495,9 @@ gc_heap_stats(void *heap_arg, uint32 *stats, int size)
             case GC_STAT_TIME:
                 stats[i] = heap->total_gc_time;
                 break;
+            case GC_STAT_MAX_TIME:
+                stats[i] = heap->max_gc_time;
+                break;
 #endif
             default:
                 break;
@@ -508,8 +534,9 @@ gc_show_stat(void *heap)
     heap = gc_heap_stats(heap, stats, GC_STAT_MAX);
 
     os_printf("\n[GC stats %p] %" PRIu32 " %" PRIu32 " %" PRIu32 " %" PRIu32
-              " %" PRIu32 "\n",
-              heap, stats[0], stats[1], stats[2], stats[3], stats[4]);
+              " %" PRIu32 " %" PRIu32 "\n",
+              heap, stats[0], stats[1], stats[2], stats[3], stats[4],
+              stats[5]);
 }
 
 #if WASM_ENABLE_GC != 0
@@ -535,9 +562,14 @@ gc_dump_perf_profiling(gc_handle_t *handle)
     gc_heap_t *gc_heap_handle = (void *)handle;
     if (gc_heap_handle) {
         os_printf("\nGC performance summary\n");
-        os_printf("    Total GC time (ms): %u\n",
+        os_printf("    Total GC count: %u\n", gc_heap_handle->total_gc_count);
+        os_printf("    Total GC time (us): %u\n",
                   gc_heap_handle->total_gc_time);
-        os_printf("    Max GC time (ms): %u\n", gc_heap_handle->max_gc_time);
+        os_printf("    Max GC pause (us): %u\n", gc_heap_handle->max_gc_time);
+        if (gc_heap_handle->total_gc_count > 0)
+            os_printf("    Average GC pause (us): %u\n",
+                      gc_heap_handle->total_gc_time
+                          / gc_heap_handle->total_gc_count);
     }
     else {
         os_printf("Failed to dump GC performance\n");
@@ -92,6 +92,18 @@ mem_allocator_add_root(mem_allocator_t allocator, WASMObjectRef obj)
 {
     return gc_add_root((gc_handle_t)allocator, (gc_object_t)obj);
 }
+
+bool
+mem_allocator_init_gc_markers(void)
+{
+    return gc_init_mark_workers();
+}
+
+void
+mem_allocator_destroy_gc_markers(void)
+{
+    gc_destroy_mark_workers();
+}
 #endif
 
 int
@@ -114,6 +126,20 @@ mem_allocator_get_alloc_info(mem_allocator_t allocator, void *mem_alloc_info)
     return true;
 }
 
+#if WASM_ENABLE_HEAP_TRIM != 0
+uint32
+mem_allocator_trim(mem_allocator_t allocator)
+{
+    return gc_trim_heap((gc_handle_t)allocator);
+}
+
+void
+mem_allocator_set_trim_threshold(mem_allocator_t allocator, uint32 threshold)
+{
+    gc_set_trim_threshold((gc_handle_t)allocator, threshold);
+}
+#endif
+
 #if WASM_ENABLE_GC != 0
 bool
 mem_allocator_set_gc_finalizer(mem_allocator_t allocator, void *obj,
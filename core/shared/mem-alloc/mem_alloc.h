@@ -73,6 +73,14 @@ mem_allocator_enable_gc_reclaim(mem_allocator_t allocator, void *cluster);
 int
 mem_allocator_add_root(mem_allocator_t allocator, WASMObjectRef obj);
 
+/* Initialize and destroy the GC markers shared by the heaps of the
+   runtime */
+bool
+mem_allocator_init_gc_markers(void);
+
+void
+mem_allocator_destroy_gc_markers(void);
+
 bool
 mem_allocator_set_gc_finalizer(mem_allocator_t allocator, void *obj,
                                gc_finalizer_t cb, void *data);
@@ -89,6 +97,14 @@ mem_allocator_dump_perf_profiling(mem_allocator_t allocator);
 bool
 mem_allocator_get_alloc_info(mem_allocator_t allocator, void *mem_alloc_info);
 
+#if WASM_ENABLE_HEAP_TRIM != 0
+uint32
+mem_allocator_trim(mem_allocator_t allocator);
+
+void
+mem_allocator_set_trim_threshold(mem_allocator_t allocator, uint32 threshold);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,13 +50,18 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
     uint64 request_size, page_size;
     uint8 *addr = MAP_FAILED;
     uint32 i;
+#if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
+    /* Align the mapping to the huge page size unless its address is
+       given or it is backed with the huge page pool */
+    bool align_huge_page = !(flags & (MMAP_MAP_FIXED | MMAP_MAP_HUGETLB));
+#endif
 
     page_size = (uint64)getpagesize();
     request_size = (size + page_size - 1) & ~(page_size - 1);
 
 #if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
     /* huge page isn't supported on MacOS and NuttX */
-    if (request_size >= HUGE_PAGE_SIZE)
+    if (align_huge_page && request_size >= HUGE_PAGE_SIZE)
         /* apply one extra huge page */
         request_size += HUGE_PAGE_SIZE;
 #endif
@@ -92,6 +97,17 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
     if (flags & MMAP_MAP_FIXED)
         map_flags |= MAP_FIXED;
 
+    if (flags & MMAP_MAP_HUGETLB) {
+#if defined(MAP_HUGETLB)
+        if ((uintptr_t)hint % HUGE_PAGE_SIZE != 0
+            || request_size % HUGE_PAGE_SIZE != 0)
+            return NULL;
+        map_flags |= MAP_HUGETLB;
+#else
+        return NULL;
+#endif
+    }
+
 #if defined(BUILD_TARGET_RISCV64_LP64D) || defined(BUILD_TARGET_RISCV64_LP64)
     /* As AOT relocation in RISCV64 may require that the code/data mapped
      * is in range 0 to 2GB, we try to map the memory with hint address
@@ -156,9 +172,12 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
     }
 
     if (addr == MAP_FAILED) {
-        os_printf("mmap failed with errno: %d, hint: %p, size: %" PRIu64
-                  ", prot: %d, flags: %d\n",
-                  errno, hint, request_size, map_prot, map_flags);
+        /* the huge page pool may be exhausted, which is left to the
+           caller to fall back to the regular pages */
+        if (!(flags & MMAP_MAP_HUGETLB))
+            os_printf("mmap failed with errno: %d, hint: %p, size: %" PRIu64
+                      ", prot: %d, flags: %d\n",
+                      errno, hint, request_size, map_prot, map_flags);
         return NULL;
     }
 
@@ -171,7 +190,7 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
 
 #if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
     /* huge page isn't supported on MacOS and NuttX */
-    if (request_size > HUGE_PAGE_SIZE) {
+    if (align_huge_page && request_size > HUGE_PAGE_SIZE) {
         uintptr_t huge_start, huge_end;
         size_t prefix_size = 0, suffix_size = HUGE_PAGE_SIZE;
 
@@ -286,6 +305,58 @@ os_mprotect(void *addr, size_t size, int prot)
     return mprotect(addr, request_size, map_prot);
 }
 
+int
+os_madvise(void *addr, size_t size, int advice)
+{
+    switch (advice) {
+        case MMAP_ADVICE_DONTNEED:
+#if defined(__linux__)
+            /* the private anonymous pages are zero-filled on next access */
+            if (madvise(addr, size, MADV_DONTNEED) == 0)
+                return 0;
+            /* e.g. the range isn't aligned to the huge page size of a
+               hugetlb mapping, or the kernel is short of resources */
+            return errno == EINVAL || errno == EAGAIN ? 1 : -1;
+#else
+            /* MADV_DONTNEED doesn't discard the content on other systems,
+               replace the range with new zero-filled anonymous pages */
+            return mmap(addr, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0)
+                           == MAP_FAILED
+                       ? -1
+                       : 0;
+#endif
+        case MMAP_ADVICE_FREE:
+#if defined(MADV_FREE)
+            if (madvise(addr, size, MADV_FREE) == 0)
+                return 0;
+            /* MADV_FREE isn't supported by the running kernel */
+#endif
+            return os_madvise(addr, size, MMAP_ADVICE_DONTNEED);
+        case MMAP_ADVICE_HUGEPAGE:
+#if defined(MADV_HUGEPAGE)
+            return madvise(addr, size, MADV_HUGEPAGE) == 0 ? 0 : -1;
+#else
+            return -1;
+#endif
+        case MMAP_ADVICE_NOHUGEPAGE:
+#if defined(MADV_NOHUGEPAGE)
+            return madvise(addr, size, MADV_NOHUGEPAGE) == 0 ? 0 : -1;
+#else
+            return -1;
+#endif
+        case MMAP_ADVICE_POPULATE_WRITE:
+            /* It fails if the running kernel is older than Linux 5.14 */
+#if defined(MADV_POPULATE_WRITE)
+            return madvise(addr, size, MADV_POPULATE_WRITE) == 0 ? 0 : -1;
+#else
+            return -1;
+#endif
+        default:
+            return -1;
+    }
+}
+
 void
 os_dcache_flush(void)
 {}
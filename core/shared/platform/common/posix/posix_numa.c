@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _GNU_SOURCE
+#if !defined(__RTTHREAD__)
+#define _GNU_SOURCE
+#endif
+#endif
+#include "platform_api_vmcore.h"
+#include "platform_api_extension.h"
+
+#ifdef OS_ENABLE_NUMA
+
+#include <sys/syscall.h>
+
+/* The memory policies and the flags of mbind and set_mempolicy, see
+   linux/mempolicy.h, the syscalls are called directly so that libnuma
+   isn't required */
+#define NUMA_MPOL_PREFERRED 1
+#define NUMA_MPOL_BIND 2
+#define NUMA_MPOL_MF_MOVE (1 << 1)
+
+#define NUMA_BITS_PER_LONG (sizeof(unsigned long) * 8)
+#define NUMA_NODE_MASK_LONGS \
+    ((OS_NUMA_NODE_MAX + NUMA_BITS_PER_LONG - 1) / NUMA_BITS_PER_LONG)
+
+static bool
+init_node_mask(unsigned long *node_mask, int node)
+{
+    if (node < 0 || node >= OS_NUMA_NODE_MAX)
+        return false;
+
+    memset(node_mask, 0, sizeof(unsigned long) * NUMA_NODE_MASK_LONGS);
+    node_mask[node / NUMA_BITS_PER_LONG] |= 1UL << (node % NUMA_BITS_PER_LONG);
+    return true;
+}
+
+int
+os_mbind(void *addr, size_t size, int node)
+{
+    unsigned long node_mask[NUMA_NODE_MASK_LONGS];
+
+    if (!init_node_mask(node_mask, node))
+        return -1;
+
+    /* The kernel reads maxnode - 1 bits of the node mask */
+    if (syscall(SYS_mbind, addr, size, NUMA_MPOL_BIND, node_mask,
+                NUMA_NODE_MASK_LONGS * NUMA_BITS_PER_LONG + 1,
+                NUMA_MPOL_MF_MOVE)
+        != 0)
+        return -1;
+
+    return 0;
+}
+
+/* Read the CPUs of the node from the sysfs cpulist file of the node,
+   e.g. "0-15,32-47" */
+static bool
+get_node_cpus(int node, cpu_set_t *cpus)
+{
+    char path[64], buf[1024], *p, *end;
+    long first, last, cpu;
+    ssize_t size;
+    int fd;
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+             node);
+    if ((fd = open(path, O_RDONLY)) < 0)
+        return false;
+    size = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (size <= 0)
+        return false;
+    buf[size] = '\0';
+
+    CPU_ZERO(cpus);
+    p = buf;
+    while (true) {
+        first = strtol(p, &end, 10);
+        if (end == p || first < 0)
+            break;
+        last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first)
+                break;
+        }
+        for (cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, cpus);
+        if (*end != ',')
+            break;
+        p = end + 1;
+    }
+
+    return CPU_COUNT(cpus) > 0;
+}
+
+int
+os_thread_bind_numa_node(int node)
+{
+    unsigned long node_mask[NUMA_NODE_MASK_LONGS];
+    cpu_set_t cpus;
+
+    if (!init_node_mask(node_mask, node) || !get_node_cpus(node, &cpus))
+        return -1;
+
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0)
+        return -1;
+
+    /* Prefer rather than bind the node, so that the memory allocated for
+       the thread can still come from the other nodes when the node is
+       out of memory */
+    if (syscall(SYS_set_mempolicy, NUMA_MPOL_PREFERRED, node_mask,
+                NUMA_NODE_MASK_LONGS * NUMA_BITS_PER_LONG + 1)
+        != 0)
+        return -1;
+
+    return 0;
+}
+
+#endif /* OS_ENABLE_NUMA */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "platform_api_extension.h"
+
+#ifdef OS_ENABLE_SAMPLING_TIMER
+
+static os_sampling_handler_t g_sampling_handler = NULL;
+
+static void
+sampling_sighandler(int signo)
+{
+    /* The handler may interrupt a system call of the thread */
+    int saved_errno = errno;
+    os_sampling_handler_t handler = g_sampling_handler;
+
+    (void)signo;
+    if (handler)
+        handler();
+    errno = saved_errno;
+}
+
+int
+os_sampling_timer_start(uint32 interval_us, os_sampling_handler_t handler)
+{
+    struct sigaction sa;
+    struct itimerval timer;
+
+    g_sampling_handler = handler;
+
+    sigemptyset(&sa.sa_mask);
+    /* Restart the interrupted system calls if possible */
+    sa.sa_flags = SA_RESTART;
+    sa.sa_handler = sampling_sighandler;
+    if (sigaction(SIGPROF, &sa, NULL)) {
+        return BHT_ERROR;
+    }
+
+    timer.it_interval.tv_sec = interval_us / 1000000;
+    timer.it_interval.tv_usec = interval_us % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL)) {
+        os_sampling_timer_stop();
+        return BHT_ERROR;
+    }
+    return BHT_OK;
+}
+
+void
+os_sampling_timer_stop(void)
+{
+    struct sigaction sa;
+    struct itimerval timer;
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+
+    /* Ignore the signals which are still pending rather than restoring the
+       default action, which terminates the process */
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPROF, &sa, NULL);
+    g_sampling_handler = NULL;
+}
+
+#endif /* OS_ENABLE_SAMPLING_TIMER */
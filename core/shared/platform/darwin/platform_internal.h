@@ -106,6 +106,9 @@ os_sigreturn();
 #if WASM_DISABLE_WAKEUP_BLOCKING_OP == 0
 #define OS_ENABLE_WAKEUP_BLOCKING_OP
 #endif
+
+/* SIGPROF and ITIMER_PROF are used by the sampling profiler */
+#define OS_ENABLE_SAMPLING_TIMER
 void
 os_set_signal_number_for_blocking_op(int signo);
 
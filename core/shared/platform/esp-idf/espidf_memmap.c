@@ -105,6 +105,12 @@ os_mprotect(void *addr, size_t size, int prot)
     return 0;
 }
 
+int
+os_madvise(void *addr, size_t size, int advice)
+{
+    return -1;
+}
+
 void
 #if (WASM_MEM_DUAL_BUS_MIRROR != 0)
     IRAM_ATTR
@@ -403,6 +403,64 @@ os_end_blocking_op(void);
 int
 os_wakeup_blocking_op(korp_tid tid);
 
+/**
+ * Callback called by the sampling timer, in a signal handler context on
+ * the thread which consumes the CPU time, so it must be async-signal-safe
+ */
+typedef void (*os_sampling_handler_t)(void);
+
+/**
+ * Start the process-wide sampling timer, which calls the handler about
+ * once every interval_us microseconds of the CPU time consumed by the
+ * process. It is available when OS_ENABLE_SAMPLING_TIMER is defined.
+ *
+ * For example, on posix-like platforms, this can be implemented with
+ * setitimer(ITIMER_PROF) and a SIGPROF handler.
+ *
+ * @param interval_us the sampling interval in microseconds
+ * @param handler the callback called on each tick
+ *
+ * @return 0 if success
+ */
+int
+os_sampling_timer_start(uint32 interval_us, os_sampling_handler_t handler);
+
+/**
+ * Stop the sampling timer, the handler may still be running on other
+ * threads when it returns.
+ */
+void
+os_sampling_timer_stop(void);
+
+/**
+ * Bind a range of memory to a NUMA node, the pages of the range are
+ * allocated from the node when they are faulted in, and the pages which
+ * are already faulted in are moved to the node. It is available when
+ * OS_ENABLE_NUMA is defined.
+ *
+ * For example, on Linux, this can be implemented with mbind(MPOL_BIND).
+ *
+ * @param addr the start address of the range, aligned to the page size
+ * @param size the size of the range
+ * @param node the NUMA node, from 0 to OS_NUMA_NODE_MAX - 1
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mbind(void *addr, size_t size, int node);
+
+/**
+ * Pin the calling thread to the CPUs of a NUMA node, and prefer the node
+ * when the memory is allocated for the thread, e.g. its native stack. It is
+ * available when OS_ENABLE_NUMA is defined.
+ *
+ * @param node the NUMA node, from 0 to OS_NUMA_NODE_MAX - 1
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_thread_bind_numa_node(int node);
+
 /****************************************************
  *                     Section 2                    *
  *                   Socket support                 *
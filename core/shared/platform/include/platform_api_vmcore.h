@@ -133,6 +133,10 @@ enum {
     /* Don't interpret addr as a hint: place the mapping at exactly
        that address. */
     MMAP_MAP_FIXED = 2,
+    /* Back the mapping with the pages of the huge page pool of the OS, the
+       size and the addr must be aligned to the huge page size, fail if it
+       isn't supported or the pool doesn't have enough free pages */
+    MMAP_MAP_HUGETLB = 4,
 };
 
 void *
@@ -142,6 +146,42 @@ os_munmap(void *addr, size_t size);
 int
 os_mprotect(void *addr, size_t size, int prot);
 
+/* Memory advices */
+enum {
+    /* The content isn't needed anymore, the pages are given back to the
+       OS and the range reads as zeros after that. On Windows the range is
+       decommitted and committed again, and a part of it may be left
+       decommitted if -1 is returned, use MMAP_ADVICE_FREE when the range
+       doesn't need to read as zeros */
+    MMAP_ADVICE_DONTNEED = 0,
+    /* The content isn't needed anymore, the OS may reclaim the pages
+       lazily, and the range reads as either zeros or the old content
+       until it is written */
+    MMAP_ADVICE_FREE = 1,
+    /* Back the range with transparent huge pages when possible */
+    MMAP_ADVICE_HUGEPAGE = 2,
+    /* Don't back the range with transparent huge pages */
+    MMAP_ADVICE_NOHUGEPAGE = 3,
+    /* Fault in the pages of the range writable now without changing their
+       content, so that the later accesses don't page fault */
+    MMAP_ADVICE_POPULATE_WRITE = 4,
+};
+
+/**
+ * Give the OS advice about the use of a range of readable and writable
+ * anonymous memory, e.g. the memory mapped by os_mmap
+ *
+ * @param addr the start address of the range, aligned to the page size
+ * @param size the size of the range, aligned to the page size
+ * @param advice the advice, one of MMAP_ADVICE_XXX
+ *
+ * @return 0 if success, 1 if the advice can't be applied to this range but
+ *         may be applied to others, e.g. the range isn't aligned to the huge
+ *         page size, -1 if failed or the advice isn't supported
+ */
+int
+os_madvise(void *addr, size_t size, int advice);
+
 static inline void *
 os_mremap_slow(void *old_addr, size_t old_size, size_t new_size)
 {
@@ -243,6 +243,12 @@ os_mprotect(void *addr, size_t size, int prot)
     return (st == SGX_SUCCESS ? 0 : -1);
 }
 
+int
+os_madvise(void *addr, size_t size, int advice)
+{
+    return -1;
+}
+
 void
 os_dcache_flush(void)
 {
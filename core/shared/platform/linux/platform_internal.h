@@ -119,6 +119,16 @@ os_sigreturn();
 #if WASM_DISABLE_WAKEUP_BLOCKING_OP == 0
 #define OS_ENABLE_WAKEUP_BLOCKING_OP
 #endif
+
+/* SIGPROF and ITIMER_PROF are used by the sampling profiler */
+#define OS_ENABLE_SAMPLING_TIMER
+
+/* mbind, set_mempolicy and sched_setaffinity are used by the NUMA-aware
+   placement */
+#define OS_ENABLE_NUMA
+/* The max number of NUMA nodes supported */
+#define OS_NUMA_NODE_MAX 128
+
 void
 os_set_signal_number_for_blocking_op(int signo);
 
@@ -110,6 +110,12 @@ os_mprotect(void *addr, size_t size, int prot)
     return 0;
 }
 
+int
+os_madvise(void *addr, size_t size, int advice)
+{
+    return -1;
+}
+
 void
 os_dcache_flush()
 {
@@ -7,6 +7,12 @@
 
 #define TRACE_MEMMAP 0
 
+/* The size of the chunks which are decommitted and committed again one by
+   one for MMAP_ADVICE_DONTNEED */
+#define DONTNEED_CHUNK_SIZE (64 * 1024)
+/* The times to retry committing a decommitted chunk again */
+#define DONTNEED_COMMIT_RETRY 16
+
 static DWORD
 access_to_win32_flags(int prot)
 {
@@ -44,6 +50,12 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
         return NULL;
     }
 
+    if (flags & MMAP_MAP_HUGETLB) {
+        /* large pages can't be reserved and committed on demand, and
+           require the SeLockMemoryPrivilege privilege */
+        return NULL;
+    }
+
 #if WASM_ENABLE_JIT != 0
     /**
      * Allocate memory at the highest possible address if the
@@ -145,3 +157,66 @@ os_mprotect(void *addr, size_t size, int prot)
 #endif
     return VirtualProtect((LPVOID)addr, request_size, protect, NULL);
 }
+
+/* Zero the range by decommitting it and committing it again chunk by
+   chunk, so that each chunk is committed again right after it releases
+   its commit charge */
+static int
+decommit_and_commit(uint8 *addr, size_t size)
+{
+    uint8 *p = addr, *end = addr + size;
+    size_t chunk_size;
+    int i;
+
+    for (; p < end; p += chunk_size) {
+        chunk_size = (size_t)(end - p) < DONTNEED_CHUNK_SIZE
+                         ? (size_t)(end - p)
+                         : DONTNEED_CHUNK_SIZE;
+
+        if (!VirtualFree((LPVOID)p, chunk_size, MEM_DECOMMIT)) {
+            /* The rest of the range is untouched, zero it instead */
+            memset(p, 0, (size_t)(end - p));
+            return 0;
+        }
+
+        /* The commit only fails if the commit charge released by the
+           decommit is taken in between, e.g. by another process */
+        for (i = 0; !os_mem_commit(p, chunk_size,
+                                   MMAP_PROT_READ | MMAP_PROT_WRITE);
+             i++) {
+            if (i == DONTNEED_COMMIT_RETRY) {
+                /* The chunk is left decommitted */
+                printf("warning: os_madvise commit pages failed, "
+                       "addr: %p, request_size: %zu\n",
+                       p, chunk_size);
+                return -1;
+            }
+            Sleep(1);
+        }
+    }
+
+    return 0;
+}
+
+int
+os_madvise(void *addr, size_t size, int advice)
+{
+    if (!addr)
+        return -1;
+
+#if TRACE_MEMMAP != 0
+    printf("Madvise memory, addr: %p, size: %zu, advice: %d\n", addr, size,
+           advice);
+#endif
+    switch (advice) {
+        case MMAP_ADVICE_DONTNEED:
+            /* the decommitted pages are zero-filled when committed again */
+            return decommit_and_commit((uint8 *)addr, size);
+        case MMAP_ADVICE_FREE:
+            return VirtualAlloc((LPVOID)addr, size, MEM_RESET, PAGE_READWRITE)
+                       ? 0
+                       : -1;
+        default:
+            return -1;
+    }
+}
@@ -19,6 +19,8 @@ typedef struct {
     uint32 addr_pool_size;
     const char *ns_lookup_pool[8];
     uint32 ns_lookup_pool_size;
+    const char *mmap_dir_list[8];
+    uint32 mmap_dir_list_size;
 } libc_wasi_parse_context_t;
 
 typedef enum {
@@ -45,6 +47,13 @@ libc_wasi_print_help(void)
            "path, for example:\n");
     printf("                             --map-dir=<guest-path1::host-path1> "
            "--map-dir=<guest-path2::host-path2>\n");
+    printf("  --mmap-dir=<guest-path>  Map the files opened read-only below "
+           "the given pre-opened\n");
+    printf("                           directory into memory to read them "
+           "without system calls,\n");
+    printf("                           the directory becomes read-only and "
+           "the files mustn't be\n");
+    printf("                           truncated while they are open\n");
     printf("  --addr-pool=<addr/mask>  Grant wasi access to the given network "
            "addresses in\n");
     printf("                           CIDR notation to the program, separated "
@@ -103,6 +112,17 @@ libc_wasi_parse(char *arg, libc_wasi_parse_context_t *ctx)
         }
         ctx->map_dir_list[ctx->map_dir_list_size++] = arg + 10;
     }
+    else if (!strncmp(arg, "--mmap-dir=", 11)) {
+        if (arg[11] == '\0')
+            return LIBC_WASI_PARSE_RESULT_NEED_HELP;
+        if (ctx->mmap_dir_list_size
+            >= sizeof(ctx->mmap_dir_list) / sizeof(char *)) {
+            printf("Only allow max mmap dir number %d\n",
+                   (int)(sizeof(ctx->mmap_dir_list) / sizeof(char *)));
+            return LIBC_WASI_PARSE_RESULT_BAD_PARAM;
+        }
+        ctx->mmap_dir_list[ctx->mmap_dir_list_size++] = arg + 11;
+    }
     else if (!strncmp(arg, "--env=", 6)) {
         char *tmp_env;
 
@@ -176,4 +196,6 @@ libc_wasi_set_init_args(struct InstantiationArgs2 *args, int argc, char **argv,
                                                        ctx->addr_pool_size);
     wasm_runtime_instantiation_args_set_wasi_ns_lookup_pool(
         args, ctx->ns_lookup_pool, ctx->ns_lookup_pool_size);
+    wasm_runtime_instantiation_args_set_wasi_mmap_dir(
+        args, ctx->mmap_dir_list, ctx->mmap_dir_list_size);
 }
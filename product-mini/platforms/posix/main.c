@@ -57,6 +57,26 @@ print_help(void)
 #else
     printf("  --heap-size=n            Set maximum heap size in bytes, default is 16 KB when libc wasi is diabled\n");
 #endif
+#if WASM_ENABLE_HEAP_TRIM != 0
+    printf("  --heap-trim-threshold=n  Set the min size in bytes of the free pages of the heap\n");
+    printf("                           given back to the OS, default is %u KB, 0 to disable\n",
+           HEAP_TRIM_THRESHOLD_DEFAULT / 1024);
+#endif
+    printf("  --huge-page=<policy>     Set the huge page policy of the linear memory, can be:\n");
+    printf("                             default, none, thp (transparent huge pages) or\n");
+    printf("                             hugetlb (huge page pool), default is default\n");
+    printf("  --memory-prefault=<policy>\n");
+    printf("                           Set the policy of faulting in the pages committed by\n");
+    printf("                           instantiation and memory.grow, can be: lazy, eager\n");
+    printf("                           or background, default is lazy\n");
+#if WASM_ENABLE_AOT != 0
+    printf("  --huge-page-text         Back the text section of the aot file with huge pages\n");
+#endif
+#if WASM_ENABLE_NUMA != 0
+    printf("  --numa-node=n            Bind the linear memory and the stacks to NUMA node n\n");
+    printf("  --numa-pin-threads       Pin the main thread and the spawned threads to the CPUs\n");
+    printf("                           of the NUMA node\n");
+#endif
 #if WASM_ENABLE_SHARED_HEAP != 0
     printf("  --shared-heap-size=n     Create shared heap of n bytes and attach to the wasm app.\n");
     printf("                           The size n will be adjusted to a minumum number aligned to page size\n");
@@ -82,7 +102,8 @@ print_help(void)
 #endif
 #endif /* WASM_ENABLE_JIT != 0 */
 #if WASM_ENABLE_LINUX_PERF != 0
-    printf("  --enable-linux-perf      Enable linux perf support. It works in aot and llvm-jit.\n");
+    printf("  --enable-linux-perf      Enable linux perf support. It works in aot, llvm-jit and fast-jit,\n"
+           "                           and writes /tmp/jit-<pid>.dump for `perf inject --jit`.\n");
 #endif
     printf("  --repl                   Start a very simple REPL (read-eval-print-loop) mode\n"
            "                           that runs commands in the form of \"FUNC ARG...\"\n");
@@ -115,6 +136,24 @@ print_help(void)
 #endif
 #if WASM_ENABLE_STATIC_PGO != 0
     printf("  --gen-prof-file=<path>   Generate LLVM PGO (Profile-Guided Optimization) profile file\n");
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    printf("  --profile=<path>         Sample the call stacks and write the profile file, in pprof\n");
+    printf("                           format if the path ends with .pb or .pprof, otherwise in\n");
+    printf("                           folded stacks format\n");
+    printf("  --profile-interval=us    Set the sampling interval in microseconds, default is 10000\n");
+#endif
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    printf("  --gen-interp-prof-file=<path>\n");
+    printf("                           Generate the interpreter profile file, which can be\n");
+    printf("                           passed to wamrc with --use-interp-prof-file\n");
+#endif
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    printf("  --gen-prepared-module=<path>\n");
+    printf("                           Generate the prepared module of the wasm file, which\n");
+    printf("                           keeps the fast interpreter code for the current build\n");
+    printf("  --use-prepared-module    Load the prepared code of the wasm file if it is valid\n");
+    printf("                           for the current build, only use it for trusted files\n");
 #endif
     printf("  --version                Show version information\n");
     return 1;
@@ -494,6 +533,57 @@ free_func(
 }
 #endif /* end of WASM_ENABLE_GLOBAL_HEAP_POOL */
 
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+static bool
+ends_with(const char *str, const char *suffix)
+{
+    size_t str_len = strlen(str), suffix_len = strlen(suffix);
+
+    return str_len >= suffix_len
+           && !strcmp(str + str_len - suffix_len, suffix);
+}
+
+static void
+dump_sampling_profile(const char *path)
+{
+    wasm_sampling_profile_format_t format = WASM_SAMPLING_PROFILE_FOLDED;
+    char *buf;
+    uint32 len;
+    FILE *file;
+
+    if (ends_with(path, ".pb") || ends_with(path, ".pprof"))
+        format = WASM_SAMPLING_PROFILE_PPROF;
+
+    if (!(len = wasm_runtime_get_sampling_profile_size(format))) {
+        printf("no sample was taken\n");
+        return;
+    }
+
+    if (!(buf = wasm_runtime_malloc(len))) {
+        printf("allocate memory failed\n");
+        return;
+    }
+
+    if (len != wasm_runtime_dump_sampling_profile_to_buf(format, buf, len)) {
+        printf("failed to dump sampling profile\n");
+        wasm_runtime_free(buf);
+        return;
+    }
+
+    if (!(file = fopen(path, "wb"))) {
+        printf("failed to create file %s\n", path);
+        wasm_runtime_free(buf);
+        return;
+    }
+    fwrite(buf, len, 1, file);
+    fclose(file);
+
+    wasm_runtime_free(buf);
+
+    printf("Sampling profile file %s was generated.\n", path);
+}
+#endif
+
 #if WASM_ENABLE_STATIC_PGO != 0
 static void
 dump_pgo_prof_data(wasm_module_inst_t module_inst, const char *path)
@@ -532,6 +622,77 @@ dump_pgo_prof_data(wasm_module_inst_t module_inst, const char *path)
 }
 #endif
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+static void
+dump_interp_prof_data(wasm_module_inst_t module_inst, const char *path)
+{
+    char *buf;
+    uint32 len;
+    FILE *file;
+
+    if (!(len = wasm_runtime_get_interp_prof_data_size(module_inst))) {
+        printf("failed to get interpreter profile data size\n");
+        return;
+    }
+
+    if (!(buf = wasm_runtime_malloc(len))) {
+        printf("allocate memory failed\n");
+        return;
+    }
+
+    if (len
+        != wasm_runtime_dump_interp_prof_data_to_buf(module_inst, buf, len)) {
+        printf("failed to dump interpreter profile data\n");
+        wasm_runtime_free(buf);
+        return;
+    }
+
+    if (!(file = fopen(path, "wb"))) {
+        printf("failed to create file %s\n", path);
+        wasm_runtime_free(buf);
+        return;
+    }
+    fwrite(buf, len, 1, file);
+    fclose(file);
+
+    wasm_runtime_free(buf);
+
+    printf("Interpreter profile file %s was generated.\n", path);
+}
+#endif
+
+#if WASM_ENABLE_PREPARED_MODULE != 0
+static bool
+gen_prepared_module(uint8 *wasm_file_buf, uint32 wasm_file_size,
+                    const char *path)
+{
+    char error_buf[128] = { 0 };
+    uint8 *buf;
+    uint32 len;
+    FILE *file;
+
+    if (!(buf = wasm_runtime_prepare_module(wasm_file_buf, wasm_file_size,
+                                            &len, error_buf,
+                                            sizeof(error_buf)))) {
+        printf("%s\n", error_buf);
+        return false;
+    }
+
+    if (!(file = fopen(path, "wb"))) {
+        printf("failed to create file %s\n", path);
+        wasm_runtime_free(buf);
+        return false;
+    }
+    fwrite(buf, len, 1, file);
+    fclose(file);
+
+    wasm_runtime_free(buf);
+
+    printf("Prepared module %s was generated.\n", path);
+    return true;
+}
+#endif
+
 #if WASM_ENABLE_THREAD_MGR != 0
 struct timeout_arg {
     uint32 timeout_ms;
@@ -582,6 +743,9 @@ main(int argc, char *argv[])
 #else
     uint32 heap_size = 16 * 1024;
 #endif
+#if WASM_ENABLE_HEAP_TRIM != 0
+    uint32 heap_trim_threshold = HEAP_TRIM_THRESHOLD_DEFAULT;
+#endif
 #if WASM_ENABLE_SHARED_HEAP != 0
     SharedHeapInitArgs shared_heap_init_args;
     uint32 shared_heap_size = 0;
@@ -631,6 +795,24 @@ main(int argc, char *argv[])
 #if WASM_ENABLE_STATIC_PGO != 0
     const char *gen_prof_file = NULL;
 #endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    const char *profile_file = NULL;
+    uint32 profile_interval_us = 10000;
+#endif
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    const char *gen_interp_prof_file = NULL;
+#endif
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    const char *gen_prepared_module_file = NULL;
+#endif
+    LoadArgs load_args = { 0 };
+    huge_page_policy_t huge_page_policy = HUGE_PAGE_POLICY_DEFAULT;
+    memory_prefault_policy_t memory_prefault_policy =
+        MEMORY_PREFAULT_POLICY_LAZY;
+#if WASM_ENABLE_NUMA != 0
+    int numa_node = -1;
+    bool numa_pin_threads = false;
+#endif
 #if WASM_ENABLE_THREAD_MGR != 0
     int timeout_ms = -1;
 #endif
@@ -694,6 +876,54 @@ main(int argc, char *argv[])
                 return print_help();
             heap_size = atoi(argv[0] + 12);
         }
+#if WASM_ENABLE_HEAP_TRIM != 0
+        else if (!strncmp(argv[0], "--heap-trim-threshold=", 22)) {
+            if (argv[0][22] == '\0')
+                return print_help();
+            heap_trim_threshold = atoi(argv[0] + 22);
+        }
+#endif
+        else if (!strncmp(argv[0], "--huge-page=", 12)) {
+            const char *policy = argv[0] + 12;
+
+            if (!strcmp(policy, "default"))
+                huge_page_policy = HUGE_PAGE_POLICY_DEFAULT;
+            else if (!strcmp(policy, "none"))
+                huge_page_policy = HUGE_PAGE_POLICY_NONE;
+            else if (!strcmp(policy, "thp"))
+                huge_page_policy = HUGE_PAGE_POLICY_THP;
+            else if (!strcmp(policy, "hugetlb"))
+                huge_page_policy = HUGE_PAGE_POLICY_HUGETLB;
+            else
+                return print_help();
+        }
+        else if (!strncmp(argv[0], "--memory-prefault=", 18)) {
+            const char *policy = argv[0] + 18;
+
+            if (!strcmp(policy, "lazy"))
+                memory_prefault_policy = MEMORY_PREFAULT_POLICY_LAZY;
+            else if (!strcmp(policy, "eager"))
+                memory_prefault_policy = MEMORY_PREFAULT_POLICY_EAGER;
+            else if (!strcmp(policy, "background"))
+                memory_prefault_policy = MEMORY_PREFAULT_POLICY_BACKGROUND;
+            else
+                return print_help();
+        }
+#if WASM_ENABLE_AOT != 0
+        else if (!strcmp(argv[0], "--huge-page-text")) {
+            load_args.huge_page_text = true;
+        }
+#endif
+#if WASM_ENABLE_NUMA != 0
+        else if (!strncmp(argv[0], "--numa-node=", 12)) {
+            if (argv[0][12] == '\0')
+                return print_help();
+            numa_node = atoi(argv[0] + 12);
+        }
+        else if (!strcmp(argv[0], "--numa-pin-threads")) {
+            numa_pin_threads = true;
+        }
+#endif
 #if WASM_ENABLE_SHARED_HEAP != 0
         else if (!strncmp(argv[0], "--shared-heap-size=", 19)) {
             if (argv[0][19] == '\0')
@@ -815,6 +1045,37 @@ main(int argc, char *argv[])
                 return print_help();
             gen_prof_file = argv[0] + 16;
         }
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+        else if (!strncmp(argv[0], "--profile=", 10)) {
+            if (argv[0][10] == '\0')
+                return print_help();
+            profile_file = argv[0] + 10;
+        }
+        else if (!strncmp(argv[0], "--profile-interval=", 19)) {
+            if (argv[0][19] == '\0')
+                return print_help();
+            profile_interval_us = atoi(argv[0] + 19);
+            if (profile_interval_us == 0)
+                return print_help();
+        }
+#endif
+#if WASM_ENABLE_INTERP_PROFILING != 0
+        else if (!strncmp(argv[0], "--gen-interp-prof-file=", 23)) {
+            if (argv[0][23] == '\0')
+                return print_help();
+            gen_interp_prof_file = argv[0] + 23;
+        }
+#endif
+#if WASM_ENABLE_PREPARED_MODULE != 0
+        else if (!strncmp(argv[0], "--gen-prepared-module=", 22)) {
+            if (argv[0][22] == '\0')
+                return print_help();
+            gen_prepared_module_file = argv[0] + 22;
+        }
+        else if (!strcmp(argv[0], "--use-prepared-module")) {
+            load_args.use_prepared_code = true;
+        }
 #endif
         else if (!strcmp(argv[0], "--version")) {
             uint32 major, minor, patch;
@@ -946,9 +1207,21 @@ main(int argc, char *argv[])
                                    module_destroyer_callback);
 #endif
 
+#if WASM_ENABLE_PREPARED_MODULE != 0
+    if (gen_prepared_module_file) {
+        if (gen_prepared_module(wasm_file_buf, wasm_file_size,
+                                gen_prepared_module_file))
+            ret = 0;
+        goto fail2;
+    }
+#endif
+
     /* load WASM module */
-    if (!(wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
-                                          error_buf, sizeof(error_buf)))) {
+    load_args.name = "";
+    wasm_module = wasm_runtime_load_ex(wasm_file_buf, wasm_file_size,
+                                       &load_args, error_buf,
+                                       sizeof(error_buf));
+    if (!wasm_module) {
         printf("%s\n", error_buf);
         goto fail2;
     }
@@ -970,6 +1243,19 @@ main(int argc, char *argv[])
                                                            stack_size);
     wasm_runtime_instantiation_args_set_host_managed_heap_size(inst_args,
                                                                heap_size);
+    wasm_runtime_instantiation_args_set_huge_page_policy(inst_args,
+                                                         huge_page_policy);
+    wasm_runtime_instantiation_args_set_memory_prefault_policy(
+        inst_args, memory_prefault_policy);
+#if WASM_ENABLE_NUMA != 0
+    wasm_runtime_instantiation_args_set_numa_node(inst_args, numa_node);
+    wasm_runtime_instantiation_args_set_numa_pin_threads(inst_args,
+                                                         numa_pin_threads);
+    if (numa_node >= 0 && numa_pin_threads
+        && os_thread_bind_numa_node(numa_node) != 0) {
+        printf("failed to pin the main thread to NUMA node %d\n", numa_node);
+    }
+#endif
 #if WASM_ENABLE_LIBC_WASI != 0
     libc_wasi_set_init_args(inst_args, argc, argv, &wasi_parse_ctx);
 #endif
@@ -983,6 +1269,11 @@ main(int argc, char *argv[])
         goto fail3;
     }
 
+#if WASM_ENABLE_HEAP_TRIM != 0
+    wasm_runtime_set_app_heap_trim_threshold(wasm_module_inst,
+                                             heap_trim_threshold);
+#endif
+
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     if (disable_bounds_checks) {
         wasm_runtime_set_bounds_checks(wasm_module_inst, false);
@@ -1041,6 +1332,14 @@ main(int argc, char *argv[])
     }
 #endif
 
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    if (profile_file
+        && !wasm_runtime_start_sampling_profiler(profile_interval_us, 0)) {
+        printf("Start sampling profiler failed\n");
+        profile_file = NULL;
+    }
+#endif
+
     ret = 0;
     const char *exception = NULL;
     if (is_repl_mode) {
@@ -1071,12 +1370,25 @@ main(int argc, char *argv[])
     if (exception)
         printf("%s\n", exception);
 
+#if WASM_ENABLE_SAMPLING_PROFILING != 0
+    if (profile_file) {
+        wasm_runtime_stop_sampling_profiler();
+        dump_sampling_profile(profile_file);
+    }
+#endif
+
 #if WASM_ENABLE_STATIC_PGO != 0 && WASM_ENABLE_AOT != 0
     if (get_package_type(wasm_file_buf, wasm_file_size) == Wasm_Module_AoT
         && gen_prof_file)
         dump_pgo_prof_data(wasm_module_inst, gen_prof_file);
 #endif
 
+#if WASM_ENABLE_INTERP_PROFILING != 0
+    if (get_package_type(wasm_file_buf, wasm_file_size) == Wasm_Module_Bytecode
+        && gen_interp_prof_file)
+        dump_interp_prof_data(wasm_module_inst, gen_interp_prof_file);
+#endif
+
 #if WASM_ENABLE_THREAD_MGR != 0
     if (timeout_ms >= 0) {
         timeout_arg.cancel = true;
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "wasm_export.h"
+
+/*
+ * The module is assembled from:
+ *
+ * (module
+ *   (import "env" "rpc" (func $rpc (param i32) (result i32)))
+ *   (func (export "run_rpc") (param $n i32) (result i32)
+ *     (local $acc i32)
+ *     (block
+ *       (loop
+ *         (br_if 1 (i32.eqz (local.get $n)))
+ *         (local.set $acc (i32.add (local.get $acc)
+ *                                  (call $rpc (local.get $n))))
+ *         (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+ *         (br 0)))
+ *     (local.get $acc)))
+ */
+static uint8_t wasm_bytes[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x0b, 0x01, 0x03, 0x65, 0x6e, 0x76, 0x03,
+    0x72, 0x70, 0x63, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x0b, 0x01,
+    0x07, 0x72, 0x75, 0x6e, 0x5f, 0x72, 0x70, 0x63, 0x00, 0x01, 0x0a, 0x25,
+    0x01, 0x23, 0x01, 0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x45,
+    0x0d, 0x01, 0x20, 0x01, 0x20, 0x00, 0x10, 0x00, 0x6a, 0x21, 0x01, 0x20,
+    0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01,
+    0x0b,
+};
+
+#define EXEC_ENV_STACK_SIZE (4 * 1024)
+
+typedef struct Request {
+    struct Request *next;
+    wasm_async_op_t op;
+    int32_t value;
+} Request;
+
+/* A fake RPC server: it answers all the pending requests with their
+   values doubled after the latency */
+static pthread_mutex_t server_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t server_cond = PTHREAD_COND_INITIALIZER;
+static Request *pending_requests;
+static bool server_exiting;
+static uint32_t latency_us = 1000;
+
+typedef struct Instance {
+    wasm_module_inst_t module_inst;
+    wasm_exec_env_t exec_env;
+    wasm_function_inst_t func;
+    uint32_t argv[1];
+    wasm_task_t task;
+} Instance;
+
+static uint64_t
+time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *
+server_routine(void *arg)
+{
+    Request *requests, *request;
+
+    (void)arg;
+    pthread_mutex_lock(&server_lock);
+    while (!server_exiting) {
+        if (!pending_requests) {
+            pthread_cond_wait(&server_cond, &server_lock);
+            continue;
+        }
+        requests = pending_requests;
+        pending_requests = NULL;
+        pthread_mutex_unlock(&server_lock);
+
+        usleep(latency_us);
+        while ((request = requests)) {
+            requests = request->next;
+            wasm_runtime_complete_async_op(request->op,
+                                           (uint64_t)request->value * 2);
+            free(request);
+        }
+
+        pthread_mutex_lock(&server_lock);
+    }
+    pthread_mutex_unlock(&server_lock);
+    return NULL;
+}
+
+static int32_t
+rpc_wrapper(wasm_exec_env_t exec_env, int32_t value)
+{
+    Request *request;
+    wasm_async_op_t op;
+
+    if (!(request = malloc(sizeof(Request))))
+        return -1;
+    if (!(op = wasm_runtime_create_async_op(exec_env))) {
+        free(request);
+        return -1;
+    }
+
+    request->op = op;
+    request->value = value;
+    pthread_mutex_lock(&server_lock);
+    request->next = pending_requests;
+    pending_requests = request;
+    pthread_cond_signal(&server_cond);
+    pthread_mutex_unlock(&server_lock);
+
+    /* The calling task is switched out until the server answers */
+    return (int32_t)wasm_runtime_await_async_op(exec_env, op);
+}
+
+static NativeSymbol native_symbols[] = {
+    { "rpc", rpc_wrapper, "(i)i", NULL },
+};
+
+static void
+print_usage(void)
+{
+    printf("Usage: async_rpc [-n instance_num] [-w worker_num] "
+           "[-r rpc_num] [-l latency_us]\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint32_t instance_num = 10000, worker_num = 1, rpc_num = 10;
+    uint32_t spawned_num = 0, failed_num = 0, i;
+    bool ret = false;
+    RuntimeInitArgs init_args;
+    wasm_module_t module = NULL;
+    Instance *insts = NULL;
+    pthread_t server_tid;
+    uint64_t start, elapsed;
+    char error_buf[128];
+
+    for (i = 1; i < (uint32_t)argc; i++) {
+        if (i + 1 < (uint32_t)argc && argv[i][0] == '-') {
+            uint32_t value = (uint32_t)atoi(argv[++i]);
+            switch (argv[i - 1][1]) {
+                case 'n':
+                    instance_num = value;
+                    break;
+                case 'w':
+                    worker_num = value;
+                    break;
+                case 'r':
+                    rpc_num = value;
+                    break;
+                case 'l':
+                    latency_us = value;
+                    break;
+                default:
+                    print_usage();
+                    return -1;
+            }
+        }
+        else {
+            print_usage();
+            return -1;
+        }
+    }
+
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    init_args.native_module_name = "env";
+    init_args.native_symbols = native_symbols;
+    init_args.n_native_symbols =
+        sizeof(native_symbols) / sizeof(NativeSymbol);
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("Init runtime environment failed.\n");
+        return -1;
+    }
+
+    if (!wasm_runtime_init_task_scheduler(worker_num, 0)) {
+        printf("Init task scheduler failed.\n");
+        goto fail1;
+    }
+
+    if (pthread_create(&server_tid, NULL, server_routine, NULL) != 0) {
+        printf("Create server thread failed.\n");
+        goto fail2;
+    }
+
+    if (!(module = wasm_runtime_load(wasm_bytes, sizeof(wasm_bytes),
+                                     error_buf, sizeof(error_buf)))) {
+        printf("Load wasm module failed. error: %s\n", error_buf);
+        goto fail3;
+    }
+
+    if (!(insts = calloc(instance_num, sizeof(Instance)))) {
+        printf("Allocate memory failed.\n");
+        goto fail4;
+    }
+
+    for (i = 0; i < instance_num; i++) {
+        Instance *inst = &insts[i];
+
+        if (!(inst->module_inst = wasm_runtime_instantiate(
+                  module, 0, 0, error_buf, sizeof(error_buf)))) {
+            printf("Instantiate wasm module %u failed. error: %s\n", i,
+                   error_buf);
+            goto fail5;
+        }
+        if (!(inst->exec_env = wasm_runtime_create_exec_env(
+                  inst->module_inst, EXEC_ENV_STACK_SIZE))) {
+            printf("Create exec env %u failed.\n", i);
+            goto fail5;
+        }
+        inst->func =
+            wasm_runtime_lookup_function(inst->module_inst, "run_rpc");
+        inst->argv[0] = rpc_num;
+    }
+
+    start = time_us();
+    for (; spawned_num < instance_num; spawned_num++) {
+        Instance *inst = &insts[spawned_num];
+
+        if (!(inst->task = wasm_runtime_spawn_task(inst->exec_env, inst->func,
+                                                   1, inst->argv))) {
+            printf("Spawn task %u failed.\n", spawned_num);
+            break;
+        }
+    }
+    for (i = 0; i < spawned_num; i++) {
+        Instance *inst = &insts[i];
+
+        if (!wasm_runtime_join_task(inst->task)) {
+            printf("%s\n", wasm_runtime_get_exception(inst->module_inst));
+            failed_num++;
+        }
+        else if (inst->argv[0] != rpc_num * (rpc_num + 1)) {
+            printf("Instance %u got wrong result %u.\n", i, inst->argv[0]);
+            failed_num++;
+        }
+    }
+    elapsed = time_us() - start;
+
+    printf("Ran %u instances on %u worker threads: %.3f s, %.0f rpcs/s, "
+           "%u failed\n",
+           spawned_num, worker_num, elapsed / 1e6,
+           (double)spawned_num * rpc_num * 1e6 / elapsed, failed_num);
+    ret = failed_num == 0;
+
+fail5:
+    for (i = 0; i < instance_num; i++) {
+        if (insts[i].exec_env)
+            wasm_runtime_destroy_exec_env(insts[i].exec_env);
+        if (insts[i].module_inst)
+            wasm_runtime_deinstantiate(insts[i].module_inst);
+    }
+    free(insts);
+fail4:
+    wasm_runtime_unload(module);
+fail3:
+    pthread_mutex_lock(&server_lock);
+    server_exiting = true;
+    pthread_cond_signal(&server_cond);
+    pthread_mutex_unlock(&server_lock);
+    pthread_join(server_tid, NULL);
+fail2:
+    wasm_runtime_destroy_task_scheduler();
+fail1:
+    wasm_runtime_destroy();
+    return ret ? 0 : -1;
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "wasm_export.h"
+
+/*
+ * The module is assembled from:
+ *
+ * (module
+ *   (memory 1 1 shared)
+ *   (func (export "run") (param $rounds i32) (param $iters i32)
+ *                        (param $timeout i64) (result i32)
+ *     (local $acc i32) (local $i i32)
+ *     (block
+ *       (loop
+ *         (br_if 1 (i32.eqz (local.get $rounds)))
+ *         (local.set $i (local.get $iters))
+ *         (block
+ *           (loop
+ *             (br_if 1 (i32.eqz (local.get $i)))
+ *             (local.set $acc (i32.add (i32.mul (local.get $acc)
+ *                                               (i32.const 31))
+ *                                      (local.get $i)))
+ *             (local.set $i (i32.sub (local.get $i) (i32.const 1)))
+ *             (br 0)))
+ *         (drop (memory.atomic.wait32 (i32.const 0) (i32.const 0)
+ *                                     (local.get $timeout)))
+ *         (local.set $rounds (i32.sub (local.get $rounds) (i32.const 1)))
+ *         (br 0)))
+ *     (local.get $acc)))
+ */
+static uint8_t wasm_bytes[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x01, 0x60,
+    0x03, 0x7f, 0x7f, 0x7e, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x05, 0x04,
+    0x01, 0x03, 0x01, 0x01, 0x07, 0x07, 0x01, 0x03, 0x72, 0x75, 0x6e, 0x00,
+    0x00, 0x0a, 0x49, 0x01, 0x47, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40,
+    0x20, 0x00, 0x45, 0x0d, 0x01, 0x20, 0x01, 0x21, 0x04, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x04, 0x45, 0x0d, 0x01, 0x20, 0x03, 0x41, 0x1f, 0x6c, 0x20,
+    0x04, 0x6a, 0x21, 0x03, 0x20, 0x04, 0x41, 0x01, 0x6b, 0x21, 0x04, 0x0c,
+    0x00, 0x0b, 0x0b, 0x41, 0x00, 0x41, 0x00, 0x20, 0x02, 0xfe, 0x01, 0x02,
+    0x00, 0x1a, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b,
+    0x0b, 0x20, 0x03, 0x0b,
+};
+
+#define EXEC_ENV_STACK_SIZE (4 * 1024)
+
+typedef struct Instance {
+    wasm_module_inst_t module_inst;
+    wasm_exec_env_t exec_env;
+    wasm_function_inst_t func;
+    uint32_t argv[4];
+    wasm_task_t task;
+    pthread_t tid;
+} Instance;
+
+static uint64_t
+time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *
+thread_routine(void *arg)
+{
+    Instance *inst = (Instance *)arg;
+
+    if (!wasm_runtime_init_thread_env())
+        return NULL;
+    if (!wasm_runtime_call_wasm(inst->exec_env, inst->func, 4, inst->argv))
+        printf("%s\n", wasm_runtime_get_exception(inst->module_inst));
+    wasm_runtime_destroy_thread_env();
+    return NULL;
+}
+
+static void
+print_usage(void)
+{
+    printf("Usage: task_scheduler [-n instance_num] [-w worker_num] "
+           "[-r rounds] [-i iterations] [-s timeout_us] [-t]\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint32_t instance_num = 100000, worker_num = 4, rounds = 10;
+    uint32_t iterations = 1000, timeout_us = 1000, spawned_num = 0, i;
+    bool use_thread = false, ret = false;
+    RuntimeInitArgs init_args;
+    wasm_module_t module = NULL;
+    Instance *insts = NULL;
+    uint64_t timeout_ns, start, elapsed;
+    char error_buf[128];
+
+    for (i = 1; i < (uint32_t)argc; i++) {
+        if (!strcmp(argv[i], "-t")) {
+            use_thread = true;
+        }
+        else if (i + 1 < (uint32_t)argc && argv[i][0] == '-') {
+            uint32_t value = (uint32_t)atoi(argv[++i]);
+            switch (argv[i - 1][1]) {
+                case 'n':
+                    instance_num = value;
+                    break;
+                case 'w':
+                    worker_num = value;
+                    break;
+                case 'r':
+                    rounds = value;
+                    break;
+                case 'i':
+                    iterations = value;
+                    break;
+                case 's':
+                    timeout_us = value;
+                    break;
+                default:
+                    print_usage();
+                    return -1;
+            }
+        }
+        else {
+            print_usage();
+            return -1;
+        }
+    }
+
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("Init runtime environment failed.\n");
+        return -1;
+    }
+
+    if (!use_thread && !wasm_runtime_init_task_scheduler(worker_num, 0)) {
+        printf("Init task scheduler failed.\n");
+        goto fail1;
+    }
+
+    if (!(module = wasm_runtime_load(wasm_bytes, sizeof(wasm_bytes),
+                                     error_buf, sizeof(error_buf)))) {
+        printf("Load wasm module failed. error: %s\n", error_buf);
+        goto fail2;
+    }
+
+    if (!(insts = calloc(instance_num, sizeof(Instance)))) {
+        printf("Allocate memory failed.\n");
+        goto fail3;
+    }
+
+    start = time_us();
+    timeout_ns = (uint64_t)timeout_us * 1000;
+    for (i = 0; i < instance_num; i++) {
+        Instance *inst = &insts[i];
+
+        if (!(inst->module_inst = wasm_runtime_instantiate(
+                  module, 0, 0, error_buf, sizeof(error_buf)))) {
+            printf("Instantiate wasm module %u failed. error: %s\n", i,
+                   error_buf);
+            goto fail4;
+        }
+        if (!(inst->exec_env = wasm_runtime_create_exec_env(
+                  inst->module_inst, EXEC_ENV_STACK_SIZE))) {
+            printf("Create exec env %u failed.\n", i);
+            goto fail4;
+        }
+        inst->func = wasm_runtime_lookup_function(inst->module_inst, "run");
+        inst->argv[0] = rounds;
+        inst->argv[1] = iterations;
+        memcpy(&inst->argv[2], &timeout_ns, sizeof(uint64_t));
+    }
+    printf("Instantiated %u instances in %.3f s\n", instance_num,
+           (time_us() - start) / 1e6);
+
+    start = time_us();
+    for (; spawned_num < instance_num; spawned_num++) {
+        Instance *inst = &insts[spawned_num];
+
+        if (use_thread) {
+            if (pthread_create(&inst->tid, NULL, thread_routine, inst) != 0) {
+                printf("Create thread %u failed.\n", spawned_num);
+                break;
+            }
+        }
+        else if (!(inst->task = wasm_runtime_spawn_task(
+                       inst->exec_env, inst->func, 4, inst->argv))) {
+            printf("Spawn task %u failed.\n", spawned_num);
+            break;
+        }
+    }
+    for (i = 0; i < spawned_num; i++) {
+        Instance *inst = &insts[i];
+
+        if (use_thread)
+            pthread_join(inst->tid, NULL);
+        else if (!wasm_runtime_join_task(inst->task))
+            printf("%s\n", wasm_runtime_get_exception(inst->module_inst));
+    }
+    elapsed = time_us() - start;
+
+    printf("Ran %u instances with %s: %.3f s, %.0f rounds/s\n", spawned_num,
+           use_thread ? "OS threads" : "tasks", elapsed / 1e6,
+           (double)spawned_num * rounds * 1e6 / elapsed);
+    ret = true;
+
+fail4:
+    for (i = 0; i < instance_num; i++) {
+        if (insts[i].exec_env)
+            wasm_runtime_destroy_exec_env(insts[i].exec_env);
+        if (insts[i].module_inst)
+            wasm_runtime_deinstantiate(insts[i].module_inst);
+    }
+    free(insts);
+fail3:
+    wasm_runtime_unload(module);
+fail2:
+    if (!use_thread)
+        wasm_runtime_destroy_task_scheduler();
+fail1:
+    wasm_runtime_destroy();
+    return ret ? 0 : -1;
+}
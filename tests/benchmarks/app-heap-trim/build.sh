@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+WAMRC_CMD=$PWD/../../../wamr-compiler/build/wamrc
+
+echo "===> compile app_heap_trim src to app_heap_trim.wasm"
+/opt/wasi-sdk/bin/clang -O3 -o app_heap_trim.wasm src/app_heap_trim.c
+
+echo "===> compile app_heap_trim.wasm to app_heap_trim.aot"
+${WAMRC_CMD} -o app_heap_trim.aot app_heap_trim.wasm
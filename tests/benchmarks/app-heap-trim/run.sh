@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+
+readonly IWASM_CMD="../../../product-mini/platforms/${PLATFORM}/build/iwasm"
+
+TOTAL_MB=${TOTAL_MB:-256}
+BLOCK_SIZES=${BLOCK_SIZES:-"1048576 4096"}
+CYCLES=${CYCLES:-3}
+HOLD_MS=${HOLD_MS:-1000}
+THRESHOLDS=${THRESHOLDS:-"0 131072"}
+INTERVAL=${INTERVAL:-0.1}
+
+HEAP_SIZE=$(((TOTAL_MB + TOTAL_MB / 4 + 16) * 1024 * 1024))
+
+# Sample the resident memory of the process every INTERVAL seconds until
+# it exits
+sample_rss() {
+    local pid=$1
+    local start=$(date +%s%N)
+
+    while kill -0 ${pid} 2>/dev/null; do
+        rss=$(awk '/^VmRSS:/ { print $2 }' /proc/${pid}/status 2>/dev/null)
+        [ -n "${rss}" ] && \
+            echo "$((($(date +%s%N) - start) / 1000000)) ms: rss ${rss} KB"
+        sleep ${INTERVAL}
+    done
+}
+
+for block_size in ${BLOCK_SIZES}; do
+    for threshold in ${THRESHOLDS}; do
+        echo "============> run app_heap_trim.aot, block size ${block_size}," \
+             "heap trim threshold ${threshold}"
+        ${IWASM_CMD} --heap-size=${HEAP_SIZE} \
+            --heap-trim-threshold=${threshold} app_heap_trim.aot \
+            ${TOTAL_MB} ${block_size} ${CYCLES} ${HOLD_MS} &
+        sample_rss $!
+        wait
+    done
+done
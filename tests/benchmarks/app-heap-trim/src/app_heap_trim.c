@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Allocates and frees memory in cycles from the app heap of the runtime,
+   which is imported from libc-builtin, so that the resident memory of the
+   runtime can be sampled while the allocations are held and after they
+   are freed */
+
+__attribute__((import_module("env"), import_name("malloc"))) void *
+app_heap_malloc(size_t size);
+
+__attribute__((import_module("env"), import_name("free"))) void
+app_heap_free(void *ptr);
+
+static double
+now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void
+sleep_ms(int ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+
+    nanosleep(&ts, NULL);
+}
+
+int
+main(int argc, char **argv)
+{
+    int total_mb, block_size, cycles, hold_ms, i, j, block_count;
+    void **blocks;
+    double start;
+
+    if (argc < 5) {
+        printf("Usage: %s total_mb block_size cycles hold_ms\n", argv[0]);
+        return 1;
+    }
+
+    total_mb = atoi(argv[1]);
+    block_size = atoi(argv[2]);
+    cycles = atoi(argv[3]);
+    hold_ms = atoi(argv[4]);
+    if (total_mb <= 0 || block_size <= 0 || cycles <= 0 || hold_ms < 0) {
+        printf("Invalid arguments\n");
+        return 1;
+    }
+
+    block_count = (int)((long long)total_mb * 1024 * 1024 / block_size);
+    if (!(blocks = calloc(block_count, sizeof(void *)))) {
+        printf("Allocate memory failed\n");
+        return 1;
+    }
+
+    start = now_ms();
+    for (i = 0; i < cycles; i++) {
+        for (j = 0; j < block_count; j++) {
+            if (!(blocks[j] = app_heap_malloc(block_size))) {
+                printf("Allocate from the app heap failed\n");
+                return 1;
+            }
+            memset(blocks[j], j, block_size);
+        }
+        printf("%.0f ms: cycle %d allocated %d MB\n", now_ms() - start, i,
+               total_mb);
+        fflush(stdout);
+        sleep_ms(hold_ms);
+
+        for (j = 0; j < block_count; j++)
+            app_heap_free(blocks[j]);
+        printf("%.0f ms: cycle %d freed %d MB\n", now_ms() - start, i,
+               total_mb);
+        fflush(stdout);
+        sleep_ms(hold_ms);
+    }
+
+    free(blocks);
+    return 0;
+}
@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+WAMRC_CMD=$PWD/../../../wamr-compiler/build/wamrc
+
+echo "===> compile memory_grow_latency src to memory_grow_latency.wasm"
+/opt/wasi-sdk/bin/clang -O3 \
+    -z stack-size=65536 \
+    -Wl,--max-memory=4294967296 \
+    -Wl,--export=__heap_base,--export=__data_end \
+    -o memory_grow_latency.wasm src/memory_grow_latency.c
+
+echo "===> compile memory_grow_latency.wasm to memory_grow_latency.aot"
+${WAMRC_CMD} -o memory_grow_latency.aot memory_grow_latency.wasm
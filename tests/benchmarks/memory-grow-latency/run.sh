@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+
+readonly IWASM_CMD="../../../product-mini/platforms/${PLATFORM}/build/iwasm"
+
+REQUESTS=${REQUESTS:-2000}
+PAGES_PER_REQUEST=${PAGES_PER_REQUEST:-16}
+WAIT_US=${WAIT_US:-1000}
+
+for policy in lazy eager background; do
+    echo "============> --memory-prefault=${policy}"
+    ${IWASM_CMD} --memory-prefault=${policy} memory_grow_latency.aot \
+        ${REQUESTS} ${PAGES_PER_REQUEST} ${WAIT_US}
+done
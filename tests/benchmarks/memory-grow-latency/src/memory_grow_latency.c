@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Simulates the requests of an app which grows the linear memory for each
+   request, waits for its input, e.g. from the network, and then fills the
+   new pages, the latency of a request is the time spent in memory.grow and
+   in filling the pages */
+
+#define WASM_PAGE_SIZE 65536
+#define OS_PAGE_SIZE 4096
+
+static double
+now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int
+compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+int
+main(int argc, char **argv)
+{
+    int request_count, pages_per_request, wait_us, i;
+    double *latencies, total = 0, start;
+    volatile uint8_t *p, *end;
+    struct timespec ts;
+    size_t old_pages;
+
+    if (argc < 4) {
+        printf("Usage: %s request_count pages_per_request wait_us\n",
+               argv[0]);
+        return 1;
+    }
+
+    request_count = atoi(argv[1]);
+    pages_per_request = atoi(argv[2]);
+    wait_us = atoi(argv[3]);
+    if (request_count <= 0 || pages_per_request <= 0 || wait_us < 0) {
+        printf("Invalid arguments\n");
+        return 1;
+    }
+
+    if (!(latencies = malloc(sizeof(double) * request_count))) {
+        printf("Allocate memory failed\n");
+        return 1;
+    }
+
+    ts.tv_sec = wait_us / 1000000;
+    ts.tv_nsec = (wait_us % 1000000) * 1000L;
+
+    for (i = 0; i < request_count; i++) {
+        start = now_us();
+        old_pages = __builtin_wasm_memory_grow(0, pages_per_request);
+        if (old_pages == (size_t)-1) {
+            printf("Grow memory failed at request %d\n", i);
+            return 1;
+        }
+        latencies[i] = now_us() - start;
+
+        if (wait_us > 0)
+            nanosleep(&ts, NULL);
+
+        /* Write each OS page of the new wasm pages */
+        start = now_us();
+        p = (volatile uint8_t *)(old_pages * WASM_PAGE_SIZE);
+        end = p + (size_t)pages_per_request * WASM_PAGE_SIZE;
+        for (; p < end; p += OS_PAGE_SIZE)
+            *p = 1;
+        latencies[i] += now_us() - start;
+        total += latencies[i];
+    }
+
+    qsort(latencies, request_count, sizeof(double), compare_double);
+    printf("mean %.1f us, p50 %.1f us, p99 %.1f us, p99.9 %.1f us, "
+           "max %.1f us\n",
+           total / request_count, latencies[request_count / 2],
+           latencies[(size_t)request_count * 99 / 100],
+           latencies[(size_t)request_count * 999 / 1000],
+           latencies[request_count - 1]);
+
+    free(latencies);
+    return 0;
+}
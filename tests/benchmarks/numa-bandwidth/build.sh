@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+WAMRC_CMD=$PWD/../../../wamr-compiler/build/wamrc
+
+echo "===> compile numa_bandwidth src to numa_bandwidth.wasm"
+/opt/wasi-sdk/bin/clang --target=wasm32-wasi-threads -O3 -pthread \
+    -z stack-size=65536 \
+    -Wl,--shared-memory,--max-memory=4294967296 \
+    -Wl,--export=__heap_base,--export=__data_end \
+    -o numa_bandwidth.wasm src/numa_bandwidth.c
+
+echo "===> compile numa_bandwidth.wasm to numa_bandwidth.aot"
+${WAMRC_CMD} --enable-multi-thread -o numa_bandwidth.aot numa_bandwidth.wasm
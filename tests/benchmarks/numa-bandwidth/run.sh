@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+
+readonly IWASM_CMD="../../../product-mini/platforms/${PLATFORM}/build/iwasm"
+
+THREADS=${THREADS:-4}
+MB_PER_THREAD=${MB_PER_THREAD:-256}
+ITERATIONS=${ITERATIONS:-20}
+HOLD_MS=${HOLD_MS:-1000}
+# The node which the threads run on, and the node which is remote to it
+LOCAL_NODE=${LOCAL_NODE:-0}
+REMOTE_NODE=${REMOTE_NODE:-1}
+
+if ! command -v numactl >/dev/null; then
+    echo "numactl is required"
+    exit 1
+fi
+
+OUTPUT=$(mktemp)
+
+# Print the pages of the linear memory per node when the app holds its
+# memory, the linear memory is the largest anonymous mapping other than
+# the native stack and the heap of the process
+show_placement() {
+    local pid=$1
+
+    while kill -0 ${pid} 2>/dev/null; do
+        if grep -q "^total:" ${OUTPUT}; then
+            awk '!/file=|stack|heap/ && / anon=/ {
+                     n = split($0, f, " ");
+                     pages = 0; nodes = "";
+                     for (i = 1; i <= n; i++) {
+                         if (f[i] ~ /^anon=/) pages = substr(f[i], 6);
+                         if (f[i] ~ /^N[0-9]+=/) nodes = nodes " " f[i];
+                     }
+                     if (pages + 0 > max) { max = pages + 0; line = $2 nodes; }
+                 }
+                 END { print "linear memory pages per node: " line }' \
+                /proc/${pid}/numa_maps
+            break
+        fi
+        sleep 0.1
+    done
+}
+
+run() {
+    local name=$1
+    local cpu_node=$2
+    local iwasm_args=$3
+    local numactl_cmd=""
+
+    echo "============> ${name}"
+    if [ -n "${cpu_node}" ]; then
+        numactl_cmd="numactl --cpunodebind=${cpu_node}"
+    fi
+    ${numactl_cmd} ${IWASM_CMD} ${iwasm_args} numa_bandwidth.aot \
+        ${THREADS} ${MB_PER_THREAD} ${ITERATIONS} ${HOLD_MS} > ${OUTPUT} &
+    show_placement $!
+    wait
+    cat ${OUTPUT}
+}
+
+# The threads float across the nodes, and the memory is faulted in from
+# the node which each thread happens to run on
+run "default" "" ""
+
+# The memory is bound to the node, and the main thread and the threads
+# spawned by the runtime are pinned to it
+run "local: --numa-node=${LOCAL_NODE} --numa-pin-threads" "" \
+    "--numa-node=${LOCAL_NODE} --numa-pin-threads"
+
+# The threads run on the node while the memory is bound to the remote node
+run "remote: --numa-node=${REMOTE_NODE}" "${LOCAL_NODE}" \
+    "--numa-node=${REMOTE_NODE}"
+
+rm -f ${OUTPUT}
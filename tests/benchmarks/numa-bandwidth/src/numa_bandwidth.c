@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Measures the memory bandwidth of the threads which read and write
+   their own buffers in the linear memory, the buffers are faulted in by
+   the threads which use them, so without NUMA binding their pages are
+   placed on the node which the threads happen to run on */
+
+typedef struct ThreadArg {
+    uint64_t *buf;
+    size_t count;
+    int iterations;
+    double seconds;
+    uint64_t sum;
+} ThreadArg;
+
+static double
+now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *
+thread_routine(void *arg)
+{
+    ThreadArg *targ = (ThreadArg *)arg;
+    uint64_t *buf = targ->buf, sum = 0;
+    size_t half = targ->count / 2, i;
+    double start;
+    int j;
+
+    /* Fault in the buffer */
+    memset(buf, 1, targ->count * sizeof(uint64_t));
+
+    start = now_s();
+    for (j = 0; j < targ->iterations; j++) {
+        /* Read the first half and write the second half */
+        for (i = 0; i < half; i++) {
+            sum += buf[i];
+            buf[half + i] = sum;
+        }
+    }
+    targ->seconds = now_s() - start;
+    targ->sum = sum;
+    return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+    int thread_count, mb_per_thread, iterations, hold_ms, i;
+    pthread_t *threads;
+    ThreadArg *args;
+    double total_mb, bandwidth, total_bandwidth = 0;
+    struct timespec ts;
+
+    if (argc < 5) {
+        printf("Usage: %s thread_count mb_per_thread iterations hold_ms\n",
+               argv[0]);
+        return 1;
+    }
+
+    thread_count = atoi(argv[1]);
+    mb_per_thread = atoi(argv[2]);
+    iterations = atoi(argv[3]);
+    hold_ms = atoi(argv[4]);
+    if (thread_count <= 0 || mb_per_thread <= 0 || iterations <= 0
+        || hold_ms < 0) {
+        printf("Invalid arguments\n");
+        return 1;
+    }
+
+    threads = calloc(thread_count, sizeof(pthread_t));
+    args = calloc(thread_count, sizeof(ThreadArg));
+    if (!threads || !args) {
+        printf("Allocate memory failed\n");
+        return 1;
+    }
+
+    for (i = 0; i < thread_count; i++) {
+        args[i].count = (size_t)mb_per_thread * 1024 * 1024 / sizeof(uint64_t);
+        args[i].iterations = iterations;
+        if (!(args[i].buf = malloc(args[i].count * sizeof(uint64_t)))) {
+            printf("Allocate buffer failed\n");
+            return 1;
+        }
+    }
+
+    for (i = 0; i < thread_count; i++) {
+        if (pthread_create(&threads[i], NULL, thread_routine, &args[i]) != 0) {
+            printf("Create thread failed\n");
+            return 1;
+        }
+    }
+
+    for (i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+        /* Each iteration reads and writes the buffer once */
+        total_mb = (double)mb_per_thread * iterations;
+        bandwidth = total_mb / args[i].seconds;
+        total_bandwidth += bandwidth;
+        printf("thread %d: %.1f MB/s (sum %llu)\n", i, bandwidth,
+               (unsigned long long)args[i].sum);
+    }
+    printf("total: %.1f MB/s\n", total_bandwidth);
+    fflush(stdout);
+
+    /* Keep the memory mapped so that its placement can be inspected */
+    ts.tv_sec = hold_ms / 1000;
+    ts.tv_nsec = (hold_ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+
+    for (i = 0; i < thread_count; i++)
+        free(args[i].buf);
+    free(args);
+    free(threads);
+    return 0;
+}
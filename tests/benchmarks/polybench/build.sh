@@ -8,6 +8,8 @@ PLATFORM=$(uname -s | tr A-Z a-z)
 OUT_DIR=$PWD/out
 WAMRC_CMD=$PWD/../../../wamr-compiler/build/wamrc
 POLYBENCH_CASES="datamining linear-algebra medley stencils"
+# MINI, SMALL, MEDIUM, STANDARD, LARGE or EXTRALARGE
+DATASET=${DATASET:-STANDARD}
 
 if [ ! -d PolyBenchC-4.2.1 ]; then
     git clone https://github.com/MatthiasJReisinger/PolyBenchC-4.2.1.git
@@ -29,14 +31,16 @@ do
 
         echo "Build ${file_name%.*}_native"
         gcc -O3 -I utilities -I ${file%/*} utilities/polybench.c ${file} \
-                -DPOLYBENCH_TIME -lm -o ${OUT_DIR}/${file_name%.*}_native
+                -DPOLYBENCH_TIME -D${DATASET}_DATASET -lm \
+                -o ${OUT_DIR}/${file_name%.*}_native
 
         echo "Build ${file_name%.*}.wasm"
         /opt/wasi-sdk/bin/clang -O3 -I utilities -I ${file%/*}      \
                 utilities/polybench.c ${file}                       \
                 -Wl,--export=__heap_base -Wl,--export=__data_end    \
                 -Wl,--export=malloc -Wl,--export=free               \
-                -DPOLYBENCH_TIME -o ${OUT_DIR}/${file_name%.*}.wasm \
+                -DPOLYBENCH_TIME -D${DATASET}_DATASET               \
+                -o ${OUT_DIR}/${file_name%.*}.wasm                  \
                 -D_WASI_EMULATED_PROCESS_CLOCKS
 
         echo "Compile ${file_name%.*}.wasm into ${file_name%.*}.aot"
@@ -0,0 +1,84 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Run the aot files with the huge page policies of iwasm and count the
+# TLB misses with perf, build the cases with `DATASET=LARGE ./build.sh`
+# to make the working sets larger than the TLB reach of the 4KB pages.
+# The hugetlb policy requires free pages in the huge page pool, e.g.
+#   echo 2048 | sudo tee /proc/sys/vm/nr_hugepages
+
+CUR_DIR=$PWD
+OUT_DIR=$CUR_DIR/out
+REPORT=$CUR_DIR/report.txt
+TIME=/usr/bin/time
+PERF=${PERF:-perf}
+PERF_EVENTS=${PERF_EVENTS:-dTLB-load-misses,dTLB-store-misses,iTLB-load-misses}
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+IWASM_CMD=$CUR_DIR/../../../product-mini/platforms/${PLATFORM}/build/iwasm
+
+BENCH_NAME_MAX_LEN=20
+
+POLYBENCH_CASES=${POLYBENCH_CASES:-"2mm 3mm adi atax bicg cholesky correlation \
+                 covariance deriche doitgen durbin fdtd-2d floyd-warshall \
+                 gemm gemver gesummv gramschmidt heat-3d jacobi-1d jacobi-2d \
+                 ludcmp lu mvt nussinov seidel-2d symm syr2k syrk trisolv trmm"}
+
+HUGE_PAGE_POLICIES="none thp hugetlb"
+
+if ! command -v ${PERF} > /dev/null; then
+    echo "${PERF} not found, please install linux perf"
+    exit 1
+fi
+
+rm -f $REPORT
+touch $REPORT
+
+function print_bench_name()
+{
+    name=$1
+    echo -en "$name" >> $REPORT
+    name_len=${#name}
+    if [ $name_len -lt $BENCH_NAME_MAX_LEN ]
+    then
+        spaces=$(( $BENCH_NAME_MAX_LEN - $name_len ))
+        for i in $(eval echo "{1..$spaces}"); do echo -n " " >> $REPORT; done
+    fi
+}
+
+# print the elapsed seconds and the counts of the events, separated by tabs
+function perf_stat()
+{
+    ${PERF} stat -x, -e ${PERF_EVENTS} -o perf.txt \
+        $TIME -f "%e" -o time.txt "$@" > /dev/null 2>&1
+    awk '{ ORS=""; print $1 }' time.txt >> $REPORT
+    awk -F, '!/^#/ && NF > 2 { ORS=""; print "\t" $1 }' perf.txt >> $REPORT
+    rm -f perf.txt time.txt
+}
+
+echo "Start to run cases, the result is written to report.txt"
+
+#run benchmarks
+cd $OUT_DIR
+echo -e "policy\ttime(s)\t${PERF_EVENTS//,/\\t}" >> $REPORT
+
+for t in $POLYBENCH_CASES
+do
+    print_bench_name $t
+    echo "" >> $REPORT
+
+    for policy in $HUGE_PAGE_POLICIES
+    do
+        echo "run $t with iwasm aot, huge page policy $policy .."
+        echo -en "  $policy\t" >> $REPORT
+        if [[ ${policy} == "none" ]]; then
+            perf_stat $IWASM_CMD --huge-page=none ${t}.aot
+        else
+            perf_stat $IWASM_CMD --huge-page=${policy} --huge-page-text \
+                      ${t}.aot
+        fi
+        echo "" >> $REPORT
+    done
+done
@@ -0,0 +1,17 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+
+WAMRC_CMD=$PWD/../../../wamr-compiler/build/wamrc
+
+echo "===> compile wasi_path src to wasi_path_native"
+gcc -O3 -o wasi_path_native src/wasi_path.c
+
+echo "===> compile wasi_path src to wasi_path.wasm"
+/opt/wasi-sdk/bin/clang -O3 -o wasi_path.wasm src/wasi_path.c
+
+echo "===> compile wasi_path.wasm to wasi_path.aot"
+${WAMRC_CMD} -o wasi_path.aot wasi_path.wasm
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+
+readonly IWASM_CMD="../../../product-mini/platforms/${PLATFORM}/build/iwasm"
+
+DEPTHS=${DEPTHS:-"1 4 16 64"}
+ITERATIONS=${ITERATIONS:-100000}
+
+rm -rf tree && mkdir tree
+
+for depth in ${DEPTHS}; do
+    echo "============> run wasi_path native, depth ${depth}"
+    ./wasi_path_native ${depth} ${ITERATIONS}
+
+    echo "============> run wasi_path.aot, depth ${depth}"
+    ${IWASM_CMD} --dir=tree wasi_path.aot ${depth} ${ITERATIONS}
+
+    if command -v strace >/dev/null; then
+        echo "============> syscalls of wasi_path.aot, depth ${depth}"
+        strace -f -c -e trace=%file,%desc \
+            ${IWASM_CMD} --dir=tree wasi_path.aot ${depth} 1000 2>&1 \
+            | grep -E "calls|openat|readlink|newfstatat|statx|close|total"
+    fi
+done
+
+rm -rf tree
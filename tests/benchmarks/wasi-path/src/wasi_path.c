@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Opens and stats a file at the bottom of a directory tree of the given
+   depth, which is created under the preopened directory "tree" */
+
+static double
+now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void
+make_tree(char *path, size_t size, int depth)
+{
+    int i, fd;
+
+    snprintf(path, size, "tree");
+    for (i = 0; i < depth; i++) {
+        snprintf(path + strlen(path), size - strlen(path), "/d%d", i);
+        mkdir(path, 0755);
+    }
+    snprintf(path + strlen(path), size - strlen(path), "/file");
+    if ((fd = open(path, O_CREAT | O_WRONLY, 0644)) >= 0)
+        close(fd);
+}
+
+int
+main(int argc, char **argv)
+{
+    int depth = argc > 1 ? atoi(argv[1]) : 16;
+    int iterations = argc > 2 ? atoi(argv[2]) : 100000;
+    char path[4096];
+    struct stat st;
+    double begin;
+    int i, fd;
+
+    make_tree(path, sizeof(path), depth);
+
+    begin = now_us();
+    for (i = 0; i < iterations; i++) {
+        if ((fd = open(path, O_RDONLY)) < 0) {
+            perror("open");
+            return 1;
+        }
+        close(fd);
+    }
+    printf("depth %d: open+close %.3f us/op\n", depth,
+           (now_us() - begin) / iterations);
+
+    begin = now_us();
+    for (i = 0; i < iterations; i++) {
+        if (stat(path, &st) != 0) {
+            perror("stat");
+            return 1;
+        }
+    }
+    printf("depth %d: stat %.3f us/op\n", depth,
+           (now_us() - begin) / iterations);
+
+    return 0;
+}
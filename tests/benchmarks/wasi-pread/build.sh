@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+WAMRC_CMD=$PWD/../../../wamr-compiler/build/wamrc
+
+echo "===> compile wasi_pread src to wasi_pread_native"
+gcc -O3 -o wasi_pread_native src/wasi_pread.c
+
+echo "===> compile wasi_pread src to wasi_pread.wasm"
+/opt/wasi-sdk/bin/clang -O3 -o wasi_pread.wasm src/wasi_pread.c
+
+echo "===> compile wasi_pread.wasm to wasi_pread.aot"
+${WAMRC_CMD} -o wasi_pread.aot wasi_pread.wasm
@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+
+readonly IWASM_CMD="../../../product-mini/platforms/${PLATFORM}/build/iwasm"
+
+SIZES=${SIZES:-"16 64 512 4096"}
+ITERATIONS=${ITERATIONS:-1000000}
+
+rm -rf data && mkdir data
+
+for size in ${SIZES}; do
+    echo "============> run wasi_pread native, size ${size}"
+    ./wasi_pread_native ${size} ${ITERATIONS}
+
+    echo "============> run wasi_pread.aot, size ${size}"
+    ${IWASM_CMD} --dir=data wasi_pread.aot ${size} ${ITERATIONS}
+
+    echo "============> run wasi_pread.aot with mmap mode, size ${size}"
+    ${IWASM_CMD} --dir=data --mmap-dir=data wasi_pread.aot ${size} \
+        ${ITERATIONS}
+done
+
+rm -rf data
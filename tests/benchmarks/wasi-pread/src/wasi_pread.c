@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Reads a data file in the preopened directory "data" with small pread and
+   read calls. The file is created by the first run and removed by run.sh,
+   as the directory is read-only in the mmap mode */
+
+#define FILE_SIZE (64 * 1024 * 1024)
+
+static double
+now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static int
+make_file(const char *path)
+{
+    static char buf[65536];
+    int fd, i;
+
+    if ((fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0644)) < 0)
+        return -1;
+    for (i = 0; i < (int)sizeof(buf); i++)
+        buf[i] = (char)(i * 7);
+    for (i = 0; i < FILE_SIZE / (int)sizeof(buf); i++) {
+        if (write(fd, buf, sizeof(buf)) != (ssize_t)sizeof(buf)) {
+            close(fd);
+            return -1;
+        }
+    }
+    return close(fd);
+}
+
+int
+main(int argc, char **argv)
+{
+    int size = argc > 1 ? atoi(argv[1]) : 64;
+    int iterations = argc > 2 ? atoi(argv[2]) : 1000000;
+    const char *path = "data/wasi_pread.bin";
+    unsigned char buf[4096];
+    unsigned sum = 0;
+    off_t offset;
+    double begin;
+    int fd, i;
+
+    if (size <= 0 || size > (int)sizeof(buf)) {
+        printf("the read size must be in (0, %d]\n", (int)sizeof(buf));
+        return 1;
+    }
+
+    if ((fd = open(path, O_RDONLY)) < 0
+        && (make_file(path) != 0 || (fd = open(path, O_RDONLY)) < 0)) {
+        perror(path);
+        return 1;
+    }
+
+    begin = now_us();
+    for (i = 0; i < iterations; i++) {
+        /* Pseudo random offsets */
+        offset = (off_t)(((unsigned)i * 2654435761u) % (FILE_SIZE - size));
+        if (pread(fd, buf, size, offset) != size) {
+            perror("pread");
+            return 1;
+        }
+        sum += buf[0];
+    }
+    printf("pread %d bytes: %.3f us/op\n", size,
+           (now_us() - begin) / iterations);
+
+    begin = now_us();
+    for (i = 0; i < iterations; i++) {
+        if (read(fd, buf, size) != size) {
+            lseek(fd, 0, SEEK_SET);
+            continue;
+        }
+        sum += buf[0];
+    }
+    printf("read %d bytes: %.3f us/op\n", size,
+           (now_us() - begin) / iterations);
+
+    close(fd);
+    return sum == 0xFFFFFFFF;
+}
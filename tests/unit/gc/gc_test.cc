@@ -7,6 +7,27 @@
 #include "bh_platform.h"
 #include "bh_read_file.h"
 #include "wasm_export.h"
+#include "gc_export.h"
+#include "wasm_runtime.h"
+#include "ems/ems_gc_internal.h"
+
+/* Number of the threads of the process */
+static uint32
+get_thread_num()
+{
+    char line[256];
+    uint32 thread_num = 0;
+    FILE *file = fopen("/proc/self/status", "r");
+
+    if (!file)
+        return 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "Threads: %" SCNu32, &thread_num) == 1)
+            break;
+    }
+    fclose(file);
+    return thread_num;
+}
 
 class WasmGCTest : public testing::Test
 {
@@ -72,6 +93,18 @@ class WasmGCTest : public testing::Test
         return true;
     }
 
+    /* Restart the runtime with the system allocator so that the GC heap
+       of the instances can be larger than the global heap buffer */
+    bool reinit_runtime(uint32 gc_heap_size)
+    {
+        wasm_runtime_destroy();
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.gc_heap_size = gc_heap_size;
+        cleanup = wasm_runtime_full_init(&init_args);
+        return cleanup;
+    }
+
   public:
     std::string CWD;
     RuntimeInitArgs init_args;
@@ -100,3 +133,291 @@ TEST_F(WasmGCTest, Test_app1)
     ASSERT_TRUE(load_wasm_file("func1.wasm"));
     ASSERT_TRUE(load_wasm_file("func2.wasm"));
 }
+
+TEST_F(WasmGCTest, Test_gc_reclaim)
+{
+    wasm_local_obj_ref_t head;
+    wasm_struct_obj_t obj;
+    wasm_obj_t p;
+    wasm_value_t value;
+    int32 next_id = 0, expected_id;
+    uint32 i, live_cnt = 0, cnt;
+
+    ASSERT_TRUE(load_wasm_file("struct4.wasm"));
+    module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                           sizeof(error_buf));
+    ASSERT_TRUE(module_inst != NULL);
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+    ASSERT_TRUE(exec_env != NULL);
+
+    wasm_runtime_push_local_obj_ref(exec_env, &head);
+    head.val = NULL;
+
+    /* Keep a list of nodes alive while allocating garbage objects of
+       different sizes, so that GC is triggered many times */
+    for (i = 0; i < 200000; i++) {
+        obj = wasm_struct_obj_new_with_typeidx(exec_env, i % 3);
+        ASSERT_TRUE(obj != NULL);
+        if (i % 3 != 0)
+            continue;
+
+        value.i32 = next_id++;
+        wasm_struct_obj_set_field(obj, 0, &value);
+        value.gc_obj = head.val;
+        wasm_struct_obj_set_field(obj, 1, &value);
+        head.val = (wasm_obj_t)obj;
+
+        if (++live_cnt == 1000) {
+            expected_id = next_id - 1;
+            cnt = 0;
+            for (p = head.val; p; p = value.gc_obj) {
+                wasm_struct_obj_get_field((wasm_struct_obj_t)p, 0, false,
+                                          &value);
+                ASSERT_EQ(value.i32, expected_id--);
+                wasm_struct_obj_get_field((wasm_struct_obj_t)p, 1, false,
+                                          &value);
+                cnt++;
+            }
+            ASSERT_EQ(cnt, live_cnt);
+            head.val = NULL;
+            live_cnt = 0;
+        }
+    }
+
+    wasm_runtime_pop_local_obj_ref(exec_env);
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(module);
+}
+
+TEST_F(WasmGCTest, Test_struct_layout)
+{
+    WASMModule *wasm_module;
+    WASMStructType *base, *derived;
+    wasm_struct_obj_t obj;
+    wasm_value_t value;
+    uint32 i, j, size_sum;
+
+    ASSERT_TRUE(load_wasm_file("struct5.wasm"));
+    wasm_module = (WASMModule *)module;
+    base = (WASMStructType *)wasm_module->types[0];
+    derived = (WASMStructType *)wasm_module->types[1];
+
+    /* The inherited fields keep their offsets in the parent type */
+    for (i = 0; i < base->field_count; i++)
+        ASSERT_EQ(derived->fields[i].field_offset,
+                  base->fields[i].field_offset);
+
+    /* The fields don't overlap and are packed without padding on x86 */
+    size_sum = offsetof(WASMStructObject, field_data);
+    for (i = 0; i < derived->field_count; i++) {
+        WASMStructFieldType *field = &derived->fields[i];
+
+        ASSERT_LE(field->field_offset + field->field_size,
+                  derived->total_size);
+        for (j = 0; j < i; j++) {
+            WASMStructFieldType *field2 = &derived->fields[j];
+            ASSERT_TRUE(field->field_offset + field->field_size
+                            <= field2->field_offset
+                        || field2->field_offset + field2->field_size
+                               <= field->field_offset);
+        }
+        size_sum += field->field_size;
+    }
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
+    || defined(BUILD_TARGET_X86_32)
+    ASSERT_EQ(derived->total_size, size_sum);
+#endif
+
+    module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                           sizeof(error_buf));
+    ASSERT_TRUE(module_inst != NULL);
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+    ASSERT_TRUE(exec_env != NULL);
+
+    obj = wasm_struct_obj_new_with_typeidx(exec_env, 1);
+    ASSERT_TRUE(obj != NULL);
+
+    value.i32 = 0x5a;
+    wasm_struct_obj_set_field(obj, 0, &value);
+    value.i64 = 0x123456789abcdefLL;
+    wasm_struct_obj_set_field(obj, 1, &value);
+    value.i32 = 0x7bcd;
+    wasm_struct_obj_set_field(obj, 2, &value);
+    value.gc_obj = (wasm_obj_t)obj;
+    wasm_struct_obj_set_field(obj, 3, &value);
+    value.i32 = 0x12345678;
+    wasm_struct_obj_set_field(obj, 4, &value);
+
+    wasm_struct_obj_get_field(obj, 0, false, &value);
+    ASSERT_EQ(value.i32, 0x5a);
+    wasm_struct_obj_get_field(obj, 1, false, &value);
+    ASSERT_EQ(value.i64, 0x123456789abcdefLL);
+    wasm_struct_obj_get_field(obj, 2, false, &value);
+    ASSERT_EQ(value.i32, 0x7bcd);
+    wasm_struct_obj_get_field(obj, 3, false, &value);
+    ASSERT_EQ(value.gc_obj, (wasm_obj_t)obj);
+    wasm_struct_obj_get_field(obj, 4, false, &value);
+    ASSERT_EQ(value.i32, 0x12345678);
+
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(module);
+}
+
+TEST_F(WasmGCTest, Test_gc_lazy_sweep_stats)
+{
+    wasm_local_obj_ref_t head;
+    wasm_struct_obj_t obj;
+    wasm_obj_t p;
+    wasm_value_t value;
+    gc_heap_t *heap;
+    uint32 stats[GC_STAT_MAX], free_size, i, cnt;
+
+    ASSERT_TRUE(reinit_runtime(4 * 1024 * 1024));
+    ASSERT_TRUE(load_wasm_file("struct4.wasm"));
+    module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                           sizeof(error_buf));
+    ASSERT_TRUE(module_inst != NULL);
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+    ASSERT_TRUE(exec_env != NULL);
+    heap = (gc_heap_t *)((WASMModuleInstance *)module_inst)
+               ->e->common.gc_heap_handle;
+
+    wasm_runtime_push_local_obj_ref(exec_env, &head);
+    head.val = NULL;
+
+    /* Fill half of the heap with large garbage objects between the
+       nodes of a live list */
+    for (i = 0; heap->total_free_size > heap->current_size / 2; i++) {
+        obj = wasm_struct_obj_new_with_typeidx(exec_env, i % 8 ? 2 : 0);
+        ASSERT_TRUE(obj != NULL);
+        if (i % 8)
+            continue;
+        value.gc_obj = head.val;
+        wasm_struct_obj_set_field(obj, 1, &value);
+        head.val = (wasm_obj_t)obj;
+    }
+    ASSERT_EQ(heap->sweep_cur, (hmu_t *)NULL);
+
+    ASSERT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+#if GC_ENABLE_LAZY_SWEEP != 0
+    ASSERT_NE(heap->sweep_cur, (hmu_t *)NULL);
+#endif
+
+    /* The garbage is counted as free before the sweep reaches it */
+    gc_heap_stats(heap, stats, GC_STAT_MAX);
+    free_size = stats[GC_STAT_FREE];
+    ASSERT_GT(free_size, heap->current_size * 3 / 4);
+
+    /* Allocate while the heap is being swept */
+    obj = wasm_struct_obj_new_with_typeidx(exec_env, 2);
+    ASSERT_TRUE(obj != NULL);
+    gc_heap_stats(heap, stats, GC_STAT_MAX);
+    ASSERT_EQ(stats[GC_STAT_FREE],
+              free_size - hmu_get_size(obj_to_hmu((gc_object_t)obj)));
+    free_size = stats[GC_STAT_FREE];
+
+    /* Finishing the sweep doesn't change the free size */
+    if (heap->sweep_cur)
+        gci_sweep_heap(heap, 0);
+    gc_heap_stats(heap, stats, GC_STAT_MAX);
+    ASSERT_EQ(stats[GC_STAT_FREE], free_size);
+
+    for (p = head.val, cnt = 0; p; p = value.gc_obj, cnt++)
+        wasm_struct_obj_get_field((wasm_struct_obj_t)p, 1, false, &value);
+    ASSERT_EQ(cnt, (i + 7) / 8);
+
+    wasm_runtime_pop_local_obj_ref(exec_env);
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(module);
+}
+
+TEST_F(WasmGCTest, Test_gc_parallel_mark)
+{
+    const uint32 chain_num = 64, node_num = 128000;
+    wasm_local_obj_ref_t heads[chain_num];
+    wasm_struct_obj_t obj;
+    wasm_obj_t p;
+    wasm_value_t value;
+    wasm_module_inst_t other_inst;
+    wasm_exec_env_t other_exec_env;
+    gc_heap_t *heap, *other_heap;
+    int32 expected_id;
+    uint32 i, cnt, thread_num;
+
+    ASSERT_TRUE(reinit_runtime(16 * 1024 * 1024));
+    ASSERT_TRUE(load_wasm_file("struct4.wasm"));
+    module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                           sizeof(error_buf));
+    ASSERT_TRUE(module_inst != NULL);
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+    ASSERT_TRUE(exec_env != NULL);
+    heap = (gc_heap_t *)((WASMModuleInstance *)module_inst)
+               ->e->common.gc_heap_handle;
+
+    for (i = 0; i < chain_num; i++) {
+        wasm_runtime_push_local_obj_ref(exec_env, &heads[i]);
+        heads[i].val = NULL;
+    }
+
+    /* Build many chains from the roots with garbage objects between
+       their nodes, so that the markers share the chains and GC is
+       triggered many times */
+    for (i = 0; i < node_num; i++) {
+        obj = wasm_struct_obj_new_with_typeidx(exec_env, 0);
+        ASSERT_TRUE(obj != NULL);
+        value.i32 = (int32)i;
+        wasm_struct_obj_set_field(obj, 0, &value);
+        value.gc_obj = heads[i % chain_num].val;
+        wasm_struct_obj_set_field(obj, 1, &value);
+        heads[i % chain_num].val = (wasm_obj_t)obj;
+
+        ASSERT_TRUE(wasm_struct_obj_new_with_typeidx(exec_env, 2) != NULL);
+        ASSERT_TRUE(wasm_struct_obj_new_with_typeidx(exec_env, 1) != NULL);
+    }
+
+    ASSERT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    thread_num = get_thread_num();
+#if GC_ENABLE_PARALLEL_MARK != 0
+    ASSERT_GE(thread_num, (uint32)GC_MARK_THREAD_NUM);
+#endif
+
+    /* The heap of another instance is marked with the same marker
+       threads */
+    other_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                          sizeof(error_buf));
+    ASSERT_TRUE(other_inst != NULL);
+    other_exec_env = wasm_runtime_create_exec_env(other_inst, 8192);
+    ASSERT_TRUE(other_exec_env != NULL);
+    other_heap = (gc_heap_t *)((WASMModuleInstance *)other_inst)
+                     ->e->common.gc_heap_handle;
+    ASSERT_GE(other_heap->current_size, GC_PARALLEL_MARK_MIN_HEAP_SIZE);
+    ASSERT_EQ(gci_gc_heap(other_heap), GC_SUCCESS);
+    ASSERT_EQ(get_thread_num(), thread_num);
+    wasm_runtime_destroy_exec_env(other_exec_env);
+    wasm_runtime_deinstantiate(other_inst);
+
+    /* All the nodes survive */
+    for (i = 0; i < chain_num; i++) {
+        expected_id = (int32)(node_num - chain_num + i);
+        cnt = 0;
+        for (p = heads[i].val; p; p = value.gc_obj) {
+            wasm_struct_obj_get_field((wasm_struct_obj_t)p, 0, false,
+                                      &value);
+            ASSERT_EQ(value.i32, expected_id);
+            expected_id -= (int32)chain_num;
+            wasm_struct_obj_get_field((wasm_struct_obj_t)p, 1, false,
+                                      &value);
+            cnt++;
+        }
+        ASSERT_EQ(cnt, node_num / chain_num);
+    }
+
+    for (i = 0; i < chain_num; i++)
+        wasm_runtime_pop_local_obj_ref(exec_env);
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_unload(module);
+}
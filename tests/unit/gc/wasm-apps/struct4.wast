@@ -0,0 +1,13 @@
+(module
+  (type $node (struct (field $id (mut i32)) (field $next (mut anyref))))
+  (type $small (struct (field (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64))))
+  (type $large (struct (field (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64)
+                              (mut i64) (mut i64) (mut i64) (mut i64) (mut i64))))
+)
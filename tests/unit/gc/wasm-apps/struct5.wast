@@ -0,0 +1,6 @@
+(module
+  (type $base (sub (struct (field $a (mut i8)) (field $b (mut i64)))))
+  (type $derived (sub $base (struct (field $a (mut i8)) (field $b (mut i64))
+                                    (field $c (mut i16)) (field $d (mut anyref))
+                                    (field $e (mut i32)))))
+)
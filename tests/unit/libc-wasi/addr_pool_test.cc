@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "posix.h"
+}
+
+class AddrPoolTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        ASSERT_TRUE(addr_pool_init(&pool));
+    }
+
+    virtual void TearDown()
+    {
+        addr_pool_destroy(&pool);
+        wasm_runtime_destroy();
+    }
+
+  public:
+    struct addr_pool pool;
+};
+
+/* A prefix and the linear matching done before the pool became a trie */
+struct Prefix {
+    uint32_t addr;
+    uint8_t mask;
+
+    bool match(uint32_t target) const
+    {
+        if (addr == 0)
+            return true;
+        if (mask > 32)
+            return false;
+        uint32_t bits = mask == 0 ? 0 : ~0u << (32 - mask);
+        return (addr & bits) == (target & bits);
+    }
+};
+
+static std::string
+ip4_to_string(uint32_t addr)
+{
+    char buf[16];
+
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", addr >> 24, (addr >> 16) & 0xFF,
+             (addr >> 8) & 0xFF, addr & 0xFF);
+    return buf;
+}
+
+TEST_F(AddrPoolTest, empty)
+{
+    EXPECT_FALSE(addr_pool_search(&pool, "127.0.0.1"));
+    EXPECT_FALSE(addr_pool_search(&pool, "::1"));
+}
+
+TEST_F(AddrPoolTest, ipv4)
+{
+    ASSERT_TRUE(addr_pool_insert(&pool, "192.168.1.0", 24));
+    ASSERT_TRUE(addr_pool_insert(&pool, "10.0.0.1", 32));
+
+    EXPECT_TRUE(addr_pool_search(&pool, "192.168.1.0"));
+    EXPECT_TRUE(addr_pool_search(&pool, "192.168.1.255"));
+    EXPECT_FALSE(addr_pool_search(&pool, "192.168.2.1"));
+    EXPECT_TRUE(addr_pool_search(&pool, "10.0.0.1"));
+    EXPECT_FALSE(addr_pool_search(&pool, "10.0.0.2"));
+    EXPECT_FALSE(addr_pool_search(&pool, "::ffff:10.0.0.1"));
+    EXPECT_FALSE(addr_pool_search(&pool, "invalid"));
+    EXPECT_FALSE(addr_pool_insert(&pool, "invalid", 8));
+}
+
+TEST_F(AddrPoolTest, ipv6)
+{
+    ASSERT_TRUE(addr_pool_insert(&pool, "2001:db8::", 32));
+    ASSERT_TRUE(addr_pool_insert(&pool, "fe80::1", 128));
+
+    EXPECT_TRUE(addr_pool_search(&pool, "2001:db8::1"));
+    EXPECT_TRUE(addr_pool_search(&pool, "2001:db8:ffff::"));
+    EXPECT_FALSE(addr_pool_search(&pool, "2001:db9::"));
+    EXPECT_TRUE(addr_pool_search(&pool, "fe80::1"));
+    EXPECT_FALSE(addr_pool_search(&pool, "fe80::2"));
+    EXPECT_FALSE(addr_pool_search(&pool, "32.1.13.184"));
+}
+
+TEST_F(AddrPoolTest, any_address)
+{
+    /* The mask of 0.0.0.0 and :: is ignored */
+    ASSERT_TRUE(addr_pool_insert(&pool, "0.0.0.0", 32));
+    EXPECT_TRUE(addr_pool_search(&pool, "1.2.3.4"));
+    EXPECT_FALSE(addr_pool_search(&pool, "::1"));
+
+    ASSERT_TRUE(addr_pool_insert(&pool, "::", 128));
+    EXPECT_TRUE(addr_pool_search(&pool, "::1"));
+}
+
+TEST_F(AddrPoolTest, invalid_mask)
+{
+    ASSERT_TRUE(addr_pool_insert(&pool, "1.2.3.4", 33));
+    ASSERT_TRUE(addr_pool_insert(&pool, "::1", 129));
+    EXPECT_FALSE(addr_pool_search(&pool, "1.2.3.4"));
+    EXPECT_FALSE(addr_pool_search(&pool, "::1"));
+}
+
+TEST_F(AddrPoolTest, nested_prefixes)
+{
+    /* A longer prefix inserted after a shorter one and the reverse */
+    ASSERT_TRUE(addr_pool_insert(&pool, "10.0.0.0", 8));
+    ASSERT_TRUE(addr_pool_insert(&pool, "10.1.2.0", 24));
+    ASSERT_TRUE(addr_pool_insert(&pool, "172.16.5.0", 24));
+    ASSERT_TRUE(addr_pool_insert(&pool, "172.16.0.0", 12));
+
+    EXPECT_TRUE(addr_pool_search(&pool, "10.200.0.1"));
+    EXPECT_TRUE(addr_pool_search(&pool, "10.1.2.3"));
+    EXPECT_TRUE(addr_pool_search(&pool, "172.31.0.1"));
+    EXPECT_TRUE(addr_pool_search(&pool, "172.16.5.1"));
+    EXPECT_FALSE(addr_pool_search(&pool, "172.32.0.1"));
+}
+
+TEST_F(AddrPoolTest, random_against_linear_match)
+{
+    std::mt19937 rng(1234);
+    std::vector<Prefix> prefixes;
+
+    for (int i = 0; i < 2000; i++) {
+        Prefix prefix = { (uint32_t)rng() | 1, (uint8_t)(rng() % 34) };
+        prefixes.push_back(prefix);
+        ASSERT_TRUE(addr_pool_insert(
+            &pool, ip4_to_string(prefix.addr).c_str(), prefix.mask));
+    }
+
+    for (int i = 0; i < 20000; i++) {
+        /* Half of the addresses share a prefix with an entry */
+        uint32_t target = (uint32_t)rng();
+        if (i % 2) {
+            const Prefix &prefix = prefixes[rng() % prefixes.size()];
+            target = (prefix.addr & 0xFFFF0000) | (target & 0xFFFF);
+        }
+
+        bool expected = false;
+        for (const Prefix &prefix : prefixes)
+            expected = expected || prefix.match(target);
+
+        ASSERT_EQ(expected,
+                  addr_pool_search(&pool, ip4_to_string(target).c_str()))
+            << ip4_to_string(target);
+    }
+}
+
+/* Not a correctness test, it reports the cost of a check with a large pool,
+   which used to grow linearly with the pool size. Disabled by default, run
+   it with --gtest_also_run_disabled_tests */
+TEST_F(AddrPoolTest, DISABLED_large_pool_benchmark)
+{
+    const int pool_size = 10000, lookups = 1000000;
+    std::mt19937 rng(5678);
+    std::vector<std::string> targets;
+    char buf[64];
+    int matched = 0;
+
+    for (int i = 0; i < pool_size; i++) {
+        ASSERT_TRUE(addr_pool_insert(
+            &pool, ip4_to_string((uint32_t)rng()).c_str(), 24));
+        snprintf(buf, sizeof(buf), "2001:db8:%x:%x::", (unsigned)rng() & 0xFFFF,
+                 (unsigned)rng() & 0xFFFF);
+        ASSERT_TRUE(addr_pool_insert(&pool, buf, 64));
+    }
+
+    for (int i = 0; i < 1024; i++) {
+        targets.push_back(ip4_to_string((uint32_t)rng()));
+        snprintf(buf, sizeof(buf), "2001:db8:%x:%x::1",
+                 (unsigned)rng() & 0xFFFF, (unsigned)rng() & 0xFFFF);
+        targets.push_back(buf);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++)
+        matched += addr_pool_search(&pool, targets[i % targets.size()].c_str());
+    auto end = std::chrono::steady_clock::now();
+
+    printf("%d IPv4 and %d IPv6 prefixes: %.1f ns per check, %d matched\n",
+           pool_size, pool_size,
+           std::chrono::duration<double, std::nano>(end - begin).count()
+               / lookups,
+           matched);
+}
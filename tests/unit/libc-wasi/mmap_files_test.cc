@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+#include "bh_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+#include "posix.h"
+#include "wasmtime_ssp.h"
+}
+
+#define DIR_FD 3
+#define FILE_SIZE (64 * 1024)
+
+class MmapFilesTest : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        RuntimeInitArgs init_args;
+        char dir_template[] = "/tmp/mmap_files_test.XXXXXX";
+        os_file_handle handle;
+        FILE *file;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        ASSERT_NE(mkdtemp(dir_template), nullptr);
+        dir = dir_template;
+        file_path = dir + "/data.bin";
+
+        content.resize(FILE_SIZE);
+        for (size_t i = 0; i < content.size(); i++)
+            content[i] = (char)(i * 7 + 3);
+        ASSERT_NE(file = fopen(file_path.c_str(), "wb"), nullptr);
+        ASSERT_EQ(fwrite(content.data(), 1, content.size(), file),
+                  content.size());
+        fclose(file);
+
+        ASSERT_TRUE(fd_table_init(&curfds));
+        ASSERT_TRUE(fd_prestats_init(&prestats));
+        ASSERT_EQ(os_open_preopendir(dir.c_str(), &handle),
+                  __WASI_ESUCCESS);
+        ASSERT_TRUE(fd_table_insert_existing(&curfds, DIR_FD, handle, false));
+        ASSERT_TRUE(fd_prestats_insert(&prestats, dir.c_str(), DIR_FD));
+    }
+
+    virtual void TearDown()
+    {
+        fd_table_destroy(&curfds);
+        fd_prestats_destroy(&prestats);
+        unlink(file_path.c_str());
+        rmdir(dir.c_str());
+        wasm_runtime_destroy();
+    }
+
+    __wasi_errno_t open_file(__wasi_oflags_t oflags, __wasi_rights_t rights,
+                             __wasi_fd_t *fd)
+    {
+        return wasmtime_ssp_path_open(NULL, &curfds, DIR_FD, 0, "data.bin",
+                                      strlen("data.bin"), oflags, rights, 0,
+                                      0, fd);
+    }
+
+  public:
+    struct fd_table curfds;
+    struct fd_prestats prestats;
+    std::string dir;
+    std::string file_path;
+    std::vector<char> content;
+};
+
+TEST_F(MmapFilesTest, read_after_truncate)
+{
+    __wasi_rights_t read_rights = __WASI_RIGHT_FD_READ | __WASI_RIGHT_FD_SEEK;
+    std::vector<char> buf(FILE_SIZE);
+    __wasi_iovec_t iov;
+    __wasi_fdstat_t fdstat;
+    __wasi_fd_t fd, fd2;
+    size_t nread;
+
+    ASSERT_TRUE(fd_table_enable_mmap_files(&curfds, &prestats, dir.c_str()));
+
+    /* The directory no longer carries the rights to resize its files */
+    ASSERT_EQ(wasmtime_ssp_fd_fdstat_get(NULL, &curfds, DIR_FD, &fdstat),
+              __WASI_ESUCCESS);
+    EXPECT_EQ(fdstat.fs_rights_base & __WASI_RIGHT_PATH_FILESTAT_SET_SIZE,
+              0u);
+    EXPECT_EQ(fdstat.fs_rights_inheriting
+                  & (__WASI_RIGHT_FD_WRITE
+                     | __WASI_RIGHT_FD_FILESTAT_SET_SIZE),
+              0u);
+
+    /* Map the file, and read its first half */
+    ASSERT_EQ(open_file(0, read_rights, &fd), __WASI_ESUCCESS);
+    iov.buf = (uint8_t *)buf.data();
+    iov.buf_len = FILE_SIZE / 2;
+    ASSERT_EQ(wasmtime_ssp_fd_read(NULL, &curfds, fd, &iov, 1, &nread),
+              __WASI_ESUCCESS);
+    ASSERT_EQ(nread, (size_t)FILE_SIZE / 2);
+
+    /* Every way the guest has to truncate the mapped file is refused */
+    EXPECT_EQ(open_file(__WASI_O_TRUNC, read_rights | __WASI_RIGHT_FD_WRITE,
+                        &fd2),
+              __WASI_ENOTCAPABLE);
+    EXPECT_EQ(open_file(0, read_rights | __WASI_RIGHT_FD_WRITE, &fd2),
+              __WASI_ENOTCAPABLE);
+    EXPECT_EQ(open_file(0, read_rights | __WASI_RIGHT_FD_FILESTAT_SET_SIZE,
+                        &fd2),
+              __WASI_ENOTCAPABLE);
+    EXPECT_EQ(wasmtime_ssp_fd_filestat_set_size(NULL, &curfds, fd, 0),
+              __WASI_ENOTCAPABLE);
+
+    /* So the rest of the mapping can still be read */
+    iov.buf = (uint8_t *)buf.data() + FILE_SIZE / 2;
+    iov.buf_len = FILE_SIZE / 2;
+    ASSERT_EQ(wasmtime_ssp_fd_read(NULL, &curfds, fd, &iov, 1, &nread),
+              __WASI_ESUCCESS);
+    ASSERT_EQ(nread, (size_t)FILE_SIZE / 2);
+    EXPECT_EQ(memcmp(buf.data(), content.data(), FILE_SIZE), 0);
+
+    memset(buf.data(), 0, FILE_SIZE);
+    iov.buf = (uint8_t *)buf.data();
+    iov.buf_len = FILE_SIZE;
+    ASSERT_EQ(wasmtime_ssp_fd_pread(NULL, &curfds, fd, &iov, 1, 0, &nread),
+              __WASI_ESUCCESS);
+    ASSERT_EQ(nread, (size_t)FILE_SIZE);
+    EXPECT_EQ(memcmp(buf.data(), content.data(), FILE_SIZE), 0);
+
+    EXPECT_EQ(wasmtime_ssp_fd_close(NULL, &curfds, &prestats, fd),
+              __WASI_ESUCCESS);
+}
+
+TEST_F(MmapFilesTest, truncate_without_mmap)
+{
+    __wasi_rights_t rights = __WASI_RIGHT_FD_READ | __WASI_RIGHT_FD_WRITE
+                             | __WASI_RIGHT_FD_FILESTAT_SET_SIZE;
+    __wasi_fd_t fd;
+
+    /* Directories without mmap mode keep their write rights */
+    ASSERT_EQ(open_file(__WASI_O_TRUNC, rights, &fd), __WASI_ESUCCESS);
+    EXPECT_EQ(wasmtime_ssp_fd_filestat_set_size(NULL, &curfds, fd, 16),
+              __WASI_ESUCCESS);
+    EXPECT_EQ(wasmtime_ssp_fd_close(NULL, &curfds, &prestats, fd),
+              __WASI_ESUCCESS);
+}
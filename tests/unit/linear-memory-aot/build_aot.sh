@@ -43,3 +43,11 @@ for file_name in "${file_names[@]}"; do
     $WAMRC --bounds-checks=1 -o "build/${file_name}_no_hw_bounds.aot" "build/${file_name}.wasm"
     $WAMRC --bounds-checks=1 --target=i386 -o "build/${file_name}_no_hw_bounds_32.aot" "build/${file_name}.wasm"
 done
+
+# wabt doesn't support memory.discard, use the wasm file of the
+# linear-memory-wasm tests, which is generated from memory_discard.wast
+DISCARD_WASM="../linear-memory-wasm/wasm_files/memory_discard.wasm"
+$WAMRC --enable-memory-discard -o "build/memory_discard.aot" "$DISCARD_WASM"
+$WAMRC --enable-memory-discard --target=i386 -o "build/memory_discard_32.aot" "$DISCARD_WASM"
+$WAMRC --enable-memory-discard --bounds-checks=1 -o "build/memory_discard_no_hw_bounds.aot" "$DISCARD_WASM"
+$WAMRC --enable-memory-discard --bounds-checks=1 --target=i386 -o "build/memory_discard_no_hw_bounds_32.aot" "$DISCARD_WASM"
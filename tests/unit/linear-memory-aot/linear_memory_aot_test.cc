@@ -359,3 +359,74 @@ TEST_F(TEST_SUITE_NAME, test_mem_grow_out_of_bounds)
 failed_out_of_bounds:
     destroy_module_env(tmp_module_env);
 }
+
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+static bool
+call_func(struct ret_env &module_env, const char *name, uint32 argc,
+          uint32 argv[])
+{
+    wasm_function_inst_t func =
+        wasm_runtime_lookup_function(module_env.aot_module_inst, name);
+
+    EXPECT_NE(nullptr, func) << name;
+    return func
+           && wasm_runtime_call_wasm(module_env.exec_env, func, argc, argv);
+}
+
+TEST_F(TEST_SUITE_NAME, test_memory_discard_opcode)
+{
+    struct ret_env tmp_module_env;
+    uint32 argv[2];
+
+    // Test case: memory_discard.wasm of the linear-memory-wasm tests,
+    // compiled with --enable-memory-discard, the AOT code calls
+    // aot_memory_discard
+#if UINTPTR_MAX == UINT64_MAX
+    tmp_module_env = load_aot((char *)"/memory_discard.aot", 0);
+#else
+    tmp_module_env = load_aot((char *)"/memory_discard_32.aot", 0);
+#endif
+    ASSERT_NE(nullptr, tmp_module_env.aot_module_inst)
+        << tmp_module_env.error_buf;
+
+    argv[0] = 0;
+    argv[1] = 0xab;
+    ASSERT_TRUE(call_func(tmp_module_env, "store", 2, argv));
+    argv[0] = 65536 + 100;
+    argv[1] = 0xab;
+    ASSERT_TRUE(call_func(tmp_module_env, "store", 2, argv));
+
+    // Discard the second page only
+    argv[0] = 65536;
+    argv[1] = 65536;
+    ASSERT_TRUE(call_func(tmp_module_env, "discard", 2, argv));
+    argv[0] = 65536 + 100;
+    ASSERT_TRUE(call_func(tmp_module_env, "load", 1, argv));
+    EXPECT_EQ(0, argv[0]);
+    argv[0] = 0;
+    ASSERT_TRUE(call_func(tmp_module_env, "load", 1, argv));
+    EXPECT_EQ(0xab, argv[0]);
+
+    // The address and the length must be multiples of 64 KB
+    argv[0] = 100;
+    argv[1] = 65536;
+    EXPECT_FALSE(call_func(tmp_module_env, "discard", 2, argv));
+    EXPECT_STREQ("Exception: unaligned memory discard",
+                 wasm_runtime_get_exception(tmp_module_env.aot_module_inst));
+    wasm_runtime_clear_exception(tmp_module_env.aot_module_inst);
+
+    // Out of bounds
+    argv[0] = 65536;
+    argv[1] = 2 * 65536;
+    EXPECT_FALSE(call_func(tmp_module_env, "discard", 2, argv));
+    EXPECT_STREQ("Exception: out of bounds memory access",
+                 wasm_runtime_get_exception(tmp_module_env.aot_module_inst));
+    wasm_runtime_clear_exception(tmp_module_env.aot_module_inst);
+
+    argv[0] = 0;
+    ASSERT_TRUE(call_func(tmp_module_env, "load", 1, argv));
+    EXPECT_EQ(0xab, argv[0]);
+
+    destroy_module_env(tmp_module_env);
+}
+#endif /* end of WASM_ENABLE_MEMORY_DISCARD != 0 */
@@ -325,3 +325,159 @@ TEST_F(TEST_SUITE_NAME, test_mem_grow_out_of_bounds)
 failed_out_of_bounds:
     destroy_module_env(tmp_module_env);
 }
+
+TEST_F(TEST_SUITE_NAME, test_discard_memory)
+{
+    struct ret_env tmp_module_env;
+    uint8 *memory_data = nullptr;
+    uint32 memory_size = 2 * 64 * 1024;
+
+    // Test case: module((memory 2)), discard the ranges of the memory filled
+    // with non-zero bytes.
+    tmp_module_env = load_wasm((char *)"/mem_grow_out_of_bounds_01.wasm", 0);
+    ASSERT_NE(nullptr, tmp_module_env.wasm_module_inst);
+
+    memory_data = (uint8 *)wasm_runtime_addr_app_to_native(
+        tmp_module_env.wasm_module_inst, 0);
+    ASSERT_NE(nullptr, memory_data);
+    memset(memory_data, 0xab, memory_size);
+
+    // A range which isn't page aligned
+    EXPECT_TRUE(wasm_runtime_discard_memory(tmp_module_env.wasm_module_inst,
+                                            100, 70000));
+    EXPECT_EQ(0xab, memory_data[99]);
+    EXPECT_EQ(0, memory_data[100]);
+    EXPECT_EQ(0, memory_data[70099]);
+    EXPECT_EQ(0xab, memory_data[70100]);
+
+    // The whole memory
+    EXPECT_TRUE(wasm_runtime_discard_memory(tmp_module_env.wasm_module_inst,
+                                            0, memory_size));
+    for (uint32 i = 0; i < memory_size; i += 4096) {
+        EXPECT_EQ(0, memory_data[i]);
+    }
+    EXPECT_EQ(0, memory_data[memory_size - 1]);
+
+    // The pages given back can be written again
+    memory_data[memory_size - 1] = 0xab;
+    EXPECT_EQ(0xab, memory_data[memory_size - 1]);
+
+    // Out of bounds ranges
+    EXPECT_FALSE(wasm_runtime_discard_memory(tmp_module_env.wasm_module_inst,
+                                             memory_size - 1, 2));
+    EXPECT_FALSE(wasm_runtime_discard_memory(tmp_module_env.wasm_module_inst,
+                                             1, UINT64_MAX));
+    EXPECT_TRUE(wasm_runtime_discard_memory(tmp_module_env.wasm_module_inst,
+                                            memory_size, 0));
+    EXPECT_EQ(0xab, memory_data[memory_size - 1]);
+
+    destroy_module_env(tmp_module_env);
+}
+
+#if WASM_ENABLE_MEMORY_DISCARD != 0
+static std::vector<RunningMode> running_mode_supported = { Mode_Interp,
+#if WASM_ENABLE_FAST_JIT != 0
+                                                           Mode_Fast_JIT,
+#endif
+#if WASM_ENABLE_JIT != 0
+                                                           Mode_LLVM_JIT,
+#endif
+};
+
+static bool
+call_func(struct ret_env &module_env, const char *name, uint32 argc,
+          uint32 argv[])
+{
+    wasm_function_inst_t func = wasm_runtime_lookup_function(
+        module_env.wasm_module_inst, name);
+
+    EXPECT_NE(nullptr, func) << name;
+    return func
+           && wasm_runtime_call_wasm(module_env.exec_env, func, argc, argv);
+}
+
+TEST_F(TEST_SUITE_NAME, test_memory_discard_opcode)
+{
+    struct ret_env tmp_module_env;
+    uint32 argv[2];
+
+    // Test case: memory_discard.wasm, the opcode with (memory 2), run by
+    // each running mode
+    tmp_module_env = load_wasm((char *)"/memory_discard.wasm", 0);
+    ASSERT_NE(nullptr, tmp_module_env.wasm_module_inst)
+        << tmp_module_env.error_buf;
+
+    for (RunningMode mode : running_mode_supported) {
+        ASSERT_TRUE(wasm_runtime_set_running_mode(
+            tmp_module_env.wasm_module_inst, mode));
+
+        argv[0] = 0;
+        argv[1] = 0xab;
+        ASSERT_TRUE(call_func(tmp_module_env, "store", 2, argv));
+        argv[0] = 65536 + 100;
+        argv[1] = 0xab;
+        ASSERT_TRUE(call_func(tmp_module_env, "store", 2, argv));
+
+        // Discard the second page only
+        argv[0] = 65536;
+        argv[1] = 65536;
+        ASSERT_TRUE(call_func(tmp_module_env, "discard", 2, argv));
+        argv[0] = 65536 + 100;
+        ASSERT_TRUE(call_func(tmp_module_env, "load", 1, argv));
+        EXPECT_EQ(0, argv[0]);
+        argv[0] = 0;
+        ASSERT_TRUE(call_func(tmp_module_env, "load", 1, argv));
+        EXPECT_EQ(0xab, argv[0]);
+
+        // The address and the length must be multiples of 64 KB
+        argv[0] = 100;
+        argv[1] = 65536;
+        EXPECT_FALSE(call_func(tmp_module_env, "discard", 2, argv));
+        EXPECT_STREQ("Exception: unaligned memory discard",
+                     wasm_runtime_get_exception(
+                         tmp_module_env.wasm_module_inst));
+        wasm_runtime_clear_exception(tmp_module_env.wasm_module_inst);
+        argv[0] = 0;
+        argv[1] = 100;
+        EXPECT_FALSE(call_func(tmp_module_env, "discard", 2, argv));
+        EXPECT_STREQ("Exception: unaligned memory discard",
+                     wasm_runtime_get_exception(
+                         tmp_module_env.wasm_module_inst));
+        wasm_runtime_clear_exception(tmp_module_env.wasm_module_inst);
+
+        // Out of bounds
+        argv[0] = 65536;
+        argv[1] = 2 * 65536;
+        EXPECT_FALSE(call_func(tmp_module_env, "discard", 2, argv));
+        EXPECT_STREQ("Exception: out of bounds memory access",
+                     wasm_runtime_get_exception(
+                         tmp_module_env.wasm_module_inst));
+        wasm_runtime_clear_exception(tmp_module_env.wasm_module_inst);
+
+        // Nothing was discarded by the failed ones
+        argv[0] = 0;
+        ASSERT_TRUE(call_func(tmp_module_env, "load", 1, argv));
+        EXPECT_EQ(0xab, argv[0]);
+    }
+
+    destroy_module_env(tmp_module_env);
+}
+
+TEST_F(TEST_SUITE_NAME, test_memory_discard_without_memory)
+{
+    // (module (func (param i32 i32) local.get 0 local.get 1 memory.discard))
+    uint8 wasm[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01,
+                     0x06, 0x01, 0x60, 0x02, 0x7f, 0x7f, 0x00, 0x03, 0x02,
+                     0x01, 0x00, 0x0a, 0x0b, 0x01, 0x09, 0x00, 0x20, 0x00,
+                     0x20, 0x01, 0xfc, 0x12, 0x00, 0x0b };
+    char error_buf[128] = { 0 };
+    wasm_module_t module;
+
+    module = wasm_runtime_load(wasm, sizeof(wasm), error_buf,
+                               sizeof(error_buf));
+    EXPECT_EQ(nullptr, module);
+    EXPECT_NE(nullptr, strstr(error_buf, "unknown memory 0")) << error_buf;
+    if (module)
+        wasm_runtime_unload(module);
+}
+#endif /* end of WASM_ENABLE_MEMORY_DISCARD != 0 */
@@ -0,0 +1,25 @@
+(module
+  (type $discard_t (func (param i32 i32)))
+  (type $load_t (func (param i32) (result i32)))
+  (memory $0 2)
+  (export "discard" (func $discard))
+  (export "load" (func $load))
+  (export "store" (func $store))
+
+  (func $discard (type $discard_t) (param $addr i32) (param $len i32)
+    local.get $addr
+    local.get $len
+    memory.discard
+    )
+
+  (func $load (type $load_t) (param $addr i32) (result i32)
+    local.get $addr
+    i32.load8_u
+    )
+
+  (func $store (type $discard_t) (param $addr i32) (param $value i32)
+    local.get $addr
+    local.get $value
+    i32.store8
+    )
+)
@@ -189,3 +189,72 @@ TEST_F(CApiTests, wasm_func_t)
     wasm_func_delete(callback_func);
     wasm_store_delete(store);
 }
+
+TEST_F(CApiTests, module_cache)
+{
+    wasm_module_cache_stats_t stats = {};
+
+#if WASM_ENABLE_WASM_CACHE == 0
+    EXPECT_FALSE(wasm_engine_get_module_cache_stats(engine, &stats));
+#else
+    /* (module) and (module (memory 1)) */
+    uint8_t empty_module[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    uint8_t memory_module[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00,
+                                0x00, 0x05, 0x03, 0x01, 0x00, 0x01 };
+    wasm_byte_vec_t binary1, binary2;
+    wasm_module_cache_stats_t begin = {};
+    wasm_module_t *module1, *module2;
+    wasm_store_t *store;
+    uint32_t module_num = bh_vector_size(&engine->modules);
+
+    wasm_byte_vec_new(&binary1, sizeof(empty_module), (char *)empty_module);
+    wasm_byte_vec_new(&binary2, sizeof(memory_module), (char *)memory_module);
+    ASSERT_TRUE(wasm_engine_get_module_cache_stats(engine, &begin));
+
+    /* without budget, a module is shared while it is used */
+    engine->module_cache_budget = 0;
+    store = wasm_store_new(engine);
+    module1 = wasm_module_new(store, &binary1);
+    ASSERT_NE(nullptr, module1);
+    EXPECT_EQ(module1, wasm_module_new(store, &binary1));
+    wasm_store_delete(store);
+
+    ASSERT_TRUE(wasm_engine_get_module_cache_stats(engine, &stats));
+    EXPECT_EQ(begin.hits + 1, stats.hits);
+    EXPECT_EQ(begin.misses + 1, stats.misses);
+    EXPECT_EQ(begin.evictions + 1, stats.evictions);
+    EXPECT_EQ(0u, stats.module_count);
+    /* the evicted module is freed */
+    EXPECT_EQ(module_num, bh_vector_size(&engine->modules));
+
+    /* the least recently used idle module is unloaded out of the budget */
+    engine->module_cache_budget = sizeof(memory_module);
+    store = wasm_store_new(engine);
+    module1 = wasm_module_new(store, &binary1);
+    module2 = wasm_module_new(store, &binary2);
+    ASSERT_NE(nullptr, module1);
+    ASSERT_NE(nullptr, module2);
+    wasm_store_delete(store);
+
+    ASSERT_TRUE(wasm_engine_get_module_cache_stats(engine, &stats));
+    EXPECT_EQ(begin.evictions + 2, stats.evictions);
+    EXPECT_EQ(1u, stats.module_count);
+    EXPECT_EQ(sizeof(memory_module), stats.size);
+    EXPECT_EQ(module_num + 1, bh_vector_size(&engine->modules));
+
+    store = wasm_store_new(engine);
+    EXPECT_EQ(module2, wasm_module_new(store, &binary2));
+    ASSERT_NE(nullptr, wasm_module_new(store, &binary1));
+    wasm_store_delete(store);
+
+    ASSERT_TRUE(wasm_engine_get_module_cache_stats(engine, &stats));
+    EXPECT_EQ(begin.hits + 2, stats.hits);
+    EXPECT_EQ(begin.misses + 4, stats.misses);
+    EXPECT_EQ(module_num + stats.module_count,
+              bh_vector_size(&engine->modules));
+
+    engine->module_cache_budget = 0;
+    wasm_byte_vec_delete(&binary1);
+    wasm_byte_vec_delete(&binary2);
+#endif
+}
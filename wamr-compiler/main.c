@@ -140,8 +140,9 @@ print_help()
     printf("  --bounds-checks=1/0       Enable or disable the bounds checks for memory access:\n");
     printf("                              This flag controls bounds checking with a software check. \n"); 
     printf("                              On 64-bit platforms, it is disabled by default, using a hardware \n"); 
-    printf("                              trap if supported, except when SGX or memory64 is enabled,\n"); 
-    printf("                              which defaults to a software check.\n"); 
+    printf("                              trap if supported, except when SGX is enabled, or memory64 is\n");
+    printf("                              enabled and its max memory size exceeds 64GB, which defaults\n");
+    printf("                              to a software check.\n");
     printf("                              On 32-bit platforms, the flag is enabled by default, using a software check\n");
     printf("                              due to the lack of hardware support.\n"); 
     printf("                            CAVEAT: --bounds-checks=0 enables some optimizations\n");
@@ -161,6 +162,7 @@ print_help()
     printf("  --disable-bulk-memory     Disable the MVP bulk memory feature\n");
     printf("  --enable-bulk-memory-opt  Enable bulk memory opt feature\n");
     printf("  --enable-extended-const   Enable extended const expr feature\n");
+    printf("  --enable-memory-discard   Enable the memory.discard opcode of the memory control proposal\n");
     printf("  --enable-multi-thread     Enable multi-thread feature, the dependent features bulk-memory and\n");
     printf("                            thread-mgr will be enabled automatically\n");
     printf("  --enable-tail-call        Enable the post-MVP tail call feature\n");
@@ -182,6 +184,13 @@ print_help()
     printf("                            Available features: bounds-checks, ip, func-idx, trap-ip, values.\n");
     printf("  --enable-perf-profiling   Enable function performance profiling\n");
     printf("  --enable-memory-profiling Enable memory usage profiling\n");
+    printf("  --enable-instruction-metering\n");
+    printf("                            Enable instruction metering, the limit set by\n");
+    printf("                            wasm_runtime_set_instruction_count_limit is checked at loop\n");
+    printf("                            headers, calls and returns\n");
+    printf("  --enable-epoch-interruption\n");
+    printf("                            Check the epoch deadline set by wasm_runtime_set_epoch_deadline\n");
+    printf("                            at function entries and loop headers\n");
     printf("  --xip                     A shorthand of --enable-indirect-mode --disable-llvm-intrinsics\n");
     printf("  --enable-indirect-mode    Enable call function through symbol table but not direct call\n");
     printf("  --enable-gc               Enable GC (Garbage Collection) feature\n");
@@ -198,6 +207,9 @@ print_help()
     printf("  --enable-llvm-passes=<passes>\n");
     printf("                            Enable the specified LLVM passes, using comma to separate\n");
     printf("  --use-prof-file=<file>    Use profile file collected by LLVM PGO (Profile-Guided Optimization)\n");
+    printf("  --use-interp-prof-file=<file>\n");
+    printf("                            Use profile file collected by the interpreter to set the branch\n");
+    printf("                            weights and mark the hot and cold functions\n");
     printf("  --enable-segue[=<flags>]  Enable using segment register GS as the base address of linear memory,\n");
     printf("                            only available on linux x86-64, which may improve performance,\n");
     printf("                            flags can be: i32.load, i64.load, f32.load, f64.load, v128.load,\n");
@@ -556,6 +568,9 @@ main(int argc, char *argv[])
         else if (!strcmp(argv[0], "--enable-extended-const")) {
             option.enable_extended_const = true;
         }
+        else if (!strcmp(argv[0], "--enable-memory-discard")) {
+            option.enable_memory_discard = true;
+        }
         else if (!strcmp(argv[0], "--enable-lime1")) {
             option.enable_lime1 = true;
         }
@@ -583,6 +598,12 @@ main(int argc, char *argv[])
             option.enable_memory_profiling = true;
             option.enable_stack_estimation = true;
         }
+        else if (!strcmp(argv[0], "--enable-instruction-metering")) {
+            option.enable_instruction_metering = true;
+        }
+        else if (!strcmp(argv[0], "--enable-epoch-interruption")) {
+            option.enable_epoch_interruption = true;
+        }
         else if (!strcmp(argv[0], "--xip")) {
             option.is_indirect_mode = true;
             option.disable_llvm_intrinsics = true;
@@ -621,6 +642,11 @@ main(int argc, char *argv[])
                 PRINT_HELP_AND_EXIT();
             option.use_prof_file = argv[0] + 16;
         }
+        else if (!strncmp(argv[0], "--use-interp-prof-file=", 23)) {
+            if (argv[0][23] == '\0')
+                PRINT_HELP_AND_EXIT();
+            option.use_interp_prof_file = argv[0] + 23;
+        }
         else if (!strcmp(argv[0], "--enable-segue")) {
             /* all flags are enabled */
             option.segue_flags = 0x1F1F;